@@ -30,9 +30,11 @@ actions/CCActionTiledGrid.cpp \
 actions/CCActionTween.cpp \
 base_nodes/CCAtlasNode.cpp \
 base_nodes/CCNode.cpp \
+base_nodes/CCTransformUpdater.cpp \
 cocoa/CCAffineTransform.cpp \
 cocoa/CCArray.cpp \
 cocoa/CCAutoreleasePool.cpp \
+cocoa/CCObjectPool.cpp \
 cocoa/CCData.cpp \
 cocoa/CCDataVisitor.cpp \
 cocoa/CCDictionary.cpp \
@@ -89,8 +91,10 @@ particle_nodes/CCParticleBatchNode.cpp \
 particle_nodes/CCParticleExamples.cpp \
 particle_nodes/CCParticleSystem.cpp \
 particle_nodes/CCParticleSystemQuad.cpp \
+particle_nodes/CCParticleSimulator.cpp \
 platform/CCEGLViewProtocol.cpp \
 platform/CCFileUtils.cpp \
+platform/CCResourcePack.cpp \
 platform/CCSAXParser.cpp \
 platform/CCThread.cpp \
 platform/third_party/common/atitc/atitc.cpp \
@@ -107,13 +111,21 @@ sprite_nodes/CCSprite.cpp \
 sprite_nodes/CCSpriteBatchNode.cpp \
 sprite_nodes/CCSpriteFrame.cpp \
 sprite_nodes/CCSpriteFrameCache.cpp \
+sprite_nodes/CCSpriteFrameAtlas.cpp \
 support/base64.cpp \
 support/CCNotificationCenter.cpp \
 support/CCProfiling.cpp \
+support/CCFrameProfiler.cpp \
+support/CCFrameArena.cpp \
 support/ccUTF8.cpp \
 support/ccUtils.cpp \
 support/CCVertex.cpp \
 support/TransformUtils.cpp \
+support/CCThreadPool.cpp \
+renderer/CCRenderer.cpp \
+renderer/CCQuadCommand.cpp \
+renderer/CCCustomCommand.cpp \
+renderer/CCGroupCommand.cpp \
 support/component/CCComponent.cpp \
 support/component/CCComponentContainer.cpp \
 support/data_support/ccCArray.cpp \
@@ -126,6 +138,7 @@ support/zip_support/ZipUtils.cpp \
 text_input_node/CCIMEDispatcher.cpp \
 text_input_node/CCTextFieldTTF.cpp \
 textures/CCTexture2D.cpp \
+textures/CCTexture2DConvert.cpp \
 textures/CCTextureAtlas.cpp \
 textures/CCTextureCache.cpp \
 tilemap_parallax_nodes/CCParallaxNode.cpp \
@@ -138,6 +151,13 @@ touch_dispatcher/CCTouch.cpp \
 touch_dispatcher/CCTouchDispatcher.cpp \
 touch_dispatcher/CCTouchHandler.cpp
 
+# the NEON kernels are built with NEON enabled on armeabi-v7a, and only used when the CPU has it
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_SRC_FILES += textures/CCTexture2DConvertNEON.cpp.neon
+else
+LOCAL_SRC_FILES += textures/CCTexture2DConvertNEON.cpp
+endif
+
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH) \
                     $(LOCAL_PATH)/include \
                     $(LOCAL_PATH)/kazmath/include \
@@ -172,6 +192,8 @@ LOCAL_WHOLE_STATIC_LIBRARIES += cocos_libtiff_static
 LOCAL_WHOLE_STATIC_LIBRARIES += cocos_libwebp_static
 LOCAL_WHOLE_STATIC_LIBRARIES += cocos_freetype2_static
 
+LOCAL_STATIC_LIBRARIES := cpufeatures
+
 # define the macro to compile through support/zip_support/ioapi.c
 LOCAL_CFLAGS   := -Wno-psabi -DUSE_FILE32API
 LOCAL_EXPORT_CFLAGS   := -Wno-psabi -DUSE_FILE32API
@@ -183,3 +205,4 @@ $(call import-module,libpng)
 $(call import-module,libtiff)
 $(call import-module,libwebp)
 $(call import-module,libfreetype2)
+$(call import-module,android/cpufeatures)
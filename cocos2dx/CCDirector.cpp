@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 // standard includes
 #include <string>
+#include <chrono>
 
 #include "ccFPSImages.h"
 #include "draw_nodes/CCDrawingPrimitives.h"
@@ -64,6 +65,12 @@ THE SOFTWARE.
 #include "CCEGLView.h"
 #include "CCConfiguration.h"
 #include "keyboard_dispatcher/CCKeyboardDispatcher.h"
+#include "renderer/CCRenderer.h"
+#include "base_nodes/CCTransformUpdater.h"
+#include "particle_nodes/CCParticleSimulator.h"
+#include "support/CCFrameProfiler.h"
+#include "support/CCFrameArena.h"
+#include "tilemap_parallax_nodes/CCTMXTiledMap.h"
 
 
 /**
@@ -127,6 +134,8 @@ bool Director::init(void)
     _SPFLabel = nullptr;
     _drawsLabel = nullptr;
     _totalFrames = _frames = 0;
+    _fixedDeltaTime = 0.0f;
+    _lastFrameTimes.update = _lastFrameTimes.visit = _lastFrameTimes.render = 0.0f;
     _FPS = new char[10];
     _lastUpdate = new struct timeval;
 
@@ -144,6 +153,7 @@ bool Director::init(void)
 
     // scheduler
     _scheduler = new Scheduler();
+    _scheduler->setTimerHeapEnabled(Configuration::getInstance()->getBool("cocos2d.x.scheduler_timer_heap", false));
     // action manager
     _actionManager = new ActionManager();
     _scheduler->scheduleUpdateForTarget(_actionManager, Scheduler::PRIORITY_SYSTEM, false);
@@ -160,6 +170,26 @@ bool Director::init(void)
     // Accelerometer
     _accelerometer = new Accelerometer();
 
+    // Renderer
+    _renderer = new Renderer();
+    _renderer->setEnabled(Configuration::getInstance()->getBool("cocos2d.x.render_queue", false));
+    _renderer->setMaterialSortEnabled(Configuration::getInstance()->getBool("cocos2d.x.render_queue.sort_by_material", false));
+
+    // TransformUpdater
+    _transformUpdater = new TransformUpdater();
+    _transformUpdater->setEnabled(Configuration::getInstance()->getBool("cocos2d.x.parallel_transforms", false));
+
+    // ParticleSimulator
+    _particleSimulator = new ParticleSimulator();
+    _particleSimulator->setEnabled(Configuration::getInstance()->getBool("cocos2d.x.parallel_particles", false));
+
+    // FrameProfiler
+    FrameProfiler::getInstance()->setThreadName("main");
+    FrameProfiler::getInstance()->setEnabled(Configuration::getInstance()->getBool("cocos2d.x.frame_profiler", false));
+
+    // the frame arena belongs to the Director thread
+    FrameArena::getInstance();
+
     // create autorelease pool
     PoolManager::sharedPoolManager()->push();
 
@@ -183,11 +213,16 @@ Director::~Director(void)
     CC_SAFE_RELEASE(_keyboardDispatcher);
     CC_SAFE_RELEASE(_keypadDispatcher);
     CC_SAFE_DELETE(_accelerometer);
+    CC_SAFE_RELEASE(_renderer);
+    CC_SAFE_DELETE(_transformUpdater);
+    CC_SAFE_DELETE(_particleSimulator);
 
     // pop the autorelease pool
     PoolManager::sharedPoolManager()->pop();
     PoolManager::purgePoolManager();
 
+    FrameArena::destroyInstance();
+
     // delete _lastUpdate
     CC_SAFE_DELETE(_lastUpdate);
     // delete fps string
@@ -230,6 +265,9 @@ void Director::setDefaultValues(void)
 	// PVR v2 has alpha premultiplied ?
 	bool pvr_alpha_premultipled = conf->getBool("cocos2d.x.texture.pvrv2_has_alpha_premultiplied", false);
 	Texture2D::PVRImagesHavePremultipliedAlpha(pvr_alpha_premultipled);
+
+	// premultiply the alpha of PNG and WebP images while they are decoded ?
+	Image::setPremultiplyAlphaOnDecode(conf->getBool("cocos2d.x.texture.premultiply_alpha_on_decode", false));
 }
 
 void Director::setGLDefaultValues()
@@ -250,6 +288,8 @@ void Director::setGLDefaultValues()
 // Draw the Scene
 void Director::drawScene()
 {
+    CC_PROFILE_ZONE(FrameProfiler::ZONE_DRAW_SCENE);
+
     // calculate "global" dt
     calculateDeltaTime();
 
@@ -258,10 +298,15 @@ void Director::drawScene()
         _openGLView->pollInputEvents();
     }
 
+    auto updateStart = std::chrono::steady_clock::now();
+
     //tick before glClear: issue #533
     if (! _paused)
     {
         _scheduler->update(_deltaTime);
+
+        // the particle systems queued by their update
+        _particleSimulator->update();
     }
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -273,8 +318,16 @@ void Director::drawScene()
         setNextScene();
     }
 
+    auto visitStart = std::chrono::steady_clock::now();
+
     kmGLPushMatrix();
 
+    // compute the world transforms of the scene on the worker threads
+    _transformUpdater->update(_runningScene);
+
+    // when the render queue is enabled, visit() only records the render commands
+    _renderer->beginFrame();
+
     // draw the scene
     if (_runningScene)
     {
@@ -286,6 +339,16 @@ void Director::drawScene()
     {
         _notificationNode->visit();
     }
+
+    auto renderStart = std::chrono::steady_clock::now();
+
+    // sort, batch and draw the recorded commands
+    _renderer->render();
+
+    auto renderEnd = std::chrono::steady_clock::now();
+    _lastFrameTimes.update = std::chrono::duration<float>(visitStart - updateStart).count();
+    _lastFrameTimes.visit = std::chrono::duration<float>(renderStart - visitStart).count();
+    _lastFrameTimes.render = std::chrono::duration<float>(renderEnd - renderStart).count();
     
     if (_displayStats)
     {
@@ -325,6 +388,10 @@ void Director::calculateDeltaTime()
         _deltaTime = 0;
         _nextDeltaTimeZero = false;
     }
+    else if (_fixedDeltaTime > 0)
+    {
+        _deltaTime = _fixedDeltaTime;
+    }
     else
     {
         _deltaTime = (now.tv_sec - _lastUpdate->tv_sec) + (now.tv_usec - _lastUpdate->tv_usec) / 1000000.0f;
@@ -345,6 +412,22 @@ float Director::getDeltaTime() const
 {
 	return _deltaTime;
 }
+
+void Director::setFixedDeltaTime(float dt)
+{
+    CCASSERT(dt >= 0, "the fixed delta time must be positive, or 0 to disable it");
+    _fixedDeltaTime = dt;
+}
+
+float Director::getFixedDeltaTime() const
+{
+    return _fixedDeltaTime;
+}
+
+const Director::FrameTimes& Director::getLastFrameTimes() const
+{
+    return _lastFrameTimes;
+}
 void Director::setOpenGLView(EGLView *pobOpenGLView)
 {
     CCASSERT(pobOpenGLView, "opengl view should not be null");
@@ -368,6 +451,7 @@ void Director::setOpenGLView(EGLView *pobOpenGLView)
         if (_openGLView)
         {
             setGLDefaultValues();
+            _renderer->initGLView();
         }  
         
         CHECK_GL_ERROR_DEBUG();
@@ -674,6 +758,9 @@ void Director::end()
 
 void Director::purgeDirector()
 {
+    // the loading threads use the caches purged below, and their loaders are released by the scheduler
+    TMXTiledMap::cancelAllAsyncLoads();
+
     // cleanup scheduler
     getScheduler()->unscheduleAll();
     
@@ -1037,6 +1124,21 @@ Accelerometer* Director::getAccelerometer() const
     return _accelerometer;
 }
 
+Renderer* Director::getRenderer() const
+{
+    return _renderer;
+}
+
+TransformUpdater* Director::getTransformUpdater() const
+{
+    return _transformUpdater;
+}
+
+ParticleSimulator* Director::getParticleSimulator() const
+{
+    return _particleSimulator;
+}
+
 /***************************************************
 * implementation of DisplayLinkDirector
 **************************************************/
@@ -1070,6 +1172,9 @@ void DisplayLinkDirector::mainLoop()
      
         // release the objects
         PoolManager::sharedPoolManager()->pop();        
+
+        // reclaim the memory allocated for the frame
+        FrameArena::getInstance()->reset();
     }
 }
 
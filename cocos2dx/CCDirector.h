@@ -57,6 +57,9 @@ class TouchDispatcher;
 class KeyboardDispatcher;
 class KeypadDispatcher;
 class Accelerometer;
+class Renderer;
+class TransformUpdater;
+class ParticleSimulator;
 
 /**
 @brief Class that creates and handle the main Window and manages how
@@ -376,9 +379,52 @@ public:
      */
     void setAccelerometer(Accelerometer* acc);
 
+    /** Gets the Renderer associated with this director.
+     It records and batches the render commands when the render queue is enabled.
+     @since v3.0
+     */
+    Renderer* getRenderer() const;
+
+    /** Gets the TransformUpdater associated with this director.
+     It computes the world transforms of the running scene on worker threads when it is enabled.
+     @since v3.0
+     */
+    TransformUpdater* getTransformUpdater() const;
+
+    /** Gets the ParticleSimulator associated with this director.
+     It simulates the particle systems on worker threads after the scheduler when it is enabled.
+     @since v3.0
+     */
+    ParticleSimulator* getParticleSimulator() const;
+
     /* Gets delta time since last tick to main loop */
 	float getDeltaTime() const;
 
+    /** Sets a fixed delta time, in seconds, used instead of the time measured between two frames.
+     0 restores the measured delta time. It makes benchmarks and replays independent of the frame rate.
+     @since v3.0
+     */
+    void setFixedDeltaTime(float dt);
+    float getFixedDeltaTime() const;
+
+    /** Time spent by a frame in each phase of drawScene()
+     @since v3.0
+     */
+    struct FrameTimes
+    {
+        /** scheduler and particle simulation, in seconds */
+        float update;
+        /** world transforms and traversal of the scene graph, in seconds */
+        float visit;
+        /** sorting, batching and submission of the render commands, in seconds */
+        float render;
+    };
+
+    /** Gets the time spent by the last frame in each phase of drawScene()
+     @since v3.0
+     */
+    const FrameTimes& getLastFrameTimes() const;
+
 protected:
     void purgeDirector();
     bool _purgeDirecotorInNextLoop; // this flag will be set to true in end()
@@ -424,9 +470,30 @@ protected:
      @since v2.0
      */
     Accelerometer* _accelerometer;
+
+    /** Renderer associated with this director
+     @since v3.0
+     */
+    Renderer* _renderer;
+
+    /** TransformUpdater associated with this director
+     @since v3.0
+     */
+    TransformUpdater* _transformUpdater;
+
+    /** ParticleSimulator associated with this director
+     @since v3.0
+     */
+    ParticleSimulator* _particleSimulator;
     
     /* delta time since last tick to main loop */
 	float _deltaTime;
+
+    /* fixed delta time, 0 when the measured one is used */
+    float _fixedDeltaTime;
+
+    /* time spent by the last frame in each phase */
+    FrameTimes _lastFrameTimes;
     
     /* The EGLView, where everything is rendered */
     EGLView    *_openGLView;
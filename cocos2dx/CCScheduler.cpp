@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "support/data_support/ccCArray.h"
 #include "cocoa/CCArray.h"
 #include "script_support/CCScriptSupport.h"
+#include "support/CCFrameProfiler.h"
 
 using namespace std;
 
@@ -81,6 +82,11 @@ Timer::Timer()
 , _interval(0.0f)
 , _selector(NULL)
 , _scriptHandler(0)
+, _heapState(HeapState::NONE)
+, _heapIndex(-1)
+, _heapSequence(0)
+, _deadline(0)
+, _lastTrigger(0)
 {
 }
 
@@ -223,6 +229,43 @@ void Timer::update(float dt)
     }
 }
 
+void Timer::trigger(float elapsed)
+{
+    if (_target && _selector)
+    {
+        (_target->*_selector)(elapsed);
+    }
+
+    if (0 != _scriptHandler)
+    {
+        SchedulerScriptData data(_scriptHandler,elapsed);
+        ScriptEvent event(kScheduleEvent,&data);
+        ScriptEngineManager::getInstance()->getScriptEngine()->sendEvent(&event);
+    }
+}
+
+bool Timer::updateWithTime(double time)
+{
+    float elapsed = (float)(time - _lastTrigger);
+
+    if (_useDelay)
+    {
+        // same as update(): the time elapsed after the delay counts for the first interval
+        _lastTrigger = _deadline;
+        _useDelay = false;
+    }
+    else
+    {
+        _lastTrigger = time;
+    }
+    _timesExecuted += 1;
+    _deadline = _lastTrigger + _interval;
+
+    trigger(elapsed);
+
+    return !_runForever && _timesExecuted > _repeat;
+}
+
 float Timer::getInterval() const
 {
     return _interval;
@@ -257,6 +300,9 @@ Scheduler::Scheduler(void)
 , _currentTargetSalvaged(false)
 , _updateHashLocked(false)
 , _scriptHandlerEntries(NULL)
+, _timerHeapEnabled(false)
+, _time(0)
+, _heapSequence(0)
 {
 
 }
@@ -265,6 +311,11 @@ Scheduler::~Scheduler(void)
 {
     unscheduleAll();
     CC_SAFE_RELEASE(_scriptHandlerEntries);
+
+    for (auto timer : _pendingTimers)
+    {
+        timer->release();
+    }
 }
 
 void Scheduler::removeHashElement(_hashSelectorEntry *element)
@@ -328,6 +379,21 @@ void Scheduler::scheduleSelector(SEL_SCHEDULE selector, Object *target, float in
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+
+                if (_timerHeapEnabled && !timer->_useDelay)
+                {
+                    // the deadline of a paused timer is relative, it stays relative
+                    if (timer->_heapState == Timer::HeapState::SCHEDULED)
+                    {
+                        timer->_deadline = timer->_lastTrigger + interval;
+                        heapSiftUp(timer->_heapIndex);
+                        heapSiftDown(timer->_heapIndex);
+                    }
+                    else if (timer->_heapState == Timer::HeapState::PAUSED)
+                    {
+                        timer->_deadline = timer->_lastTrigger + interval;
+                    }
+                }
                 return;
             }        
         }
@@ -338,6 +404,11 @@ void Scheduler::scheduleSelector(SEL_SCHEDULE selector, Object *target, float in
     pTimer->initWithTarget(target, selector, interval, repeat, delay);
     ccArrayAppendObject(element->timers, pTimer);
     pTimer->release();    
+
+    if (_timerHeapEnabled)
+    {
+        addTimerToHeap(pTimer, element->paused);
+    }
 }
 
 void Scheduler::unscheduleSelector(SEL_SCHEDULE selector, Object *target)
@@ -368,6 +439,11 @@ void Scheduler::unscheduleSelector(SEL_SCHEDULE selector, Object *target)
                     element->currentTimerSalvaged = true;
                 }
 
+                if (_timerHeapEnabled)
+                {
+                    removeTimerFromHeap(pTimer);
+                }
+
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
                 // update timerIndex in case we are in tick:, looping over the actions
@@ -655,6 +731,14 @@ void Scheduler::unscheduleAllForTarget(Object *target)
             element->currentTimer->retain();
             element->currentTimerSalvaged = true;
         }
+
+        if (_timerHeapEnabled)
+        {
+            for (unsigned int i = 0; i < element->timers->num; ++i)
+            {
+                removeTimerFromHeap(static_cast<Timer*>(element->timers->arr[i]));
+            }
+        }
         ccArrayRemoveAllObjects(element->timers);
 
         if (_currentTarget == element)
@@ -705,6 +789,10 @@ void Scheduler::resumeTarget(Object *target)
     HASH_FIND_INT(_hashForTimers, &target, element);
     if (element)
     {
+        if (_timerHeapEnabled && element->paused)
+        {
+            resumeTimersInHeap(element);
+        }
         element->paused = false;
     }
 
@@ -727,6 +815,10 @@ void Scheduler::pauseTarget(Object *target)
     HASH_FIND_INT(_hashForTimers, &target, element);
     if (element)
     {
+        if (_timerHeapEnabled && !element->paused)
+        {
+            pauseTimersInHeap(element);
+        }
         element->paused = true;
     }
 
@@ -777,6 +869,10 @@ Set* Scheduler::pauseAllTargetsWithMinPriority(int nMinPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != NULL;
         element = (tHashTimerEntry*)element->hh.next)
     {
+        if (_timerHeapEnabled && !element->paused)
+        {
+            pauseTimersInHeap(element);
+        }
         element->paused = true;
         idsWithSelectors->addObject(element->target);
     }
@@ -828,6 +924,8 @@ void Scheduler::resumeTargets(Set* targetsToResume)
 // main loop
 void Scheduler::update(float dt)
 {
+    CC_PROFILE_ZONE(FrameProfiler::ZONE_SCHEDULER_UPDATE);
+
     _updateHashLocked = true;
 
     if (_timeScale != 1.0f)
@@ -865,42 +963,50 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != NULL; )
+    if (_timerHeapEnabled)
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
-
-        if (! _currentTarget->paused)
+        // Only the custom selectors that are due
+        updateTimerHeap(dt);
+    }
+    else
+    {
+        // Iterate over all the custom selectors
+        for (tHashTimerEntry *elt = _hashForTimers; elt != NULL; )
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+            _currentTarget = elt;
+            _currentTargetSalvaged = false;
+
+            if (! _currentTarget->paused)
             {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
+                // The 'timers' array may change while inside this loop
+                for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+                {
+                    elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
+                    elt->currentTimerSalvaged = false;
 
-                elt->currentTimer->update(dt);
+                    elt->currentTimer->update(dt);
 
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+                    if (elt->currentTimerSalvaged)
+                    {
+                        // The currentTimer told the remove itself. To prevent the timer from
+                        // accidentally deallocating itself before finishing its step, we retained
+                        // it. Now that step is done, it's safe to release it.
+                        elt->currentTimer->release();
+                    }
 
-                elt->currentTimer = NULL;
+                    elt->currentTimer = NULL;
+                }
             }
-        }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+            // elt, at this moment, is still valid
+            // so it is safe to ask this here (issue #490)
+            elt = (tHashTimerEntry *)elt->hh.next;
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
+            // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
+            if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+            {
+                removeHashElement(_currentTarget);
+            }
         }
     }
 
@@ -954,5 +1060,240 @@ void Scheduler::update(float dt)
     _currentTarget = NULL;
 }
 
+// timer heap
+
+void Scheduler::setTimerHeapEnabled(bool enabled)
+{
+    CCASSERT(_hashForTimers == NULL, "The timer heap must be set before any selector is scheduled");
+    _timerHeapEnabled = enabled;
+}
+
+void Scheduler::updateTimerHeap(float dt)
+{
+    _time += dt;
+
+    // The timers scheduled since the last update start now.
+    // Like with Timer::update(), the first frame doesn't count.
+    if (!_pendingTimers.empty())
+    {
+        std::vector<Timer*> pendingTimers;
+        pendingTimers.swap(_pendingTimers);
+
+        for (auto timer : pendingTimers)
+        {
+            if (timer->_heapState == Timer::HeapState::PENDING)
+            {
+                Object *target = timer->_target;
+                tHashTimerEntry *element = NULL;
+                HASH_FIND_INT(_hashForTimers, &target, element);
+
+                // paused targets add their pending timers again when they are resumed
+                if (element && !element->paused)
+                {
+                    timer->_lastTrigger = _time;
+                    timer->_deadline = _time + (timer->_useDelay ? timer->_delay : timer->_interval);
+                    heapPush(timer);
+                }
+            }
+            timer->release();
+        }
+    }
+
+    // Take out all the due timers first: the ones scheduled again are triggered by the next update
+    while (!_timerHeap.empty() && _timerHeap[0]->_deadline <= _time)
+    {
+        Timer *timer = _timerHeap[0];
+        heapRemove(0);
+        timer->_heapState = Timer::HeapState::DUE;
+        timer->retain();
+        _dueTimers.push_back(timer);
+    }
+
+    for (size_t i = 0; i < _dueTimers.size(); ++i)
+    {
+        Timer *timer = _dueTimers[i];
+
+        // not unscheduled or paused by a previous callback ?
+        if (timer->_heapState == Timer::HeapState::DUE)
+        {
+            Object *target = timer->_target;
+            tHashTimerEntry *element = NULL;
+            HASH_FIND_INT(_hashForTimers, &target, element);
+            CCASSERT(element, "A due timer must belong to a target");
+
+            _currentTarget = element;
+            _currentTargetSalvaged = false;
+            element->currentTimer = timer;
+            element->currentTimerSalvaged = false;
+
+            // the callback may have unscheduled the timer already
+            if (timer->updateWithTime(_time) && timer->_heapState != Timer::HeapState::NONE)
+            {
+                unscheduleSelector(timer->_selector, target);
+            }
+
+            if (element->currentTimerSalvaged)
+            {
+                // The timer was unscheduled during its step, see update()
+                timer->release();
+            }
+            else if (timer->_heapState == Timer::HeapState::DUE)
+            {
+                heapPush(timer);
+            }
+
+            element->currentTimer = NULL;
+
+            // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
+            if (_currentTargetSalvaged && element->timers->num == 0)
+            {
+                removeHashElement(element);
+            }
+            _currentTarget = NULL;
+        }
+
+        timer->release();
+    }
+    _dueTimers.clear();
+}
+
+void Scheduler::addTimerToHeap(Timer *timer, bool paused)
+{
+    timer->_heapState = Timer::HeapState::PENDING;
+
+    // a paused target adds it to the pending timers when it is resumed
+    if (!paused)
+    {
+        timer->retain();
+        _pendingTimers.push_back(timer);
+    }
+}
+
+void Scheduler::removeTimerFromHeap(Timer *timer)
+{
+    // the pending and due timers are retained by their lists, which skip them
+    if (timer->_heapState == Timer::HeapState::SCHEDULED)
+    {
+        heapRemove(timer->_heapIndex);
+    }
+    timer->_heapState = Timer::HeapState::NONE;
+}
+
+void Scheduler::pauseTimersInHeap(tHashTimerEntry *element)
+{
+    for (unsigned int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+
+        if (timer->_heapState == Timer::HeapState::SCHEDULED || timer->_heapState == Timer::HeapState::DUE)
+        {
+            if (timer->_heapState == Timer::HeapState::SCHEDULED)
+            {
+                heapRemove(timer->_heapIndex);
+            }
+
+            // the time doesn't run while the target is paused
+            timer->_deadline -= _time;
+            timer->_lastTrigger -= _time;
+            timer->_heapState = Timer::HeapState::PAUSED;
+        }
+    }
+}
+
+void Scheduler::resumeTimersInHeap(tHashTimerEntry *element)
+{
+    for (unsigned int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+
+        if (timer->_heapState == Timer::HeapState::PAUSED)
+        {
+            timer->_deadline += _time;
+            timer->_lastTrigger += _time;
+            heapPush(timer);
+        }
+        else if (timer->_heapState == Timer::HeapState::PENDING)
+        {
+            timer->retain();
+            _pendingTimers.push_back(timer);
+        }
+    }
+}
+
+bool Scheduler::heapLess(Timer *a, Timer *b) const
+{
+    return a->_deadline < b->_deadline || (a->_deadline == b->_deadline && a->_heapSequence < b->_heapSequence);
+}
+
+void Scheduler::heapPush(Timer *timer)
+{
+    timer->_heapState = Timer::HeapState::SCHEDULED;
+    timer->_heapSequence = _heapSequence++;
+    timer->_heapIndex = (int)_timerHeap.size();
+    _timerHeap.push_back(timer);
+    heapSiftUp(timer->_heapIndex);
+}
+
+void Scheduler::heapRemove(int index)
+{
+    _timerHeap[index]->_heapIndex = -1;
+
+    Timer *last = _timerHeap.back();
+    _timerHeap.pop_back();
+
+    if (index < (int)_timerHeap.size())
+    {
+        _timerHeap[index] = last;
+        last->_heapIndex = index;
+        heapSiftUp(index);
+        heapSiftDown(last->_heapIndex);
+    }
+}
+
+void Scheduler::heapSiftUp(int index)
+{
+    Timer *timer = _timerHeap[index];
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (!heapLess(timer, _timerHeap[parent]))
+        {
+            break;
+        }
+        _timerHeap[index] = _timerHeap[parent];
+        _timerHeap[index]->_heapIndex = index;
+        index = parent;
+    }
+    _timerHeap[index] = timer;
+    timer->_heapIndex = index;
+}
+
+void Scheduler::heapSiftDown(int index)
+{
+    int count = (int)_timerHeap.size();
+    Timer *timer = _timerHeap[index];
+    while (true)
+    {
+        int child = index * 2 + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && heapLess(_timerHeap[child + 1], _timerHeap[child]))
+        {
+            ++child;
+        }
+        if (!heapLess(_timerHeap[child], timer))
+        {
+            break;
+        }
+        _timerHeap[index] = _timerHeap[child];
+        _timerHeap[index]->_heapIndex = index;
+        index = child;
+    }
+    _timerHeap[index] = timer;
+    timer->_heapIndex = index;
+}
+
 
 NS_CC_END
@@ -27,6 +27,8 @@ THE SOFTWARE.
 #ifndef __CCSCHEDULER_H__
 #define __CCSCHEDULER_H__
 
+#include <vector>
+
 #include "cocoa/CCObject.h"
 #include "support/data_support/uthash.h"
 
@@ -79,6 +81,17 @@ public:
     inline int getScriptHandler() const { return _scriptHandler; };
 
 protected:
+    friend class Scheduler;
+
+    /** Triggers the timer when the scheduler keeps the timers in a heap.
+     Computes the elapsed time and the next deadline from the time of the scheduler.
+     @return true when the timer was triggered as many times as it was asked to
+     */
+    bool updateWithTime(double time);
+
+    /** Calls the selector or the script callback */
+    void trigger(float elapsed);
+
     Object *_target;
     float _elapsed;
     bool _runForever;
@@ -90,6 +103,21 @@ protected:
     SEL_SCHEDULE _selector;
     
     int _scriptHandler;
+
+    // used when the scheduler keeps the timers in a heap
+    enum class HeapState
+    {
+        NONE,       // not in the heap
+        PENDING,    // starts at the next update of the scheduler
+        SCHEDULED,  // in the heap
+        DUE,        // removed from the heap, triggered by the current update
+        PAUSED,     // the target is paused: _deadline and _lastTrigger are relative to the time of the pause
+    };
+    HeapState _heapState;
+    int _heapIndex;
+    unsigned int _heapSequence;     // keeps the timers with the same deadline in FIFO order
+    double _deadline;
+    double _lastTrigger;
 };
 
 //
@@ -241,6 +269,17 @@ public:
       */
     void resumeTargets(Set* targetsToResume);
 
+    /** Keeps the custom selectors in a min-heap ordered by the time of their next trigger.
+     update() then only visits the selectors that are triggered, instead of all the scheduled ones.
+     Use it when many selectors are scheduled with an interval or a delay.
+     The selectors that are triggered during the same update() are called in the order of their deadlines.
+     It must be set before any custom selector is scheduled. It is disabled by default, and can be enabled
+     with the "cocos2d.x.scheduler_timer_heap" key of the Configuration.
+     @since v3.0
+     */
+    void setTimerHeapEnabled(bool enabled);
+    inline bool isTimerHeapEnabled() const { return _timerHeapEnabled; }
+
 private:
     void removeHashElement(struct _hashSelectorEntry *pElement);
     void removeUpdateFromHash(struct _listEntry *entry);
@@ -250,6 +289,19 @@ private:
     void priorityIn(struct _listEntry **ppList, Object *target, int nPriority, bool bPaused);
     void appendIn(struct _listEntry **ppList, Object *target, bool bPaused);
 
+    // timer heap specific
+
+    void updateTimerHeap(float dt);
+    void addTimerToHeap(Timer* timer, bool paused);
+    void removeTimerFromHeap(Timer* timer);
+    void pauseTimersInHeap(struct _hashSelectorEntry *element);
+    void resumeTimersInHeap(struct _hashSelectorEntry *element);
+    void heapPush(Timer* timer);
+    void heapRemove(int index);
+    void heapSiftUp(int index);
+    void heapSiftDown(int index);
+    bool heapLess(Timer* a, Timer* b) const;
+
 protected:
     float _timeScale;
 
@@ -268,6 +320,14 @@ protected:
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
     Array* _scriptHandlerEntries;
+
+    // Used for "selectors with interval" when the timer heap is enabled
+    bool _timerHeapEnabled;
+    double _time;
+    unsigned int _heapSequence;
+    std::vector<Timer*> _timerHeap;
+    std::vector<Timer*> _pendingTimers;
+    std::vector<Timer*> _dueTimers;
 };
 
 // end of global group
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define __ACTIONS_CCACTION_H__
 
 #include "cocoa/CCObject.h"
+#include "cocoa/CCObjectPool.h"
 #include "cocoa/CCGeometry.h"
 #include "platform/CCPlatformMacros.h"
 
@@ -43,7 +44,8 @@ NS_CC_BEGIN
  */
 class CC_DLL Action : public Object, public Clonable
 {
-public:
+    CC_USE_OBJECT_POOL
+
     /// Default tag used for all the actions
     static const int INVALID_TAG = -1;
 
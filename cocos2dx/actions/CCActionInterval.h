@@ -84,6 +84,8 @@ public:
 protected:
     float _elapsed;
     bool   _firstTick;
+
+    friend class ActionManager;
 };
 
 /** @brief Runs actions sequentially, one after another
@@ -284,6 +286,8 @@ protected:
     float _dstAngleY;
     float _startAngleY;
     float _diffAngleY;
+
+    friend class ActionManager;
 };
 
 /** @brief Rotates a Node object clockwise a number of degrees by modifying it's rotation attribute.
@@ -313,6 +317,8 @@ protected:
     float _startAngleX;
     float _angleY;
     float _startAngleY;
+
+    friend class ActionManager;
 };
 
 /**  Moves a Node object x,y pixels by modifying it's position attribute.
@@ -342,6 +348,8 @@ protected:
     Point _positionDelta;
     Point _startPosition;
     Point _previousPosition;
+
+    friend class ActionManager;
 };
 
 /** Moves a Node object to the position x,y. x and y are absolute coordinates by modifying it's position attribute.
@@ -553,6 +561,8 @@ protected:
     float _endScaleY;
     float _deltaX;
     float _deltaY;
+
+    friend class ActionManager;
 };
 
 /** @brief Scales a Node object a zoom factor by modifying it's scale attribute.
@@ -656,6 +666,8 @@ public:
 protected:
     GLubyte _toOpacity;
     GLubyte _fromOpacity;
+
+    friend class ActionManager;
 };
 
 /** @brief Tints a Node that implements the NodeRGB protocol from current tint to a custom one.
@@ -26,32 +26,48 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "CCActionManager.h"
+#include "CCActionInterval.h"
 #include "base_nodes/CCNode.h"
 #include "CCScheduler.h"
 #include "ccMacros.h"
-#include "support/data_support/ccCArray.h"
-#include "support/data_support/uthash.h"
+#include "CCProtocols.h"
+#include "support/CCFrameProfiler.h"
 #include "cocoa/CCSet.h"
 
+#include <algorithm>
+#include <climits>
+#include <float.h>
+#include <typeinfo>
+
 NS_CC_BEGIN
-//
-// singleton stuff
-//
-typedef struct _hashElement
+
+namespace {
+
+// ActionInterval::step() without the virtual calls, returns the time passed to update()
+inline float advance(float duration, float dt, float& elapsed, bool& firstTick)
 {
-    struct _ccArray             *actions;
-    Object                    *target;
-    unsigned int                actionIndex;
-    Action                    *currentAction;
-    bool                        currentActionSalvaged;
-    bool                        paused;
-    UT_hash_handle                hh;
-} tHashElement;
+    if (firstTick)
+    {
+        firstTick = false;
+        elapsed = 0;
+    }
+    else
+    {
+        elapsed += dt;
+    }
+
+    return MAX (0,                                  // needed for rewind. elapsed could be negative
+                MIN(1, elapsed /
+                    MAX(duration, FLT_EPSILON)   // division by 0
+                    )
+                );
+}
+
+} // namespace
 
 ActionManager::ActionManager(void)
-: _targets(NULL), 
-  _currentTarget(NULL),
-  _currentTargetSalvaged(false)
+: _removedRecordCount(0)
+, _updating(false)
 {
 
 }
@@ -65,78 +81,143 @@ ActionManager::~ActionManager(void)
 
 // private
 
-void ActionManager::deleteHashElement(tHashElement *pElement)
+ActionManager::Kind ActionManager::getKind(Action* action)
 {
-    ccArrayFree(pElement->actions);
-    HASH_DEL(_targets, pElement);
-    pElement->target->release();
-    free(pElement);
-}
+    // only the exact classes: a subclass may override update()
+    const std::type_info& type = typeid(*action);
 
-void ActionManager::actionAllocWithHashElement(tHashElement *pElement)
-{
-    // 4 actions per Node by default
-    if (pElement->actions == NULL)
+    if (type == typeid(MoveTo) || type == typeid(MoveBy))
     {
-        pElement->actions = ccArrayNew(4);
-    }else 
-    if (pElement->actions->num == pElement->actions->max)
+        return KIND_MOVE;
+    }
+    if (type == typeid(ScaleTo) || type == typeid(ScaleBy))
     {
-        ccArrayDoubleCapacity(pElement->actions);
+        return KIND_SCALE;
+    }
+    if (type == typeid(RotateTo))
+    {
+        return KIND_ROTATE_TO;
+    }
+    if (type == typeid(RotateBy))
+    {
+        return KIND_ROTATE_BY;
+    }
+    if (type == typeid(FadeTo))
+    {
+        return KIND_FADE_TO;
+    }
+    if (type == typeid(DelayTime))
+    {
+        return KIND_DELAY;
     }
 
+    return KIND_GENERIC;
 }
 
-void ActionManager::removeActionAtIndex(unsigned int uIndex, tHashElement *pElement)
+unsigned int ActionManager::findTarget(const Object* target) const
 {
-    Action *pAction = (Action*)pElement->actions->arr[uIndex];
+    auto it = _targetIndices.find(target);
+    return it != _targetIndices.end() ? it->second : UINT_MAX;
+}
 
-    if (pAction == pElement->currentAction && (! pElement->currentActionSalvaged))
+void ActionManager::removeActionFromTarget(unsigned int targetIndex, unsigned int position)
+{
+    TargetEntry& entry = _targets[targetIndex];
+    unsigned int slot = entry.slots[position];
+    entry.slots.erase(entry.slots.begin() + position);
+
+    ActionRecord& record = _records[_positions[slot]];
+    Action* action = record.action;
+    record.action = NULL;
+    ++_removedRecordCount;
+    _freeSlots.push_back(slot);
+
+    if (entry.slots.empty())
     {
-        pElement->currentAction->retain();
-        pElement->currentActionSalvaged = true;
+        if (_updating)
+        {
+            _emptiedTargets.push_back(targetIndex);
+        }
+        else
+        {
+            deleteTargetEntry(targetIndex);
+        }
     }
 
-    ccArrayRemoveObjectAtIndex(pElement->actions, uIndex, true);
+    // last, the destructors may use the manager
+    releaseAction(action);
+}
+
+void ActionManager::removeSlot(unsigned int slot)
+{
+    unsigned int targetIndex = _records[_positions[slot]].targetIndex;
+    const std::vector<unsigned int>& slots = _targets[targetIndex].slots;
+
+    auto it = std::find(slots.begin(), slots.end(), slot);
+    CCASSERT(it != slots.end(), "the action isn't in the slots of its target");
+    removeActionFromTarget(targetIndex, it - slots.begin());
+}
+
+void ActionManager::deleteTargetEntry(unsigned int targetIndex)
+{
+    TargetEntry& entry = _targets[targetIndex];
+    Object* target = entry.target;
+
+    _targetIndices.erase(target);
+    entry.target = NULL;
+    entry.paused = false;
+    _freeTargets.push_back(targetIndex);
 
-    // update actionIndex in case we are in tick. looping over the actions
-    if (pElement->actionIndex >= uIndex)
+    target->release();
+}
+
+void ActionManager::releaseAction(Action* action)
+{
+    if (_updating)
     {
-        pElement->actionIndex--;
+        // the action may be the one being stepped
+        _releasedActions.push_back(action);
     }
+    else
+    {
+        action->release();
+    }
+}
 
-    if (pElement->actions->num == 0)
+void ActionManager::compact()
+{
+    // keep the order of the records, the later actions of a target override the earlier ones
+    unsigned int count = 0;
+    for (const ActionRecord& record : _records)
     {
-        if (_currentTarget == pElement)
+        if (record.action)
         {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            deleteHashElement(pElement);
+            _positions[record.slot] = count;
+            _records[count++] = record;
         }
     }
+
+    _records.resize(count);
+    _removedRecordCount = 0;
 }
 
 // pause / resume
 
 void ActionManager::pauseTarget(Object *target)
 {
-    tHashElement *pElement = NULL;
-    HASH_FIND_INT(_targets, &target, pElement);
-    if (pElement)
+    unsigned int targetIndex = findTarget(target);
+    if (targetIndex != UINT_MAX)
     {
-        pElement->paused = true;
+        _targets[targetIndex].paused = true;
     }
 }
 
 void ActionManager::resumeTarget(Object *target)
 {
-    tHashElement *pElement = NULL;
-    HASH_FIND_INT(_targets, &target, pElement);
-    if (pElement)
+    unsigned int targetIndex = findTarget(target);
+    if (targetIndex != UINT_MAX)
     {
-        pElement->paused = false;
+        _targets[targetIndex].paused = false;
     }
 }
 
@@ -145,12 +226,12 @@ Set* ActionManager::pauseAllRunningActions()
     Set *idsWithActions = new Set();
     idsWithActions->autorelease();
     
-    for (tHashElement *element=_targets; element != NULL; element = (tHashElement *)element->hh.next) 
+    for (TargetEntry& entry : _targets)
     {
-        if (! element->paused) 
+        if (entry.target && ! entry.paused)
         {
-            element->paused = true;
-            idsWithActions->addObject(element->target);
+            entry.paused = true;
+            idsWithActions->addObject(entry.target);
         }
     }    
     
@@ -173,36 +254,81 @@ void ActionManager::addAction(Action *pAction, Node *target, bool paused)
     CCASSERT(pAction != NULL, "");
     CCASSERT(target != NULL, "");
 
-    tHashElement *pElement = NULL;
     // we should convert it to Object*, because we save it as Object*
-    Object *tmp = target;
-    HASH_FIND_INT(_targets, &tmp, pElement);
-    if (! pElement)
+    unsigned int targetIndex = findTarget(static_cast<Object*>(target));
+    if (targetIndex == UINT_MAX)
     {
-        pElement = (tHashElement*)calloc(sizeof(*pElement), 1);
-        pElement->paused = paused;
+        if (_freeTargets.empty())
+        {
+            targetIndex = _targets.size();
+            _targets.push_back(TargetEntry());
+        }
+        else
+        {
+            targetIndex = _freeTargets.back();
+            _freeTargets.pop_back();
+        }
+
+        TargetEntry& entry = _targets[targetIndex];
+        entry.target = target;
+        entry.paused = paused;
         target->retain();
-        pElement->target = target;
-        HASH_ADD_INT(_targets, target, pElement);
+        _targetIndices[target] = targetIndex;
     }
 
-     actionAllocWithHashElement(pElement);
- 
-     CCASSERT(! ccArrayContainsObject(pElement->actions, pAction), "");
-     ccArrayAppendObject(pElement->actions, pAction);
- 
-     pAction->startWithTarget(target);
+    TargetEntry& entry = _targets[targetIndex];
+
+#if COCOS2D_DEBUG > 0
+    for (unsigned int slot : entry.slots)
+    {
+        CCASSERT(_records[_positions[slot]].action != pAction, "");
+    }
+#endif
+
+    // the records are compacted after each update, unless the manager isn't updated
+    if (! _updating && _removedRecordCount > 32 && _removedRecordCount * 2 > _records.size())
+    {
+        compact();
+    }
+
+    unsigned int slot;
+    if (_freeSlots.empty())
+    {
+        slot = _positions.size();
+        _positions.push_back(0);
+    }
+    else
+    {
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+
+    _positions[slot] = _records.size();
+
+    ActionRecord record;
+    record.action = pAction;
+    record.kind = getKind(pAction);
+    record.rgbaTarget = (record.kind == KIND_FADE_TO) ? dynamic_cast<RGBAProtocol*>(target) : NULL;
+    record.targetIndex = targetIndex;
+    record.slot = slot;
+    _records.push_back(record);
+
+    entry.slots.push_back(slot);
+    pAction->retain();
+
+    pAction->startWithTarget(target);
 }
 
 // remove
 
 void ActionManager::removeAllActions(void)
 {
-    for (tHashElement *pElement = _targets; pElement != NULL; )
+    for (unsigned int i = 0; i < _targets.size(); ++i)
     {
-        Object *target = pElement->target;
-        pElement = (tHashElement*)pElement->hh.next;
-        removeAllActionsFromTarget(target);
+        if (_targets[i].target)
+        {
+            removeAllActionsFromTarget(_targets[i].target);
+        }
     }
 }
 
@@ -214,24 +340,13 @@ void ActionManager::removeAllActionsFromTarget(Object *target)
         return;
     }
 
-    tHashElement *pElement = NULL;
-    HASH_FIND_INT(_targets, &target, pElement);
-    if (pElement)
+    unsigned int targetIndex = findTarget(target);
+    if (targetIndex != UINT_MAX)
     {
-        if (ccArrayContainsObject(pElement->actions, pElement->currentAction) && (! pElement->currentActionSalvaged))
-        {
-            pElement->currentAction->retain();
-            pElement->currentActionSalvaged = true;
-        }
-
-        ccArrayRemoveAllObjects(pElement->actions);
-        if (_currentTarget == pElement)
+        // from the last one, the entry is deleted with the first one
+        while (_targets[targetIndex].target == target && ! _targets[targetIndex].slots.empty())
         {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            deleteHashElement(pElement);
+            removeActionFromTarget(targetIndex, _targets[targetIndex].slots.size() - 1);
         }
     }
     else
@@ -248,15 +363,17 @@ void ActionManager::removeAction(Action *pAction)
         return;
     }
 
-    tHashElement *pElement = NULL;
-    Object *target = pAction->getOriginalTarget();
-    HASH_FIND_INT(_targets, &target, pElement);
-    if (pElement)
+    unsigned int targetIndex = findTarget(pAction->getOriginalTarget());
+    if (targetIndex != UINT_MAX)
     {
-        unsigned int i = ccArrayGetIndexOfObject(pElement->actions, pAction);
-        if (UINT_MAX != i)
+        const std::vector<unsigned int>& slots = _targets[targetIndex].slots;
+        for (unsigned int i = 0; i < slots.size(); ++i)
         {
-            removeActionAtIndex(i, pElement);
+            if (_records[_positions[slots[i]]].action == pAction)
+            {
+                removeActionFromTarget(targetIndex, i);
+                break;
+            }
         }
     }
     else
@@ -270,19 +387,17 @@ void ActionManager::removeActionByTag(int tag, Object *target)
     CCASSERT(tag != Action::INVALID_TAG, "");
     CCASSERT(target != NULL, "");
 
-    tHashElement *pElement = NULL;
-    HASH_FIND_INT(_targets, &target, pElement);
-
-    if (pElement)
+    unsigned int targetIndex = findTarget(target);
+    if (targetIndex != UINT_MAX)
     {
-        unsigned int limit = pElement->actions->num;
-        for (unsigned int i = 0; i < limit; ++i)
+        const std::vector<unsigned int>& slots = _targets[targetIndex].slots;
+        for (unsigned int i = 0; i < slots.size(); ++i)
         {
-            Action *pAction = (Action*)pElement->actions->arr[i];
+            Action *pAction = _records[_positions[slots[i]]].action;
 
             if (pAction->getTag() == (int)tag && pAction->getOriginalTarget() == target)
             {
-                removeActionAtIndex(i, pElement);
+                removeActionFromTarget(targetIndex, i);
                 break;
             }
         }
@@ -291,28 +406,20 @@ void ActionManager::removeActionByTag(int tag, Object *target)
 
 // get
 
-// XXX: Passing "const O *" instead of "const O&" because HASH_FIND_IT requries the address of a pointer
-// and, it is not possible to get the address of a reference
 Action* ActionManager::getActionByTag(int tag, const Object *target) const
 {
     CCASSERT(tag != Action::INVALID_TAG, "");
 
-    tHashElement *pElement = NULL;
-    HASH_FIND_INT(_targets, &target, pElement);
-
-    if (pElement)
+    unsigned int targetIndex = findTarget(target);
+    if (targetIndex != UINT_MAX)
     {
-        if (pElement->actions != NULL)
+        for (unsigned int slot : _targets[targetIndex].slots)
         {
-            unsigned int limit = pElement->actions->num;
-            for (unsigned int i = 0; i < limit; ++i)
-            {
-                Action *pAction = (Action*)pElement->actions->arr[i];
+            Action *pAction = _records[_positions[slot]].action;
 
-                if (pAction->getTag() == (int)tag)
-                {
-                    return pAction;
-                }
+            if (pAction->getTag() == (int)tag)
+            {
+                return pAction;
             }
         }
         CCLOG("cocos2d : getActionByTag(tag = %d): Action not found", tag);
@@ -325,78 +432,180 @@ Action* ActionManager::getActionByTag(int tag, const Object *target) const
     return NULL;
 }
 
-// XXX: Passing "const O *" instead of "const O&" because HASH_FIND_IT requries the address of a pointer
-// and, it is not possible to get the address of a reference
 unsigned int ActionManager::getNumberOfRunningActionsInTarget(const Object *target) const
 {
-    tHashElement *pElement = NULL;
-    HASH_FIND_INT(_targets, &target, pElement);
-    if (pElement)
+    unsigned int targetIndex = findTarget(target);
+    if (targetIndex != UINT_MAX)
     {
-        return pElement->actions ? pElement->actions->num : 0;
+        return _targets[targetIndex].slots.size();
     }
 
     return 0;
 }
 
 // main loop
+
+bool ActionManager::stepGeneric(const ActionRecord& record, float dt)
+{
+    record.action->step(dt);
+    return record.action->isDone();
+}
+
+bool ActionManager::stepDelay(const ActionRecord& record, float dt)
+{
+    ActionInterval* action = static_cast<ActionInterval*>(record.action);
+    advance(action->_duration, dt, action->_elapsed, action->_firstTick);
+
+    return action->_elapsed >= action->_duration;
+}
+
+bool ActionManager::stepMove(const ActionRecord& record, float dt)
+{
+    MoveBy* action = static_cast<MoveBy*>(record.action);
+    float t = advance(action->_duration, dt, action->_elapsed, action->_firstTick);
+
+    // MoveBy::update()
+    if (action->_target)
+    {
+#if CC_ENABLE_STACKABLE_ACTIONS
+        Point currentPos = action->_target->getPosition();
+        Point diff = currentPos - action->_previousPosition;
+        action->_startPosition = action->_startPosition + diff;
+        Point newPos =  action->_startPosition + (action->_positionDelta * t);
+        action->_target->setPosition(newPos);
+        action->_previousPosition = newPos;
+#else
+        action->_target->setPosition(ccpAdd(action->_startPosition, ccpMult(action->_positionDelta, t)));
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+    }
+
+    return action->_elapsed >= action->_duration;
+}
+
+bool ActionManager::stepScale(const ActionRecord& record, float dt)
+{
+    ScaleTo* action = static_cast<ScaleTo*>(record.action);
+    float t = advance(action->_duration, dt, action->_elapsed, action->_firstTick);
+
+    // ScaleTo::update()
+    if (action->_target)
+    {
+        action->_target->setScaleX(action->_startScaleX + action->_deltaX * t);
+        action->_target->setScaleY(action->_startScaleY + action->_deltaY * t);
+    }
+
+    return action->_elapsed >= action->_duration;
+}
+
+bool ActionManager::stepRotateTo(const ActionRecord& record, float dt)
+{
+    RotateTo* action = static_cast<RotateTo*>(record.action);
+    float t = advance(action->_duration, dt, action->_elapsed, action->_firstTick);
+
+    // RotateTo::update()
+    if (action->_target)
+    {
+        action->_target->setRotationX(action->_startAngleX + action->_diffAngleX * t);
+        action->_target->setRotationY(action->_startAngleY + action->_diffAngleY * t);
+    }
+
+    return action->_elapsed >= action->_duration;
+}
+
+bool ActionManager::stepRotateBy(const ActionRecord& record, float dt)
+{
+    RotateBy* action = static_cast<RotateBy*>(record.action);
+    float t = advance(action->_duration, dt, action->_elapsed, action->_firstTick);
+
+    // RotateBy::update()
+    if (action->_target)
+    {
+        action->_target->setRotationX(action->_startAngleX + action->_angleX * t);
+        action->_target->setRotationY(action->_startAngleY + action->_angleY * t);
+    }
+
+    return action->_elapsed >= action->_duration;
+}
+
+bool ActionManager::stepFadeTo(const ActionRecord& record, float dt)
+{
+    FadeTo* action = static_cast<FadeTo*>(record.action);
+    float t = advance(action->_duration, dt, action->_elapsed, action->_firstTick);
+
+    // FadeTo::update(), with the RGBAProtocol of the target found once
+    if (action->_target && record.rgbaTarget)
+    {
+        record.rgbaTarget->setOpacity((GLubyte)(action->_fromOpacity + (action->_toOpacity - action->_fromOpacity) * t));
+    }
+
+    return action->_elapsed >= action->_duration;
+}
+
 void ActionManager::update(float dt)
 {
-    for (tHashElement *elt = _targets; elt != NULL; )
+    CC_PROFILE_ZONE(FrameProfiler::ZONE_ACTION_MANAGER_UPDATE);
+
+    _updating = true;
+
+    // the records added while stepping are stepped in the same frame: they are read by index
+    for (size_t i = 0; i < _records.size(); ++i)
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+        const ActionRecord record = _records[i];
+        if (record.action == NULL || _targets[record.targetIndex].paused)
+        {
+            continue;
+        }
+
+        bool done = false;
+        switch (record.kind)
+        {
+        case KIND_GENERIC:      done = stepGeneric(record, dt); break;
+        case KIND_DELAY:        done = stepDelay(record, dt); break;
+        case KIND_MOVE:         done = stepMove(record, dt); break;
+        case KIND_SCALE:        done = stepScale(record, dt); break;
+        case KIND_ROTATE_TO:    done = stepRotateTo(record, dt); break;
+        case KIND_ROTATE_BY:    done = stepRotateBy(record, dt); break;
+        case KIND_FADE_TO:      done = stepFadeTo(record, dt); break;
+        }
 
-        if (! _currentTarget->paused)
+        // the action may remove itself while it is stepped, in which case it
+        // is released at the end of the update
+        if (done && _records[i].action == record.action)
         {
-            // The 'actions' MutableArray may change while inside this loop.
-            for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
-                _currentTarget->actionIndex++)
+            record.action->stop();
+
+            if (_records[i].action == record.action)
             {
-                _currentTarget->currentAction = (Action*)_currentTarget->actions->arr[_currentTarget->actionIndex];
-                if (_currentTarget->currentAction == NULL)
-                {
-                    continue;
-                }
-
-                _currentTarget->currentActionSalvaged = false;
-
-                _currentTarget->currentAction->step(dt);
-
-                if (_currentTarget->currentActionSalvaged)
-                {
-                    // The currentAction told the node to remove it. To prevent the action from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    _currentTarget->currentAction->release();
-                } else
-                if (_currentTarget->currentAction->isDone())
-                {
-                    _currentTarget->currentAction->stop();
-
-                    Action *pAction = _currentTarget->currentAction;
-                    // Make currentAction nil to prevent removeAction from salvaging it.
-                    _currentTarget->currentAction = NULL;
-                    removeAction(pAction);
-                }
-
-                _currentTarget->currentAction = NULL;
+                removeSlot(record.slot);
             }
         }
+    }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashElement*)(elt->hh.next);
+    _updating = false;
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->actions->num == 0)
+    if (_removedRecordCount > 0)
+    {
+        compact();
+    }
+
+    // the destructors may use the manager again
+    std::vector<unsigned int> emptiedTargets;
+    emptiedTargets.swap(_emptiedTargets);
+    for (unsigned int targetIndex : emptiedTargets)
+    {
+        // it may have been given new actions since
+        if (_targets[targetIndex].target && _targets[targetIndex].slots.empty())
         {
-            deleteHashElement(_currentTarget);
+            deleteTargetEntry(targetIndex);
         }
     }
 
-    // issue #635
-    _currentTarget = NULL;
+    std::vector<Action*> releasedActions;
+    releasedActions.swap(_releasedActions);
+    for (Action* action : releasedActions)
+    {
+        action->release();
+    }
 }
 
 NS_CC_END
@@ -28,6 +28,9 @@ THE SOFTWARE.
 #ifndef __ACTION_CCACTION_MANAGER_H__
 #define __ACTION_CCACTION_MANAGER_H__
 
+#include <unordered_map>
+#include <vector>
+
 #include "CCAction.h"
 #include "cocoa/CCArray.h"
 #include "cocoa/CCObject.h"
@@ -35,8 +38,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Set;
-
-struct _hashElement;
+class RGBAProtocol;
 
 /**
  * @addtogroup actions
@@ -51,7 +53,13 @@ struct _hashElement;
  Examples:
     - When you want to run an action where the target is different from a Node. 
     - When you want to pause / resume the actions
- 
+
+ The running actions are stored in one contiguous array, in the order they were added, along
+ with their kind: the instances of MoveBy, MoveTo, ScaleTo, ScaleBy, RotateTo, RotateBy, FadeTo
+ and DelayTime are updated inline without virtual calls, the other actions are stepped through
+ Action::step(). Each action is referenced by a slot which stays valid while the array is
+ compacted, so that it is removed without searching the array.
+
  @since v0.8
  */
 class CC_DLL ActionManager : public Object
@@ -117,17 +125,72 @@ public:
     void resumeTargets(Set *targetsToResume);
 
 protected:
-    // declared in ActionManager.m
+    /** The kinds of actions updated in their own loop */
+    enum Kind
+    {
+        KIND_GENERIC,
+        KIND_DELAY,
+        KIND_MOVE,
+        KIND_SCALE,
+        KIND_ROTATE_TO,
+        KIND_ROTATE_BY,
+        KIND_FADE_TO
+    };
+
+    /** A running action. A NULL action is a removed one, until the array is compacted */
+    struct ActionRecord
+    {
+        Action* action;
+        RGBAProtocol* rgbaTarget;
+        Kind kind;
+        unsigned int targetIndex;
+        unsigned int slot;
+    };
+
+    /** The slots of the actions of a target, in the order they were added */
+    struct TargetEntry
+    {
+        Object* target;
+        bool paused;
+        std::vector<unsigned int> slots;
+    };
+
+    static Kind getKind(Action* action);
+
+    unsigned int findTarget(const Object* target) const;
+    void removeActionFromTarget(unsigned int targetIndex, unsigned int position);
+    void removeSlot(unsigned int slot);
+    void deleteTargetEntry(unsigned int targetIndex);
+    void releaseAction(Action* action);
+    void compact();
+
+    /** Each step function returns whether the action is done */
+    bool stepGeneric(const ActionRecord& record, float dt);
+    bool stepDelay(const ActionRecord& record, float dt);
+    bool stepMove(const ActionRecord& record, float dt);
+    bool stepScale(const ActionRecord& record, float dt);
+    bool stepRotateTo(const ActionRecord& record, float dt);
+    bool stepRotateBy(const ActionRecord& record, float dt);
+    bool stepFadeTo(const ActionRecord& record, float dt);
 
-    void removeActionAtIndex(unsigned int uIndex, struct _hashElement *pElement);
-    void deleteHashElement(struct _hashElement *pElement);
-    void actionAllocWithHashElement(struct _hashElement *pElement);
     void update(float dt);
 
 protected:
-    struct _hashElement    *_targets;
-    struct _hashElement    *_currentTarget;
-    bool            _currentTargetSalvaged;
+    std::vector<ActionRecord> _records;
+    unsigned int _removedRecordCount;
+
+    /** the positions of the records, by slot */
+    std::vector<unsigned int> _positions;
+    std::vector<unsigned int> _freeSlots;
+
+    std::vector<TargetEntry> _targets;
+    std::vector<unsigned int> _freeTargets;
+    std::unordered_map<const Object*, unsigned int> _targetIndices;
+
+    /** while updating, the removed actions and the targets left without action are released at the end */
+    bool _updating;
+    std::vector<Action*> _releasedActions;
+    std::vector<unsigned int> _emptiedTargets;
 };
 
 // end of actions group
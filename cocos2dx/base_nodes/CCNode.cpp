@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "CCNode.h"
 
 #include <algorithm>
+#include <string.h>
 
 #include "cocoa/CCString.h"
 #include "support/data_support/ccCArray.h"
@@ -40,11 +41,13 @@ THE SOFTWARE.
 #include "actions/CCActionManager.h"
 #include "script_support/CCScriptSupport.h"
 #include "shaders/CCGLProgram.h"
+#include "renderer/CCRenderer.h"
 
 // externals
 #include "kazmath/GL/matrix.h"
 #include "support/component/CCComponent.h"
 #include "support/component/CCComponentContainer.h"
+#include "support/CCFrameProfiler.h"
 
 #if CC_NODE_RENDER_SUBPIXEL
 #define RENDER_IN_SUBPIXEL
@@ -54,29 +57,12 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
-#if CC_USE_ARRAY_VECTOR
-bool nodeComparisonLess(const RCPtr<Object>& pp1, const RCPtr<Object>& pp2)
+bool nodeComparisonLess(Node* n1, Node* n2)
 {
-    Object *p1 = static_cast<Object*>(pp1);
-    Object *p2 = static_cast<Object*>(pp2);
-    Node *n1 = static_cast<Node*>(p1);
-    Node *n2 = static_cast<Node*>(p2);
-
     return( n1->getZOrder() < n2->getZOrder() ||
            ( n1->getZOrder() == n2->getZOrder() && n1->getOrderOfArrival() < n2->getOrderOfArrival() )
            );
 }
-#else
-bool nodeComparisonLess(Object* p1, Object* p2)
-{
-    Node *n1 = static_cast<Node*>(p1);
-    Node *n2 = static_cast<Node*>(p2);
-
-    return( n1->getZOrder() < n2->getZOrder() ||
-           ( n1->getZOrder() == n2->getZOrder() && n1->getOrderOfArrival() < n2->getOrderOfArrival() )
-           );
-}
-#endif
 
 // XXX: Yes, nodes might have a sort problem once every 15 days if the game runs at 60 FPS and each frame sprites are reordered.
 static int s_globalOrderOfArrival = 1;
@@ -87,6 +73,7 @@ Node::Node(void)
 , _scaleX(1.0f)
 , _scaleY(1.0f)
 , _vertexZ(0.0f)
+, _globalZOrder(0.0f)
 , _position(Point::ZERO)
 , _skewX(0.0f)
 , _skewY(0.0f)
@@ -104,7 +91,6 @@ Node::Node(void)
 // lazy alloc
 , _grid(NULL)
 , _ZOrder(0)
-, _children(NULL)
 , _parent(NULL)
 // "whole screen" objects. like Scenes and Layers, should set _ignoreAnchorPointForPosition to true
 , _tag(Node::INVALID_TAG)
@@ -117,10 +103,18 @@ Node::Node(void)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _reorderPending(false)
 , _isTransitionFinished(false)
 , _updateScriptHandler(0)
 , _componentContainer(NULL)
+, _modelViewDirty(true)
+, _modelViewVersion(0)
+, _parentModelViewVersion(0)
+, _visitingChildren(false)
+, _branchTransformDirty(true)
 {
+    kmMat4Identity(&_modelViewTransform);
+
     // set default scheduler and actionManager
     Director *director = Director::getInstance();
     _actionManager = director->getActionManager();
@@ -151,21 +145,14 @@ Node::~Node()
     CC_SAFE_RELEASE(_shaderProgram);
     CC_SAFE_RELEASE(_userObject);
 
-    if(_children && _children->count() > 0)
+    for (const auto& child : _children)
     {
-        Object* child;
-        CCARRAY_FOREACH(_children, child)
-        {
-            Node* node = static_cast<Node*>(child);
-            if (node)
-            {
-                node->_parent = NULL;
-            }
-        }
+        child->_parent = NULL;
+        child->_reorderPending = false;
     }
 
     // children
-    CC_SAFE_RELEASE(_children);
+    _children.clear();
     
           // _comsContainer
     _componentContainer->removeAll();
@@ -186,6 +173,7 @@ void Node::setSkewX(float newSkewX)
 {
     _skewX = newSkewX;
     _transformDirty = _inverseDirty = true;
+    markBranchTransformDirty();
 }
 
 float Node::getSkewY() const
@@ -198,6 +186,8 @@ void Node::setSkewY(float newSkewY)
     _skewY = newSkewY;
 
     _transformDirty = _inverseDirty = true;
+
+    markBranchTransformDirty();
 }
 
 /// zOrder getter
@@ -215,11 +205,15 @@ void Node::_setZOrder(int z)
 
 void Node::setZOrder(int z)
 {
-    _setZOrder(z);
     if (_parent)
     {
+        // the parent sets it, after comparing it with the previous one
         _parent->reorderChild(this, z);
     }
+    else
+    {
+        _setZOrder(z);
+    }
 }
 
 /// vertexZ getter
@@ -233,9 +227,22 @@ float Node::getVertexZ() const
 void Node::setVertexZ(float var)
 {
     _vertexZ = var;
+    // the vertex Z is part of the world transform
+    _transformDirty = true;
+    markBranchTransformDirty();
 }
 
 
+float Node::getGlobalZOrder() const
+{
+    return _globalZOrder;
+}
+
+void Node::setGlobalZOrder(float globalZOrder)
+{
+    _globalZOrder = globalZOrder;
+}
+
 /// rotation getter
 float Node::getRotation() const
 {
@@ -248,6 +255,7 @@ void Node::setRotation(float newRotation)
 {
     _rotationX = _rotationY = newRotation;
     _transformDirty = _inverseDirty = true;
+    markBranchTransformDirty();
 }
 
 float Node::getRotationX() const
@@ -259,6 +267,7 @@ void Node::setRotationX(float fRotationX)
 {
     _rotationX = fRotationX;
     _transformDirty = _inverseDirty = true;
+    markBranchTransformDirty();
 }
 
 float Node::getRotationY() const
@@ -270,6 +279,7 @@ void Node::setRotationY(float fRotationY)
 {
     _rotationY = fRotationY;
     _transformDirty = _inverseDirty = true;
+    markBranchTransformDirty();
 }
 
 /// scale getter
@@ -284,6 +294,7 @@ void Node::setScale(float scale)
 {
     _scaleX = _scaleY = scale;
     _transformDirty = _inverseDirty = true;
+    markBranchTransformDirty();
 }
 
 /// scaleX getter
@@ -297,6 +308,7 @@ void Node::setScaleX(float newScaleX)
 {
     _scaleX = newScaleX;
     _transformDirty = _inverseDirty = true;
+    markBranchTransformDirty();
 }
 
 /// scaleY getter
@@ -310,6 +322,7 @@ void Node::setScaleY(float newScaleY)
 {
     _scaleY = newScaleY;
     _transformDirty = _inverseDirty = true;
+    markBranchTransformDirty();
 }
 
 /// position getter
@@ -323,6 +336,7 @@ void Node::setPosition(const Point& newPosition)
 {
     _position = newPosition;
     _transformDirty = _inverseDirty = true;
+    markBranchTransformDirty();
 }
 
 void Node::getPosition(float* x, float* y) const
@@ -358,7 +372,7 @@ void Node::setPositionY(float y)
 
 unsigned int Node::getChildrenCount() const
 {
-    return _children ? _children->count() : 0;
+    return _children.size();
 }
 
 /// camera getter: lazy alloc
@@ -390,6 +404,11 @@ bool Node::isVisible() const
 /// isVisible setter
 void Node::setVisible(bool var)
 {
+    if (var && !_visible)
+    {
+        // the TransformUpdater skipped the node while it was hidden
+        markBranchTransformDirty();
+    }
     _visible = var;
 }
 
@@ -411,6 +430,7 @@ void Node::setAnchorPoint(const Point& point)
         _anchorPoint = point;
         _anchorPointInPoints = Point(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformDirty = _inverseDirty = true;
+        markBranchTransformDirty();
     }
 }
 
@@ -428,6 +448,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints = Point(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformDirty = _inverseDirty = true;
+        markBranchTransformDirty();
     }
 }
 
@@ -441,6 +462,11 @@ bool Node::isRunning() const
 void Node::setParent(Node * var)
 {
     _parent = var;
+    // the cached model-view matrix was based on the previous parent
+    _modelViewDirty = true;
+    // the ancestors of the previous parent may be the only marked ones
+    _branchTransformDirty = false;
+    markBranchTransformDirty();
 }
 
 /// isRelativeAnchorPoint getter
@@ -455,6 +481,7 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
 		_ignoreAnchorPointForPosition = newValue;
 		_transformDirty = _inverseDirty = true;
+		markBranchTransformDirty();
 	}
 }
 
@@ -536,7 +563,10 @@ void Node::cleanup()
     }
     
     // timers
-    arrayMakeObjectsPerformSelector(_children, cleanup, Node*);
+    for (const auto& child : _children)
+    {
+        child->cleanup();
+    }
 }
 
 
@@ -545,26 +575,14 @@ const char* Node::description() const
     return String::createWithFormat("<Node | Tag = %d>", _tag)->getCString();
 }
 
-// lazy allocs
-void Node::childrenAlloc(void)
-{
-    _children = Array::createWithCapacity(4);
-    _children->retain();
-}
-
 Node* Node::getChildByTag(int aTag)
 {
     CCASSERT( aTag != Node::INVALID_TAG, "Invalid tag");
 
-    if(_children && _children->count() > 0)
+    for (const auto& child : _children)
     {
-        Object* child;
-        CCARRAY_FOREACH(_children, child)
-        {
-            Node* pNode = static_cast<Node*>(child);
-            if(pNode && pNode->_tag == aTag)
-                return pNode;
-        }
+        if(child->_tag == aTag)
+            return child;
     }
     return NULL;
 }
@@ -578,9 +596,9 @@ void Node::addChild(Node *child, int zOrder, int tag)
     CCASSERT( child != NULL, "Argument must be non-nil");
     CCASSERT( child->_parent == NULL, "child already added. It can't be added again");
 
-    if( ! _children )
+    if (_children.empty())
     {
-        this->childrenAlloc();
+        _children.reserve(4);
     }
 
     this->insertChild(child, zOrder);
@@ -632,12 +650,12 @@ void Node::removeFromParentAndCleanup(bool cleanup)
 void Node::removeChild(Node* child, bool cleanup /* = true */)
 {
     // explicit nil handling
-    if (_children == NULL)
+    if (_children.empty())
     {
         return;
     }
 
-    int index = _children->getIndexOfObject(child);
+    int index = _children.getIndex(child);
     if( index != CC_INVALID_INDEX )
         this->detachChild( child, index, cleanup );
 }
@@ -666,33 +684,30 @@ void Node::removeAllChildren()
 void Node::removeAllChildrenWithCleanup(bool cleanup)
 {
     // not using detachChild improves speed here
-    if ( _children && _children->count() > 0 )
+    if ( ! _children.empty() )
     {
-        Object* child;
-        CCARRAY_FOREACH(_children, child)
+        for (const auto& child : _children)
         {
-            Node* pNode = static_cast<Node*>(child);
-            if (pNode)
+            // IMPORTANT:
+            //  -1st do onExit
+            //  -2nd cleanup
+            if(_running)
             {
-                // IMPORTANT:
-                //  -1st do onExit
-                //  -2nd cleanup
-                if(_running)
-                {
-                    pNode->onExitTransitionDidStart();
-                    pNode->onExit();
-                }
+                child->onExitTransitionDidStart();
+                child->onExit();
+            }
 
-                if (cleanup)
-                {
-                    pNode->cleanup();
-                }
-                // set parent nil at the end
-                pNode->setParent(NULL);
+            if (cleanup)
+            {
+                child->cleanup();
             }
+            // set parent nil at the end
+            child->setParent(NULL);
+            child->_reorderPending = false;
         }
         
-        _children->removeAllObjects();
+        _children.clear();
+        _reorderedChildren.clear();
     }
     
 }
@@ -718,7 +733,17 @@ void Node::detachChild(Node *child, int childIndex, bool doCleanup)
     // set parent nil at the end
     child->setParent(NULL);
 
-    _children->removeObjectAtIndex(childIndex);
+    if (child->_reorderPending)
+    {
+        child->_reorderPending = false;
+        auto pending = std::find(_reorderedChildren.begin(), _reorderedChildren.end(), child);
+        if (pending != _reorderedChildren.end())
+        {
+            _reorderedChildren.erase(pending);
+        }
+    }
+
+    _children.erase(childIndex);
 }
 
 
@@ -726,8 +751,11 @@ void Node::detachChild(Node *child, int childIndex, bool doCleanup)
 void Node::insertChild(Node* child, int z)
 {
     _reorderChildDirty = true;
-    _children->addObject(child);
+    _children.pushBack(child);
     child->_setZOrder(z);
+
+    child->_reorderPending = true;
+    _reorderedChildren.push_back(child);
 }
 
 void Node::reorderChild(Node *child, int zOrder)
@@ -736,43 +764,83 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->setOrderOfArrival(s_globalOrderOfArrival++);
     child->_setZOrder(zOrder);
+
+    if (! child->_reorderPending)
+    {
+        child->_reorderPending = true;
+        _reorderedChildren.push_back(child);
+    }
 }
 
 void Node::sortAllChildren()
 {
-#if 0
-    if (_reorderChildDirty)
+    if( _reorderChildDirty ) {
+        sortReorderedChildren();
+        _reorderChildDirty = false;
+    }
+}
+
+void Node::sortReorderedChildren(int* first, int* last)
+{
+    int firstChanged = 0, lastChanged = -1;
+
+    if (! _reorderedChildren.empty())
     {
-        int i,j,length = _children->count();
+        std::vector<Node*>& children = _children.data();
 
-        // insertion sort
-        for(i=1; i<length; i++)
+        // take the reordered children out, the others stay sorted
+        int count = 0;
+        firstChanged = -1;
+        for (int i = 0; i < static_cast<int>(children.size()); ++i)
         {
-            j = i-1;
-            auto tempI = static_cast<Node*>( _children->getObjectAtIndex(i) );
-            auto tempJ = static_cast<Node*>( _children->getObjectAtIndex(j) );
+            Node* child = children[i];
+            if (child->_reorderPending)
+            {
+                if (firstChanged == -1)
+                {
+                    firstChanged = i;
+                }
+                lastChanged = i;
+            }
+            else
+            {
+                children[count++] = child;
+            }
+        }
+
+        // and merge them back, sorted, from the place of the first one
+        std::sort(_reorderedChildren.begin(), _reorderedChildren.end(), nodeComparisonLess);
+        std::copy(_reorderedChildren.begin(), _reorderedChildren.end(), children.begin() + count);
 
-            //continue moving element downwards while zOrder is smaller or when zOrder is the same but mutatedIndex is smaller
-            while(j>=0 && ( tempI->_ZOrder < tempJ->_ZOrder || ( tempI->_ZOrder == tempJ->_ZOrder && tempI->_orderOfArrival < tempJ->_orderOfArrival ) ) )
+        auto middle = children.begin() + count;
+        auto start = std::upper_bound(children.begin(), middle, _reorderedChildren.front(), nodeComparisonLess);
+        std::inplace_merge(start, middle, children.end(), nodeComparisonLess);
+
+        firstChanged = std::min(firstChanged, static_cast<int>(start - children.begin()));
+        for (int i = static_cast<int>(children.size()) - 1; i > lastChanged; --i)
+        {
+            if (children[i]->_reorderPending)
             {
-                _children->fastSetObject( tempJ, j+1 );
-                j = j-1;
-                if(j>=0)
-                    tempJ = static_cast<Node*>( _children->getObjectAtIndex(j) );
+                lastChanged = i;
+                break;
             }
-            _children->fastSetObject(tempI, j+1);
         }
 
-        //don't need to check children recursively, that's done in visit of each child
+        for (const auto& child : _reorderedChildren)
+        {
+            child->_reorderPending = false;
+        }
+        _reorderedChildren.clear();
+    }
 
-        _reorderChildDirty = false;
+    if (first)
+    {
+        *first = firstChanged;
     }
-#else
-    if( _reorderChildDirty ) {
-        std::sort( std::begin(*_children), std::end(*_children), nodeComparisonLess );
-        _reorderChildDirty = false;
+    if (last)
+    {
+        *last = lastChanged;
     }
-#endif
 }
 
 
@@ -784,6 +852,30 @@ void Node::sortAllChildren()
      // DON'T draw your stuff outside this method
  }
 
+void Node::addRenderCommands(Renderer* renderer)
+{
+    CustomCommand* command = renderer->newCustomCommand();
+    command->init(_globalZOrder);
+    command->func = std::bind(&Node::draw, this);
+    renderer->addCommand(command);
+}
+
+bool Node::deferVisitToRenderer()
+{
+    Renderer* renderer = Director::getInstance()->getRenderer();
+    if (!renderer->isRecording())
+    {
+        return false;
+    }
+
+    // the command runs once the renderer stopped recording, so visit() will draw immediately
+    CustomCommand* command = renderer->newCustomCommand();
+    command->init(_globalZOrder);
+    command->func = std::bind(&Node::visit, this);
+    renderer->addCommand(command);
+    return true;
+}
+
 void Node::visit()
 {
     // quick return if not visible. children won't be drawn.
@@ -791,23 +883,51 @@ void Node::visit()
     {
         return;
     }
+
+    CC_PROFILE_ZONE(FrameProfiler::ZONE_NODE_VISIT);
+
+    Renderer* renderer = Director::getInstance()->getRenderer();
+    bool recording = renderer->isRecording();
+    bool gridActive = _grid && _grid->isActive();
+
     kmGLPushMatrix();
 
-     if (_grid && _grid->isActive())
-     {
-         _grid->beforeDraw();
-     }
+    if (gridActive)
+    {
+        if (recording)
+        {
+            // the grabbed subtree gets its own render queue, so global Z sorting
+            // can't move its commands outside of beforeDraw() / afterDraw()
+            GroupCommand* groupCommand = renderer->newGroupCommand();
+            groupCommand->init(_globalZOrder, renderer->createRenderQueue());
+            renderer->addCommand(groupCommand);
+            renderer->pushGroup(groupCommand->getRenderQueueID());
+
+            CustomCommand* beforeDraw = renderer->newCustomCommand();
+            beforeDraw->init(_globalZOrder);
+            beforeDraw->func = std::bind(&GridBase::beforeDraw, _grid);
+            renderer->addCommand(beforeDraw);
+
+            // beforeDraw() resets the modelview matrix: do the same for the recorded commands
+            kmGLLoadIdentity();
+        }
+        else
+        {
+            _grid->beforeDraw();
+        }
+    }
 
     this->transform();
-    unsigned int i = 0;
+    _visitingChildren = true;
+    int i = 0;
 
-    if(_children && _children->count() > 0)
+    if(! _children.empty())
     {
         sortAllChildren();
         // draw children zOrder < 0
-        for( ; i < _children->count(); i++ )
+        for( ; i < _children.size(); i++ )
         {
-            auto node = static_cast<Node*>( _children->getObjectAtIndex(i) );
+            auto node = _children.at(i);
 
             if ( node && node->_ZOrder < 0 )
                 node->visit();
@@ -815,27 +935,47 @@ void Node::visit()
                 break;
         }
         // self draw
-        this->draw();
+        if (recording)
+            this->addRenderCommands(renderer);
+        else
+            this->draw();
 
-        for( ; i < _children->count(); i++ )
+        for( ; i < _children.size(); i++ )
         {
-            auto node = static_cast<Node*>( _children->getObjectAtIndex(i) );
+            auto node = _children.at(i);
             if (node)
                 node->visit();
         }
     }
     else
     {
-        this->draw();
+        if (recording)
+            this->addRenderCommands(renderer);
+        else
+            this->draw();
     }
 
     // reset for next frame
     _orderOfArrival = 0;
 
-     if (_grid && _grid->isActive())
-     {
-         _grid->afterDraw(this);
+    if (gridActive)
+    {
+        if (recording)
+        {
+            CustomCommand* afterDraw = renderer->newCustomCommand();
+            afterDraw->init(_globalZOrder);
+            afterDraw->func = std::bind(&GridBase::afterDraw, _grid, this);
+            renderer->addCommand(afterDraw);
+
+            renderer->popGroup();
+        }
+        else
+        {
+            _grid->afterDraw(this);
+        }
     }
+
+    _visitingChildren = false;
  
     kmGLPopMatrix();
 }
@@ -845,11 +985,52 @@ void Node::transformAncestors()
     if( _parent != NULL  )
     {
         _parent->transformAncestors();
-        _parent->transform();
+        _parent->multiplyTransform();
     }
 }
 
 void Node::transform()
+{
+    bool gridActive = _grid != NULL && _grid->isActive();
+    bool cameraActive = _camera != NULL && !gridActive;
+
+    // The parent's cached matrix is on top of the stack only when the parent is visiting its children.
+    // A grid replaces the matrix of the parent.
+    bool inParentVisit = _parent != NULL && _parent->_visitingChildren && !gridActive;
+
+    // Nothing changed in the branch since the cached matrix was computed: skip the matrix multiplication.
+    // The parent's version also covers the frames where this node wasn't visited (e.g. hidden).
+    if (inParentVisit && _parentModelViewVersion == _parent->_modelViewVersion && !_modelViewDirty && !_transformDirty && !cameraActive)
+    {
+        kmGLLoadMatrix(&_modelViewTransform);
+        return;
+    }
+
+    this->multiplyTransform();
+
+    if (inParentVisit && !cameraActive)
+    {
+        kmGLGetMatrix(KM_GL_MODELVIEW, &_modelViewTransform);
+        _parentModelViewVersion = _parent->_modelViewVersion;
+        _modelViewDirty = false;
+        ++_modelViewVersion;
+    }
+    else
+    {
+        // The node is visited out of its parent (scene, render texture...): the children can
+        // keep their cached matrices if the result is the same as the last time
+        kmMat4 modelView;
+        kmGLGetMatrix(KM_GL_MODELVIEW, &modelView);
+        if (memcmp(&modelView, &_modelViewTransform, sizeof(kmMat4)) != 0)
+        {
+            _modelViewTransform = modelView;
+            ++_modelViewVersion;
+        }
+        _modelViewDirty = true;
+    }
+}
+
+void Node::multiplyTransform()
 {    
     kmMat4 transfrom4x4;
 
@@ -878,12 +1059,24 @@ void Node::transform()
 
 }
 
+void Node::markBranchTransformDirty()
+{
+    // the ancestors of a marked node are marked too: stop at the first one
+    for (Node* node = this; node && !node->_branchTransformDirty; node = node->_parent)
+    {
+        node->_branchTransformDirty = true;
+    }
+}
+
 
 void Node::onEnter()
 {
     _isTransitionFinished = false;
 
-    arrayMakeObjectsPerformSelector(_children, onEnter, Node*);
+    for (const auto& child : _children)
+    {
+        child->onEnter();
+    }
 
     this->resumeSchedulerAndActions();
 
@@ -902,7 +1095,10 @@ void Node::onEnterTransitionDidFinish()
 {
     _isTransitionFinished = true;
 
-    arrayMakeObjectsPerformSelector(_children, onEnterTransitionDidFinish, Node*);
+    for (const auto& child : _children)
+    {
+        child->onEnterTransitionDidFinish();
+    }
 
     if (_scriptType != kScriptTypeNone)
     {
@@ -915,7 +1111,10 @@ void Node::onEnterTransitionDidFinish()
 
 void Node::onExitTransitionDidStart()
 {
-    arrayMakeObjectsPerformSelector(_children, onExitTransitionDidStart, Node*);
+    for (const auto& child : _children)
+    {
+        child->onExitTransitionDidStart();
+    }
     if (_scriptType != kScriptTypeNone)
     {
         int action = kNodeOnExitTransitionDidStart;
@@ -938,7 +1137,10 @@ void Node::onExit()
         ScriptEngineManager::getInstance()->getScriptEngine()->sendEvent(&scriptEvent);
     }
 
-    arrayMakeObjectsPerformSelector(_children, onExit, Node*);    
+    for (const auto& child : _children)
+    {
+        child->onExit();
+    }
 }
 
 void Node::setActionManager(ActionManager* actionManager)
@@ -1176,6 +1378,7 @@ void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
     _additionalTransform = additionalTransform;
     _transformDirty = true;
     _additionalTransformDirty = true;
+    markBranchTransformDirty();
 }
 
 const AffineTransform& Node::getParentToNodeTransform() const
@@ -1248,7 +1451,10 @@ Point Node::convertTouchToNodeSpaceAR(Touch *touch) const
 void Node::updateTransform()
 {
     // Recursively iterate over children
-    arrayMakeObjectsPerformSelector(_children, updateTransform, Node*);
+    for (const auto& child : _children)
+    {
+        child->updateTransform();
+    }
 }
 
 Component* Node::getComponent(const char *pName)
@@ -1327,10 +1533,9 @@ void NodeRGBA::updateDisplayedOpacity(GLubyte parentOpacity)
 	
     if (_cascadeOpacityEnabled)
     {
-        Object* pObj;
-        CCARRAY_FOREACH(_children, pObj)
+        for (const auto& child : _children)
         {
-            RGBAProtocol* item = dynamic_cast<RGBAProtocol*>(pObj);
+            RGBAProtocol* item = dynamic_cast<RGBAProtocol*>(child);
             if (item)
             {
                 item->updateDisplayedOpacity(_displayedOpacity);
@@ -1384,10 +1589,9 @@ void NodeRGBA::updateDisplayedColor(const Color3B& parentColor)
     
     if (_cascadeColorEnabled)
     {
-        Object *obj = NULL;
-        CCARRAY_FOREACH(_children, obj)
+        for (const auto& child : _children)
         {
-            RGBAProtocol *item = dynamic_cast<RGBAProtocol*>(obj);
+            RGBAProtocol *item = dynamic_cast<RGBAProtocol*>(child);
             if (item)
             {
                 item->updateDisplayedColor(_displayedColor);
@@ -31,6 +31,7 @@
 #include "ccMacros.h"
 #include "cocoa/CCAffineTransform.h"
 #include "cocoa/CCArray.h"
+#include "cocoa/CCVector.h"
 #include "CCGL.h"
 #include "shaders/ccGLStateCache.h"
 #include "shaders/CCGLProgram.h"
@@ -52,6 +53,8 @@ class ActionManager;
 class Component;
 class Dictionary;
 class ComponentContainer;
+class Renderer;
+class TransformUpdater;
 
 /**
  * @addtogroup base_nodes
@@ -66,11 +69,9 @@ enum {
     kNodeOnCleanup
 };
 
-#if CC_USE_ARRAY_VECTOR
-bool nodeComparisonLess(const RCPtr<Object>& pp1, const RCPtr<Object>& pp2);
-#else
-bool nodeComparisonLess(Object* p1, Object* p2);
-#endif
+class Node;
+
+bool nodeComparisonLess(Node* n1, Node* n2);
 
 /** @brief Node is the main element. Anything that gets drawn or contains things that get drawn is a Node.
  The most popular Nodes are: Scene, Layer, Sprite, Menu.
@@ -223,6 +224,26 @@ public:
      */
     virtual float getVertexZ() const;
 
+    /**
+     * Sets the global Z order used by the render queue.
+     *
+     * When the render queue is enabled (see Renderer), the commands of the whole scene are sorted by
+     * their global Z order before being drawn. Nodes with the same global Z order are drawn in the
+     * order of the visit, so the local Z order keeps working as usual.
+     * It has no effect when the render queue is disabled.
+     *
+     * @param globalZOrder  The global Z order of this node. Default value is 0.
+     */
+    virtual void setGlobalZOrder(float globalZOrder);
+    /**
+     * Gets the global Z order of this node.
+     *
+     * @see setGlobalZOrder(float)
+     *
+     * @return The global Z order.
+     */
+    virtual float getGlobalZOrder() const;
+
 
     /**
      * Changes the scale factor on X axis of this node
@@ -591,8 +612,7 @@ public:
      * Composing a "tree" structure is a very important feature of Node
      * Here's a sample code of traversing children array:
      * @code
-     * Node* node = NULL;
-     * CCARRAY_FOREACH(parent->getChildren(), node)
+     * for (const auto& node : parent->getChildren())
      * {
      *     node->setPosition(0,0);
      * }
@@ -601,8 +621,8 @@ public:
      *
      * @return An array of children
      */
-    virtual Array* getChildren() { return _children; }
-    virtual const Array *getChildren() const { return _children; }
+    virtual Vector<Node*>& getChildren() { return _children; }
+    virtual const Vector<Node*>& getChildren() const { return _children; }
     
     /** 
      * Get the amount of children.
@@ -682,10 +702,17 @@ public:
     /** 
      * Sorts the children array once before drawing, instead of every time when a child is added or reordered.
      * This appraoch can improves the performance massively.
+     * Only the children added or reordered since the last sort are moved, the others are already in order.
      * @note Don't call this manually unless a child added needs to be removed in the same frame 
      */
     virtual void sortAllChildren();
 
+    /**
+     * Returns whether children were added or reordered since the children array was last sorted.
+     * @since v3.0
+     */
+    bool isReorderChildDirty() const { return _reorderChildDirty; }
+
     /// @} end of Children and Parent
     
 
@@ -730,8 +757,7 @@ public:
      * parent->addChild(node2);
      * parent->addChild(node3);
      * // identify by tags
-     * Node* node = NULL;
-     * CCARRAY_FOREACH(parent->getChildren(), node)
+     * for (const auto& node : parent->getChildren())
      * {
      *     switch(node->getTag())
      *     {
@@ -909,8 +935,21 @@ public:
      */
     virtual void draw();
 
+    /**
+     * Adds the render commands that draw this node to the renderer.
+     * It is called instead of draw() when the render queue is enabled.
+     *
+     * The default implementation records draw() in a CustomCommand, so the nodes that issue GL calls
+     * directly are drawn in the right order. Override it to emit commands that can be batched,
+     * like Sprite does.
+     *
+     * @param renderer  The renderer that is recording the frame.
+     */
+    virtual void addRenderCommands(Renderer* renderer);
+
     /** 
      * Visits this node's children and draw them recursively.
+     * When the render queue is enabled, the nodes are not drawn: their render commands are recorded.
      */
     virtual void visit();
 
@@ -1137,8 +1176,17 @@ public:
     
     /**
      * Performs OpenGL view-matrix transformation based on position, scale, rotation and other attributes.
+     *
+     * The resulting model-view matrix is cached. When the node is visited by its parent and neither the node
+     * nor its ancestors changed since the last frame, the cached matrix is loaded instead of being computed again.
      */
     void transform();
+    /**
+     * Returns the model-view matrix computed by the last call to transform().
+     * It is the matrix used by draw().
+     * @since v3.0
+     */
+    inline const kmMat4& getModelViewTransform() const { return _modelViewTransform; }
     /**
      * Performs OpenGL view-matrix transformation of it's ancestors.
      * Generally the ancestors are already transformed, but in certain cases (eg: attaching a FBO)
@@ -1302,18 +1350,36 @@ public:
     /// @} end of component functions
 
 protected:
-    /// lazy allocs
-    void childrenAlloc(void);
-    
     /// helper that reorder a child
     void insertChild(Node* child, int z);
     
     /// Removes a child, call child->onExit(), do cleanup, remove it from children array.
     void detachChild(Node *child, int index, bool doCleanup);
+
+    /** Moves the children added or reordered since the last sort to their place in the children array.
+     The others keep their relative order, so this costs a pass over the children instead of a full sort.
+     The indexes of the first and last children which changed place are returned in first and last,
+     last is smaller than first if none did.
+     @since v3.0
+     */
+    void sortReorderedChildren(int* first = nullptr, int* last = nullptr);
     
     /// Convert cocos2d coordinates to UI windows coordinate.
     Point convertToWindowSpace(const Point& nodePoint) const;
 
+    /**
+     * If the render queue is recording, records the whole visit() of this node in a CustomCommand
+     * that will visit it in immediate mode, and returns true.
+     * Used by the nodes whose visit() changes the GL state of their children (stencil, scissor, FBO, batch nodes).
+     */
+    bool deferVisitToRenderer();
+
+    /// Multiplies the node to parent transform (and the camera) onto the matrix stack, without using the cached model-view matrix.
+    void multiplyTransform();
+
+    /// Tells the TransformUpdater that this node and its ancestors lead to a changed transform. Call it after setting _transformDirty.
+    void markBranchTransformDirty();
+
 
     float _rotationX;                 ///< rotation angle on x-axis
     float _rotationY;                 ///< rotation angle on y-axis
@@ -1322,6 +1388,8 @@ protected:
     float _scaleY;                    ///< scaling factor on y-axis
     
     float _vertexZ;                   ///< OpenGL real Z vertex
+
+    float _globalZOrder;              ///< global order used to sort the render commands
     
     Point _position;               ///< position of the node
     
@@ -1347,7 +1415,7 @@ protected:
     
     int _ZOrder;                      ///< z-order value that affects the draw order
     
-    Array *_children;               ///< array of children nodes
+    Vector<Node*> _children;        ///< array of children nodes
     Node *_parent;                  ///< weak reference to parent node
     
     int _tag;                         ///< a tag. Can be any number you assigned just to identify this node
@@ -1371,6 +1439,8 @@ protected:
                                           ///< Used by Layer and Scene.
     
     bool _reorderChildDirty;          ///< children order dirty flag
+    std::vector<Node*> _reorderedChildren;  ///< children added or reordered since the last sort (weak references)
+    bool _reorderPending;             ///< this node is in the _reorderedChildren of its parent
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
     
     int _scriptHandler;               ///< script handler for onEnter() & onExit(), used in Javascript binding and Lua binding.
@@ -1379,6 +1449,15 @@ protected:
     
     ComponentContainer *_componentContainer;        ///< Dictionary of components
 
+    kmMat4 _modelViewTransform;       ///< model-view matrix computed by transform()
+    bool _modelViewDirty;             ///< the cached model-view matrix isn't based on the one of the parent
+    unsigned int _modelViewVersion;   ///< incremented every time the cached model-view matrix changes
+    unsigned int _parentModelViewVersion; ///< version of the parent's matrix that the cached matrix was computed from
+    bool _visitingChildren;           ///< the model-view matrix of this node is on top of the stack while its children are visited
+    bool _branchTransformDirty;       ///< this node or one of its descendants changed its transform since the last TransformUpdater::update()
+
+    friend class TransformUpdater;
+
 };
 
 //#pragma mark - NodeRGBA
@@ -0,0 +1,216 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base_nodes/CCTransformUpdater.h"
+
+#include <string.h>
+
+#include "base_nodes/CCNode.h"
+#include "effects/CCGrid.h"
+#include "support/CCThreadPool.h"
+#include "support/TransformUtils.h"
+#include "kazmath/GL/matrix.h"
+
+NS_CC_BEGIN
+
+TransformUpdater::TransformUpdater()
+: _enabled(false)
+, _threadCount(0)
+, _threadPool(nullptr)
+{
+    kmMat4Identity(&_baseTransform);
+}
+
+TransformUpdater::~TransformUpdater()
+{
+    CC_SAFE_DELETE(_threadPool);
+}
+
+void TransformUpdater::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+
+    if (!_enabled)
+    {
+        // don't keep idle threads around
+        CC_SAFE_DELETE(_threadPool);
+    }
+}
+
+void TransformUpdater::setThreadCount(int threadCount)
+{
+    if (threadCount != _threadCount)
+    {
+        _threadCount = threadCount;
+        // recreated with the new size by the next update()
+        CC_SAFE_DELETE(_threadPool);
+    }
+}
+
+int TransformUpdater::getThreadCount() const
+{
+    return _threadCount > 0 ? _threadCount : ThreadPool::getDefaultThreadCount();
+}
+
+bool TransformUpdater::canPrecompute(Node* node)
+{
+    // the subtrees of the nodes that are not precomputed use Node::transform()
+    return node->_visible && node->_camera == nullptr && !(node->_grid && node->_grid->isActive());
+}
+
+bool TransformUpdater::isModelViewOutdated(Node* node, Node* parent)
+{
+    return node->_parentModelViewVersion != parent->_modelViewVersion || node->_modelViewDirty || node->_transformDirty;
+}
+
+void TransformUpdater::clearBranchTransformDirty(Node* node)
+{
+    // the unmarked nodes have no marked descendants
+    if (node->_branchTransformDirty)
+    {
+        node->_branchTransformDirty = false;
+        for (const auto& child : node->_children)
+        {
+            clearBranchTransformDirty(child);
+        }
+    }
+}
+
+void TransformUpdater::gatherChildren(int begin, int end)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        Node* node = _nodes[i];
+        node->_branchTransformDirty = false;
+
+        for (const auto& child : node->_children)
+        {
+            if (!canPrecompute(child))
+            {
+                // so a change below it marks its ancestors again
+                clearBranchTransformDirty(child);
+                continue;
+            }
+
+            // the other children are clean, and so are their subtrees
+            if (child->_branchTransformDirty || isModelViewOutdated(child, node))
+            {
+                _nodes.push_back(child);
+                _parentIndices.push_back(i);
+            }
+        }
+    }
+}
+
+void TransformUpdater::computeLevel(int begin, int end)
+{
+    int levelCount = end - begin;
+    if (levelCount < GRAIN_SIZE * 2)
+    {
+        computeTransforms(begin, end);
+        return;
+    }
+
+    if (!_threadPool)
+    {
+        _threadPool = new ThreadPool(_threadCount);
+    }
+    _threadPool->parallelFor(levelCount, GRAIN_SIZE, [this, begin](int first, int last) {
+        computeTransforms(begin + first, begin + last);
+    });
+}
+
+void TransformUpdater::computeTransforms(int begin, int end)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        Node* node = _nodes[i];
+        int parent = _parentIndices[i];
+        Node* parentNode = parent >= 0 ? _nodes[parent] : nullptr;
+
+        // the node only leads to a change below it
+        if (parentNode && !isModelViewOutdated(node, parentNode))
+        {
+            continue;
+        }
+
+        kmMat4 transform4x4;
+        CGAffineToGL(node->getNodeToParentTransform(), transform4x4.mat);
+        transform4x4.mat[14] = node->_vertexZ;
+
+        if (parentNode)
+        {
+            kmMat4Multiply(&node->_modelViewTransform, &parentNode->_modelViewTransform, &transform4x4);
+            node->_parentModelViewVersion = parentNode->_modelViewVersion;
+            node->_modelViewDirty = false;
+            ++node->_modelViewVersion;
+        }
+        else
+        {
+            // the root is visited out of a parent: Node::transform() compares the result with the cached matrix
+            kmMat4 modelView;
+            kmMat4Multiply(&modelView, &_baseTransform, &transform4x4);
+            if (memcmp(&modelView, &node->_modelViewTransform, sizeof(kmMat4)) != 0)
+            {
+                node->_modelViewTransform = modelView;
+                ++node->_modelViewVersion;
+            }
+            node->_modelViewDirty = true;
+        }
+    }
+}
+
+void TransformUpdater::update(Node* root)
+{
+    if (!_enabled || !root)
+    {
+        return;
+    }
+
+    kmGLGetMatrix(KM_GL_MODELVIEW, &_baseTransform);
+
+    _nodes.clear();
+    _parentIndices.clear();
+
+    if (!canPrecompute(root))
+    {
+        clearBranchTransformDirty(root);
+        return;
+    }
+
+    _nodes.push_back(root);
+    _parentIndices.push_back(-1);
+
+    // every level depends on the previous one: it is gathered once the matrices of its parents are known
+    int levelStart = 0;
+    while (levelStart < (int)_nodes.size())
+    {
+        int levelEnd = (int)_nodes.size();
+        computeLevel(levelStart, levelEnd);
+        gatherChildren(levelStart, levelEnd);
+        levelStart = levelEnd;
+    }
+}
+
+NS_CC_END
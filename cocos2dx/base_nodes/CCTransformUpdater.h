@@ -0,0 +1,113 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCTRANSFORMUPDATER_H__
+#define __CCTRANSFORMUPDATER_H__
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "kazmath/mat4.h"
+
+NS_CC_BEGIN
+
+class Node;
+class ThreadPool;
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/** @brief Computes the world (modelview) matrices of the scene graph on a pool of worker threads.
+
+ When it is enabled, Director::drawScene() calls update() before visiting the running scene.
+ The tree is walked breadth first, and the cached model-view matrices of every level are refreshed
+ in parallel (a node only depends on its parent, which belongs to the previous level). Only the
+ branches that lead to a change are walked: the nodes whose matrix changed, their ancestors
+ (marked by Node::markBranchTransformDirty()) and their descendants. A clean subtree costs nothing,
+ and its nodes are never touched by the worker threads. Node::transform() then finds the matrices
+ up to date and only loads them.
+
+ The nodes that use a grid or a camera, and their children, are left to Node::transform().
+ So are the nodes whose transform changes after update() (e.g. in a visit() override).
+
+ getNodeToParentTransform() is called from the worker threads for the nodes whose transform
+ changed: overrides of it must not touch anything but the node itself.
+
+ It is disabled by default. It can be enabled with setEnabled() or with the
+ "cocos2d.x.parallel_transforms" key of the Configuration.
+ @since v3.0
+ */
+class CC_DLL TransformUpdater
+{
+public:
+    /** Below this number of nodes in a level, the level is computed by the calling thread */
+    static const int GRAIN_SIZE = 256;
+
+    TransformUpdater();
+    ~TransformUpdater();
+
+    inline bool isEnabled() const { return _enabled; }
+    void setEnabled(bool enabled);
+
+    /** Sets the number of worker threads. 0 uses ThreadPool::getDefaultThreadCount() */
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+
+    /** Refreshes the model-view matrices of root and its visible descendants, based on the current modelview matrix */
+    void update(Node* root);
+
+    /** Number of nodes walked by the last update(): the changed ones and their ancestors */
+    inline int getNodeCount() const { return (int)_nodes.size(); }
+
+protected:
+    static bool canPrecompute(Node* node);
+    /** Whether the cached model-view matrix of node has to be computed again, same rules as Node::transform() */
+    static bool isModelViewOutdated(Node* node, Node* parent);
+    /** Forgets the marks of a subtree that is left to Node::transform() */
+    static void clearBranchTransformDirty(Node* node);
+
+    /** Appends the children of the nodes [begin, end) that changed or lead to a change */
+    void gatherChildren(int begin, int end);
+    void computeLevel(int begin, int end);
+    void computeTransforms(int begin, int end);
+
+    bool _enabled;
+    int _threadCount;
+    ThreadPool* _threadPool;
+
+    kmMat4 _baseTransform;
+
+    /** breadth first: the nodes of a level are contiguous */
+    std::vector<Node*> _nodes;
+    std::vector<int> _parentIndices;
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTRANSFORMUPDATER_H__
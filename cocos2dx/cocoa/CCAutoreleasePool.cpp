@@ -24,64 +24,60 @@ THE SOFTWARE.
 #include "CCAutoreleasePool.h"
 #include "ccMacros.h"
 
+#include <algorithm>
+
 NS_CC_BEGIN
 
 static PoolManager* s_pPoolManager = NULL;
 
 AutoreleasePool::AutoreleasePool()
 {
-    _managedObjectArray = new Array();
-    _managedObjectArray->initWithCapacity(150);
+    _managedObjects.reserve(150);
 }
 
 AutoreleasePool::~AutoreleasePool()
 {
     CCLOGINFO("deallocing AutoreleasePool: %p", this);
-    CC_SAFE_DELETE(_managedObjectArray);
 }
 
 void AutoreleasePool::addObject(Object* object)
 {
-    _managedObjectArray->addObject(object);
+    CCASSERT(object->_reference > object->_autoReleaseCount, "the object is autoreleased more times than it is referenced");
 
-    CCASSERT(object->_reference > 1, "reference count should be greater than 1");
+    _managedObjects.push_back(object);
     ++(object->_autoReleaseCount);
-    object->release(); // no ref count, in this case autorelease pool added.
 }
 
 void AutoreleasePool::removeObject(Object* object)
 {
-    for (unsigned int i = 0; i < object->_autoReleaseCount; ++i)
-    {
-        _managedObjectArray->removeObject(object, false);
-    }
+    _managedObjects.erase(std::remove(_managedObjects.begin(), _managedObjects.end(), object), _managedObjects.end());
+
+    // an object deleted while the pool is cleared
+    std::replace(_releasingObjects.begin(), _releasingObjects.end(), object, static_cast<Object*>(nullptr));
 }
 
 void AutoreleasePool::clear()
 {
-    if(_managedObjectArray->count() > 0)
+    if (_managedObjects.empty())
     {
-        //CCAutoreleasePool* pReleasePool;
-#ifdef _DEBUG
-        int nIndex = _managedObjectArray->count() - 1;
-#endif
+        return;
+    }
 
-        Object* pObj = NULL;
-        CCARRAY_FOREACH_REVERSE(_managedObjectArray, pObj)
-        {
-            if(!pObj)
-                break;
+    // release the objects in the reverse order they were added,
+    // the objects autoreleased by their destructors go to the next clear()
+    _releasingObjects.swap(_managedObjects);
 
-            --(pObj->_autoReleaseCount);
-            //(*it)->release();
-            //delete (*it);
-#ifdef _DEBUG
-            nIndex--;
-#endif
+    for (auto it = _releasingObjects.rbegin(); it != _releasingObjects.rend(); ++it)
+    {
+        Object* object = *it;
+        if (object)
+        {
+            --(object->_autoReleaseCount);
+            object->release();
         }
-
-        _managedObjectArray->removeAllObjects();
     }
+
+    _releasingObjects.clear();
 }
 
 
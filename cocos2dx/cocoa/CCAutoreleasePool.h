@@ -24,6 +24,8 @@ THE SOFTWARE.
 #ifndef __AUTORELEASEPOOL_H__
 #define __AUTORELEASEPOOL_H__
 
+#include <vector>
+
 #include "CCObject.h"
 #include "CCArray.h"
 
@@ -37,15 +39,20 @@ NS_CC_BEGIN
 class CC_DLL AutoreleasePool : public Object
 {
     /**
-     * The underlying array of object managed by the pool.
+     * The objects managed by the pool, in the order they were added.
      *
-     * Although Array retains the object once when an object is added, proper
-     * Object::release() is called outside the array to make sure that the pool
-     * does not affect the managed object's reference count. So an object can
-     * be destructed properly by calling Object::release() even if the object
-     * is in the pool.
+     * The pool doesn't retain the objects: each entry stands for one pending
+     * Object::release(), counted by Object::_autoReleaseCount. The vectors keep
+     * their capacity, so that adding objects doesn't allocate once the pool has
+     * grown to the number of objects autoreleased in a frame.
+     */
+    std::vector<Object*> _managedObjects;
+
+    /**
+     * The objects being released by clear(). The objects autoreleased meanwhile
+     * are added to _managedObjects.
      */
-    Array   *_managedObjectArray;
+    std::vector<Object*> _releasingObjects;
 public:
     AutoreleasePool();
     ~AutoreleasePool();
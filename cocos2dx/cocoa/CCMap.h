@@ -0,0 +1,249 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCMAP_H__
+#define __CCMAP_H__
+
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cocoa/CCObject.h"
+#include "ccMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup data_structures
+ * @{
+ */
+
+/** @brief Typed hash map of Objects, over a std::unordered_map.
+
+ Map<K, V*> retains the objects it holds and releases them when they are removed from it,
+ replaced or when it is destructed, as Dictionary does, but any hashable key can be used,
+ with no fixed size buffer for string keys and without the casts of DictElement. Copying
+ a Map retains all its objects again, moving it doesn't touch their reference count.
+
+ The objects must not be NULL.
+ @since v3.0
+ */
+template <class K, class V>
+class Map
+{
+public:
+    typedef std::unordered_map<K, V> container_type;
+    typedef typename container_type::iterator iterator;
+    typedef typename container_type::const_iterator const_iterator;
+
+    Map()
+    {
+    }
+
+    /** creates an empty map able to hold capacity objects without rehashing */
+    explicit Map(int capacity)
+    {
+        reserve(capacity);
+    }
+
+    Map(const Map<K, V>& other)
+    : _data(other._data)
+    {
+        retainAll();
+    }
+
+    Map(Map<K, V>&& other)
+    : _data(std::move(other._data))
+    {
+    }
+
+    ~Map()
+    {
+        // here, so that a class can have a Map of itself
+        static_assert(std::is_convertible<V, Object*>::value, "Map can only hold pointers to Object subclasses");
+
+        clear();
+    }
+
+    Map<K, V>& operator=(const Map<K, V>& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            _data = other._data;
+            retainAll();
+        }
+        return *this;
+    }
+
+    Map<K, V>& operator=(Map<K, V>&& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            _data = std::move(other._data);
+        }
+        return *this;
+    }
+
+    // iterators, the elements are pairs of a key and an object
+
+    iterator begin() { return _data.begin(); }
+    const_iterator begin() const { return _data.begin(); }
+    iterator end() { return _data.end(); }
+    const_iterator end() const { return _data.end(); }
+
+    // capacity
+
+    int size() const { return static_cast<int>(_data.size()); }
+
+    bool empty() const { return _data.empty(); }
+
+    void reserve(int capacity) { _data.reserve(capacity); }
+
+    // accessors
+
+    /** returns the object of key, NULL if there is none */
+    V at(const K& key) const
+    {
+        auto it = _data.find(key);
+        return it != _data.end() ? it->second : NULL;
+    }
+
+    iterator find(const K& key) { return _data.find(key); }
+    const_iterator find(const K& key) const { return _data.find(key); }
+
+    bool contains(const K& key) const { return _data.find(key) != _data.end(); }
+
+    /** returns all the keys */
+    std::vector<K> keys() const
+    {
+        std::vector<K> keys;
+        keys.reserve(_data.size());
+        for (const auto& element : _data)
+        {
+            keys.push_back(element.first);
+        }
+        return keys;
+    }
+
+    /** returns the keys of object */
+    std::vector<K> keys(V object) const
+    {
+        std::vector<K> keys;
+        for (const auto& element : _data)
+        {
+            if (element.second == object)
+            {
+                keys.push_back(element.first);
+            }
+        }
+        return keys;
+    }
+
+    // modifiers
+
+    /** retains object and stores it for key, releasing the object it replaces */
+    void insert(const K& key, V object)
+    {
+        CCASSERT(object != NULL, "the object must not be NULL");
+        object->retain();
+
+        auto result = _data.insert(std::make_pair(key, object));
+        if (! result.second)
+        {
+            V previous = result.first->second;
+            result.first->second = object;
+            previous->release();
+        }
+    }
+
+    /** removes and releases the object of key, returns whether there was one */
+    bool erase(const K& key)
+    {
+        auto it = _data.find(key);
+        if (it == _data.end())
+        {
+            return false;
+        }
+
+        erase(it);
+        return true;
+    }
+
+    /** removes and releases the object at position, returns the position of the next one */
+    iterator erase(iterator position)
+    {
+        V object = position->second;
+        iterator next = _data.erase(position);
+        object->release();
+        return next;
+    }
+
+    /** removes and releases the objects of keys */
+    void erase(const std::vector<K>& keys)
+    {
+        for (const K& key : keys)
+        {
+            erase(key);
+        }
+    }
+
+    /** removes and releases all the objects */
+    void clear()
+    {
+        // the objects are released once the map is empty: their destructors may use it
+        std::vector<V> removed;
+        removed.reserve(_data.size());
+        for (const auto& element : _data)
+        {
+            removed.push_back(element.second);
+        }
+        _data.clear();
+
+        for (V object : removed)
+        {
+            object->release();
+        }
+    }
+
+protected:
+    void retainAll()
+    {
+        for (const auto& element : _data)
+        {
+            element.second->retain();
+        }
+    }
+
+    container_type _data;
+};
+
+// end of data_structures group
+/// @}
+
+NS_CC_END
+
+#endif // __CCMAP_H__
@@ -0,0 +1,144 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cocoa/CCObjectPool.h"
+
+#include <stdlib.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+
+NS_CC_BEGIN
+
+namespace {
+
+const size_t SIZE_CLASS_COUNT = ObjectPool::MAX_BLOCK_SIZE / ObjectPool::GRANULARITY;
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct SizeClass
+{
+    std::mutex mutex;
+    FreeBlock* freeBlocks;
+
+    // part of the last chunk which isn't carved yet
+    char* chunkCursor;
+    char* chunkEnd;
+};
+
+// never destroyed: Objects are still released during the destruction of the static variables
+SizeClass* getSizeClasses()
+{
+    static SizeClass* s_sizeClasses = new SizeClass[SIZE_CLASS_COUNT]();
+    return s_sizeClasses;
+}
+
+std::atomic<size_t> s_usedBlockCount(0);
+std::atomic<size_t> s_reservedSize(0);
+
+} // namespace
+
+void* ObjectPool::allocate(size_t size)
+{
+    if (size > MAX_BLOCK_SIZE)
+    {
+        return ::operator new(size);
+    }
+
+    size_t index = (size > 0) ? (size - 1) / GRANULARITY : 0;
+    size_t blockSize = (index + 1) * GRANULARITY;
+    SizeClass& sizeClass = getSizeClasses()[index];
+
+    void* block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+
+        if (sizeClass.freeBlocks)
+        {
+            block = sizeClass.freeBlocks;
+            sizeClass.freeBlocks = sizeClass.freeBlocks->next;
+        }
+        else
+        {
+            if (sizeClass.chunkCursor + blockSize > sizeClass.chunkEnd)
+            {
+                // the rest of the previous chunk is smaller than a block
+                char* chunk = static_cast<char*>(malloc(CHUNK_SIZE));
+                if (! chunk)
+                {
+                    throw std::bad_alloc();
+                }
+                sizeClass.chunkCursor = chunk;
+                sizeClass.chunkEnd = chunk + CHUNK_SIZE;
+                s_reservedSize += CHUNK_SIZE;
+            }
+
+            block = sizeClass.chunkCursor;
+            sizeClass.chunkCursor += blockSize;
+        }
+    }
+
+    ++s_usedBlockCount;
+    return block;
+}
+
+void ObjectPool::deallocate(void* block, size_t size)
+{
+    if (! block)
+    {
+        return;
+    }
+
+    if (size > MAX_BLOCK_SIZE)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    size_t index = (size > 0) ? (size - 1) / GRANULARITY : 0;
+    SizeClass& sizeClass = getSizeClasses()[index];
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        freeBlock->next = sizeClass.freeBlocks;
+        sizeClass.freeBlocks = freeBlock;
+    }
+
+    --s_usedBlockCount;
+}
+
+size_t ObjectPool::getUsedBlockCount()
+{
+    return s_usedBlockCount;
+}
+
+size_t ObjectPool::getReservedSize()
+{
+    return s_reservedSize;
+}
+
+NS_CC_END
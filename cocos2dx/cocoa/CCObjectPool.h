@@ -0,0 +1,100 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __COCOA_CCOBJECTPOOL_H__
+#define __COCOA_CCOBJECTPOOL_H__
+
+#include <stddef.h>
+
+#include "ccConfig.h"
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/** @brief Free lists of memory blocks for the Objects created and destroyed all the time.
+
+ The blocks are grouped by size classes of GRANULARITY bytes, up to MAX_BLOCK_SIZE bytes.
+ They are carved from chunks of CHUNK_SIZE bytes and a freed block goes back to the free
+ list of its class instead of the heap, so the sprites, actions and strings created during
+ a frame reuse the memory of the ones released at the end of the previous frame, without
+ calling malloc() nor fragmenting the heap. Larger blocks come from the heap.
+
+ A class takes its memory from the pool with CC_USE_OBJECT_POOL in its declaration; its
+ subclasses inherit it. It is thread safe, with a lock per size class.
+
+ The chunks are kept until the end of the process.
+ @since v3.0
+ */
+class CC_DLL ObjectPool
+{
+public:
+    /** size classes step, in bytes */
+    static const size_t GRANULARITY = 16;
+
+    /** larger blocks are allocated from the heap */
+    static const size_t MAX_BLOCK_SIZE = 1024;
+
+    /** size of the chunks the blocks are carved from */
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+    /** Allocates a block of at least size bytes. Throws std::bad_alloc when out of memory. */
+    static void* allocate(size_t size);
+
+    /** Gives back a block returned by allocate(size) */
+    static void deallocate(void* block, size_t size);
+
+    /** Gets the number of blocks in use, the blocks allocated from the heap excluded */
+    static size_t getUsedBlockCount();
+
+    /** Gets the memory reserved by the chunks, in bytes */
+    static size_t getReservedSize();
+};
+
+/** @def CC_USE_OBJECT_POOL
+ Declares the allocation functions of a class so that its instances, and the ones of its
+ subclasses, take their memory from ObjectPool. The class must have a virtual destructor, so
+ that the size of the actual class is given back. The declarations that follow it are public.
+ It does nothing when CC_ENABLE_OBJECT_POOL is 0.
+ @since v3.0
+ */
+#if CC_ENABLE_OBJECT_POOL
+#define CC_USE_OBJECT_POOL \
+public: \
+    static void* operator new(size_t size) { return cocos2d::ObjectPool::allocate(size); } \
+    static void operator delete(void* block, size_t size) { cocos2d::ObjectPool::deallocate(block, size); }
+#else
+#define CC_USE_OBJECT_POOL
+#endif
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __COCOA_CCOBJECTPOOL_H__
@@ -28,11 +28,56 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "CCArray.h"
+#include "support/CCFrameArena.h"
 
 NS_CC_BEGIN
 
 #define kMaxStringLen (1024*100)
 
+namespace {
+
+// The buffer the strings are formatted in: taken from the frame arena and given back
+// right away on the Director thread, allocated from the heap on the other threads.
+class FormatBuffer
+{
+public:
+    FormatBuffer()
+    : _arena(FrameArena::getInstance())
+    {
+        if (_arena->isOwnerThread())
+        {
+            _marker = _arena->getMarker();
+            _data = static_cast<char*>(_arena->allocate(kMaxStringLen, 1));
+        }
+        else
+        {
+            _arena = nullptr;
+            _data = static_cast<char*>(malloc(kMaxStringLen));
+        }
+    }
+
+    ~FormatBuffer()
+    {
+        if (_arena)
+        {
+            _arena->rewind(_marker);
+        }
+        else
+        {
+            free(_data);
+        }
+    }
+
+    char* get() const { return _data; }
+
+private:
+    FrameArena* _arena;
+    FrameArena::Marker _marker;
+    char* _data;
+};
+
+} // namespace
+
 String::String()
     :_string("")
 {}
@@ -65,12 +110,12 @@ String& String::operator= (const String& other)
 bool String::initWithFormatAndValist(const char* format, va_list ap)
 {
     bool bRet = false;
-    char* pBuf = (char*)malloc(kMaxStringLen);
+    FormatBuffer buffer;
+    char* pBuf = buffer.get();
     if (pBuf != NULL)
     {
         vsnprintf(pBuf, kMaxStringLen, format, ap);
         _string = pBuf;
-        free(pBuf);
         bRet = true;
     }
     return bRet;
@@ -166,12 +211,14 @@ void String::appendWithFormat(const char* format, ...)
     va_list ap;
     va_start(ap, format);
     
-    char* pBuf = (char*)malloc(kMaxStringLen);
-    if (pBuf != NULL)
     {
-        vsnprintf(pBuf, kMaxStringLen, format, ap);
-        _string.append(pBuf);
-        free(pBuf);
+        FormatBuffer buffer;
+        char* pBuf = buffer.get();
+        if (pBuf != NULL)
+        {
+            vsnprintf(pBuf, kMaxStringLen, format, ap);
+            _string.append(pBuf);
+        }
     }
     
     va_end(ap);
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <string>
 #include <functional>
 #include "CCObject.h"
+#include "CCObjectPool.h"
 
 NS_CC_BEGIN
 
@@ -42,7 +43,8 @@ NS_CC_BEGIN
 
 class CC_DLL String : public Object, public Clonable
 {
-public:
+    CC_USE_OBJECT_POOL
+
     String();
     String(const char* str);
     String(const std::string& str);
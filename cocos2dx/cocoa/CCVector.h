@@ -0,0 +1,315 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCVECTOR_H__
+#define __CCVECTOR_H__
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cocoa/CCObject.h"
+#include "ccMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup data_structures
+ * @{
+ */
+
+/** @brief Typed array of Objects, stored contiguously in a std::vector.
+
+ Vector<T*> retains the objects it holds and releases them when they are removed from it or when
+ it is destructed, as Array does, but without the casts and without the indirection of ccArray:
+ the elements are read as T* and iterated with the iterators of std::vector. Copying a Vector
+ retains all its objects again, moving it doesn't touch their reference count.
+
+ The elements must not be NULL.
+ @since v3.0
+ */
+template <class T>
+class Vector
+{
+public:
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+    typedef typename std::vector<T>::reverse_iterator reverse_iterator;
+    typedef typename std::vector<T>::const_reverse_iterator const_reverse_iterator;
+
+    Vector()
+    {
+    }
+
+    /** creates an empty vector able to hold capacity objects without allocating */
+    explicit Vector(int capacity)
+    {
+        reserve(capacity);
+    }
+
+    Vector(const Vector<T>& other)
+    : _data(other._data)
+    {
+        retainAll();
+    }
+
+    Vector(Vector<T>&& other)
+    : _data(std::move(other._data))
+    {
+    }
+
+    ~Vector()
+    {
+        // here, so that a class can have a Vector of itself
+        static_assert(std::is_convertible<T, Object*>::value, "Vector can only hold pointers to Object subclasses");
+
+        clear();
+    }
+
+    Vector<T>& operator=(const Vector<T>& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            _data = other._data;
+            retainAll();
+        }
+        return *this;
+    }
+
+    Vector<T>& operator=(Vector<T>&& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            _data = std::move(other._data);
+        }
+        return *this;
+    }
+
+    // iterators
+
+    iterator begin() { return _data.begin(); }
+    const_iterator begin() const { return _data.begin(); }
+    iterator end() { return _data.end(); }
+    const_iterator end() const { return _data.end(); }
+
+    reverse_iterator rbegin() { return _data.rbegin(); }
+    const_reverse_iterator rbegin() const { return _data.rbegin(); }
+    reverse_iterator rend() { return _data.rend(); }
+    const_reverse_iterator rend() const { return _data.rend(); }
+
+    // capacity
+
+    /** number of objects in the vector */
+    int size() const { return static_cast<int>(_data.size()); }
+
+    bool empty() const { return _data.empty(); }
+
+    /** number of objects the vector can hold without allocating */
+    int capacity() const { return static_cast<int>(_data.capacity()); }
+
+    void reserve(int capacity) { _data.reserve(capacity); }
+
+    /** frees the memory which isn't used */
+    void shrinkToFit() { _data.shrink_to_fit(); }
+
+    // accessors
+
+    T at(int index) const
+    {
+        CCASSERT(index >= 0 && index < size(), "index out of range");
+        return _data[index];
+    }
+
+    T operator[](int index) const { return at(index); }
+
+    T front() const
+    {
+        CCASSERT(! _data.empty(), "the vector is empty");
+        return _data.front();
+    }
+
+    T back() const
+    {
+        CCASSERT(! _data.empty(), "the vector is empty");
+        return _data.back();
+    }
+
+    /** returns the index of the first occurrence of object, -1 if it isn't in the vector */
+    int getIndex(T object) const
+    {
+        auto it = std::find(_data.begin(), _data.end(), object);
+        return it != _data.end() ? static_cast<int>(it - _data.begin()) : -1;
+    }
+
+    const_iterator find(T object) const { return std::find(_data.begin(), _data.end(), object); }
+    iterator find(T object) { return std::find(_data.begin(), _data.end(), object); }
+
+    bool contains(T object) const { return find(object) != _data.end(); }
+
+    // modifiers
+
+    /** adds and retains object at the end of the vector */
+    void pushBack(T object)
+    {
+        CCASSERT(object != NULL, "the object must not be NULL");
+        _data.push_back(object);
+        object->retain();
+    }
+
+    /** adds and retains the objects of other at the end of the vector */
+    void pushBack(const Vector<T>& other)
+    {
+        for (T object : other._data)
+        {
+            pushBack(object);
+        }
+    }
+
+    /** inserts and retains object before index */
+    void insert(int index, T object)
+    {
+        CCASSERT(index >= 0 && index <= size(), "index out of range");
+        CCASSERT(object != NULL, "the object must not be NULL");
+        _data.insert(_data.begin() + index, object);
+        object->retain();
+    }
+
+    /** removes and releases the last object */
+    void popBack()
+    {
+        CCASSERT(! _data.empty(), "the vector is empty");
+        T last = _data.back();
+        _data.pop_back();
+        last->release();
+    }
+
+    /** removes and releases the object at index, keeping the order of the others */
+    void erase(int index)
+    {
+        CCASSERT(index >= 0 && index < size(), "index out of range");
+        erase(_data.begin() + index);
+    }
+
+    /** removes and releases the object at position, returns the position of the next one */
+    iterator erase(iterator position)
+    {
+        T object = *position;
+        iterator next = _data.erase(position);
+        object->release();
+        return next;
+    }
+
+    /** removes and releases the objects in [first, last), returns the position of the next one */
+    iterator erase(iterator first, iterator last)
+    {
+        std::vector<T> removed(first, last);
+        iterator next = _data.erase(first, last);
+        for (T object : removed)
+        {
+            object->release();
+        }
+        return next;
+    }
+
+    /** removes and releases the first occurrence of object, or all of them */
+    void eraseObject(T object, bool removeAll = false)
+    {
+        if (removeAll)
+        {
+            for (iterator it = _data.begin(); it != _data.end(); )
+            {
+                it = (*it == object) ? erase(it) : it + 1;
+            }
+        }
+        else
+        {
+            iterator it = find(object);
+            if (it != _data.end())
+            {
+                erase(it);
+            }
+        }
+    }
+
+    /** replaces the object at index, retaining the new one and releasing the old one */
+    void replace(int index, T object)
+    {
+        CCASSERT(index >= 0 && index < size(), "index out of range");
+        CCASSERT(object != NULL, "the object must not be NULL");
+        object->retain();
+        _data[index]->release();
+        _data[index] = object;
+    }
+
+    /** swaps the objects at two indexes, their reference count is unchanged */
+    void swap(int index1, int index2)
+    {
+        CCASSERT(index1 >= 0 && index1 < size() && index2 >= 0 && index2 < size(), "index out of range");
+        std::swap(_data[index1], _data[index2]);
+    }
+
+    void reverse() { std::reverse(_data.begin(), _data.end()); }
+
+    /** removes and releases all the objects, from the last one */
+    void clear()
+    {
+        // each object is removed before it is released: its destructor may use the vector
+        while (! _data.empty())
+        {
+            T object = _data.back();
+            _data.pop_back();
+            object->release();
+        }
+    }
+
+    /** sorts the objects with comparator, keeping the order of the equal ones */
+    template <class Comparator>
+    void stableSort(Comparator comparator) { std::stable_sort(_data.begin(), _data.end(), comparator); }
+
+    /** gives direct access to the storage, for the algorithms which don't change the reference counts */
+    std::vector<T>& data() { return _data; }
+    const std::vector<T>& data() const { return _data; }
+
+protected:
+    void retainAll()
+    {
+        for (T object : _data)
+        {
+            object->retain();
+        }
+    }
+
+    std::vector<T> _data;
+};
+
+// end of data_structures group
+/// @}
+
+NS_CC_END
+
+#endif // __CCVECTOR_H__
@@ -230,6 +230,44 @@ To enable set it to a value different than 0. Disabled by default.
 #define CC_SPRITEBATCHNODE_DEBUG_DRAW 0
 #endif
 
+/** @def CC_USE_CULLING
+ If enabled, Sprite, SpriteBatchNode and TMXLayer don't draw the quads that are outside of the viewport.
+ The quads are tested against the projection and model-view matrices on top of the stacks when they are drawn.
+ SpriteBatchNode only draws the ranges of its texture atlas that contain visible quads.
+
+ To enable set it to a value different than 0. Disabled by default.
+
+ @since v3.0
+ */
+#ifndef CC_USE_CULLING
+#define CC_USE_CULLING 0
+#endif
+
+/** @def CC_USE_PARTICLE_SIMD
+ If enabled, ParticleSystem updates 4 particles at a time with the SSE2 or NEON instructions, when they are available.
+ The particles are updated one by one on the other CPUs, or when it is disabled.
+
+ To disable set it to 0. Enabled by default.
+
+ @since v3.0
+ */
+#ifndef CC_USE_PARTICLE_SIMD
+#define CC_USE_PARTICLE_SIMD 1
+#endif
+
+/** @def CC_USE_TEXTURE_CONVERT_SIMD
+ If enabled, Texture2D converts the pixel formats 16 pixels at a time with the SSE2 or NEON instructions.
+ On Android armeabi-v7a, NEON is used when the CPU supports it, which is checked at runtime.
+ The pixels are converted one by one on the other CPUs, or when it is disabled.
+
+ To disable set it to 0. Enabled by default.
+
+ @since v3.0
+ */
+#ifndef CC_USE_TEXTURE_CONVERT_SIMD
+#define CC_USE_TEXTURE_CONVERT_SIMD 1
+#endif
+
 /** @def CC_LABELBMFONT_DEBUG_DRAW
 If enabled, all subclasses of LabelBMFont will draw a bounding box
 Useful for debugging purposes only. It is recommended to leave it disabled.
@@ -261,6 +299,32 @@ To enable set it to a value different than 0. Disabled by default.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_ENABLE_FRAME_PROFILER
+ If enabled, the zones of FrameProfiler (CC_PROFILE_ZONE) are compiled in. They only record something
+ once FrameProfiler is enabled at runtime, so it can be left enabled in the release builds.
+
+ To disable set it to 0. Enabled by default.
+
+ @since v3.0
+ */
+#ifndef CC_ENABLE_FRAME_PROFILER
+#define CC_ENABLE_FRAME_PROFILER 1
+#endif
+
+/** @def CC_ENABLE_OBJECT_POOL
+ If enabled, the objects created in large numbers (sprites, actions, strings) are
+ allocated from per-size free lists instead of the global heap.
+
+ To disable it when the memory is checked by tools like AddressSanitizer or
+ valgrind, which can't see the use of a block after it was returned to a pool:
+ #define CC_ENABLE_OBJECT_POOL 0
+
+ @since v3.0
+ */
+#ifndef CC_ENABLE_OBJECT_POOL
+#define CC_ENABLE_OBJECT_POOL 1
+#endif
+
 /** Enable Lua engine debug log */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
@@ -60,6 +60,8 @@ THE SOFTWARE.
 #include "cocoa/CCDictionary.h"
 #include "cocoa/CCObject.h"
 #include "cocoa/CCArray.h"
+#include "cocoa/CCVector.h"
+#include "cocoa/CCMap.h"
 #include "cocoa/CCGeometry.h"
 #include "cocoa/CCSet.h"
 #include "cocoa/CCAutoreleasePool.h"
@@ -123,6 +125,10 @@ THE SOFTWARE.
 #include "particle_nodes/CCParticleSystem.h"
 #include "particle_nodes/CCParticleExamples.h"
 #include "particle_nodes/CCParticleSystemQuad.h"
+#include "particle_nodes/CCParticleSimulator.h"
+
+// renderer
+#include "renderer/CCRenderer.h"
 
 // platform
 #include "platform/CCDevice.h"
@@ -240,6 +246,7 @@ THE SOFTWARE.
 #include "sprite_nodes/CCSpriteBatchNode.h"
 #include "sprite_nodes/CCSpriteFrame.h"
 #include "sprite_nodes/CCSpriteFrameCache.h"
+#include "sprite_nodes/CCSpriteFrameAtlas.h"
 
 // support
 #include "support/ccUTF8.h"
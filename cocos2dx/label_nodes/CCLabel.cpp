@@ -661,12 +661,10 @@ bool Label::isOpacityModifyRGB() const
 void Label::setOpacityModifyRGB(bool isOpacityModifyRGB)
 {
     _isOpacityModifyRGB = isOpacityModifyRGB;
-    if (_children && _children->count() != 0)
+    if (! _children.empty())
     {
-        Object* child;
-        CCARRAY_FOREACH(_children, child)
+        for (const auto& pNode : _children)
         {
-            Node* pNode = static_cast<Node*>( child );
             if (pNode)
             {
                 RGBAProtocol *pRGBAProtocol = dynamic_cast<RGBAProtocol*>(pNode);
@@ -707,8 +705,7 @@ void Label::updateDisplayedOpacity(GLubyte parentOpacity)
 {
     _displayedOpacity = _realOpacity * parentOpacity/255.0;
     
-	Object* pObj;
-	CCARRAY_FOREACH(_children, pObj)
+	for (const auto& pObj : _children)
     {
         Sprite *item = static_cast<Sprite*>( pObj );
 		item->updateDisplayedOpacity(_displayedOpacity);
@@ -757,8 +754,7 @@ void Label::updateDisplayedColor(const Color3B& parentColor)
 	_displayedColor.g = _realColor.g * parentColor.g/255.0;
 	_displayedColor.b = _realColor.b * parentColor.b/255.0;
     
-    Object* pObj;
-	CCARRAY_FOREACH(_children, pObj)
+    for (const auto& pObj : _children)
     {
         Sprite *item = static_cast<Sprite*>( pObj );
 		item->updateDisplayedColor(_displayedColor);
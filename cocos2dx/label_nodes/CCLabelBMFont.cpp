@@ -757,12 +757,10 @@ void LabelBMFont::setString(unsigned short *newString, bool needUpdateLabel)
         CC_SAFE_DELETE_ARRAY(tmp);
     }
     
-    if (_children && _children->count() != 0)
+    if (! _children.empty())
     {
-        Object* child;
-        CCARRAY_FOREACH(_children, child)
+        for (const auto& pNode : _children)
         {
-            Node* pNode = static_cast<Node*>( child );
             if (pNode)
             {
                 pNode->setVisible(false);
@@ -841,12 +839,10 @@ void LabelBMFont::setOpacity(GLubyte opacity)
 void LabelBMFont::setOpacityModifyRGB(bool var)
 {
     _isOpacityModifyRGB = var;
-    if (_children && _children->count() != 0)
+    if (! _children.empty())
     {
-        Object* child;
-        CCARRAY_FOREACH(_children, child)
+        for (const auto& pNode : _children)
         {
-            Node* pNode = static_cast<Node*>( child );
             if (pNode)
             {
                 RGBAProtocol *pRGBAProtocol = dynamic_cast<RGBAProtocol*>(pNode);
@@ -867,8 +863,7 @@ void LabelBMFont::updateDisplayedOpacity(GLubyte parentOpacity)
 {
 	_displayedOpacity = _realOpacity * parentOpacity/255.0;
     
-	Object* pObj;
-	CCARRAY_FOREACH(_children, pObj)
+	for (const auto& pObj : _children)
     {
         Sprite *item = static_cast<Sprite*>( pObj );
 		item->updateDisplayedOpacity(_displayedOpacity);
@@ -881,8 +876,7 @@ void LabelBMFont::updateDisplayedColor(const Color3B& parentColor)
 	_displayedColor.g = _realColor.g * parentColor.g/255.0;
 	_displayedColor.b = _realColor.b * parentColor.b/255.0;
     
-    Object* pObj;
-	CCARRAY_FOREACH(_children, pObj)
+    for (const auto& pObj : _children)
     {
         Sprite *item = static_cast<Sprite*>( pObj );
 		item->updateDisplayedColor(_displayedColor);
@@ -939,8 +933,8 @@ void LabelBMFont::updateLabel()
         float startOfLine = -1, startOfWord = -1;
         int skip = 0;
 
-        Array* children = getChildren();
-        for (unsigned int j = 0; j < children->count(); j++)
+        auto& children = getChildren();
+        for (int j = 0; j < children.size(); j++)
         {
             Sprite* characterSprite;
             unsigned int justSkipped = 0;
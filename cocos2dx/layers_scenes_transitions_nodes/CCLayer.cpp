@@ -588,8 +588,7 @@ void LayerRGBA::updateDisplayedOpacity(GLubyte parentOpacity)
     
     if (_cascadeOpacityEnabled)
     {
-        Object *obj = NULL;
-        CCARRAY_FOREACH(_children, obj)
+        for (const auto& obj : _children)
         {
             RGBAProtocol *item = dynamic_cast<RGBAProtocol*>(obj);
             if (item)
@@ -608,8 +607,7 @@ void LayerRGBA::updateDisplayedColor(const Color3B& parentColor)
     
     if (_cascadeColorEnabled)
     {
-        Object *obj = NULL;
-        CCARRAY_FOREACH(_children, obj)
+        for (const auto& obj : _children)
         {
             RGBAProtocol *item = dynamic_cast<RGBAProtocol*>(obj);
             if (item)
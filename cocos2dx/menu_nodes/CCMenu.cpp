@@ -301,12 +301,10 @@ void Menu::alignItemsVertically()
 void Menu::alignItemsVerticallyWithPadding(float padding)
 {
     float height = -padding;
-    if (_children && _children->count() > 0)
+    if (! _children.empty())
     {
-        Object* pObject = NULL;
-        CCARRAY_FOREACH(_children, pObject)
+        for (const auto& child : _children)
         {
-            Node* child = dynamic_cast<Node*>(pObject);
             if (child)
             {
                 height += child->getContentSize().height * child->getScaleY() + padding;
@@ -315,12 +313,10 @@ void Menu::alignItemsVerticallyWithPadding(float padding)
     }
 
     float y = height / 2.0f;
-    if (_children && _children->count() > 0)
+    if (! _children.empty())
     {
-        Object* pObject = NULL;
-        CCARRAY_FOREACH(_children, pObject)
+        for (const auto& child : _children)
         {
-            Node* child = dynamic_cast<Node*>(pObject);
             if (child)
             {
                 child->setPosition(Point(0, y - child->getContentSize().height * child->getScaleY() / 2.0f));
@@ -339,12 +335,10 @@ void Menu::alignItemsHorizontallyWithPadding(float padding)
 {
 
     float width = -padding;
-    if (_children && _children->count() > 0)
+    if (! _children.empty())
     {
-        Object* pObject = NULL;
-        CCARRAY_FOREACH(_children, pObject)
+        for (const auto& child : _children)
         {
-            Node* child = dynamic_cast<Node*>(pObject);
             if (child)
             {
                 width += child->getContentSize().width * child->getScaleX() + padding;
@@ -353,12 +347,10 @@ void Menu::alignItemsHorizontallyWithPadding(float padding)
     }
 
     float x = -width / 2.0f;
-    if (_children && _children->count() > 0)
+    if (! _children.empty())
     {
-        Object* pObject = NULL;
-        CCARRAY_FOREACH(_children, pObject)
+        for (const auto& child : _children)
         {
-            Node* child = dynamic_cast<Node*>(pObject);
             if (child)
             {
                 child->setPosition(Point(x + child->getContentSize().width * child->getScaleX() / 2.0f, 0));
@@ -400,12 +392,10 @@ void Menu::alignItemsInColumnsWithArray(Array* rowsArray)
     unsigned int columnsOccupied = 0;
     unsigned int rowColumns;
 
-    if (_children && _children->count() > 0)
+    if (! _children.empty())
     {
-        Object* pObject = NULL;
-        CCARRAY_FOREACH(_children, pObject)
+        for (const auto& child : _children)
         {
-            Node* child = dynamic_cast<Node*>(pObject);
             if (child)
             {
                 CCASSERT(row < rows.size(), "");
@@ -442,12 +432,10 @@ void Menu::alignItemsInColumnsWithArray(Array* rowsArray)
     float x = 0.0;
     float y = (float)(height / 2);
 
-    if (_children && _children->count() > 0)
+    if (! _children.empty())
     {
-        Object* pObject = NULL;
-        CCARRAY_FOREACH(_children, pObject)
+        for (const auto& child : _children)
         {
-            Node* child = dynamic_cast<Node*>(pObject);
             if (child)
             {
                 if (rowColumns == 0)
@@ -515,12 +503,10 @@ void Menu::alignItemsInRowsWithArray(Array* columnArray)
     unsigned int rowsOccupied = 0;
     unsigned int columnRows;
 
-    if (_children && _children->count() > 0)
+    if (! _children.empty())
     {
-        Object* pObject = NULL;
-        CCARRAY_FOREACH(_children, pObject)
+        for (const auto& child : _children)
         {
-            Node* child = dynamic_cast<Node*>(pObject);
             if (child)
             {
                 // check if too many menu items for the amount of rows/columns
@@ -563,12 +549,10 @@ void Menu::alignItemsInRowsWithArray(Array* columnArray)
     float x = (float)(-width / 2);
     float y = 0.0;
 
-    if (_children && _children->count() > 0)
+    if (! _children.empty())
     {
-        Object* pObject = NULL;
-        CCARRAY_FOREACH(_children, pObject)
+        for (const auto& child : _children)
         {
-            Node* child = dynamic_cast<Node*>(pObject);
             if (child)
             {
                 if (columnRows == 0)
@@ -604,10 +588,9 @@ MenuItem* Menu::itemForTouch(Touch *touch)
 {
     Point touchLocation = touch->getLocation();
 
-    if (_children && _children->count() > 0)
+    if (! _children.empty())
     {
-        Object* pObject = NULL;
-        CCARRAY_FOREACH(_children, pObject)
+        for (const auto& pObject : _children)
         {
             MenuItem* child = dynamic_cast<MenuItem*>(pObject);
             if (child && child->isVisible() && child->isEnabled())
@@ -39,12 +39,10 @@ static GLint g_sStencilBits = -1;
 static void setProgram(Node *n, GLProgram *p)
 {
     n->setShaderProgram(p);
-    if (!n->getChildren()) return;
     
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(n->getChildren(), pObj)
+    for (const auto& child : n->getChildren())
     {
-        setProgram(static_cast<Node*>(pObj), p);
+        setProgram(child, p);
     }
 }
 
@@ -161,6 +159,12 @@ void ClippingNode::drawFullScreenQuadClearStencil()
 
 void ClippingNode::visit()
 {
+    // the stencil state can't be changed while the commands are recorded: record the whole visit
+    if (deferVisitToRenderer())
+    {
+        return;
+    }
+
     // if stencil buffer disabled
     if (g_sStencilBits < 1)
     {
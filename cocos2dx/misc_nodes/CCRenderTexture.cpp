@@ -450,6 +450,12 @@ void RenderTexture::visit()
     // override visit.
 	// Don't call visit on its children
     if (!_visible)
+    {
+        return;
+    }
+
+    // the FBO can't be bound while the commands are recorded: record the whole visit
+    if (deferVisitToRenderer())
     {
         return;
     }
@@ -528,10 +534,8 @@ void RenderTexture::draw()
 		//! make sure all children are drawn
         sortAllChildren();
 		
-		Object *pElement;
-		CCARRAY_FOREACH(_children, pElement)
+		for (const auto& child : _children)
         {
-            Node *child = static_cast<Node*>(pElement);
 
             if (child != _sprite)
             {
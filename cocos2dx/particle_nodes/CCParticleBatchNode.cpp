@@ -96,8 +96,7 @@ bool ParticleBatchNode::initWithTexture(Texture2D *tex, unsigned int capacity)
     _textureAtlas->initWithTexture(tex, capacity);
 
     // no lazy alloc in this node
-    _children = new Array();
-    _children->initWithCapacity(capacity);
+    _children.reserve(capacity);
 
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 
@@ -133,6 +132,12 @@ void ParticleBatchNode::visit()
         return;
     }
 
+    // the children are drawn by the batch node itself: record the whole visit
+    if (deferVisitToRenderer())
+    {
+        return;
+    }
+
     kmGLPushMatrix();
 
     if ( _grid && _grid->isActive())
@@ -171,7 +176,7 @@ void ParticleBatchNode::addChild(Node * aChild, int zOrder, int tag)
     ParticleSystem* child = static_cast<ParticleSystem*>(aChild);
     CCASSERT( child->getTexture()->getName() == _textureAtlas->getTexture()->getName(), "CCParticleSystem is not using the same texture id");
     // If this is the 1st children, then copy blending function
-    if( _children->count() == 0 ) 
+    if( _children.empty() ) 
     {
         setBlendFunc(child->getBlendFunc());
     }
@@ -186,7 +191,7 @@ void ParticleBatchNode::addChild(Node * aChild, int zOrder, int tag)
 
     if (pos != 0) 
     {
-        ParticleSystem* p = (ParticleSystem*)_children->getObjectAtIndex(pos-1);
+        ParticleSystem* p = static_cast<ParticleSystem*>(_children.at(pos-1));
         atlasIndex = p->getAtlasIndex() + p->getTotalParticles();
 
     }
@@ -210,16 +215,10 @@ unsigned int ParticleBatchNode::addChildHelper(ParticleSystem* child, int z, int
     CCASSERT( child != NULL, "Argument must be non-nil");
     CCASSERT( child->getParent() == NULL, "child already added. It can't be added again");
 
-    if( ! _children ) 
-    {
-        _children = new Array();
-        _children->initWithCapacity(4);
-    }
-
     //don't use a lazy insert
     unsigned int pos = searchNewPositionInChildrenForZ(z);
 
-    _children->insertObject(child, pos);
+    _children.insert(pos, child);
 
     child->setTag(aTag);
     child->_setZOrder(z);
@@ -239,7 +238,7 @@ void ParticleBatchNode::reorderChild(Node * aChild, int zOrder)
 {
     CCASSERT( aChild != NULL, "Child must be non-NULL");
     CCASSERT( dynamic_cast<ParticleSystem*>(aChild) != NULL, "CCParticleBatchNode only supports QuadParticleSystems as children");
-    CCASSERT( _children->containsObject(aChild), "Child doesn't belong to batch" );
+    CCASSERT( _children.contains(aChild), "Child doesn't belong to batch" );
 
     ParticleSystem* child = static_cast<ParticleSystem*>(aChild);
 
@@ -249,7 +248,7 @@ void ParticleBatchNode::reorderChild(Node * aChild, int zOrder)
     }
 
     // no reordering if only 1 child
-    if( _children->count() > 1)
+    if( _children.size() > 1)
     {
         unsigned int newIndex = 0, oldIndex = 0;
 
@@ -258,10 +257,10 @@ void ParticleBatchNode::reorderChild(Node * aChild, int zOrder)
         if( oldIndex != newIndex )
         {
 
-            // reorder _children->array
+            // reorder _children
             child->retain();
-            _children->removeObjectAtIndex(oldIndex);
-            _children->insertObject(child, newIndex);
+            _children.erase(oldIndex);
+            _children.insert(newIndex, child);
             child->release();
 
             // save old altasIndex
@@ -272,9 +271,9 @@ void ParticleBatchNode::reorderChild(Node * aChild, int zOrder)
 
             // Find new AtlasIndex
             int newAtlasIndex = 0;
-            for( unsigned int i=0;i < _children->count();i++)
+            for( int i=0;i < _children.size();i++)
             {
-                ParticleSystem* pNode = (ParticleSystem*)_children->getObjectAtIndex(i);
+                ParticleSystem* pNode = static_cast<ParticleSystem*>(_children.at(i));
                 if( pNode == child ) 
                 {
                     newAtlasIndex = child->getAtlasIndex();
@@ -298,11 +297,11 @@ void ParticleBatchNode::getCurrentIndex(unsigned int* oldIndex, unsigned int* ne
     bool foundNewIdx = false;
 
     int  minusOne = 0;
-    unsigned int count = _children->count();
+    unsigned int count = _children.size();
 
     for( unsigned int i=0; i < count; i++ ) 
     {
-        Node* pNode = (Node *)_children->getObjectAtIndex(i);
+        Node* pNode = _children.at(i);
 
         // new index
         if( pNode->getZOrder() > z &&  ! foundNewIdx ) 
@@ -345,11 +344,11 @@ void ParticleBatchNode::getCurrentIndex(unsigned int* oldIndex, unsigned int* ne
 
 unsigned int ParticleBatchNode::searchNewPositionInChildrenForZ(int z)
 {
-    unsigned int count = _children->count();
+    unsigned int count = _children.size();
 
     for( unsigned int i=0; i < count; i++ ) 
     {
-        Node *child = (Node *)_children->getObjectAtIndex(i);
+        Node *child = _children.at(i);
         if (child->getZOrder() > z)
         {
             return i;
@@ -366,7 +365,7 @@ void  ParticleBatchNode::removeChild(Node* aChild, bool cleanup)
         return;
     
     CCASSERT( dynamic_cast<ParticleSystem*>(aChild) != NULL, "CCParticleBatchNode only supports QuadParticleSystems as children");
-    CCASSERT(_children->containsObject(aChild), "CCParticleBatchNode doesn't contain the sprite. Can't remove it");
+    CCASSERT(_children.contains(aChild), "CCParticleBatchNode doesn't contain the sprite. Can't remove it");
 
     ParticleSystem* child = static_cast<ParticleSystem*>(aChild);
     Node::removeChild(child, cleanup);
@@ -385,12 +384,15 @@ void  ParticleBatchNode::removeChild(Node* aChild, bool cleanup)
 
 void ParticleBatchNode::removeChildAtIndex(unsigned int index, bool doCleanup)
 {
-    removeChild((ParticleSystem *)_children->getObjectAtIndex(index),doCleanup);
+    removeChild(static_cast<ParticleSystem*>(_children.at(index)),doCleanup);
 }
 
 void ParticleBatchNode::removeAllChildrenWithCleanup(bool doCleanup)
 {
-    arrayMakeObjectsPerformSelectorWithObject(_children, setBatchNode, NULL, ParticleSystem*);
+    for (const auto& child : _children)
+    {
+        static_cast<ParticleSystem*>(child)->setBatchNode(NULL);
+    }
 
     Node::removeAllChildrenWithCleanup(doCleanup);
 
@@ -467,10 +469,9 @@ void ParticleBatchNode::insertChild(ParticleSystem* system, int index)
 //rebuild atlas indexes
 void ParticleBatchNode::updateAllAtlasIndexes()
 {
-    Object *pObj = NULL;
     unsigned int index = 0;
 
-    CCARRAY_FOREACH(_children,pObj)
+    for (const auto& pObj : _children)
     {
         ParticleSystem* child = static_cast<ParticleSystem*>(pObj);
         child->setAtlasIndex(index);
@@ -0,0 +1,164 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "particle_nodes/CCParticleSimulator.h"
+
+#include "particle_nodes/CCParticleSystem.h"
+#include "support/CCThreadPool.h"
+#include "support/CCProfiling.h"
+
+NS_CC_BEGIN
+
+ParticleSimulator::ParticleSimulator()
+: _enabled(false)
+, _threadCount(0)
+, _threadPool(nullptr)
+, _lastSystemCount(0)
+{
+}
+
+ParticleSimulator::~ParticleSimulator()
+{
+    // the systems queued after the last frame are dropped
+    for (auto& simulation : _simulations)
+    {
+        if (simulation.system)
+        {
+            simulation.system->_simulationIndex = -1;
+            simulation.system->release();
+        }
+    }
+
+    CC_SAFE_DELETE(_threadPool);
+}
+
+void ParticleSimulator::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+
+    if (!_enabled)
+    {
+        // the systems already queued are simulated by the next update()
+
+        // don't keep idle threads around
+        CC_SAFE_DELETE(_threadPool);
+    }
+}
+
+void ParticleSimulator::setThreadCount(int threadCount)
+{
+    if (threadCount != _threadCount)
+    {
+        _threadCount = threadCount;
+        // recreated with the new size by the next update()
+        CC_SAFE_DELETE(_threadPool);
+    }
+}
+
+int ParticleSimulator::getThreadCount() const
+{
+    return _threadCount > 0 ? _threadCount : ThreadPool::getDefaultThreadCount();
+}
+
+void ParticleSimulator::addSystem(ParticleSystem* system, float dt)
+{
+    // updated twice in the same frame: the first step must be done before the second one
+    if (system->_simulationIndex >= 0)
+    {
+        Simulation& previous = _simulations[system->_simulationIndex];
+        previous.alive = system->simulate(previous.dt);
+        endSimulation(previous);
+    }
+
+    system->retain();
+    system->_simulationIndex = (int)_simulations.size();
+
+    Simulation simulation = { system, dt, true };
+    _simulations.push_back(simulation);
+}
+
+void ParticleSimulator::update()
+{
+    _lastSystemCount = (int)_simulations.size();
+    if (_simulations.empty())
+    {
+        return;
+    }
+
+    CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles, "CCParticleSimulator - update");
+
+    // one system per task: the big systems don't wait for the small ones
+    bool parallel = _simulations.size() > 1;
+    if (parallel)
+    {
+        if (!_threadPool)
+        {
+            _threadPool = new ThreadPool(_threadCount);
+        }
+        _threadPool->parallelFor((int)_simulations.size(), 1, [this](int begin, int end) {
+            for (int i = begin; i < end; ++i)
+            {
+                Simulation& simulation = _simulations[i];
+                if (simulation.system && !simulation.system->getBatchNode())
+                {
+                    simulation.alive = simulation.system->simulate(simulation.dt);
+                }
+            }
+        });
+    }
+
+    // a lone system, and the systems of a ParticleBatchNode: they write the quads and the dirty flag of its shared atlas
+    for (auto& simulation : _simulations)
+    {
+        if (simulation.system && (!parallel || simulation.system->getBatchNode()))
+        {
+            simulation.alive = simulation.system->simulate(simulation.dt);
+        }
+    }
+
+    // upload the quads and remove the finished systems on the GL thread.
+    // endUpdate() may remove systems from the scene: the systems queued meanwhile wait for the next update()
+    std::vector<Simulation> simulations;
+    simulations.swap(_simulations);
+    for (auto& simulation : simulations)
+    {
+        endSimulation(simulation);
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles, "CCParticleSimulator - update");
+}
+
+void ParticleSimulator::endSimulation(Simulation& simulation)
+{
+    ParticleSystem* system = simulation.system;
+    if (system)
+    {
+        simulation.system = nullptr;
+        system->_simulationIndex = -1;
+        system->endUpdate(simulation.alive);
+        system->release();
+    }
+}
+
+NS_CC_END
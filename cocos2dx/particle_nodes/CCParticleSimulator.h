@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCPARTICLESIMULATOR_H__
+#define __CCPARTICLESIMULATOR_H__
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class ParticleSystem;
+class ThreadPool;
+
+/**
+ * @addtogroup particle_nodes
+ * @{
+ */
+
+/** @brief Simulates the particle systems of the frame on a pool of worker threads.
+
+ When it is enabled, ParticleSystem::update() only queues the system. Director::drawScene() calls
+ update() once the scheduler has run: the queued systems are simulated in parallel, then their quads
+ are uploaded and the finished systems are removed on the calling (GL) thread.
+
+ Each system only touches its own particles and quads, and uses its own random generator:
+ the results don't depend on the number of threads. ParticleSystem::updateParticleQuads()
+ is called from the worker threads: overrides of it must not touch anything but the system itself.
+ The systems of a ParticleBatchNode share its texture atlas: they are simulated one after the
+ other on the calling thread, once the worker threads are done.
+
+ It is disabled by default. It can be enabled with setEnabled() or with the
+ "cocos2d.x.parallel_particles" key of the Configuration.
+ @since v3.0
+ */
+class CC_DLL ParticleSimulator
+{
+public:
+    ParticleSimulator();
+    ~ParticleSimulator();
+
+    inline bool isEnabled() const { return _enabled; }
+    void setEnabled(bool enabled);
+
+    /** Sets the number of worker threads. 0 uses ThreadPool::getDefaultThreadCount() */
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+
+    /** Queues the simulation of system for dt seconds. The system is retained until update() */
+    void addSystem(ParticleSystem* system, float dt);
+
+    /** Simulates the queued systems, then ends their update on the calling thread */
+    void update();
+
+    /** Number of systems simulated by the last update() */
+    inline int getSystemCount() const { return _lastSystemCount; }
+
+protected:
+    struct Simulation
+    {
+        ParticleSystem* system;
+        float dt;
+        bool alive;
+    };
+
+    void endSimulation(Simulation& simulation);
+
+    bool _enabled;
+    int _threadCount;
+    ThreadPool* _threadPool;
+
+    std::vector<Simulation> _simulations;
+    int _lastSystemCount;
+};
+
+// end of particle_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPARTICLESIMULATOR_H__
@@ -54,10 +54,21 @@ THE SOFTWARE.
 #include "platform/CCImage.h"
 #include "support/zip_support/ZipUtils.h"
 #include "CCDirector.h"
+#include "CCParticleSimulator.h"
 #include "support/CCProfiling.h"
 // opengl
 #include "CCGL.h"
 
+#include <stdint.h>
+
+#if CC_USE_PARTICLE_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CC_PARTICLE_SIMD_SSE 1
+#include <emmintrin.h>
+#elif CC_USE_PARTICLE_SIMD && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define CC_PARTICLE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
 
@@ -80,12 +91,354 @@ NS_CC_BEGIN
 //  cocos2d uses a another approach, but the results are almost identical. 
 //
 
+// The update kernels are written once with these functions, and update WIDTH particles at a time.
+// Without SIMD instructions, they work on single floats.
+namespace {
+
+#if CC_PARTICLE_SIMD_SSE
+
+typedef __m128 Float;
+typedef __m128 Mask;
+const unsigned int WIDTH = 4;
+
+inline Float load(const float *p) { return _mm_load_ps(p); }
+inline void store(float *p, Float v) { _mm_store_ps(p, v); }
+inline Float set(float v) { return _mm_set1_ps(v); }
+inline Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+inline Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+inline Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+inline Float divide(Float a, Float b) { return _mm_div_ps(a, b); }
+inline Float squareRoot(Float a) { return _mm_sqrt_ps(a); }
+inline Float maximum(Float a, Float b) { return _mm_max_ps(a, b); }
+inline Mask greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+inline Float select(Mask m, Float a, Float b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+// Cephes sinf/cosf: the angle is reduced to [-pi/4, pi/4] and the octant selects the polynomial and the signs
+inline void sincos(Float x, Float *s, Float *c)
+{
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+    __m128 signSin = _mm_and_ps(x, signMask);
+    x = _mm_andnot_ps(signMask, x);
+
+    __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+    j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    __m128 y = _mm_cvtepi32_ps(j);
+
+    signSin = _mm_xor_ps(signSin, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+    __m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+    __m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+    __m128 z = _mm_mul_ps(x, x);
+
+    __m128 pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(-1.388731625493765e-3f));
+    pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+    pc = _mm_mul_ps(_mm_mul_ps(pc, z), z);
+    pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+    __m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+    ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(-1.6666654611e-1f));
+    ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), x), x);
+
+    *s = _mm_xor_ps(select(polyMask, ps, pc), signSin);
+    *c = _mm_xor_ps(select(polyMask, pc, ps), signCos);
+}
+
+#elif CC_PARTICLE_SIMD_NEON
+
+typedef float32x4_t Float;
+typedef uint32x4_t Mask;
+const unsigned int WIDTH = 4;
+
+inline Float load(const float *p) { return vld1q_f32(p); }
+inline void store(float *p, Float v) { vst1q_f32(p, v); }
+inline Float set(float v) { return vdupq_n_f32(v); }
+inline Float add(Float a, Float b) { return vaddq_f32(a, b); }
+inline Float sub(Float a, Float b) { return vsubq_f32(a, b); }
+inline Float mul(Float a, Float b) { return vmulq_f32(a, b); }
+inline Float maximum(Float a, Float b) { return vmaxq_f32(a, b); }
+inline Mask greater(Float a, Float b) { return vcgtq_f32(a, b); }
+inline Float select(Mask m, Float a, Float b) { return vbslq_f32(m, a, b); }
+
+// ARMv7 NEON has no division nor square root: the estimates are refined by 2 Newton-Raphson steps
+inline Float divide(Float a, Float b)
+{
+    Float r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+}
+
+inline Float squareRoot(Float a)
+{
+    Float r = vrsqrteq_f32(a);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    // the estimate of 1/sqrt(0) is infinite
+    return select(vcgtq_f32(a, vdupq_n_f32(0)), vmulq_f32(a, r), vdupq_n_f32(0));
+}
+
+// Cephes sinf/cosf: the angle is reduced to [-pi/4, pi/4] and the octant selects the polynomial and the signs
+inline void sincos(Float x, Float *s, Float *c)
+{
+    uint32x4_t signSin = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000));
+    x = vabsq_f32(x);
+
+    int32x4_t j = vcvtq_s32_f32(vmulq_f32(x, vdupq_n_f32(1.27323954473516f)));
+    j = vandq_s32(vaddq_s32(j, vdupq_n_s32(1)), vdupq_n_s32(~1));
+    float32x4_t y = vcvtq_f32_s32(j);
+
+    signSin = veorq_u32(signSin, vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(j, vdupq_n_s32(4))), 29));
+    uint32x4_t signCos = vshlq_n_u32(vreinterpretq_u32_s32(vbicq_s32(vdupq_n_s32(4), vsubq_s32(j, vdupq_n_s32(2)))), 29);
+    uint32x4_t polyMask = vceqq_s32(vandq_s32(j, vdupq_n_s32(2)), vdupq_n_s32(0));
+
+    x = vsubq_f32(x, vmulq_f32(y, vdupq_n_f32(0.78515625f)));
+    x = vsubq_f32(x, vmulq_f32(y, vdupq_n_f32(2.4187564849853515625e-4f)));
+    x = vsubq_f32(x, vmulq_f32(y, vdupq_n_f32(3.77489497744594108e-8f)));
+    float32x4_t z = vmulq_f32(x, x);
+
+    float32x4_t pc = vaddq_f32(vmulq_f32(vdupq_n_f32(2.443315711809948e-5f), z), vdupq_n_f32(-1.388731625493765e-3f));
+    pc = vaddq_f32(vmulq_f32(pc, z), vdupq_n_f32(4.166664568298827e-2f));
+    pc = vmulq_f32(vmulq_f32(pc, z), z);
+    pc = vaddq_f32(vsubq_f32(pc, vmulq_f32(z, vdupq_n_f32(0.5f))), vdupq_n_f32(1.0f));
+
+    float32x4_t ps = vaddq_f32(vmulq_f32(vdupq_n_f32(-1.9515295891e-4f), z), vdupq_n_f32(8.3321608736e-3f));
+    ps = vaddq_f32(vmulq_f32(ps, z), vdupq_n_f32(-1.6666654611e-1f));
+    ps = vaddq_f32(vmulq_f32(vmulq_f32(ps, z), x), x);
+
+    *s = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(polyMask, ps, pc)), signSin));
+    *c = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(polyMask, pc, ps)), signCos));
+}
+
+#else
+
+typedef float Float;
+typedef bool Mask;
+const unsigned int WIDTH = 1;
+
+inline Float load(const float *p) { return *p; }
+inline void store(float *p, Float v) { *p = v; }
+inline Float set(float v) { return v; }
+inline Float add(Float a, Float b) { return a + b; }
+inline Float sub(Float a, Float b) { return a - b; }
+inline Float mul(Float a, Float b) { return a * b; }
+inline Float divide(Float a, Float b) { return a / b; }
+inline Float squareRoot(Float a) { return sqrtf(a); }
+inline Float maximum(Float a, Float b) { return a > b ? a : b; }
+inline Mask greater(Float a, Float b) { return a > b; }
+inline Float select(Mask m, Float a, Float b) { return m ? a : b; }
+
+inline void sincos(Float x, Float *s, Float *c)
+{
+    *s = sinf(x);
+    *c = cosf(x);
+}
+
+#endif
+
+// the arrays of ParticleData are padded: the last particles are updated with the padding
+inline unsigned int roundToWidth(unsigned int count)
+{
+    return (count + WIDTH - 1) / WIDTH * WIDTH;
+}
+
+void updateLife(ParticleData& data, unsigned int begin, unsigned int end, float dt)
+{
+    const Float delta = set(dt);
+    for (unsigned int i = begin; i < end; i += WIDTH)
+    {
+        store(data.timeToLive + i, sub(load(data.timeToLive + i), delta));
+    }
+}
+
+// Mode A: gravity, direction, tangential accel & radial accel
+void updateGravityMode(ParticleData& data, unsigned int begin, unsigned int end, float dt, const Point& gravity)
+{
+    const Float delta = set(dt);
+    const Float gravityX = set(gravity.x);
+    const Float gravityY = set(gravity.y);
+    const Float zero = set(0);
+
+    for (unsigned int i = begin; i < end; i += WIDTH)
+    {
+        Float x = load(data.posx + i);
+        Float y = load(data.posy + i);
+
+        // radial direction, none at the origin
+        Float length = squareRoot(add(mul(x, x), mul(y, y)));
+        Mask notAtOrigin = greater(length, zero);
+        Float radialX = select(notAtOrigin, divide(x, length), zero);
+        Float radialY = select(notAtOrigin, divide(y, length), zero);
+
+        // (gravity + radial + tangential) * dt, the tangential direction is the radial one rotated by 90 degrees
+        Float radialAccel = load(data.modeA.radialAccel + i);
+        Float tangentialAccel = load(data.modeA.tangentialAccel + i);
+        Float accelX = add(sub(mul(radialX, radialAccel), mul(radialY, tangentialAccel)), gravityX);
+        Float accelY = add(add(mul(radialY, radialAccel), mul(radialX, tangentialAccel)), gravityY);
+
+        Float dirX = add(load(data.modeA.dirX + i), mul(accelX, delta));
+        Float dirY = add(load(data.modeA.dirY + i), mul(accelY, delta));
+        store(data.modeA.dirX + i, dirX);
+        store(data.modeA.dirY + i, dirY);
+
+        store(data.posx + i, add(x, mul(dirX, delta)));
+        store(data.posy + i, add(y, mul(dirY, delta)));
+    }
+}
+
+// Mode B: radius movement
+void updateRadiusMode(ParticleData& data, unsigned int begin, unsigned int end, float dt)
+{
+    const Float delta = set(dt);
+    const Float zero = set(0);
+
+    for (unsigned int i = begin; i < end; i += WIDTH)
+    {
+        // Update the angle and radius of the particle.
+        Float angle = add(load(data.modeB.angle + i), mul(load(data.modeB.degreesPerSecond + i), delta));
+        Float radius = add(load(data.modeB.radius + i), mul(load(data.modeB.deltaRadius + i), delta));
+        store(data.modeB.angle + i, angle);
+        store(data.modeB.radius + i, radius);
+
+        Float s, c;
+        sincos(angle, &s, &c);
+        store(data.posx + i, sub(zero, mul(c, radius)));
+        store(data.posy + i, sub(zero, mul(s, radius)));
+    }
+}
+
+// color, size and angle
+void updateAppearance(ParticleData& data, unsigned int begin, unsigned int end, float dt)
+{
+    const Float delta = set(dt);
+    const Float zero = set(0);
+
+    for (unsigned int i = begin; i < end; i += WIDTH)
+    {
+        store(data.colorR + i, add(load(data.colorR + i), mul(load(data.deltaColorR + i), delta)));
+        store(data.colorG + i, add(load(data.colorG + i), mul(load(data.deltaColorG + i), delta)));
+        store(data.colorB + i, add(load(data.colorB + i), mul(load(data.deltaColorB + i), delta)));
+        store(data.colorA + i, add(load(data.colorA + i), mul(load(data.deltaColorA + i), delta)));
+
+        store(data.size + i, maximum(zero, add(load(data.size + i), mul(load(data.deltaSize + i), delta))));
+
+        store(data.rotation + i, add(load(data.rotation + i), mul(load(data.deltaRotation + i), delta)));
+    }
+}
+
+} // namespace
+
+// ParticleData
+
+// number of float arrays, atlasIndex included
+static const int kParticleDataArrays = 26;
+
+ParticleData::ParticleData()
+: maxCount(0)
+, _buffer(NULL)
+{
+    memset(&modeA, 0, sizeof(modeA));
+    memset(&modeB, 0, sizeof(modeB));
+    posx = posy = startPosX = startPosY = NULL;
+    colorR = colorG = colorB = colorA = NULL;
+    deltaColorR = deltaColorG = deltaColorB = deltaColorA = NULL;
+    size = deltaSize = rotation = deltaRotation = timeToLive = NULL;
+    atlasIndex = NULL;
+}
+
+ParticleData::~ParticleData()
+{
+    release();
+}
+
+bool ParticleData::init(unsigned int count)
+{
+    // arrays of 16 bytes aligned floats, padded to a multiple of 4
+    const size_t arraySize = ((count + 3) & ~3u) * sizeof(float);
+    void *buffer = calloc(kParticleDataArrays * arraySize + 15, 1);
+    if (! buffer)
+    {
+        return false;
+    }
+
+    release();
+    _buffer = buffer;
+    maxCount = count;
+
+    char *array = (char*)(((uintptr_t)buffer + 15) & ~(uintptr_t)15);
+    float **arrays[kParticleDataArrays - 1] = {
+        &posx, &posy, &startPosX, &startPosY,
+        &colorR, &colorG, &colorB, &colorA,
+        &deltaColorR, &deltaColorG, &deltaColorB, &deltaColorA,
+        &size, &deltaSize, &rotation, &deltaRotation, &timeToLive,
+        &modeA.dirX, &modeA.dirY, &modeA.radialAccel, &modeA.tangentialAccel,
+        &modeB.angle, &modeB.degreesPerSecond, &modeB.radius, &modeB.deltaRadius,
+    };
+    for (int i = 0; i < kParticleDataArrays - 1; ++i, array += arraySize)
+    {
+        *arrays[i] = (float*)array;
+    }
+    atlasIndex = (unsigned int*)array;
+
+    return true;
+}
+
+void ParticleData::release()
+{
+    CC_SAFE_FREE(_buffer);
+    maxCount = 0;
+}
+
+void ParticleData::copyParticle(unsigned int dst, unsigned int src)
+{
+    posx[dst] = posx[src];
+    posy[dst] = posy[src];
+    startPosX[dst] = startPosX[src];
+    startPosY[dst] = startPosY[src];
+
+    colorR[dst] = colorR[src];
+    colorG[dst] = colorG[src];
+    colorB[dst] = colorB[src];
+    colorA[dst] = colorA[src];
+
+    deltaColorR[dst] = deltaColorR[src];
+    deltaColorG[dst] = deltaColorG[src];
+    deltaColorB[dst] = deltaColorB[src];
+    deltaColorA[dst] = deltaColorA[src];
+
+    size[dst] = size[src];
+    deltaSize[dst] = deltaSize[src];
+
+    rotation[dst] = rotation[src];
+    deltaRotation[dst] = deltaRotation[src];
+
+    timeToLive[dst] = timeToLive[src];
+
+    atlasIndex[dst] = atlasIndex[src];
+
+    modeA.dirX[dst] = modeA.dirX[src];
+    modeA.dirY[dst] = modeA.dirY[src];
+    modeA.radialAccel[dst] = modeA.radialAccel[src];
+    modeA.tangentialAccel[dst] = modeA.tangentialAccel[src];
+
+    modeB.angle[dst] = modeB.angle[src];
+    modeB.degreesPerSecond[dst] = modeB.degreesPerSecond[src];
+    modeB.radius[dst] = modeB.radius[src];
+    modeB.deltaRadius[dst] = modeB.deltaRadius[src];
+}
+
+// ParticleSystem
+
 ParticleSystem::ParticleSystem()
 : _isBlendAdditive(false)
 , _isAutoRemoveOnFinish(false)
 , _plistFile("")
 , _elapsed(0)
-, _particles(NULL)
+, _randomState(0)
+, _emitterPosition(Point::ZERO)
+, _simulationIndex(-1)
 , _emitCounter(0)
 , _particleIdx(0)
 , _batchNode(NULL)
@@ -131,6 +484,8 @@ ParticleSystem::ParticleSystem()
     modeB.endRadiusVar = 0;            
     modeB.rotatePerSecond = 0;
     modeB.rotatePerSecondVar = 0;
+
+    setRandomSeed(rand());
 }
 // implementation ParticleSystem
 
@@ -391,11 +746,7 @@ bool ParticleSystem::initWithTotalParticles(unsigned int numberOfParticles)
 {
     _totalParticles = numberOfParticles;
 
-    CC_SAFE_FREE(_particles);
-    
-    _particles = (tParticle*)calloc(_totalParticles, sizeof(tParticle));
-
-    if( ! _particles )
+    if( ! _particleData.init(_totalParticles) )
     {
         CCLOG("Particle system: not enough memory");
         this->release();
@@ -407,7 +758,7 @@ bool ParticleSystem::initWithTotalParticles(unsigned int numberOfParticles)
     {
         for (unsigned int i = 0; i < _totalParticles; i++)
         {
-            _particles[i].atlasIndex=i;
+            _particleData.atlasIndex[i] = i;
         }
     }
     // default, active
@@ -444,7 +795,6 @@ ParticleSystem::~ParticleSystem()
     // Since the scheduler retains the "target (in this case the ParticleSystem)
 	// it is not needed to call "unscheduleUpdate" here. In fact, it will be called in "cleanup"
     //unscheduleUpdate();
-    CC_SAFE_FREE(_particles);
     CC_SAFE_RELEASE(_texture);
 }
 
@@ -455,125 +805,180 @@ bool ParticleSystem::addParticle()
         return false;
     }
 
-    tParticle * particle = &_particles[ _particleCount ];
-    this->initParticle(particle);
-    ++_particleCount;
+    _emitterPosition = computeEmitterPosition();
+    this->addParticles(1);
 
     return true;
 }
 
-void ParticleSystem::initParticle(tParticle* particle)
+void ParticleSystem::addParticles(unsigned int count)
 {
+    CCASSERT(_particleCount + count <= _totalParticles, "ParticleSystem: not enough room for the particles");
+
+    const unsigned int start = _particleCount;
+    const unsigned int end = _particleCount + count;
+    _particleCount = end;
+
+    // Each value is initialized for all the new particles at once
+    ParticleData& p = _particleData;
+
     // timeToLive
     // no negative life. prevent division by 0
-    particle->timeToLive = _life + _lifeVar * CCRANDOM_MINUS1_1();
-    particle->timeToLive = MAX(0, particle->timeToLive);
+    for (unsigned int i = start; i < end; ++i)
+    {
+        float timeToLive = _life + _lifeVar * randomMinus1To1();
+        p.timeToLive[i] = MAX(0, timeToLive);
+    }
 
     // position
-    particle->pos.x = _sourcePosition.x + _posVar.x * CCRANDOM_MINUS1_1();
+    for (unsigned int i = start; i < end; ++i)
+    {
+        p.posx[i] = _sourcePosition.x + _posVar.x * randomMinus1To1();
+    }
+    for (unsigned int i = start; i < end; ++i)
+    {
+        p.posy[i] = _sourcePosition.y + _posVar.y * randomMinus1To1();
+    }
 
-    particle->pos.y = _sourcePosition.y + _posVar.y * CCRANDOM_MINUS1_1();
+    // Color
+#define CC_INIT_PARTICLE_COLOR(c, b, v)                                              \
+    for (unsigned int i = start; i < end; ++i)                                      \
+    {                                                                               \
+        c[i] = clampf(b + v * randomMinus1To1(), 0, 1);                           \
+    }
+#define CC_INIT_PARTICLE_DELTA_COLOR(c, dc, b, v)                                    \
+    for (unsigned int i = start; i < end; ++i)                                      \
+    {                                                                               \
+        dc[i] = (clampf(b + v * randomMinus1To1(), 0, 1) - c[i]) / p.timeToLive[i]; \
+    }
 
+    CC_INIT_PARTICLE_COLOR(p.colorR, _startColor.r, _startColorVar.r);
+    CC_INIT_PARTICLE_COLOR(p.colorG, _startColor.g, _startColorVar.g);
+    CC_INIT_PARTICLE_COLOR(p.colorB, _startColor.b, _startColorVar.b);
+    CC_INIT_PARTICLE_COLOR(p.colorA, _startColor.a, _startColorVar.a);
 
-    // Color
-    Color4F start;
-    start.r = clampf(_startColor.r + _startColorVar.r * CCRANDOM_MINUS1_1(), 0, 1);
-    start.g = clampf(_startColor.g + _startColorVar.g * CCRANDOM_MINUS1_1(), 0, 1);
-    start.b = clampf(_startColor.b + _startColorVar.b * CCRANDOM_MINUS1_1(), 0, 1);
-    start.a = clampf(_startColor.a + _startColorVar.a * CCRANDOM_MINUS1_1(), 0, 1);
-
-    Color4F end;
-    end.r = clampf(_endColor.r + _endColorVar.r * CCRANDOM_MINUS1_1(), 0, 1);
-    end.g = clampf(_endColor.g + _endColorVar.g * CCRANDOM_MINUS1_1(), 0, 1);
-    end.b = clampf(_endColor.b + _endColorVar.b * CCRANDOM_MINUS1_1(), 0, 1);
-    end.a = clampf(_endColor.a + _endColorVar.a * CCRANDOM_MINUS1_1(), 0, 1);
-
-    particle->color = start;
-    particle->deltaColor.r = (end.r - start.r) / particle->timeToLive;
-    particle->deltaColor.g = (end.g - start.g) / particle->timeToLive;
-    particle->deltaColor.b = (end.b - start.b) / particle->timeToLive;
-    particle->deltaColor.a = (end.a - start.a) / particle->timeToLive;
+    CC_INIT_PARTICLE_DELTA_COLOR(p.colorR, p.deltaColorR, _endColor.r, _endColorVar.r);
+    CC_INIT_PARTICLE_DELTA_COLOR(p.colorG, p.deltaColorG, _endColor.g, _endColorVar.g);
+    CC_INIT_PARTICLE_DELTA_COLOR(p.colorB, p.deltaColorB, _endColor.b, _endColorVar.b);
+    CC_INIT_PARTICLE_DELTA_COLOR(p.colorA, p.deltaColorA, _endColor.a, _endColorVar.a);
 
-    // size
-    float startS = _startSize + _startSizeVar * CCRANDOM_MINUS1_1();
-    startS = MAX(0, startS); // No negative value
+#undef CC_INIT_PARTICLE_COLOR
+#undef CC_INIT_PARTICLE_DELTA_COLOR
 
-    particle->size = startS;
+    // size
+    for (unsigned int i = start; i < end; ++i)
+    {
+        float startS = _startSize + _startSizeVar * randomMinus1To1();
+        p.size[i] = MAX(0, startS); // No negative value
+    }
 
     if (_endSize == START_SIZE_EQUAL_TO_END_SIZE)
     {
-        particle->deltaSize = 0;
+        for (unsigned int i = start; i < end; ++i)
+        {
+            p.deltaSize[i] = 0;
+        }
     }
     else
     {
-        float endS = _endSize + _endSizeVar * CCRANDOM_MINUS1_1();
-        endS = MAX(0, endS); // No negative values
-        particle->deltaSize = (endS - startS) / particle->timeToLive;
+        for (unsigned int i = start; i < end; ++i)
+        {
+            float endS = _endSize + _endSizeVar * randomMinus1To1();
+            endS = MAX(0, endS); // No negative values
+            p.deltaSize[i] = (endS - p.size[i]) / p.timeToLive[i];
+        }
     }
 
     // rotation
-    float startA = _startSpin + _startSpinVar * CCRANDOM_MINUS1_1();
-    float endA = _endSpin + _endSpinVar * CCRANDOM_MINUS1_1();
-    particle->rotation = startA;
-    particle->deltaRotation = (endA - startA) / particle->timeToLive;
-
-    // position
-    if (_positionType == PositionType::FREE)
+    for (unsigned int i = start; i < end; ++i)
     {
-        particle->startPos = this->convertToWorldSpace(Point::ZERO);
+        float startA = _startSpin + _startSpinVar * randomMinus1To1();
+        float endA = _endSpin + _endSpinVar * randomMinus1To1();
+        p.rotation[i] = startA;
+        p.deltaRotation[i] = (endA - startA) / p.timeToLive[i];
     }
-    else if (_positionType == PositionType::RELATIVE)
+
+    // position
+    for (unsigned int i = start; i < end; ++i)
     {
-        particle->startPos = _position;
+        p.startPosX[i] = _emitterPosition.x;
+        p.startPosY[i] = _emitterPosition.y;
     }
 
-    // direction
-    float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * CCRANDOM_MINUS1_1() );    
-
     // Mode Gravity: A
     if (_emitterMode == Mode::GRAVITY)
     {
-        Point v(cosf( a ), sinf( a ));
-        float s = modeA.speed + modeA.speedVar * CCRANDOM_MINUS1_1();
-
-        // direction
-        particle->modeA.dir = v * s ;
+        for (unsigned int i = start; i < end; ++i)
+        {
+            // direction
+            float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * randomMinus1To1() );
+            Point v(cosf( a ), sinf( a ));
+            float s = modeA.speed + modeA.speedVar * randomMinus1To1();
+            p.modeA.dirX[i] = v.x * s;
+            p.modeA.dirY[i] = v.y * s;
+        }
 
         // radial accel
-        particle->modeA.radialAccel = modeA.radialAccel + modeA.radialAccelVar * CCRANDOM_MINUS1_1();
- 
+        for (unsigned int i = start; i < end; ++i)
+        {
+            p.modeA.radialAccel[i] = modeA.radialAccel + modeA.radialAccelVar * randomMinus1To1();
+        }
 
         // tangential accel
-        particle->modeA.tangentialAccel = modeA.tangentialAccel + modeA.tangentialAccelVar * CCRANDOM_MINUS1_1();
+        for (unsigned int i = start; i < end; ++i)
+        {
+            p.modeA.tangentialAccel[i] = modeA.tangentialAccel + modeA.tangentialAccelVar * randomMinus1To1();
+        }
 
         // rotation is dir
         if(modeA.rotationIsDir)
-            particle->rotation = -CC_RADIANS_TO_DEGREES(particle->modeA.dir.getAngle());
+        {
+            for (unsigned int i = start; i < end; ++i)
+            {
+                p.rotation[i] = -CC_RADIANS_TO_DEGREES(Point(p.modeA.dirX[i], p.modeA.dirY[i]).getAngle());
+            }
+        }
     }
 
     // Mode Radius: B
     else 
     {
         // Set the default diameter of the particle from the source position
-        float startRadius = modeB.startRadius + modeB.startRadiusVar * CCRANDOM_MINUS1_1();
-        float endRadius = modeB.endRadius + modeB.endRadiusVar * CCRANDOM_MINUS1_1();
-
-        particle->modeB.radius = startRadius;
+        for (unsigned int i = start; i < end; ++i)
+        {
+            p.modeB.radius[i] = modeB.startRadius + modeB.startRadiusVar * randomMinus1To1();
+        }
 
         if (modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
         {
-            particle->modeB.deltaRadius = 0;
+            for (unsigned int i = start; i < end; ++i)
+            {
+                p.modeB.deltaRadius[i] = 0;
+            }
         }
         else
         {
-            particle->modeB.deltaRadius = (endRadius - startRadius) / particle->timeToLive;
+            for (unsigned int i = start; i < end; ++i)
+            {
+                float endRadius = modeB.endRadius + modeB.endRadiusVar * randomMinus1To1();
+                p.modeB.deltaRadius[i] = (endRadius - p.modeB.radius[i]) / p.timeToLive[i];
+            }
         }
 
-        particle->modeB.angle = a;
-        particle->modeB.degreesPerSecond = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * CCRANDOM_MINUS1_1());
+        for (unsigned int i = start; i < end; ++i)
+        {
+            p.modeB.angle[i] = CC_DEGREES_TO_RADIANS( _angle + _angleVar * randomMinus1To1() );
+            p.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * randomMinus1To1());
+        }
     }    
 }
 
+void ParticleSystem::setRandomSeed(unsigned int seed)
+{
+    // xorshift gets stuck at 0
+    _randomState = seed ? seed : 0x9e3779b9;
+}
+
 void ParticleSystem::stopSystem()
 {
     _isActive = false;
@@ -587,8 +992,7 @@ void ParticleSystem::resetSystem()
     _elapsed = 0;
     for (_particleIdx = 0; _particleIdx < _particleCount; ++_particleIdx)
     {
-        tParticle *p = &_particles[_particleIdx];
-        p->timeToLive = 0;
+        _particleData.timeToLive[_particleIdx] = 0;
     }
 }
 bool ParticleSystem::isFull()
@@ -601,6 +1005,37 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    // the parents are read here, the simulation may run on a worker thread
+    _emitterPosition = computeEmitterPosition();
+
+    ParticleSimulator *simulator = Director::getInstance()->getParticleSimulator();
+    if (simulator->isEnabled())
+    {
+        simulator->addSystem(this, dt);
+    }
+    else
+    {
+        endUpdate(simulate(dt));
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+Point ParticleSystem::computeEmitterPosition()
+{
+    if (_positionType == PositionType::FREE)
+    {
+        return this->convertToWorldSpace(Point::ZERO);
+    }
+    else if (_positionType == PositionType::RELATIVE)
+    {
+        return _position;
+    }
+    return Point::ZERO;
+}
+
+bool ParticleSystem::simulate(float dt)
+{
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -610,11 +1045,13 @@ void ParticleSystem::update(float dt)
             _emitCounter += dt;
         }
         
-        while (_particleCount < _totalParticles && _emitCounter > rate) 
+        unsigned int emitCount = 0;
+        while (_particleCount + emitCount < _totalParticles && _emitCounter > rate) 
         {
-            this->addParticle();
+            ++emitCount;
             _emitCounter -= rate;
         }
+        this->addParticles(emitCount);
 
         _elapsed += dt;
         if (_duration != -1 && _duration < _elapsed)
@@ -623,147 +1060,81 @@ void ParticleSystem::update(float dt)
         }
     }
 
-    _particleIdx = 0;
-
-    Point currentPosition = Point::ZERO;
-    if (_positionType == PositionType::FREE)
-    {
-        currentPosition = this->convertToWorldSpace(Point::ZERO);
-    }
-    else if (_positionType == PositionType::RELATIVE)
-    {
-        currentPosition = _position;
-    }
-
     if (_visible)
     {
+        // life
+        updateLife(_particleData, 0, roundToWidth(_particleCount), dt);
+
+        // remove the dead particles: the last particle takes their place
+        _particleIdx = 0;
         while (_particleIdx < _particleCount)
         {
-            tParticle *p = &_particles[_particleIdx];
-
-            // life
-            p->timeToLive -= dt;
-
-            if (p->timeToLive > 0) 
+            if (_particleData.timeToLive[_particleIdx] > 0)
             {
-                // Mode A: gravity, direction, tangential accel & radial accel
-                if (_emitterMode == Mode::GRAVITY)
-                {
-                    Point tmp, radial, tangential;
-
-                    radial = Point::ZERO;
-                    // radial acceleration
-                    if (p->pos.x || p->pos.y)
-                    {
-                        radial = p->pos.normalize();
-                    }
-                    tangential = radial;
-                    radial = radial * p->modeA.radialAccel;
-
-                    // tangential acceleration
-                    float newy = tangential.x;
-                    tangential.x = -tangential.y;
-                    tangential.y = newy;
-                    tangential = tangential * p->modeA.tangentialAccel;
-
-                    // (gravity + radial + tangential) * dt
-                    tmp = radial + tangential + modeA.gravity;
-                    tmp = tmp * dt;
-                    p->modeA.dir = p->modeA.dir + tmp;
-                    tmp = p->modeA.dir * dt;
-                    p->pos = p->pos + tmp;
-                }
-
-                // Mode B: radius movement
-                else 
-                {                
-                    // Update the angle and radius of the particle.
-                    p->modeB.angle += p->modeB.degreesPerSecond * dt;
-                    p->modeB.radius += p->modeB.deltaRadius * dt;
-
-                    p->pos.x = - cosf(p->modeB.angle) * p->modeB.radius;
-                    p->pos.y = - sinf(p->modeB.angle) * p->modeB.radius;
-                }
-
-                // color
-                p->color.r += (p->deltaColor.r * dt);
-                p->color.g += (p->deltaColor.g * dt);
-                p->color.b += (p->deltaColor.b * dt);
-                p->color.a += (p->deltaColor.a * dt);
-
-                // size
-                p->size += (p->deltaSize * dt);
-                p->size = MAX( 0, p->size );
-
-                // angle
-                p->rotation += (p->deltaRotation * dt);
-
-                //
-                // update values in quad
-                //
-
-                Point    newPos;
+                ++_particleIdx;
+                continue;
+            }
 
-                if (_positionType == PositionType::FREE || _positionType == PositionType::RELATIVE)
-                {
-                    Point diff = currentPosition - p->startPos;
-                    newPos = p->pos - diff;
-                } 
-                else
-                {
-                    newPos = p->pos;
-                }
+            // life < 0
+            unsigned int currentIndex = _particleData.atlasIndex[_particleIdx];
+            if( _particleIdx != _particleCount-1 )
+            {
+                _particleData.copyParticle(_particleIdx, _particleCount-1);
+            }
+            if (_batchNode)
+            {
+                //disable the switched particle
+                _batchNode->disableParticle(_atlasIndex+currentIndex);
 
-                // translate newPos to correct position, since matrix transform isn't performed in batchnode
-                // don't update the particle with the new position information, it will interfere with the radius and tangential calculations
-                if (_batchNode)
-                {
-                    newPos.x+=_position.x;
-                    newPos.y+=_position.y;
-                }
+                //switch indexes
+                _particleData.atlasIndex[_particleCount-1] = currentIndex;
+            }
 
-                updateQuadWithParticle(p, newPos);
-                //updateParticleImp(self, updateParticleSel, p, newPos);
+            --_particleCount;
 
-                // update particle counter
-                ++_particleIdx;
-            } 
-            else 
+            if( _particleCount == 0 && _isAutoRemoveOnFinish )
             {
-                // life < 0
-                int currentIndex = p->atlasIndex;
-                if( _particleIdx != _particleCount-1 )
-                {
-                    _particles[_particleIdx] = _particles[_particleCount-1];
-                }
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    _batchNode->disableParticle(_atlasIndex+currentIndex);
-
-                    //switch indexes
-                    _particles[_particleCount-1].atlasIndex = currentIndex;
-                }
+                return false;
+            }
+        }
 
+        // simulate the living particles, several at a time
+        const unsigned int end = roundToWidth(_particleCount);
+        if (_emitterMode == Mode::GRAVITY)
+        {
+            updateGravityMode(_particleData, 0, end, dt, modeA.gravity);
+        }
+        else
+        {
+            updateRadiusMode(_particleData, 0, end, dt);
+        }
+        updateAppearance(_particleData, 0, end, dt);
 
-                --_particleCount;
+        // update values in quads
+        updateParticleQuads();
 
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        } //while
         _transformSystemDirty = false;
     }
+
+    return true;
+}
+
+void ParticleSystem::endUpdate(bool alive)
+{
+    if (! alive)
+    {
+        this->unscheduleUpdate();
+        if (_parent)
+        {
+            _parent->removeChild(this, true);
+        }
+        return;
+    }
+
     if (! _batchNode)
     {
         postStep();
     }
-
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 }
 
 void ParticleSystem::updateWithNoTime(void)
@@ -771,10 +1142,8 @@ void ParticleSystem::updateWithNoTime(void)
     this->update(0.0f);
 }
 
-void ParticleSystem::updateQuadWithParticle(tParticle* particle, const Point& newPosition)
+void ParticleSystem::updateParticleQuads()
 {
-    CC_UNUSED_PARAM(particle);
-    CC_UNUSED_PARAM(newPosition);
     // should be overridden
 }
 
@@ -1072,7 +1441,7 @@ void ParticleSystem::setBatchNode(ParticleBatchNode* batchNode)
             //each particle needs a unique index
             for (unsigned int i = 0; i < _totalParticles; i++)
             {
-                _particles[i].atlasIndex=i;
+                _particleData.atlasIndex[i] = i;
             }
         }
     }
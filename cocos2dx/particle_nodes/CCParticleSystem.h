@@ -39,45 +39,77 @@ NS_CC_BEGIN
  */
 
 class ParticleBatchNode;
+class ParticleSimulator;
 
-/**
-Structure that contains the values of each particle
+/** @brief Structure of arrays that contains the values of the particles.
+Each value has its own array, aligned on 16 bytes and padded to a multiple of 4 particles,
+so that the particles can be updated by the SIMD instructions.
+@since v3.0
 */
-typedef struct sParticle {
-    Point     pos;
-    Point     startPos;
+class CC_DLL ParticleData
+{
+public:
+    ParticleData();
+    ~ParticleData();
+
+    /** allocates the arrays for count particles, with all the values set to 0.
+     The previous arrays are kept if there isn't enough memory.
+     */
+    bool init(unsigned int count);
+    /** frees the arrays */
+    void release();
+    /** copies all the values of the particle src to the particle dst */
+    void copyParticle(unsigned int dst, unsigned int src);
+
+    float *posx;
+    float *posy;
+    float *startPosX;
+    float *startPosY;
 
-    Color4F    color;
-    Color4F    deltaColor;
+    float *colorR;
+    float *colorG;
+    float *colorB;
+    float *colorA;
 
-    float        size;
-    float        deltaSize;
+    float *deltaColorR;
+    float *deltaColorG;
+    float *deltaColorB;
+    float *deltaColorA;
 
-    float        rotation;
-    float        deltaRotation;
+    float *size;
+    float *deltaSize;
 
-    float        timeToLive;
+    float *rotation;
+    float *deltaRotation;
 
-    unsigned int    atlasIndex;
+    float *timeToLive;
+
+    unsigned int *atlasIndex;
 
     //! Mode A: gravity, direction, radial accel, tangential accel
     struct {
-        Point        dir;
-        float        radialAccel;
-        float        tangentialAccel;
+        float *dirX;
+        float *dirY;
+        float *radialAccel;
+        float *tangentialAccel;
     } modeA;
 
     //! Mode B: radius mode
     struct {
-        float        angle;
-        float        degreesPerSecond;
-        float        radius;
-        float        deltaRadius;
+        float *angle;
+        float *degreesPerSecond;
+        float *radius;
+        float *deltaRadius;
     } modeB;
 
-}tParticle;
+    //! Number of allocated particles
+    unsigned int maxCount;
+
+private:
+    CC_DISABLE_COPY(ParticleData);
 
-//typedef void (*CC_UPDATE_PARTICLE_IMP)(id, SEL, tParticle*, Point);
+    void *_buffer;
+};
 
 class Texture2D;
 
@@ -199,8 +231,11 @@ public:
 
     //! Add a particle to the emitter
     bool addParticle();
-    //! Initializes a particle
-    void initParticle(tParticle* particle);
+    /** Adds and initializes count particles at the position of the emitter computed by the last update().
+     There must be room for them.
+     @since v3.0
+     */
+    void addParticles(unsigned int count);
     //! stop emitting particles. Running particles will continue to run until they die
     void stopSystem();
     //! Kill all living particles.
@@ -208,8 +243,19 @@ public:
     //! whether or not the system is full
     bool isFull();
 
-    //! should be overridden by subclasses
-    virtual void updateQuadWithParticle(tParticle* particle, const Point& newPosition);
+    /** Seeds the random generator of the system. Every system has its own generator, so that
+     the systems simulated by ParticleSimulator give the same results whatever the number of threads.
+     By default, the generator is seeded with rand().
+     @since v3.0
+     */
+    void setRandomSeed(unsigned int seed);
+
+    /** Updates the quads of all the living particles. Called once per frame after the particles are simulated,
+     possibly from a worker thread of ParticleSimulator.
+     Should be overridden by subclasses.
+     @since v3.0
+     */
+    virtual void updateParticleQuads();
     //! should be overridden by subclasses
     virtual void postStep();
 
@@ -379,6 +425,26 @@ public:
 protected:
     virtual void updateBlendFunc();
 
+    friend class ParticleSimulator;
+
+    /** Emits, moves and kills the particles, then updates their quads. It only touches the system itself,
+     so that it can run on a worker thread. Returns false if the system is finished and must be removed.
+     */
+    bool simulate(float dt);
+    /** Uploads the quads, or removes the finished system. Called on the GL thread after simulate() */
+    void endUpdate(bool alive);
+    /** Position of the emitter in the space of the particles. Not thread safe */
+    Point computeEmitterPosition();
+
+    //! random float between -1 and 1, from the generator of the system (xorshift)
+    inline float randomMinus1To1()
+    {
+        _randomState ^= _randomState << 13;
+        _randomState ^= _randomState >> 17;
+        _randomState ^= _randomState << 5;
+        return (_randomState >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    }
+
 protected:
     /** whether or not the particles are using blend additive.
      If enabled, the following blending function will be used.
@@ -436,8 +502,17 @@ protected:
         float rotatePerSecondVar;
     } modeB;
 
-    //! Array of particles
-    tParticle *_particles;
+    //! Values of the particles
+    ParticleData _particleData;
+
+    //! State of the random generator of the system
+    unsigned int _randomState;
+
+    //! Position of the emitter computed by update(): the world position when the particles are free
+    Point _emitterPosition;
+
+    //! Index of the system in the queue of ParticleSimulator, -1 if not queued
+    int _simulationIndex;
 
     // color modulate
     //    BOOL colorModulate;
@@ -90,7 +90,7 @@ public:
     // Overrides
     virtual bool initWithTotalParticles(unsigned int numberOfParticles) override;
     virtual void setTexture(Texture2D* texture) override;
-    virtual void updateQuadWithParticle(tParticle* particle, const Point& newPosition) override;
+    virtual void updateParticleQuads() override;
     virtual void postStep() override;
     virtual void draw() override;
     virtual void setBatchNode(ParticleBatchNode* batchNode) override;
@@ -23,14 +23,24 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "CCFileUtils.h"
+#include "CCResourcePack.h"
 #include "CCDirector.h"
 #include "cocoa/CCDictionary.h"
 #include "cocoa/CCString.h"
 #include "CCSAXParser.h"
 #include "support/tinyxml2/tinyxml2.h"
 #include "support/zip_support/unzip.h"
+#include "support/CCFrameProfiler.h"
 #include <stack>
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN)
+// the search paths are listed where the file system is case sensitive, so the listing answers like stat() does
+#define CC_FILEUTILS_LIST_SEARCH_PATHS 1
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#endif
+
 using namespace std;
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC)
@@ -483,6 +493,7 @@ FileUtils::FileUtils()
 
 FileUtils::~FileUtils()
 {
+    removeAllResourcePacks();
     CC_SAFE_RELEASE(_filenameLookupDict);
 }
 
@@ -496,18 +507,42 @@ bool FileUtils::init()
 
 void FileUtils::purgeCachedEntries()
 {
+    std::lock_guard<std::mutex> lock(_pathCacheMutex);
     _fullPathCache.clear();
+    _missingPathCache.clear();
+    _searchPathIndices.clear();
+}
+
+void FileUtils::prewarmFullPathCache(const std::vector<std::string>& filenames)
+{
+    bool found = false;
+    for (auto iter = _searchPathArray.begin(); iter != _searchPathArray.end(); ++iter)
+    {
+        findInSearchPathIndex(*iter, *iter, &found);
+    }
+
+    for (auto iter = filenames.begin(); iter != filenames.end(); ++iter)
+    {
+        fullPathForFilename(iter->c_str());
+    }
 }
 
 unsigned char* FileUtils::getFileData(const char* filename, const char* pszMode, unsigned long * pSize)
 {
+    CC_PROFILE_ZONE(FrameProfiler::ZONE_FILE_READ);
+
     unsigned char * pBuffer = NULL;
     CCASSERT(filename != NULL && pSize != NULL && pszMode != NULL, "Invalid parameters.");
     *pSize = 0;
     do
     {
-        // read the file from hardware
         std::string fullPath = fullPathForFilename(filename);
+
+        // the resource packs are searched first
+        pBuffer = getFileDataFromResourcePack(fullPath, pSize);
+        CC_BREAK_IF(pBuffer);
+
+        // read the file from hardware
         FILE *fp = fopen(fullPath.c_str(), pszMode);
         CC_BREAK_IF(!fp);
         
@@ -531,6 +566,8 @@ unsigned char* FileUtils::getFileData(const char* filename, const char* pszMode,
 
 unsigned char* FileUtils::getFileDataFromZip(const char* pszZipFilePath, const char* filename, unsigned long * pSize)
 {
+    CC_PROFILE_ZONE(FrameProfiler::ZONE_FILE_READ);
+
     unsigned char * pBuffer = NULL;
     unzFile pFile = NULL;
     *pSize = 0;
@@ -570,6 +607,104 @@ unsigned char* FileUtils::getFileDataFromZip(const char* pszZipFilePath, const c
     return pBuffer;
 }
 
+const unsigned char* FileUtils::getMappedFileData(const char* filename, unsigned long* size)
+{
+    CCASSERT(filename != NULL && size != NULL, "Invalid parameters.");
+    *size = 0;
+    if (_resourcePacks.empty())
+    {
+        return NULL;
+    }
+
+    std::string entryName;
+    ResourcePack* pack = getResourcePackForFullPath(fullPathForFilename(filename), &entryName);
+    return pack ? pack->getMappedFileData(entryName, size) : NULL;
+}
+
+bool FileUtils::addResourcePack(const char* filename, const char* mountPath)
+{
+    CCASSERT(filename != NULL && mountPath != NULL, "Invalid parameters.");
+
+    ResourcePack* pack = new ResourcePack();
+    if (! pack->initWithFile(fullPathForFilename(filename)))
+    {
+        delete pack;
+        return false;
+    }
+
+    MountedResourcePack mounted;
+    mounted.pack = pack;
+    mounted.mountPath = mountPath;
+    if (!isAbsolutePath(mounted.mountPath))
+    { // Not an absolute path
+        mounted.mountPath.insert(0, _defaultResRootPath);
+    }
+    if (mounted.mountPath.length() > 0 && mounted.mountPath[mounted.mountPath.length()-1] != '/')
+    {
+        mounted.mountPath += "/";
+    }
+    _resourcePacks.push_back(mounted);
+
+    // the files of the pack hide the ones on the file system
+    purgeCachedEntries();
+    return true;
+}
+
+void FileUtils::removeResourcePack(const char* filename)
+{
+    std::string fullPath = fullPathForFilename(filename);
+    for (auto iter = _resourcePacks.begin(); iter != _resourcePacks.end(); ++iter)
+    {
+        if (iter->pack->getPath() == fullPath)
+        {
+            delete iter->pack;
+            _resourcePacks.erase(iter);
+            purgeCachedEntries();
+            break;
+        }
+    }
+}
+
+void FileUtils::removeAllResourcePacks()
+{
+    for (auto iter = _resourcePacks.begin(); iter != _resourcePacks.end(); ++iter)
+    {
+        delete iter->pack;
+    }
+    _resourcePacks.clear();
+    purgeCachedEntries();
+}
+
+ResourcePack* FileUtils::getResourcePackForFullPath(const std::string& fullPath, std::string* entryName)
+{
+    for (auto iter = _resourcePacks.rbegin(); iter != _resourcePacks.rend(); ++iter)
+    {
+        const std::string& mountPath = iter->mountPath;
+        if (fullPath.length() > mountPath.length() && fullPath.compare(0, mountPath.length(), mountPath) == 0)
+        {
+            std::string name = fullPath.substr(mountPath.length());
+            if (iter->pack->fileExists(name))
+            {
+                *entryName = name;
+                return iter->pack;
+            }
+        }
+    }
+    return NULL;
+}
+
+unsigned char* FileUtils::getFileDataFromResourcePack(const std::string& fullPath, unsigned long* size)
+{
+    if (_resourcePacks.empty())
+    {
+        return NULL;
+    }
+
+    std::string entryName;
+    ResourcePack* pack = getResourcePackForFullPath(fullPath, &entryName);
+    return pack ? pack->getFileData(entryName, size) : NULL;
+}
+
 std::string FileUtils::getNewFilename(const char* filename)
 {
     const char* pszNewFileName = NULL;
@@ -600,6 +735,30 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
     std::string path = searchPath;
     path += file_path;
     path += resolutionDirectory;
+
+    std::string candidate = path;
+    if (candidate.size() && candidate[candidate.size()-1] != '/')
+    {
+        candidate += '/';
+    }
+    candidate += file;
+
+    // the resource packs are searched first
+    if (! _resourcePacks.empty())
+    {
+        std::string entryName;
+        if (getResourcePackForFullPath(candidate, &entryName))
+        {
+            return candidate;
+        }
+    }
+
+    // then the listing of the search path, which avoids a stat() per candidate
+    bool found = false;
+    if (findInSearchPathIndex(searchPath, candidate, &found))
+    {
+        return found ? candidate : "";
+    }
     
     path = getFullPathForDirectoryAndFilename(path, file);
     
@@ -620,11 +779,18 @@ std::string FileUtils::fullPathForFilename(const char* filename)
     }
     
     // Already Cached ?
-    std::map<std::string, std::string>::iterator cacheIter = _fullPathCache.find(filename);
-    if (cacheIter != _fullPathCache.end())
     {
-        //CCLOG("Return full path from cache: %s", cacheIter->second.c_str());
-        return cacheIter->second;
+        std::lock_guard<std::mutex> lock(_pathCacheMutex);
+        std::map<std::string, std::string>::iterator cacheIter = _fullPathCache.find(strFileName);
+        if (cacheIter != _fullPathCache.end())
+        {
+            //CCLOG("Return full path from cache: %s", cacheIter->second.c_str());
+            return cacheIter->second;
+        }
+        if (_missingPathCache.find(strFileName) != _missingPathCache.end())
+        {
+            return strFileName;
+        }
     }
     
     // Get the new file name.
@@ -644,7 +810,8 @@ std::string FileUtils::fullPathForFilename(const char* filename)
             if (fullpath.length() > 0)
             {
                 // Using the filename passed in as key.
-                _fullPathCache.insert(std::pair<std::string, std::string>(filename, fullpath));
+                std::lock_guard<std::mutex> lock(_pathCacheMutex);
+                _fullPathCache.insert(std::pair<std::string, std::string>(strFileName, fullpath));
 //                CCLOG("Returning path: %s\n", fullpath.c_str());
                 return fullpath;
             }
@@ -654,9 +821,113 @@ std::string FileUtils::fullPathForFilename(const char* filename)
 //    CCLOG("cocos2d: fullPathForFilename: No file found at %s. Possible missing file.", filename);
 
     // The file wasn't found, return the file name passed in.
+    std::lock_guard<std::mutex> lock(_pathCacheMutex);
+    _missingPathCache.insert(strFileName);
     return filename;
 }
 
+#if CC_FILEUTILS_LIST_SEARCH_PATHS
+// Lists the files and directories under a directory, recursively. It gives up on huge or deep trees.
+static bool listDirectory(const std::string& dirPath, const std::string& prefix, int depth, std::unordered_set<std::string>* files)
+{
+    static const int MAX_DEPTH = 32;
+    static const size_t MAX_FILES = 65536;
+
+    if (depth > MAX_DEPTH)
+    {
+        return false;
+    }
+
+    DIR* dir = opendir(dirPath.c_str());
+    if (! dir)
+    {
+        // a search path which doesn't exist has no file
+        return depth == 0 && errno == ENOENT;
+    }
+
+    bool ret = true;
+    struct dirent* entry = NULL;
+    while (ret && (entry = readdir(dir)) != NULL)
+    {
+        const char* name = entry->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+        {
+            continue;
+        }
+
+        std::string path = dirPath + name;
+        bool isDirectory = false;
+        if (entry->d_type == DT_DIR)
+        {
+            isDirectory = true;
+        }
+        else if (entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN)
+        {
+            // follow the links, like stat() does
+            struct stat st;
+            isDirectory = stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+        }
+
+        files->insert(prefix + name);
+        if (isDirectory)
+        {
+            ret = listDirectory(path + "/", prefix + name + "/", depth + 1, files);
+        }
+        ret = ret && files->size() <= MAX_FILES;
+    }
+    closedir(dir);
+    return ret;
+}
+#endif // CC_FILEUTILS_LIST_SEARCH_PATHS
+
+bool FileUtils::findInSearchPathIndex(const std::string& searchPath, const std::string& fullPath, bool* found)
+{
+#if CC_FILEUTILS_LIST_SEARCH_PATHS
+    // only the absolute search paths are on the file system, "assets/" is in the APK on Android
+    if (searchPath.empty() || searchPath[0] != '/' || searchPath[searchPath.length()-1] != '/'
+        || fullPath.compare(0, searchPath.length(), searchPath) != 0)
+    {
+        return false;
+    }
+
+    // a listing doesn't know about "./", "../" or "//"
+    std::string relativePath = fullPath.substr(searchPath.length());
+    if (relativePath.find("./") != std::string::npos || relativePath.find("//") != std::string::npos)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_pathCacheMutex);
+        auto iter = _searchPathIndices.find(searchPath);
+        if (iter != _searchPathIndices.end())
+        {
+            *found = iter->second.files.find(relativePath) != iter->second.files.end();
+            return iter->second.listed;
+        }
+    }
+
+    // list the search path without holding the lock, another thread may list it meanwhile
+    SearchPathIndex index;
+    index.listed = listDirectory(searchPath, "", 0, &index.files);
+    if (! index.listed)
+    {
+        index.files.clear();
+        CCLOG("cocos2d: FileUtils: can't list the search path %s", searchPath.c_str());
+    }
+
+    std::lock_guard<std::mutex> lock(_pathCacheMutex);
+    auto iter = _searchPathIndices.insert(std::make_pair(searchPath, std::move(index))).first;
+    *found = iter->second.files.find(relativePath) != iter->second.files.end();
+    return iter->second.listed;
+#else
+    CC_UNUSED_PARAM(searchPath);
+    CC_UNUSED_PARAM(fullPath);
+    *found = false;
+    return false;
+#endif
+}
+
 const char* FileUtils::fullPathFromRelativeFile(const char *filename, const char *pszRelativeFile)
 {
     std::string relativeFile = pszRelativeFile;
@@ -669,7 +940,7 @@ const char* FileUtils::fullPathFromRelativeFile(const char *filename, const char
 void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& searchResolutionsOrder)
 {
     bool bExistDefault = false;
-    _fullPathCache.clear();
+    purgeCachedEntries();
     _searchResolutionsOrderArray.clear();
     for (std::vector<std::string>::const_iterator iter = searchResolutionsOrder.begin(); iter != searchResolutionsOrder.end(); ++iter)
     {
@@ -694,6 +965,8 @@ void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& search
 
 void FileUtils::addSearchResolutionsOrder(const char* order)
 {
+    // the files missing so far may be found in it
+    purgeCachedEntries();
     _searchResolutionsOrderArray.push_back(order);
 }
 
@@ -711,7 +984,7 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
 {
     bool bExistDefaultRootPath = false;
     
-    _fullPathCache.clear();
+    purgeCachedEntries();
     _searchPathArray.clear();
     for (std::vector<std::string>::const_iterator iter = searchPaths.begin(); iter != searchPaths.end(); ++iter)
     {
@@ -753,12 +1026,14 @@ void FileUtils::addSearchPath(const char* path_)
     {
         path += "/";
     }
+    // the files missing so far may be found in it
+    purgeCachedEntries();
     _searchPathArray.push_back(path);
 }
 
 void FileUtils::setFilenameLookupDictionary(Dictionary* pFilenameLookupDict)
 {
-    _fullPathCache.clear();    
+    purgeCachedEntries();
     CC_SAFE_RELEASE(_filenameLookupDict);
     _filenameLookupDict = pFilenameLookupDict;
     CC_SAFE_RETAIN(_filenameLookupDict);
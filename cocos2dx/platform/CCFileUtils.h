@@ -27,6 +27,9 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include "CCPlatformMacros.h"
 #include "ccTypes.h"
 
@@ -34,6 +37,7 @@ NS_CC_BEGIN
 
 class Dictionary;
 class Array;
+class ResourcePack;
 /**
  * @addtogroup platform
  * @{
@@ -68,7 +72,7 @@ public:
     virtual ~FileUtils();
     
     /**
-     *  Purges the file searching cache.
+     *  Purges the file searching cache, including the files known to be missing and the listings of the search paths.
      *
      *  @note It should be invoked after the resources were updated.
      *        For instance, in the CocosPlayer sample, every time you run application from CocosBuilder,
@@ -76,6 +80,15 @@ public:
      *        this method should be invoked to clean the file search cache.
      */
     virtual void purgeCachedEntries();
+
+    /**
+     *  Resolves the full paths of files ahead of time, and lists the search paths if they weren't yet.
+     *  It can be called from a loading thread, e.g. while a splash screen is shown.
+     *
+     *  @param filenames The files to resolve, as passed to fullPathForFilename().
+     *  @since v3.0
+     */
+    void prewarmFullPathCache(const std::vector<std::string>& filenames);
     
     /**
      *  Gets resource file data
@@ -98,6 +111,45 @@ public:
      */
     virtual unsigned char* getFileDataFromZip(const char* pszZipFilePath, const char* filename, unsigned long *size);
 
+    /**
+     *  Gets the data of a file stored uncompressed in a resource pack, without copying it.
+     *
+     *  @param[in]  filename The resource file name which contains the path.
+     *  @param[out] size If the file is found, it will be the data size, otherwise 0.
+     *  @return The data, which stays valid until the pack is removed. NULL if the file isn't in a pack,
+     *          or is compressed in it; use getFileData() then.
+     *  @see addResourcePack(const char*, const char*)
+     *  @since v3.0
+     */
+    virtual const unsigned char* getMappedFileData(const char* filename, unsigned long* size);
+
+    /**
+     *  Adds a resource pack. Its files are found by fullPathForFilename() and read by getFileData()
+     *  as if they were in the mount path, and they are searched before the files on the file system.
+     *
+     *  @param filename The pack file. It is searched with fullPathForFilename().
+     *  @param mountPath The directory the files of the pack are seen in, relative to the default resource
+     *                   root unless it is absolute. It should be one of the search paths.
+     *  @return false if the pack can't be opened.
+     *  @note The packs added last are searched first. Like the search paths, the packs must not be
+     *        changed while resources are loaded in the background.
+     *  @see ResourcePack
+     *  @since v3.0
+     */
+    virtual bool addResourcePack(const char* filename, const char* mountPath = "");
+
+    /**
+     *  Removes a resource pack added by addResourcePack(const char*, const char*).
+     *  @since v3.0
+     */
+    virtual void removeResourcePack(const char* filename);
+
+    /**
+     *  Removes all the resource packs.
+     *  @since v3.0
+     */
+    virtual void removeAllResourcePacks();
+
     
     /** Returns the fullpath for a given filename.
      
@@ -138,6 +190,11 @@ public:
      	    internal_dir/gamescene/uilayer/sprite.pvr.gz                      (if not found, return "gamescene/uilayer/sprite.png")
 
      If the new file can't be found on the file system, it will return the parameter filename directly.
+
+     The results are cached, including the files which are missing, until purgeCachedEntries() is called
+     or the search paths change. Where the platform allows it, each search path is listed once instead of
+     checking every candidate on the file system. This method can be called from any thread, as long as
+     the search paths aren't changed meanwhile.
      
      This method was added to simplify multiplatform support. Whether you are using cocos2d-js or any cross-compilation toolchain like StellaSDK or Apportable,
      you might need to load different resources for a given file in the different platforms.
@@ -353,6 +410,29 @@ protected:
      *  @note This method is used internally.
      */
     virtual Array* createArrayWithContentsOfFile(const std::string& filename);
+
+    /**
+     *  Finds the resource pack which holds a file.
+     *  @param fullPath The full path of the file, as returned by fullPathForFilename().
+     *  @param[out] entryName The name of the file in the pack.
+     *  @return NULL if no pack holds the file.
+     */
+    ResourcePack* getResourcePackForFullPath(const std::string& fullPath, std::string* entryName);
+
+    /**
+     *  Gets a copy of a file held by a resource pack. getFileData() calls it before reading the file system.
+     *  @return NULL if no pack holds the file.
+     */
+    unsigned char* getFileDataFromResourcePack(const std::string& fullPath, unsigned long* size);
+
+    /**
+     *  Checks a file in the listing of a search path, which is made the first time the search path is used.
+     *  @param searchPath A search path, ending with '/'.
+     *  @param fullPath The full path of the file, which starts with the search path.
+     *  @param[out] found Whether the file, or directory, exists.
+     *  @return false if the search path can't be listed; then the file system has to be checked.
+     */
+    bool findInSearchPathIndex(const std::string& searchPath, const std::string& fullPath, bool* found);
     
     /** Dictionary used to lookup filenames based on a key.
      *  It is used internally by the following methods:
@@ -389,6 +469,41 @@ protected:
      *  This variable is used for improving the performance of file search.
      */
     std::map<std::string, std::string> _fullPathCache;
+
+    /**
+     *  The files which weren't found, so that they aren't searched again.
+     */
+    std::unordered_set<std::string> _missingPathCache;
+
+    struct SearchPathIndex
+    {
+        /** false when the search path couldn't be listed */
+        bool listed;
+        /** the files and directories under the search path, relative to it */
+        std::unordered_set<std::string> files;
+    };
+
+    /**
+     *  The listings of the search paths, by search path.
+     */
+    std::unordered_map<std::string, SearchPathIndex> _searchPathIndices;
+
+    /**
+     *  Guards the caches above, so that files can be searched from several threads.
+     */
+    std::mutex _pathCacheMutex;
+
+    struct MountedResourcePack
+    {
+        ResourcePack* pack;
+        /** full path of the directory the files of the pack are seen in, ending with '/' */
+        std::string mountPath;
+    };
+
+    /**
+     *  The resource packs. The last one has the highest priority.
+     */
+    std::vector<MountedResourcePack> _resourcePacks;
     
     /**
      *  The singleton pointer of FileUtils.
@@ -27,6 +27,8 @@ THE SOFTWARE.
 
 #include "cocoa/CCObject.h"
 #include "textures/CCTexture2D.h"
+#include <string>
+#include <vector>
 
 // premultiply alpha, or the effect will wrong when want to use other pixel format in Texture2D,
 // such as RGB888, RGB5A1
@@ -105,6 +107,14 @@ public:
     */
     bool initWithImageFile(const char *path);
 
+    /**
+    @brief The same result as with initWithImageFile, but thread safe: it can be called on a loading thread.
+    @param fullpath  full path of the file.
+    @return  true if loaded correctly.
+    @since v3.0
+    */
+    bool initWithImageFileThreadSafe(const char *fullpath);
+
     /**
     @brief Load image from stream buffer.
     @param data  stream buffer which holds the image data.
@@ -116,6 +126,24 @@ public:
     // @warning kFmtRawData only support RGBA8888
     bool initWithRawData(const unsigned char * data, int dataLen, int width, int height, int bitsPerComponent, bool preMulti = false);
 
+    /**
+    @brief Decode several image files at once, in parallel on a pool of threads shared by all the batches.
+    @param fullPaths  the absolute paths of the files.
+    @return one image per path, in the same order, or nullptr for the files that can't be loaded.
+     The images are retained: release them when they aren't needed anymore.
+    @since v3.0
+    */
+    static std::vector<Image*> decodeBatch(const std::vector<std::string>& fullPaths);
+
+    /**
+    @brief Whether the PNG and WebP decoders multiply the colors by the alpha while they decode the rows,
+     instead of leaving the alpha straight. The textures created from these images have the alpha premultiplied.
+     It is set by the "cocos2d.x.texture.premultiply_alpha_on_decode" key of the configuration, disabled by default.
+    @since v3.0
+    */
+    static void setPremultiplyAlphaOnDecode(bool enabled);
+    static bool isPremultiplyAlphaOnDecode();
+
     /**
     @brief Create image with specified string.
     @param text       the text the image will show (cannot be nil).
@@ -196,6 +224,8 @@ protected:
     bool initWithETCData(const unsigned char * data, int dataLen);
     bool initWithS3TCData(const unsigned char * data, int dataLen);
     bool initWithATITCData(const unsigned char *data, int dataLen);
+    // sets _data to dataLen bytes of data from offset, taking over _unpackedData if data is it
+    void setDataFrom(const unsigned char *data, int offset, int dataLen);
 
     bool saveImageToPNG(const char *filePath, bool isToRGB = true);
     bool saveImageToJPG(const char *filePath);
@@ -217,6 +247,8 @@ private:
     int _numberOfMipmaps;
     // false if we cann't auto detect the image is premultiplied or not.
     bool _hasPremultipliedAlpha;
+    // the data inflated by initWithImageData(), which the compressed texture formats take over instead of copying it
+    unsigned char *_unpackedData;
 
 
 private:
@@ -224,15 +256,6 @@ private:
     Image(const Image&    rImg);
     Image & operator=(const Image&);
     
-    /*
-     @brief The same result as with initWithImageFile, but thread safe. It is caused by
-     loadImage() in TextureCache.cpp.
-     @param fullpath  full path of the file.
-     @param imageType the type of image, currently only supporting two types.
-     @return  true if loaded correctly.
-     */
-    bool initWithImageFileThreadSafe(const char *fullpath);
-    
     Format detectFormat(const unsigned char * data, int dataLen);
     bool isPng(const unsigned char * data, int dataLen);
     bool isJpg(const unsigned char * data, int dataLen);
@@ -56,7 +56,9 @@ extern "C"
 #include "CCFileUtils.h"
 #include "CCConfiguration.h"
 #include "support/ccUtils.h"
+#include "support/CCThreadPool.h"
 #include "support/zip_support/ZipUtils.h"
+#include "textures/CCTexture2DConvert.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "platform/android/CCFileUtilsAndroid.h"
 #endif
@@ -373,6 +375,34 @@ namespace
     }
 }
 
+namespace
+{
+    static bool s_premultiplyAlphaOnDecode = false;
+
+    // the decoding threads of Image::decodeBatch(), started by the first batch
+    static ThreadPool* getDecodeThreadPool()
+    {
+        static ThreadPool* s_decodeThreadPool = new ThreadPool();
+        return s_decodeThreadPool;
+    }
+
+    // premultiplies decoded RGBA8888 or AI88 rows in place, like CC_RGB_PREMULTIPLY_ALPHA
+    static void premultiplyAlpha(unsigned char* data, int dataLen, Texture2D::PixelFormat format)
+    {
+        if (format == Texture2D::PixelFormat::RGBA8888)
+        {
+            getPixelConverters().rgba8888ToPremultipliedRGBA8888(data, dataLen, data);
+        }
+        else if (format == Texture2D::PixelFormat::AI88)
+        {
+            for (int i = 0; i < dataLen - 1; i += 2)
+            {
+                data[i] = (unsigned char)((unsigned)data[i] * (data[i + 1] + 1) >> 8);
+            }
+        }
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Implement Image
 //////////////////////////////////////////////////////////////////////////
@@ -387,6 +417,7 @@ Image::Image()
 , _preMulti(false)
 , _hasPremultipliedAlpha(true)
 , _numberOfMipmaps(0)
+, _unpackedData(nullptr)
 {
 
 }
@@ -411,17 +442,19 @@ bool Image::initWithImageFile(const char * strPath)
     int size = 4 * (iSurf->w * iSurf->h);
     bRet = initWithRawData((void*)iSurf->pixels, size, iSurf->w, iSurf->h, 8, true);
 
-    unsigned int *tmp = (unsigned int *)_data;
-    int nrPixels = iSurf->w * iSurf->h;
-    for(int i = 0; i < nrPixels; i++)
-    {
-        unsigned char *p = _data + i * 4;
-        tmp[i] = CC_RGB_PREMULTIPLY_ALPHA( p[0], p[1], p[2], p[3] );
-    }
+    getPixelConverters().rgba8888ToPremultipliedRGBA8888(_data, size, _data);
 
     SDL_FreeSurface(iSurf);
 #else
     unsigned long bufferLen = 0;
+
+    // decode the files stored uncompressed in a resource pack in place
+    const unsigned char* mapped = FileUtils::getInstance()->getMappedFileData(fullPath.c_str(), &bufferLen);
+    if (mapped != nullptr && bufferLen > 0)
+    {
+        return initWithImageData(mapped, bufferLen);
+    }
+
     unsigned char* buffer = FileUtils::getInstance()->getFileData(fullPath.c_str(), "rb", &bufferLen);
 
     if (buffer != nullptr && bufferLen > 0)
@@ -435,10 +468,51 @@ bool Image::initWithImageFile(const char * strPath)
     return bRet;
 }
 
+std::vector<Image*> Image::decodeBatch(const std::vector<std::string>& fullPaths)
+{
+    const int count = (int)fullPaths.size();
+    std::vector<Image*> images(count, nullptr);
+    std::vector<char> loaded(count, 0);
+
+    getDecodeThreadPool()->parallelFor(count, 1, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            images[i] = new Image();
+            loaded[i] = images[i]->initWithImageFileThreadSafe(fullPaths[i].c_str());
+        }
+    });
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (!loaded[i])
+        {
+            CC_SAFE_RELEASE_NULL(images[i]);
+        }
+    }
+    return images;
+}
+
+void Image::setPremultiplyAlphaOnDecode(bool enabled)
+{
+    s_premultiplyAlphaOnDecode = enabled;
+}
+
+bool Image::isPremultiplyAlphaOnDecode()
+{
+    return s_premultiplyAlphaOnDecode;
+}
+
 bool Image::initWithImageFileThreadSafe(const char *fullpath)
 {
     bool bRet = false;
     unsigned long dataLen = 0;
+
+    const unsigned char* mapped = FileUtils::getInstance()->getMappedFileData(fullpath, &dataLen);
+    if (mapped != nullptr && dataLen > 0)
+    {
+        return initWithImageData(mapped, dataLen);
+    }
+
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
     FileUtilsAndroid *fileUitls = (FileUtilsAndroid*)FileUtils::getInstance();
     unsigned char *pBuffer = fileUitls->getFileDataForAsync(fullpath, "rb", &dataLen);
@@ -464,10 +538,13 @@ bool Image::initWithImageData(const unsigned char * data, int dataLen)
         unsigned char* unpackedData = nullptr;
         int unpackedLen = 0;
         
-        //detecgt and unzip the compress file
+        //detecgt and unzip the compress file, straight into a buffer of the stated length for CCZ
         if (ZipUtils::ccIsCCZBuffer(data, dataLen))
         {
-            unpackedLen = ZipUtils::ccInflateCCZBuffer(data, dataLen, &unpackedData);
+            unpackedLen = ZipUtils::ccGetCCZBufferLength(data, dataLen);
+            CC_BREAK_IF(unpackedLen <= 0);
+            unpackedData = new unsigned char[unpackedLen];
+            unpackedLen = ZipUtils::ccInflateCCZBufferToBuffer(data, dataLen, unpackedData, unpackedLen);
         }
         else if (ZipUtils::ccIsGZipBuffer(data, dataLen))
         {
@@ -479,6 +556,16 @@ bool Image::initWithImageData(const unsigned char * data, int dataLen)
             unpackedLen = dataLen;
         }
 
+        if (unpackedData != data)
+        {
+            _unpackedData = unpackedData;
+            if (unpackedLen <= 0)
+            {
+                CC_SAFE_DELETE_ARRAY(_unpackedData);
+                break;
+            }
+        }
+
         _fileType = detectFormat(unpackedData, unpackedLen);
 
         switch (_fileType)
@@ -512,10 +599,8 @@ bool Image::initWithImageData(const unsigned char * data, int dataLen)
             break;
         }
         
-        if(unpackedData != data)
-        {
-            free(unpackedData);
-        }
+        // unless the decoder took it over
+        CC_SAFE_DELETE_ARRAY(_unpackedData);
     } while (0);
     
     return ret;
@@ -740,10 +825,8 @@ bool Image::initWithJpgData(const unsigned char * data, int dataLen)
 	 * struct, to avoid dangling-pointer problems.
 	 */
 	struct MyErrorMgr jerr;
-    /* libjpeg data structure for storing one row, that is, scanline of an image */
-    JSAMPROW row_pointer[1] = {0};
-    unsigned long location = 0;
-    unsigned int i = 0;
+    /* the scanlines of the image, which libjpeg writes straight into _data */
+    JSAMPROW* row_pointers = nullptr;
 
     bool bRet = false;
     do 
@@ -792,22 +875,23 @@ bool Image::initWithJpgData(const unsigned char * data, int dataLen)
         _width  = cinfo.output_width;
         _height = cinfo.output_height;
         _preMulti = false;
-        row_pointer[0] = new unsigned char[cinfo.output_width*cinfo.output_components];
-        CC_BREAK_IF(! row_pointer[0]);
 
-        _dataLen = cinfo.output_width*cinfo.output_height*cinfo.output_components;
+        const unsigned int rowBytes = cinfo.output_width*cinfo.output_components;
+        _dataLen = rowBytes*cinfo.output_height;
         _data = new unsigned char[_dataLen];
         CC_BREAK_IF(! _data);
 
+        row_pointers = new JSAMPROW[cinfo.output_height];
+        for (unsigned int i = 0; i < cinfo.output_height; ++i)
+        {
+            row_pointers[i] = _data + i*rowBytes;
+        }
+
         /* now actually read the jpeg into the raw buffer */
-        /* read one scan line at a time */
+        /* as many scan lines at a time as the decoder can output */
         while( cinfo.output_scanline < cinfo.output_height )
         {
-            jpeg_read_scanlines( &cinfo, row_pointer, 1 );
-            for( i=0; i<cinfo.output_width*cinfo.output_components;i++) 
-            {
-                _data[location++] = row_pointer[0][i];
-            }
+            jpeg_read_scanlines( &cinfo, row_pointers + cinfo.output_scanline, cinfo.output_height - cinfo.output_scanline );
         }
 
 		/* When read image file with broken data, jpeg_finish_decompress() may cause error.
@@ -821,7 +905,7 @@ bool Image::initWithJpgData(const unsigned char * data, int dataLen)
         bRet = true;
     } while (0);
 
-    CC_SAFE_DELETE_ARRAY(row_pointer[0]);
+    CC_SAFE_DELETE_ARRAY(row_pointers);
     return bRet;
 }
 
@@ -901,6 +985,8 @@ bool Image::initWithPngData(const unsigned char * data, int dataLen)
         if (bit_depth < 8) {
             png_set_packing(png_ptr);
         }
+        // the interlaced images are decoded in several passes
+        const int passes = png_set_interlace_handling(png_ptr);
         // update info
         png_read_update_info(png_ptr, info_ptr);
         bit_depth = png_get_bit_depth(png_ptr, info_ptr);
@@ -938,11 +1024,28 @@ bool Image::initWithPngData(const unsigned char * data, int dataLen)
         {
             row_pointers[i] = _data + i*rowbytes;
         }
-        png_read_image(png_ptr, row_pointers);
 
-        png_read_end(png_ptr, NULL);
+        _preMulti = s_premultiplyAlphaOnDecode &&
+            (_renderFormat == Texture2D::PixelFormat::RGBA8888 || _renderFormat == Texture2D::PixelFormat::AI88);
+        if (_preMulti && passes == 1)
+        {
+            // premultiply each row while it is still in the cache
+            for (int i = 0; i < _height; ++i)
+            {
+                png_read_row(png_ptr, row_pointers[i], NULL);
+                premultiplyAlpha(row_pointers[i], rowbytes, _renderFormat);
+            }
+        }
+        else
+        {
+            png_read_image(png_ptr, row_pointers);
+            if (_preMulti)
+            {
+                premultiplyAlpha(_data, _dataLen, _renderFormat);
+            }
+        }
 
-        _preMulti = false;
+        png_read_end(png_ptr, NULL);
 
         CC_SAFE_FREE(row_pointers);
 
@@ -1225,10 +1328,8 @@ bool Image::initWithPVRv2Data(const unsigned char * data, int dataLen)
     //Get ptr to where data starts..
     dataLength = CC_SWAP_INT32_LITTLE_TO_HOST(header->dataLength);
 
-    //Move by size of header
-    _dataLen = dataLen - sizeof(PVRv2TexHeader);
-    _data = new unsigned char[_dataLen];
-    memcpy(_data, (unsigned char*)data + sizeof(PVRv2TexHeader), _dataLen);
+    //Move by size of header, the header may be overwritten from here
+    setDataFrom(data, sizeof(PVRv2TexHeader), dataLen - sizeof(PVRv2TexHeader));
 
     // Calculate the data size for each texture level and respect the minimum number of blocks
     while (dataOffset < dataLength)
@@ -1348,12 +1449,11 @@ bool Image::initWithPVRv3Data(const unsigned char * data, int dataLen)
 	int dataOffset = 0, dataSize = 0;
 	int blockSize = 0, widthBlocks = 0, heightBlocks = 0;
 	
-    _dataLen = dataLen - (sizeof(PVRv3TexHeader) + header->metadataLength);
-    _data = new unsigned char[_dataLen];
-    memcpy(_data, static_cast<const unsigned char*>(data) + sizeof(PVRv3TexHeader) + header->metadataLength, _dataLen);
-	
 	_numberOfMipmaps = header->numberOfMipmaps;
 	CCAssert(_numberOfMipmaps < MIPMAP_MAX, "Image: Maximum number of mimpaps reached. Increate the CC_MIPMAP_MAX value");
+
+    // the header may be overwritten from here
+    setDataFrom(data, sizeof(PVRv3TexHeader) + header->metadataLength, dataLen - (sizeof(PVRv3TexHeader) + header->metadataLength));
     
 	for (int i = 0; i < _numberOfMipmaps; i++)
     {
@@ -1435,9 +1535,7 @@ bool Image::initWithETCData(const unsigned char * data, int dataLen)
         //old opengl version has no define for GL_ETC1_RGB8_OES, add macro to make compiler happy. 
 #ifdef GL_ETC1_RGB8_OES
         _renderFormat = Texture2D::PixelFormat::ETC;
-        _dataLen = dataLen - ETC_PKM_HEADER_SIZE;
-        _data = new unsigned char[_dataLen];
-        memcpy(_data, static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, _dataLen);
+        setDataFrom(data, ETC_PKM_HEADER_SIZE, dataLen - ETC_PKM_HEADER_SIZE);
         return true;
 #endif
     }
@@ -1717,6 +1815,23 @@ bool Image::initWithATITCData(const unsigned char *data, int dataLen)
     return true;
 }
 
+void Image::setDataFrom(const unsigned char * data, int offset, int dataLen)
+{
+    _dataLen = dataLen;
+    if (data == _unpackedData)
+    {
+        // move the payload over the header rather than keeping a second copy
+        memmove(_unpackedData, _unpackedData + offset, dataLen);
+        _data = _unpackedData;
+        _unpackedData = nullptr;
+    }
+    else
+    {
+        _data = new unsigned char[dataLen];
+        memcpy(_data, data + offset, dataLen);
+    }
+}
+
 bool Image::initWithPVRData(const unsigned char * data, int dataLen)
 {
     return initWithPVRv2Data(data, dataLen) || initWithPVRv3Data(data, dataLen);
@@ -1732,7 +1847,10 @@ bool Image::initWithWebpData(const unsigned char * data, int dataLen)
         if (WebPGetFeatures(static_cast<const uint8_t*>(data), dataLen, &config.input) != VP8_STATUS_OK) break;
         if (config.input.width == 0 || config.input.height == 0) break;
         
-        config.output.colorspace = MODE_RGBA;
+        // the alpha is premultiplied by the decoder, and decoded on another thread while the colors are
+        _preMulti = s_premultiplyAlphaOnDecode && config.input.has_alpha;
+        config.output.colorspace = _preMulti ? MODE_rgbA : MODE_RGBA;
+        config.options.use_threads = 1;
         _renderFormat = Texture2D::PixelFormat::RGBA8888;
         _width    = config.input.width;
         _height   = config.input.height;
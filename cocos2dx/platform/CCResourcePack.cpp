@@ -0,0 +1,283 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CCResourcePack.h"
+#include "CCFileUtils.h"
+#include "ccMacros.h"
+#include <zlib.h>
+#include <string.h>
+#include <algorithm>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#define CC_RESOURCE_PACK_MAP_WIN32 1
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_EMSCRIPTEN) && (CC_TARGET_PLATFORM != CC_PLATFORM_NACL) && (CC_TARGET_PLATFORM != CC_PLATFORM_MARMALADE)
+#define CC_RESOURCE_PACK_MAP_POSIX 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+NS_CC_BEGIN
+
+// The index is read in place, so the pack format is little-endian like all the supported targets.
+
+uint64_t ResourcePack::hashName(const char* name, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+ResourcePack::ResourcePack()
+: _data(nullptr)
+, _size(0)
+, _header(nullptr)
+, _entries(nullptr)
+, _names(nullptr)
+, _mapped(false)
+{
+}
+
+ResourcePack::~ResourcePack()
+{
+    close();
+}
+
+void ResourcePack::close()
+{
+    if (_data)
+    {
+        if (_mapped)
+        {
+#if CC_RESOURCE_PACK_MAP_WIN32
+            UnmapViewOfFile(_data);
+#elif CC_RESOURCE_PACK_MAP_POSIX
+            munmap((void*)_data, _size);
+#endif
+        }
+        else
+        {
+            delete [] _data;
+        }
+    }
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _entries = nullptr;
+    _names = nullptr;
+    _mapped = false;
+}
+
+static const unsigned char* mapFile(const std::string& fullPath, unsigned long* size)
+{
+    const unsigned char* data = nullptr;
+    *size = 0;
+
+#if CC_RESOURCE_PACK_MAP_WIN32
+    int length = MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, NULL, 0);
+    std::wstring widePath(length, 0);
+    MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, &widePath[0], length);
+
+    HANDLE fileHandle = ::CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, NULL, NULL);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+    {
+        DWORD fileSize = ::GetFileSize(fileHandle, NULL);
+        HANDLE mapping = fileSize > 0 ? ::CreateFileMappingW(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+        if (mapping)
+        {
+            data = (const unsigned char*)::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            // the view keeps the file mapped once the handles are closed
+            ::CloseHandle(mapping);
+        }
+        ::CloseHandle(fileHandle);
+        if (data)
+        {
+            *size = fileSize;
+        }
+    }
+#elif CC_RESOURCE_PACK_MAP_POSIX
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                data = (const unsigned char*)mapping;
+                *size = st.st_size;
+            }
+        }
+        ::close(fd);
+    }
+#else
+    CC_UNUSED_PARAM(fullPath);
+#endif
+
+    return data;
+}
+
+bool ResourcePack::initWithFile(const std::string& fullPath)
+{
+    close();
+    _path = fullPath;
+
+    // files inside the APK have no path on the file system
+    if (! fullPath.empty() && fullPath[0] == '/')
+    {
+        _data = mapFile(fullPath, &_size);
+    }
+#if CC_RESOURCE_PACK_MAP_WIN32
+    else
+    {
+        _data = mapFile(fullPath, &_size);
+    }
+#endif
+    _mapped = (_data != nullptr);
+
+    if (! _data)
+    {
+        _data = FileUtils::getInstance()->getFileData(fullPath.c_str(), "rb", &_size);
+        if (! _data)
+        {
+            return false;
+        }
+    }
+
+    do
+    {
+        CC_BREAK_IF(_size < sizeof(Header));
+
+        _header = (const Header*)_data;
+        CC_BREAK_IF(memcmp(_header->magic, "CCPK", 4) != 0 || _header->version != VERSION);
+
+        // the index is read in place, it has to be aligned
+        CC_BREAK_IF(_header->indexOffset % sizeof(uint64_t) != 0);
+        CC_BREAK_IF((uint64_t)_header->indexOffset + (uint64_t)_header->entryCount * sizeof(Entry) > _size);
+        CC_BREAK_IF((uint64_t)_header->namesOffset + _header->namesSize > _size);
+
+        _entries = (const Entry*)(_data + _header->indexOffset);
+        _names = (const char*)(_data + _header->namesOffset);
+
+        bool valid = true;
+        for (uint32_t i = 0; i < _header->entryCount && valid; ++i)
+        {
+            const Entry& entry = _entries[i];
+            valid = (uint64_t)entry.nameOffset + entry.nameLength <= _header->namesSize
+                && entry.dataOffset + entry.storedSize <= _size
+                && ((entry.flags & ENTRY_COMPRESSED) || entry.storedSize == entry.size)
+                && (i == 0 || _entries[i - 1].hash <= entry.hash);
+        }
+        CC_BREAK_IF(! valid);
+
+        return true;
+    } while (0);
+
+    CCLOG("cocos2d: ResourcePack: %s is not a valid resource pack", fullPath.c_str());
+    close();
+    return false;
+}
+
+const ResourcePack::Entry* ResourcePack::findEntry(const std::string& fileName) const
+{
+    if (! _entries)
+    {
+        return nullptr;
+    }
+
+    uint64_t hash = hashName(fileName.c_str(), fileName.length());
+    const Entry* end = _entries + _header->entryCount;
+    const Entry* entry = std::lower_bound(_entries, end, hash, [](const Entry& e, uint64_t h) {
+        return e.hash < h;
+    });
+
+    for (; entry != end && entry->hash == hash; ++entry)
+    {
+        if (entry->nameLength == fileName.length()
+            && memcmp(_names + entry->nameOffset, fileName.c_str(), entry->nameLength) == 0)
+        {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+bool ResourcePack::fileExists(const std::string& fileName) const
+{
+    return findEntry(fileName) != nullptr;
+}
+
+unsigned char* ResourcePack::getFileData(const std::string& fileName, unsigned long* size) const
+{
+    *size = 0;
+
+    const Entry* entry = findEntry(fileName);
+    if (! entry)
+    {
+        return nullptr;
+    }
+
+    unsigned char* buffer = new unsigned char[entry->size];
+    const unsigned char* stored = _data + entry->dataOffset;
+
+    if (entry->flags & ENTRY_COMPRESSED)
+    {
+        uLongf length = entry->size;
+        if (uncompress(buffer, &length, stored, entry->storedSize) != Z_OK || length != entry->size)
+        {
+            CCLOG("cocos2d: ResourcePack: can't inflate %s from %s", fileName.c_str(), _path.c_str());
+            delete [] buffer;
+            return nullptr;
+        }
+    }
+    else
+    {
+        memcpy(buffer, stored, entry->size);
+    }
+
+    *size = entry->size;
+    return buffer;
+}
+
+const unsigned char* ResourcePack::getMappedFileData(const std::string& fileName, unsigned long* size) const
+{
+    *size = 0;
+
+    const Entry* entry = findEntry(fileName);
+    if (! entry || (entry->flags & ENTRY_COMPRESSED))
+    {
+        return nullptr;
+    }
+
+    *size = entry->size;
+    return _data + entry->dataOffset;
+}
+
+NS_CC_END
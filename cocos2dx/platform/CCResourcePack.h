@@ -0,0 +1,146 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_RESOURCE_PACK_H__
+#define __CC_RESOURCE_PACK_H__
+
+#include <string>
+#include <stdint.h>
+#include "CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** Read-only archive of resource files with a precomputed index.
+
+ The pack is mapped in memory: opening it reads nothing but the header, and the files
+ stored uncompressed can be used in place without any copy. The files can also be
+ stored zlib compressed, one by one. Packs are built by tools/resource-packer.
+
+ All the numbers are little-endian. The layout is:
+
+     Header      magic "CCPK", version, number of entries, offsets of the index and of the names
+     Index       one Entry per file, sorted by the hash of its name
+     Names       the names of the files, not null-terminated
+     Data        the contents of the files
+
+ The name of a file is its path relative to the directory where the pack is mounted,
+ with '/' as separator. The hash is the 64-bit FNV-1a hash of the name.
+
+ @see FileUtils::addResourcePack()
+ @since v3.0
+ */
+class CC_DLL ResourcePack
+{
+public:
+    struct Header
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t indexOffset;
+        uint32_t namesOffset;
+        uint32_t namesSize;
+        uint32_t reserved[2];
+    };
+
+    struct Entry
+    {
+        uint64_t hash;
+        uint64_t dataOffset;
+        uint32_t nameOffset;
+        uint16_t nameLength;
+        uint16_t flags;
+        uint32_t size;
+        uint32_t storedSize;
+    };
+
+    enum
+    {
+        VERSION = 1,
+        /** the entry is stored as a zlib stream of storedSize bytes */
+        ENTRY_COMPRESSED = 1 << 0,
+    };
+
+    /** Returns the hash used by the index for a file name */
+    static uint64_t hashName(const char* name, size_t length);
+
+    ResourcePack();
+    ~ResourcePack();
+
+    /** Maps the pack at the given full path.
+     Where the platform can't map it (e.g. inside the APK on Android), the pack is read in memory once.
+     @return false if the file can't be read or is not a valid pack.
+     */
+    bool initWithFile(const std::string& fullPath);
+
+    /** Full path of the pack file */
+    const std::string& getPath() const { return _path; }
+
+    /** Number of files in the pack */
+    unsigned int getFileCount() const { return _header ? _header->entryCount : 0; }
+
+    /** Whether the pack contains the file */
+    bool fileExists(const std::string& fileName) const;
+
+    /** Gets a copy of a file, inflating it if it is compressed.
+     @param[out] size If the file is found, it will be the data size, otherwise 0.
+     @return Upon success, a pointer to the data is returned, otherwise NULL.
+     @warning Recall: you are responsible for calling delete[] on any Non-NULL pointer returned.
+     */
+    unsigned char* getFileData(const std::string& fileName, unsigned long* size) const;
+
+    /** Gets the data of a file stored uncompressed, without copying it.
+     The pointer stays valid as long as the pack is alive.
+     @param[out] size If the file is found and uncompressed, it will be the data size, otherwise 0.
+     @return NULL if the file is not in the pack or is compressed.
+     */
+    const unsigned char* getMappedFileData(const std::string& fileName, unsigned long* size) const;
+
+private:
+    const Entry* findEntry(const std::string& fileName) const;
+    void close();
+
+    std::string _path;
+    const unsigned char* _data;
+    unsigned long _size;
+    const Header* _header;
+    const Entry* _entries;
+    const char* _names;
+    /** true when _data is a mapping, false when it is a buffer owned by the pack */
+    bool _mapped;
+
+    CC_DISABLE_COPY(ResourcePack);
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_RESOURCE_PACK_H__
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "jni/Java_org_cocos2dx_lib_Cocos2dxHelper.h"
 #include "android/asset_manager.h"
 #include "android/asset_manager_jni.h"
+#include "support/CCFrameProfiler.h"
 
 #include <stdlib.h>
 
@@ -132,6 +133,8 @@ bool FileUtilsAndroid::isAbsolutePath(const std::string& strPath)
 
 unsigned char* FileUtilsAndroid::getFileData(const char* filename, const char* pszMode, unsigned long * pSize)
 {    
+    CC_PROFILE_ZONE(FrameProfiler::ZONE_FILE_READ);
+
     return doGetFileData(filename, pszMode, pSize, false);
 }
 
@@ -150,17 +153,23 @@ unsigned char* FileUtilsAndroid::doGetFileData(const char* filename, const char*
     }
     
     string fullPath = fullPathForFilename(filename);
+
+    // the resource packs are searched first
+    unsigned long packedSize = 0;
+    pData = getFileDataFromResourcePack(fullPath, &packedSize);
+    if (pData)
+    {
+        if (pSize)
+        {
+            *pSize = packedSize;
+        }
+        return pData;
+    }
     
     if (fullPath[0] != '/')
     {
-        
-        // fullPathForFilename is not thread safe.
-        if (forAsync) {
-            LOGD("Async loading not supported. fullPathForFilename is not thread safe.");
-            return NULL;
-        }
-
-        string fullPath = fullPathForFilename(filename);
+        // fullPathForFilename is thread safe, and so is the asset manager
+        CC_UNUSED_PARAM(forAsync);
         LOGD("full path = %s", fullPath.c_str());
 
         string relativePath = string();
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "CCTextureCacheEmscripten.h"
 #include "platform/CCImage.h"
 #include "platform/CCFileUtils.h"
+#include "textures/CCTexture2DConvert.h"
 #include <emscripten/emscripten.h>
 #include <sstream>
 
@@ -99,19 +100,13 @@ void TextureCacheEmscripten_preMultiplyImageRegion(
     unsigned char *out, int wout, int hout, // Output image, its width and height
     int xout, int yout) // x and y offsets into the output image
 {
-    int iter = 0;
+    PixelConvertFunction premultiply = getPixelConverters().rgba8888ToPremultipliedRGBA8888;
     for(int j = 0; j < hin; j++)
     {
-        for(int i = 0; i < win; i++)
-        {
-            int inOffset = 4 * (j * win + i);
-            int outOffset = 4 * ((j + yout) * wout + (i + xout));
-
-            unsigned char *pin = in + inOffset;
-            unsigned int *pout = (unsigned int *) (out + outOffset);
+        int inOffset = 4 * (j * win);
+        int outOffset = 4 * ((j + yout) * wout + xout);
 
-            *pout = CC_RGB_PREMULTIPLY_ALPHA( pin[0], pin[1], pin[2], pin[3] );
-        }
+        premultiply(in + inOffset, 4 * win, out + outOffset);
     }
 }
 
@@ -155,7 +150,7 @@ void TextureCacheEmscripten::addImageAsyncCallBack_emscripten(AsyncStruct *data,
     delete data;
 }
 
-void TextureCacheEmscripten::addImageAsync(const char *path, Object *target, SEL_CallFuncO selector)
+void TextureCacheEmscripten::addImageAsync(const char *path, Object *target, SEL_CallFuncO selector, int priority)
 {
     CCAssert(path != NULL, "TextureCache: fileimage MUST not be NULL");    
 
@@ -185,6 +180,7 @@ void TextureCacheEmscripten::addImageAsync(const char *path, Object *target, SEL
     AsyncStruct *data = new AsyncStruct(fullpath, target, selector);
 
     // Call into JavaScript code in TextureCacheEmscripten.js to do the rest.
+    // The browser loads the images itself: the priority is ignored.
     cocos2dx_asyncImageLoader_LoadImage(data->filename.c_str(), data);
 
     return;
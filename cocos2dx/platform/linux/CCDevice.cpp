@@ -1,7 +1,10 @@
 #include "platform/CCDevice.h"
-#include <X11/Xlib.h>
 #include <stdio.h>
 
+#if ! CC_HEADLESS
+#include <X11/Xlib.h>
+#endif
+
 NS_CC_BEGIN
 
 int Device::getDPI()
@@ -9,6 +12,10 @@ int Device::getDPI()
 	static int dpi = -1;
 	if (dpi == -1)
 	{
+#if CC_HEADLESS
+		// no display to query
+		dpi = 160;
+#else
 		Display *dpy;
 	    char *displayname = NULL;
 	    int scr = 0; /* Screen number */
@@ -24,6 +31,7 @@ int Device::getDPI()
 	        ((double) DisplayWidthMM(dpy,scr)));
 	    dpi = (int) (xres + 0.5);
 	    //printf("dpi = %d\n", dpi);
+#endif
 	}
 	return dpi;
 }
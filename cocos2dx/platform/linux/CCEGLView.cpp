@@ -18,6 +18,7 @@
 bool initExtensions()
 {
     // Do nothing, on Linux we use GLEW.
+    return true;
 }
 
 NS_CC_BEGIN
@@ -25,8 +26,10 @@ NS_CC_BEGIN
 EGLView::EGLView()
 : _wasInit(false)
 , _frameZoomFactor(1.0f)
+#if ! CC_HEADLESS
 ,_window(nullptr)
 ,_context(nullptr)
+#endif
 {
 }
 
@@ -34,6 +37,8 @@ EGLView::~EGLView()
 {
 }
 
+#if ! CC_HEADLESS
+
 static std::string getApplicationName()
 {
     char fullpath[256] = {0};
@@ -114,6 +119,8 @@ void EGLView::setFrameZoomFactor(float fZoomFactor)
     Director::getInstance()->setProjection(Director::getInstance()->getProjection());
 }
 
+#endif // ! CC_HEADLESS
+
 float EGLView::getFrameZoomFactor()
 {
     return _frameZoomFactor;
@@ -141,6 +148,8 @@ bool EGLView::isOpenGLReady()
     return _wasInit;
 }
 
+#if ! CC_HEADLESS
+
 void EGLView::end()
 {
     SDL_GL_DeleteContext(_context);
@@ -247,6 +256,8 @@ void EGLView::pollInputEvents()
     }
 }
 
+#endif // ! CC_HEADLESS
+
 void EGLView::setIMEKeyboardState(bool bOpen)
 {
     _IMEKeyboardOpened = bOpen;
@@ -264,6 +275,8 @@ void EGLView::setIMEKeyboardState(bool bOpen)
     }
 }
 
+#if ! CC_HEADLESS
+
 bool EGLView::initGL()
 {
     GLenum GlewInitResult = glewInit();
@@ -297,6 +310,47 @@ bool EGLView::initGL()
     return true;
 }
 
+#else
+
+// Without a display there is no window nor input: the frame size only drives
+// the projection, and the null GL implementation (CCGLNull.cpp) accepts every call.
+void EGLView::setFrameSize(float width, float height)
+{
+    CCAssert(width!=0&&height!=0, "invalid window's size equal 0");
+
+    _wasInit = true;
+    EGLViewProtocol::setFrameSize(width, height);
+    initGL();
+}
+
+void EGLView::setFrameZoomFactor(float fZoomFactor)
+{
+    _frameZoomFactor = fZoomFactor;
+    Director::getInstance()->setProjection(Director::getInstance()->getProjection());
+}
+
+void EGLView::end()
+{
+    delete this;
+    exit(0);
+}
+
+void EGLView::swapBuffers()
+{
+}
+
+void EGLView::pollInputEvents()
+{
+}
+
+bool EGLView::initGL()
+{
+    log("Running headless with the null OpenGL implementation");
+    return true;
+}
+
+#endif // ! CC_HEADLESS
+
 void EGLView::destroyGL()
 {
 }
@@ -11,9 +11,12 @@
 #include "platform/CCCommon.h"
 #include "cocoa/CCGeometry.h"
 #include "platform/CCEGLViewProtocol.h"
-#include <SDL2/SDL.h>
 #include <set>
 
+#if ! CC_HEADLESS
+#include <SDL2/SDL.h>
+#endif
+
 bool initExtensions();
 
 NS_CC_BEGIN
@@ -65,8 +68,10 @@ private:
     bool _wasInit;
     float _frameZoomFactor;
 
+#if ! CC_HEADLESS
     SDL_Window *_window;
     SDL_GLContext _context;
+#endif
     // Several mouse instances are possible.
     std::set<int> _pressedMouseInstances;
     bool _IMEKeyboardOpened;
@@ -25,7 +25,15 @@ THE SOFTWARE.
 #ifndef __CCGL_H__
 #define __CCGL_H__
 
+#if CC_HEADLESS
+// Headless builds link against the null GL implementation in CCGLNull.cpp
+// instead of GLEW, so that the engine runs without a display or a GPU.
+#define GL_GLEXT_PROTOTYPES 1
+#include <GL/gl.h>
+#include <GL/glext.h>
+#else
 #include "GL/glew.h"
+#endif
 
 #define CC_GL_DEPTH24_STENCIL8		GL_DEPTH24_STENCIL8
 
@@ -0,0 +1,372 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Null OpenGL implementation used by the headless Linux builds (HEADLESS=1).
+ *
+ * Every entry point the engine calls is implemented without touching a GPU:
+ * object names are allocated, shaders always compile and link, and the state
+ * that the engine reads back (bindings, viewport, clear values, stencil state)
+ * is tracked so that the queries return what was set. Draw calls do nothing,
+ * which leaves the CPU cost of update, visit and command submission to measure.
+ */
+
+#include "CCGL.h"
+
+#if CC_HEADLESS
+
+#include <string.h>
+#include <functional>
+#include <string>
+#include <unordered_set>
+
+namespace {
+
+struct NullGLState
+{
+    NullGLState()
+    : nextName(1)
+    , framebuffer(0)
+    , renderbuffer(0)
+    , clearDepth(1.0f)
+    , clearStencil(0)
+    , depthMask(GL_TRUE)
+    , stencilFunc(GL_ALWAYS)
+    , stencilRef(0)
+    , stencilValueMask(~0u)
+    , stencilWriteMask(~0u)
+    , stencilFail(GL_KEEP)
+    , stencilPassDepthFail(GL_KEEP)
+    , stencilPassDepthPass(GL_KEEP)
+    , alphaFunc(GL_ALWAYS)
+    , alphaRef(0)
+    {
+        memset(viewport, 0, sizeof(viewport));
+        memset(scissorBox, 0, sizeof(scissorBox));
+        memset(clearColor, 0, sizeof(clearColor));
+    }
+
+    GLuint nextName;
+    std::unordered_set<GLenum> enabled;
+
+    GLint framebuffer;
+    GLint renderbuffer;
+    GLint viewport[4];
+    GLint scissorBox[4];
+
+    GLfloat clearColor[4];
+    GLfloat clearDepth;
+    GLint clearStencil;
+
+    GLboolean depthMask;
+    GLenum stencilFunc;
+    GLint stencilRef;
+    GLuint stencilValueMask;
+    GLuint stencilWriteMask;
+    GLenum stencilFail;
+    GLenum stencilPassDepthFail;
+    GLenum stencilPassDepthPass;
+    GLenum alphaFunc;
+    GLfloat alphaRef;
+};
+
+// GL is only called from the main thread
+NullGLState s_state;
+
+void generateNames(GLsizei n, GLuint *names)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        names[i] = s_state.nextName++;
+    }
+}
+
+// Returns the value of an integer state, or false if the state is not tracked
+bool getInteger(GLenum pname, GLint *params)
+{
+    switch (pname)
+    {
+        case GL_FRAMEBUFFER_BINDING:            params[0] = s_state.framebuffer; return true;
+        case GL_RENDERBUFFER_BINDING:           params[0] = s_state.renderbuffer; return true;
+        case GL_VIEWPORT:                       memcpy(params, s_state.viewport, sizeof(s_state.viewport)); return true;
+        case GL_SCISSOR_BOX:                    memcpy(params, s_state.scissorBox, sizeof(s_state.scissorBox)); return true;
+        case GL_STENCIL_CLEAR_VALUE:            params[0] = s_state.clearStencil; return true;
+        case GL_STENCIL_BITS:                   params[0] = 8; return true;
+        case GL_STENCIL_FUNC:                   params[0] = s_state.stencilFunc; return true;
+        case GL_STENCIL_REF:                    params[0] = s_state.stencilRef; return true;
+        case GL_STENCIL_VALUE_MASK:             params[0] = s_state.stencilValueMask; return true;
+        case GL_STENCIL_WRITEMASK:              params[0] = s_state.stencilWriteMask; return true;
+        case GL_STENCIL_FAIL:                   params[0] = s_state.stencilFail; return true;
+        case GL_STENCIL_PASS_DEPTH_FAIL:        params[0] = s_state.stencilPassDepthFail; return true;
+        case GL_STENCIL_PASS_DEPTH_PASS:        params[0] = s_state.stencilPassDepthPass; return true;
+        case GL_ALPHA_TEST_FUNC:                params[0] = s_state.alphaFunc; return true;
+        case GL_MAX_TEXTURE_SIZE:               params[0] = 4096; return true;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: params[0] = 16; return true;
+        default:                                return false;
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+// textures
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint *textures) { generateNames(n, textures); }
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint *textures) {}
+void GLAPIENTRY glActiveTexture(GLenum texture) {}
+void GLAPIENTRY glBindTexture(GLenum target, GLuint texture) {}
+void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param) {}
+void GLAPIENTRY glPixelStorei(GLenum pname, GLint param) {}
+void GLAPIENTRY glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+                             GLint border, GLenum format, GLenum type, const GLvoid *pixels) {}
+void GLAPIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height,
+                                       GLint border, GLsizei imageSize, const GLvoid *data) {}
+void APIENTRY glGenerateMipmap(GLenum target) {}
+
+// buffers
+
+void APIENTRY glGenBuffers(GLsizei n, GLuint *buffers) { generateNames(n, buffers); }
+void APIENTRY glDeleteBuffers(GLsizei n, const GLuint *buffers) {}
+void APIENTRY glBindBuffer(GLenum target, GLuint buffer) {}
+void APIENTRY glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {}
+void APIENTRY glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {}
+
+// framebuffers
+
+void APIENTRY glGenFramebuffers(GLsizei n, GLuint *framebuffers) { generateNames(n, framebuffers); }
+void APIENTRY glDeleteFramebuffers(GLsizei n, const GLuint *framebuffers) {}
+void APIENTRY glBindFramebuffer(GLenum target, GLuint framebuffer) { s_state.framebuffer = framebuffer; }
+void APIENTRY glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {}
+void APIENTRY glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {}
+GLenum APIENTRY glCheckFramebufferStatus(GLenum target) { return GL_FRAMEBUFFER_COMPLETE; }
+void APIENTRY glGenRenderbuffers(GLsizei n, GLuint *renderbuffers) { generateNames(n, renderbuffers); }
+void APIENTRY glDeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers) {}
+void APIENTRY glBindRenderbuffer(GLenum target, GLuint renderbuffer) { s_state.renderbuffer = renderbuffer; }
+void APIENTRY glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {}
+
+void GLAPIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels)
+{
+    // only used to read back RGBA8888 render textures
+    memset(pixels, 0, width * height * 4);
+}
+
+// shaders and programs
+
+GLuint APIENTRY glCreateShader(GLenum type) { return s_state.nextName++; }
+void APIENTRY glDeleteShader(GLuint shader) {}
+void APIENTRY glShaderSource(GLuint shader, GLsizei count, const GLchar *const*string, const GLint *length) {}
+void APIENTRY glCompileShader(GLuint shader) {}
+GLuint APIENTRY glCreateProgram(void) { return s_state.nextName++; }
+void APIENTRY glDeleteProgram(GLuint program) {}
+void APIENTRY glAttachShader(GLuint program, GLuint shader) {}
+void APIENTRY glBindAttribLocation(GLuint program, GLuint index, const GLchar *name) {}
+void APIENTRY glLinkProgram(GLuint program) {}
+void APIENTRY glUseProgram(GLuint program) {}
+
+void APIENTRY glGetShaderiv(GLuint shader, GLenum pname, GLint *params)
+{
+    params[0] = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+void APIENTRY glGetProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+    params[0] = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+}
+
+void APIENTRY glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    if (length) *length = 0;
+    if (bufSize > 0) infoLog[0] = '\0';
+}
+
+void APIENTRY glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    if (length) *length = 0;
+    if (bufSize > 0) infoLog[0] = '\0';
+}
+
+void APIENTRY glGetShaderSource(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *source)
+{
+    if (length) *length = 0;
+    if (bufSize > 0) source[0] = '\0';
+}
+
+GLint APIENTRY glGetUniformLocation(GLuint program, const GLchar *name)
+{
+    // stable and distinct per uniform, so that the uniform value caches behave as with a driver
+    return (GLint)((std::hash<std::string>()(name) ^ program) & 0x7fffffff);
+}
+
+void APIENTRY glUniform1f(GLint location, GLfloat v0) {}
+void APIENTRY glUniform1i(GLint location, GLint v0) {}
+void APIENTRY glUniform2f(GLint location, GLfloat v0, GLfloat v1) {}
+void APIENTRY glUniform2fv(GLint location, GLsizei count, const GLfloat *value) {}
+void APIENTRY glUniform2i(GLint location, GLint v0, GLint v1) {}
+void APIENTRY glUniform2iv(GLint location, GLsizei count, const GLint *value) {}
+void APIENTRY glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {}
+void APIENTRY glUniform3fv(GLint location, GLsizei count, const GLfloat *value) {}
+void APIENTRY glUniform3i(GLint location, GLint v0, GLint v1, GLint v2) {}
+void APIENTRY glUniform3iv(GLint location, GLsizei count, const GLint *value) {}
+void APIENTRY glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {}
+void APIENTRY glUniform4fv(GLint location, GLsizei count, const GLfloat *value) {}
+void APIENTRY glUniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3) {}
+void APIENTRY glUniform4iv(GLint location, GLsizei count, const GLint *value) {}
+void APIENTRY glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) {}
+
+// vertex attributes and drawing
+
+void APIENTRY glEnableVertexAttribArray(GLuint index) {}
+void APIENTRY glDisableVertexAttribArray(GLuint index) {}
+void APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) {}
+void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count) {}
+void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices) {}
+void GLAPIENTRY glLineWidth(GLfloat width) {}
+void GLAPIENTRY glFlush(void) {}
+
+// fixed function state
+
+void GLAPIENTRY glEnable(GLenum cap) { s_state.enabled.insert(cap); }
+void GLAPIENTRY glDisable(GLenum cap) { s_state.enabled.erase(cap); }
+GLboolean GLAPIENTRY glIsEnabled(GLenum cap) { return s_state.enabled.count(cap) ? GL_TRUE : GL_FALSE; }
+
+void GLAPIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    s_state.viewport[0] = x;
+    s_state.viewport[1] = y;
+    s_state.viewport[2] = width;
+    s_state.viewport[3] = height;
+}
+
+void GLAPIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    s_state.scissorBox[0] = x;
+    s_state.scissorBox[1] = y;
+    s_state.scissorBox[2] = width;
+    s_state.scissorBox[3] = height;
+}
+
+void GLAPIENTRY glClear(GLbitfield mask) {}
+
+void GLAPIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    s_state.clearColor[0] = red;
+    s_state.clearColor[1] = green;
+    s_state.clearColor[2] = blue;
+    s_state.clearColor[3] = alpha;
+}
+
+void GLAPIENTRY glClearDepth(GLclampd depth) { s_state.clearDepth = (GLfloat)depth; }
+void GLAPIENTRY glClearStencil(GLint s) { s_state.clearStencil = s; }
+void GLAPIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) {}
+void GLAPIENTRY glBlendEquation(GLenum mode) {}
+void GLAPIENTRY glDepthFunc(GLenum func) {}
+void GLAPIENTRY glDepthMask(GLboolean flag) { s_state.depthMask = flag; }
+
+void GLAPIENTRY glAlphaFunc(GLenum func, GLclampf ref)
+{
+    s_state.alphaFunc = func;
+    s_state.alphaRef = ref;
+}
+
+void GLAPIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    s_state.stencilFunc = func;
+    s_state.stencilRef = ref;
+    s_state.stencilValueMask = mask;
+}
+
+void GLAPIENTRY glStencilMask(GLuint mask) { s_state.stencilWriteMask = mask; }
+
+void GLAPIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+    s_state.stencilFail = fail;
+    s_state.stencilPassDepthFail = zfail;
+    s_state.stencilPassDepthPass = zpass;
+}
+
+// queries
+
+GLenum GLAPIENTRY glGetError(void) { return GL_NO_ERROR; }
+
+const GLubyte* GLAPIENTRY glGetString(GLenum name)
+{
+    switch (name)
+    {
+        case GL_VENDOR:     return (const GLubyte*)"cocos2d-x";
+        case GL_RENDERER:   return (const GLubyte*)"null";
+        case GL_VERSION:    return (const GLubyte*)"2.0 null";
+        case GL_EXTENSIONS: return (const GLubyte*)"GL_ARB_texture_non_power_of_two GL_ARB_framebuffer_object GL_ARB_vertex_buffer_object";
+        default:            return (const GLubyte*)"";
+    }
+}
+
+void GLAPIENTRY glGetIntegerv(GLenum pname, GLint *params)
+{
+    if (! getInteger(pname, params))
+    {
+        params[0] = 0;
+    }
+}
+
+void GLAPIENTRY glGetFloatv(GLenum pname, GLfloat *params)
+{
+    switch (pname)
+    {
+        case GL_COLOR_CLEAR_VALUE:  memcpy(params, s_state.clearColor, sizeof(s_state.clearColor)); break;
+        case GL_DEPTH_CLEAR_VALUE:  params[0] = s_state.clearDepth; break;
+        case GL_ALPHA_TEST_REF:     params[0] = s_state.alphaRef; break;
+        case GL_SCISSOR_BOX:
+            for (int i = 0; i < 4; ++i)
+            {
+                params[i] = (GLfloat)s_state.scissorBox[i];
+            }
+            break;
+        default:
+        {
+            GLint value[4] = {0};
+            getInteger(pname, value);
+            params[0] = (GLfloat)value[0];
+            break;
+        }
+    }
+}
+
+void GLAPIENTRY glGetBooleanv(GLenum pname, GLboolean *params)
+{
+    if (pname == GL_DEPTH_WRITEMASK)
+    {
+        params[0] = s_state.depthMask;
+    }
+    else
+    {
+        GLint value[4] = {0};
+        getInteger(pname, value);
+        params[0] = value[0] ? GL_TRUE : GL_FALSE;
+    }
+}
+
+} // extern "C"
+
+#endif // CC_HEADLESS
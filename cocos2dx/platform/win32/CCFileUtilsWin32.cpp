@@ -23,6 +23,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "CCFileUtilsWin32.h"
 #include "platform/CCCommon.h"
+#include "support/CCFrameProfiler.h"
 #include <Shlobj.h>
 
 using namespace std;
@@ -123,14 +124,20 @@ bool FileUtilsWin32::isAbsolutePath(const std::string& strPath)
 
 unsigned char* FileUtilsWin32::getFileData(const char* filename, const char* mode, unsigned long* size)
 {
+    CC_PROFILE_ZONE(FrameProfiler::ZONE_FILE_READ);
+
     unsigned char * pBuffer = NULL;
     CCASSERT(filename != NULL && size != NULL && mode != NULL, "Invalid parameters.");
     *size = 0;
     do
     {
-        // read the file from hardware
         std::string fullPath = fullPathForFilename(filename);
 
+        // the resource packs are searched first
+        pBuffer = getFileDataFromResourcePack(fullPath, size);
+        CC_BREAK_IF(pBuffer);
+
+        // read the file from hardware
         WCHAR wszBuf[CC_MAX_PATH] = {0};
         MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, wszBuf, sizeof(wszBuf));
 
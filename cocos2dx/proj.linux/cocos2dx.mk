@@ -7,6 +7,7 @@
 # - V=1      : Enables the verbose mode.
 # - DEBUG=1  : Enables the debug mode, disable compiler optimizations.
 # - OPENAL=1 : Uses OpenAL instead of FMOD as sound engine.
+# - HEADLESS=1 : Runs without a display nor a GPU, on a null OpenGL implementation.
 #
 ################################################################################
 
@@ -84,6 +85,16 @@ LIB_DIR := $(LIB_DIR)/release
 BIN_DIR := $(BIN_DIR)/release
 endif
 
+ifeq ($(HEADLESS), 1)
+DEFINES += -DCC_HEADLESS=1
+OBJ_DIR := $(OBJ_DIR)/headless
+LIB_DIR := $(LIB_DIR)/headless
+# same directory as the regular executable, which locates the resources from it
+ifdef EXECUTABLE
+EXECUTABLE := $(EXECUTABLE)-headless
+endif
+endif
+
 ifndef V
 LOG_CC = @echo " CC $@";
 LOG_CXX = @echo " CXX $@";
@@ -120,11 +131,18 @@ SHAREDLIBS += -lfmodex
 endif
 endif
 
+ifeq ($(HEADLESS), 1)
+SHAREDLIBS += -lfontconfig -lpthread -lpng
+else
 SHAREDLIBS += -lSDL2 -lGLEW -lfontconfig -lpthread -lGL -lpng
+endif
 SHAREDLIBS += -L$(FMOD_LIBDIR) -Wl,-rpath,$(abspath $(FMOD_LIBDIR))
 SHAREDLIBS += -L$(LIB_DIR) -Wl,-rpath,$(abspath $(LIB_DIR))
 
-LIBS = -lrt -lz -lX11
+LIBS = -lrt -lz
+ifneq ($(HEADLESS), 1)
+LIBS += -lX11
+endif
 
 clean:
 	rm -rf $(OBJ_DIR)
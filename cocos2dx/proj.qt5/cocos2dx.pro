@@ -25,8 +25,10 @@ SOURCES += ../actions/CCAction.cpp \
 ../actions/CCActionTween.cpp \
 ../base_nodes/CCAtlasNode.cpp \
 ../base_nodes/CCNode.cpp \
+../base_nodes/CCTransformUpdater.cpp \
 ../cocoa/CCAffineTransform.cpp \
 ../cocoa/CCAutoreleasePool.cpp \
+../cocoa/CCObjectPool.cpp \
 ../cocoa/CCGeometry.cpp \
 ../cocoa/CCNS.cpp \
 ../cocoa/CCObject.cpp \
@@ -60,11 +62,13 @@ SOURCES += ../actions/CCAction.cpp \
 ../particle_nodes/CCParticleExamples.cpp \
 ../particle_nodes/CCParticleSystem.cpp \
 ../particle_nodes/CCParticleSystemQuad.cpp \
+../particle_nodes/CCParticleSimulator.cpp \
 ../particle_nodes/CCParticleBatchNode.cpp \
 ../platform/CCSAXParser.cpp \
 ../platform/CCThread.cpp \
 ../platform/CCEGLViewProtocol.cpp \
 ../platform/CCFileUtils.cpp \
+../platform/CCResourcePack.cpp \
 ../platform/qt5/CCCommon.cpp \
 ../platform/qt5/CCFileUtilsQt5.cpp \
 ../platform/qt5/CCEGLView.cpp \
@@ -80,10 +84,18 @@ SOURCES += ../actions/CCAction.cpp \
 ../sprite_nodes/CCSpriteBatchNode.cpp \
 ../sprite_nodes/CCSpriteFrame.cpp \
 ../sprite_nodes/CCSpriteFrameCache.cpp \
+../sprite_nodes/CCSpriteFrameAtlas.cpp \
 ../support/ccUTF8.cpp \
 ../support/CCProfiling.cpp \
+../support/CCFrameProfiler.cpp \
+../support/CCFrameArena.cpp \
 ../support/user_default/CCUserDefault.cpp \
 ../support/TransformUtils.cpp \
+../support/CCThreadPool.cpp \
+../renderer/CCRenderer.cpp \
+../renderer/CCQuadCommand.cpp \
+../renderer/CCCustomCommand.cpp \
+../renderer/CCGroupCommand.cpp \
 ../support/base64.cpp \
 ../support/ccUtils.cpp \
 ../support/CCVertex.cpp \
@@ -99,6 +111,8 @@ SOURCES += ../actions/CCAction.cpp \
 ../text_input_node/CCIMEDispatcher.cpp \
 ../text_input_node/CCTextFieldTTF.cpp \
 ../textures/CCTexture2D.cpp \
+../textures/CCTexture2DConvert.cpp \
+../textures/CCTexture2DConvertNEON.cpp \
 ../textures/CCTextureAtlas.cpp \
 ../textures/CCTextureCache.cpp \
 ../platform/third_party/common/etc/etc1.cpp \
@@ -0,0 +1,56 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCCustomCommand.h"
+#include "kazmath/GL/matrix.h"
+
+NS_CC_BEGIN
+
+CustomCommand::CustomCommand()
+: func(nullptr)
+{
+    _type = RenderCommand::Type::CUSTOM_COMMAND;
+}
+
+void CustomCommand::init(float globalOrder)
+{
+    _globalOrder = globalOrder;
+    kmGLGetMatrix(KM_GL_MODELVIEW, &_modelView);
+}
+
+void CustomCommand::execute()
+{
+    if (func)
+    {
+        kmGLPushMatrix();
+        kmGLLoadMatrix(&_modelView);
+
+        func();
+
+        kmGLMatrixMode(KM_GL_MODELVIEW);
+        kmGLPopMatrix();
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,69 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCCUSTOMCOMMAND_H__
+#define __CCCUSTOMCOMMAND_H__
+
+#include <functional>
+
+#include "renderer/CCRenderCommand.h"
+#include "kazmath/mat4.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/** Command that runs arbitrary GL code.
+ The modelview matrix that was current when the command was initialized is restored
+ while the callback runs, so draw() implementations written for the immediate mode keep working.
+ The Renderer draws all the pending quads before executing a custom command.
+ @since v3.0
+ */
+class CC_DLL CustomCommand : public RenderCommand
+{
+public:
+    CustomCommand();
+
+    /** Initializes the command with the current modelview matrix */
+    void init(float globalOrder);
+
+    /** Runs the callback with the recorded modelview matrix */
+    void execute();
+
+    /** Callback that issues the GL calls */
+    std::function<void()> func;
+
+protected:
+    kmMat4 _modelView;
+};
+
+// end of renderer group
+/// @}
+
+NS_CC_END
+
+#endif // __CCCUSTOMCOMMAND_H__
@@ -0,0 +1,65 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCGROUPCOMMAND_H__
+#define __CCGROUPCOMMAND_H__
+
+#include "renderer/CCRenderCommand.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/** Command that draws a whole render queue in place.
+ The commands of the queue are sorted among themselves, so global Z sorting can't move
+ them outside of the group. Nodes use it to keep their subtree between two custom commands
+ (e.g. the grid effects capture their children into a texture).
+ @since v3.0
+ */
+class CC_DLL GroupCommand : public RenderCommand
+{
+public:
+    GroupCommand();
+
+    /** Initializes the command.
+     @param globalOrder the global Z order of the command
+     @param renderQueueID the queue created with Renderer::createRenderQueue()
+     */
+    void init(float globalOrder, int renderQueueID);
+
+    inline int getRenderQueueID() const { return _renderQueueID; }
+
+protected:
+    int _renderQueueID;
+};
+
+// end of renderer group
+/// @}
+
+NS_CC_END
+
+#endif // __CCGROUPCOMMAND_H__
@@ -0,0 +1,62 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCQuadCommand.h"
+#include "kazmath/vec3.h"
+
+NS_CC_BEGIN
+
+static inline void transformVertex(Vertex3F& vertex, const kmMat4& matrix)
+{
+    kmVec3 vec;
+    kmVec3Fill(&vec, vertex.x, vertex.y, vertex.z);
+    kmVec3Transform(&vec, &vec, &matrix);
+    vertex.x = vec.x;
+    vertex.y = vec.y;
+    vertex.z = vec.z;
+}
+
+QuadCommand::QuadCommand()
+: _textureID(0)
+, _shader(nullptr)
+, _blendType(BlendFunc::DISABLE)
+{
+    _type = RenderCommand::Type::QUAD_COMMAND;
+}
+
+void QuadCommand::init(float globalOrder, GLuint textureID, GLProgram* shader, const BlendFunc& blendType, const V3F_C4B_T2F_Quad& quad, const kmMat4& modelView)
+{
+    _globalOrder = globalOrder;
+    _textureID = textureID;
+    _shader = shader;
+    _blendType = blendType;
+
+    _quad = quad;
+    transformVertex(_quad.bl.vertices, modelView);
+    transformVertex(_quad.br.vertices, modelView);
+    transformVertex(_quad.tl.vertices, modelView);
+    transformVertex(_quad.tr.vertices, modelView);
+}
+
+NS_CC_END
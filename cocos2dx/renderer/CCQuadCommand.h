@@ -0,0 +1,101 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCQUADCOMMAND_H__
+#define __CCQUADCOMMAND_H__
+
+#include "renderer/CCRenderCommand.h"
+#include "ccTypes.h"
+#include "kazmath/mat4.h"
+
+NS_CC_BEGIN
+
+class GLProgram;
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/** Command that draws one textured quad.
+ The vertices are transformed to world coordinates when the command is initialized,
+ so consecutive quads using the same texture, shader and blend function are merged
+ by the Renderer into a single draw call.
+ @since v3.0
+ */
+class CC_DLL QuadCommand : public RenderCommand
+{
+public:
+    QuadCommand();
+
+    /** Initializes the command.
+     @param globalOrder the global Z order of the command
+     @param textureID the GL name of the texture used by the quad
+     @param shader the program used to draw the quad
+     @param blendType the blend function used to draw the quad
+     @param quad the quad, in node coordinates
+     @param modelView the matrix that converts the node coordinates to world coordinates
+     */
+    void init(float globalOrder, GLuint textureID, GLProgram* shader, const BlendFunc& blendType, const V3F_C4B_T2F_Quad& quad, const kmMat4& modelView);
+
+    /** Returns whether both commands can be drawn with the same GL state */
+    inline bool hasSameMaterial(const QuadCommand* other) const
+    {
+        return _textureID == other->_textureID
+            && _shader == other->_shader
+            && _blendType.src == other->_blendType.src
+            && _blendType.dst == other->_blendType.dst;
+    }
+
+    /** Orders the commands by texture, shader and blend function, so the ones with the same material are consecutive */
+    inline bool hasMaterialLessThan(const QuadCommand* other) const
+    {
+        if (_textureID != other->_textureID)
+            return _textureID < other->_textureID;
+        if (_shader != other->_shader)
+            return _shader < other->_shader;
+        if (_blendType.src != other->_blendType.src)
+            return _blendType.src < other->_blendType.src;
+        return _blendType.dst < other->_blendType.dst;
+    }
+
+    inline GLuint getTextureID() const { return _textureID; }
+    inline GLProgram* getShader() const { return _shader; }
+    inline const BlendFunc& getBlendType() const { return _blendType; }
+    /** Returns the quad, already in world coordinates */
+    inline const V3F_C4B_T2F_Quad& getQuad() const { return _quad; }
+
+protected:
+    GLuint _textureID;
+    GLProgram* _shader;
+    BlendFunc _blendType;
+    V3F_C4B_T2F_Quad _quad;
+};
+
+// end of renderer group
+/// @}
+
+NS_CC_END
+
+#endif // __CCQUADCOMMAND_H__
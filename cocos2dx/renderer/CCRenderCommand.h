@@ -0,0 +1,76 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCRENDERCOMMAND_H__
+#define __CCRENDERCOMMAND_H__
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/** Base class of the commands recorded by the Renderer while the scene graph is visited.
+ Commands are lightweight: they are allocated from per-frame pools owned by the Renderer
+ and are only valid until Renderer::render() returns.
+ @since v3.0
+ */
+class CC_DLL RenderCommand
+{
+public:
+    enum class Type
+    {
+        QUAD_COMMAND,
+        CUSTOM_COMMAND,
+        GROUP_COMMAND,
+        UNKNOWN_COMMAND,
+    };
+
+    virtual ~RenderCommand() {}
+
+    /** Returns the type of the command */
+    inline Type getType() const { return _type; }
+
+    /** Returns the global Z order used to sort the commands of a render queue */
+    inline float getGlobalOrder() const { return _globalOrder; }
+
+protected:
+    RenderCommand()
+    : _type(Type::UNKNOWN_COMMAND)
+    , _globalOrder(0)
+    {}
+
+    Type _type;
+    float _globalOrder;
+};
+
+// end of renderer group
+/// @}
+
+NS_CC_END
+
+#endif // __CCRENDERCOMMAND_H__
@@ -0,0 +1,378 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCRenderer.h"
+
+#include <algorithm>
+#include <stddef.h>
+
+#include "shaders/CCGLProgram.h"
+#include "shaders/ccGLStateCache.h"
+#include "support/CCNotificationCenter.h"
+#include "CCEventType.h"
+#include "ccMacros.h"
+#include "kazmath/GL/matrix.h"
+
+NS_CC_BEGIN
+
+static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+{
+    return a->getGlobalOrder() < b->getGlobalOrder();
+}
+
+static bool compareQuadCommandMaterial(RenderCommand* a, RenderCommand* b)
+{
+    return static_cast<QuadCommand*>(a)->hasMaterialLessThan(static_cast<QuadCommand*>(b));
+}
+
+Renderer::Renderer()
+: _numQuads(0)
+, _enabled(false)
+, _materialSortEnabled(false)
+, _recording(false)
+, _glViewAssigned(false)
+, _drawnBatches(0)
+, _drawnQuads(0)
+{
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+
+    // queue 0 is the main render queue
+    _renderGroups.push_back(RenderQueue());
+    _commandGroupStack.push(0);
+
+    _batchedQuadCommands.reserve(VBO_SIZE);
+}
+
+Renderer::~Renderer()
+{
+    if (_glViewAssigned)
+    {
+        glDeleteBuffers(2, _buffersVBO);
+    }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    NotificationCenter::getInstance()->removeObserver(this, EVNET_COME_TO_FOREGROUND);
+#endif
+}
+
+void Renderer::initGLView()
+{
+    if (_glViewAssigned)
+    {
+        return;
+    }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // listen the event when app go to background
+    NotificationCenter::getInstance()->addObserver(this,
+                                                   callfuncO_selector(Renderer::listenBackToForeground),
+                                                   EVNET_COME_TO_FOREGROUND,
+                                                   NULL);
+#endif
+
+    setupIndices();
+    setupVBO();
+
+    _glViewAssigned = true;
+}
+
+void Renderer::listenBackToForeground(Object *obj)
+{
+    CC_UNUSED_PARAM(obj);
+    setupVBO();
+}
+
+void Renderer::setupIndices()
+{
+    for( int i=0; i < VBO_SIZE; i++)
+    {
+        _indices[i*6+0] = (GLushort) (i*4+0);
+        _indices[i*6+1] = (GLushort) (i*4+1);
+        _indices[i*6+2] = (GLushort) (i*4+2);
+        _indices[i*6+3] = (GLushort) (i*4+3);
+        _indices[i*6+4] = (GLushort) (i*4+2);
+        _indices[i*6+5] = (GLushort) (i*4+1);
+    }
+}
+
+void Renderer::setupVBO()
+{
+    glGenBuffers(2, &_buffersVBO[0]);
+
+    mapBuffers();
+}
+
+void Renderer::mapBuffers()
+{
+    // Avoid changing the element buffer for whatever VAO might be bound.
+    GL::bindVAO(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, _quads, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void Renderer::setEnabled(bool enabled)
+{
+    CCASSERT(!_recording, "Can't toggle the render queue while recording a frame");
+    _enabled = enabled;
+}
+
+void Renderer::setMaterialSortEnabled(bool enabled)
+{
+    CCASSERT(!_recording, "Can't toggle the material sort while recording a frame");
+    _materialSortEnabled = enabled;
+}
+
+void Renderer::beginFrame()
+{
+    _recording = _enabled && _glViewAssigned;
+}
+
+QuadCommand* Renderer::newQuadCommand()
+{
+    return _quadCommandPool.generateCommand();
+}
+
+CustomCommand* Renderer::newCustomCommand()
+{
+    return _customCommandPool.generateCommand();
+}
+
+GroupCommand* Renderer::newGroupCommand()
+{
+    return _groupCommandPool.generateCommand();
+}
+
+void Renderer::addCommand(RenderCommand* command)
+{
+    addCommand(command, _commandGroupStack.top());
+}
+
+void Renderer::addCommand(RenderCommand* command, int renderQueueID)
+{
+    CCASSERT(_recording, "The render queue is not recording");
+    CCASSERT(renderQueueID >= 0 && renderQueueID < (int)_renderGroups.size(), "Invalid render queue");
+    CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid render command");
+
+    _renderGroups[renderQueueID].push_back(command);
+}
+
+void Renderer::pushGroup(int renderQueueID)
+{
+    _commandGroupStack.push(renderQueueID);
+}
+
+void Renderer::popGroup()
+{
+    CCASSERT(_commandGroupStack.size() > 1, "Can't pop the main render queue");
+    _commandGroupStack.pop();
+}
+
+int Renderer::createRenderQueue()
+{
+    _renderGroups.push_back(RenderQueue());
+    return (int)_renderGroups.size() - 1;
+}
+
+void Renderer::render()
+{
+    if (!_recording)
+    {
+        return;
+    }
+
+    // from now on, the nodes visited by the custom commands draw immediately
+    _recording = false;
+
+    _drawnBatches = _drawnQuads = 0;
+
+    // the stable sort keeps the order of the visit for the commands that share the same global Z
+    for (auto &queue : _renderGroups)
+    {
+        std::stable_sort(queue.begin(), queue.end(), compareRenderCommand);
+
+        if (_materialSortEnabled)
+        {
+            sortByMaterial(queue);
+        }
+    }
+
+    visitRenderQueue(_renderGroups[0]);
+    flush();
+
+    // release the commands of the frame
+    for (auto &queue : _renderGroups)
+    {
+        queue.clear();
+    }
+    _renderGroups.resize(1);
+
+    while (_commandGroupStack.size() > 1)
+    {
+        _commandGroupStack.pop();
+    }
+
+    _quadCommandPool.reset();
+    _customCommandPool.reset();
+    _groupCommandPool.reset();
+}
+
+void Renderer::sortByMaterial(RenderQueue& queue)
+{
+    // the custom and group commands stay where they are: they draw with the GL state of the visit
+    auto runStart = queue.begin();
+    while (runStart != queue.end())
+    {
+        if ((*runStart)->getType() != RenderCommand::Type::QUAD_COMMAND)
+        {
+            ++runStart;
+            continue;
+        }
+
+        auto runEnd = runStart + 1;
+        while (runEnd != queue.end()
+               && (*runEnd)->getType() == RenderCommand::Type::QUAD_COMMAND
+               && (*runEnd)->getGlobalOrder() == (*runStart)->getGlobalOrder())
+        {
+            ++runEnd;
+        }
+
+        std::stable_sort(runStart, runEnd, compareQuadCommandMaterial);
+        runStart = runEnd;
+    }
+}
+
+void Renderer::visitRenderQueue(const RenderQueue& queue)
+{
+    for (auto command : queue)
+    {
+        switch (command->getType())
+        {
+            case RenderCommand::Type::QUAD_COMMAND:
+            {
+                if (_numQuads >= VBO_SIZE)
+                {
+                    flush();
+                }
+
+                auto quadCommand = static_cast<QuadCommand*>(command);
+                _quads[_numQuads++] = quadCommand->getQuad();
+                _batchedQuadCommands.push_back(quadCommand);
+                break;
+            }
+            case RenderCommand::Type::CUSTOM_COMMAND:
+            {
+                flush();
+                static_cast<CustomCommand*>(command)->execute();
+                break;
+            }
+            case RenderCommand::Type::GROUP_COMMAND:
+            {
+                auto groupCommand = static_cast<GroupCommand*>(command);
+                visitRenderQueue(_renderGroups[groupCommand->getRenderQueueID()]);
+                break;
+            }
+            default:
+                CCASSERT(false, "Invalid render command");
+                break;
+        }
+    }
+}
+
+void Renderer::flush()
+{
+    if (_numQuads == 0)
+    {
+        return;
+    }
+
+    // the quads are already in world coordinates
+    kmGLMatrixMode(KM_GL_MODELVIEW);
+    kmGLPushMatrix();
+    kmGLLoadIdentity();
+
+#define kQuadSize sizeof(_quads[0].bl)
+    GL::bindVAO(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(_quads[0]) * _numQuads, _quads);
+
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+
+    // vertices
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
+
+    // colors
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
+
+    // tex coords
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+
+    // one draw call for every run of quads that share the same material
+    int start = 0;
+    for (int i = 1; i <= _numQuads; ++i)
+    {
+        const QuadCommand* first = _batchedQuadCommands[start];
+        if (i < _numQuads && first->hasSameMaterial(_batchedQuadCommands[i]))
+        {
+            continue;
+        }
+
+        GLProgram* shader = first->getShader();
+        shader->use();
+        shader->setUniformsForBuiltins();
+
+        GL::bindTexture2D(first->getTextureID());
+        GL::blendFunc(first->getBlendType().src, first->getBlendType().dst);
+
+        glDrawElements(GL_TRIANGLES, (GLsizei) (i - start) * 6, GL_UNSIGNED_SHORT, (GLvoid*) (start * 6 * sizeof(_indices[0])));
+
+        CC_INCREMENT_GL_DRAWS(1);
+        ++_drawnBatches;
+        start = i;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    kmGLMatrixMode(KM_GL_MODELVIEW);
+    kmGLPopMatrix();
+
+    CHECK_GL_ERROR_DEBUG();
+
+    _drawnQuads += _numQuads;
+    _numQuads = 0;
+    _batchedQuadCommands.clear();
+}
+
+NS_CC_END
@@ -0,0 +1,199 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCRENDERER_H__
+#define __CCRENDERER_H__
+
+#include <vector>
+#include <stack>
+
+#include "cocoa/CCObject.h"
+#include "ccTypes.h"
+#include "CCGL.h"
+#include "renderer/CCRenderCommand.h"
+#include "renderer/CCQuadCommand.h"
+#include "renderer/CCCustomCommand.h"
+#include "renderer/CCGroupCommand.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/** Fixed size pool of commands. The storage is allocated in blocks, so the returned
+ pointers stay valid until reset() is called, and reused across frames.
+ */
+template <class T>
+class RenderCommandPool
+{
+public:
+    RenderCommandPool() : _used(0) {}
+    ~RenderCommandPool()
+    {
+        for (auto block : _blocks)
+            delete [] block;
+    }
+
+    T* generateCommand()
+    {
+        if (_used == _blocks.size() * BLOCK_SIZE)
+        {
+            _blocks.push_back(new T[BLOCK_SIZE]);
+        }
+        T* command = &_blocks[_used / BLOCK_SIZE][_used % BLOCK_SIZE];
+        ++_used;
+        return command;
+    }
+
+    void reset() { _used = 0; }
+
+protected:
+    static const size_t BLOCK_SIZE = 256;
+
+    std::vector<T*> _blocks;
+    size_t _used;
+};
+
+/** @brief Renderer records the render commands emitted while the scene graph is visited and
+ draws them at the end of the frame.
+
+ When the render queue is enabled, Node::visit() doesn't draw: it adds commands to the current
+ render queue. Director::drawScene() then calls render(), which stable sorts every queue by
+ global Z order (nodes with the same global Z keep the order of the visit) and merges the
+ consecutive quads that share texture, shader and blend function into a single draw call.
+ This makes batching automatic for the sprites that are not children of a SpriteBatchNode.
+
+ While render() runs, the Renderer is not recording, so the nodes visited by a custom
+ command (e.g. a ClippingNode or a RenderTexture) are drawn immediately.
+
+ The render queue is disabled by default. It can be enabled with setEnabled() or with
+ the "cocos2d.x.render_queue" key of the Configuration.
+
+ Within a global Z, the order of the visit decides which of two overlapping quads is on top,
+ so by default only the neighbours of the visit are merged. setMaterialSortEnabled() (or the
+ "cocos2d.x.render_queue.sort_by_material" key) also sorts the consecutive quads of a global Z
+ by texture, shader and blend function, which batches interleaved materials but is only correct
+ when the quads of different materials that share a global Z don't overlap.
+ @since v3.0
+ */
+class CC_DLL Renderer : public Object
+{
+public:
+    /** Maximum number of quads that are uploaded to the VBO at once */
+    static const int VBO_SIZE = 65536 / 6;
+
+    Renderer();
+    virtual ~Renderer();
+
+    /** Creates the GL buffers. Must be called once the GL context is ready */
+    void initGLView();
+
+    /** Whether the visit of the scene records render commands instead of drawing */
+    inline bool isEnabled() const { return _enabled; }
+    void setEnabled(bool enabled);
+
+    /** Whether the quads of a same global Z are sorted by material before being batched */
+    inline bool isMaterialSortEnabled() const { return _materialSortEnabled; }
+    void setMaterialSortEnabled(bool enabled);
+
+    /** Returns true between beginFrame() and render(), when the commands are being recorded */
+    inline bool isRecording() const { return _recording; }
+
+    /** Starts recording the commands of a new frame, if the render queue is enabled */
+    void beginFrame();
+
+    /** Sorts, batches and draws the recorded commands, then releases them */
+    void render();
+
+    /** Commands are owned by the renderer, and are valid until the end of the frame */
+    QuadCommand* newQuadCommand();
+    CustomCommand* newCustomCommand();
+    GroupCommand* newGroupCommand();
+
+    /** Adds a command to the render queue on top of the group stack */
+    void addCommand(RenderCommand* command);
+    /** Adds a command to a given render queue */
+    void addCommand(RenderCommand* command, int renderQueueID);
+
+    /** Makes a render queue the destination of addCommand() */
+    void pushGroup(int renderQueueID);
+    void popGroup();
+
+    /** Creates an empty render queue. The queue must be drawn by a GroupCommand */
+    int createRenderQueue();
+
+    /** Number of draw calls issued for the quad commands during the last frame */
+    inline unsigned int getDrawnBatches() const { return _drawnBatches; }
+    /** Number of quads drawn during the last frame */
+    inline unsigned int getDrawnQuads() const { return _drawnQuads; }
+
+protected:
+    typedef std::vector<RenderCommand*> RenderQueue;
+
+    void setupIndices();
+    void setupVBO();
+    void mapBuffers();
+
+    /** Sorts by material every run of consecutive quad commands that share the same global Z */
+    void sortByMaterial(RenderQueue& queue);
+
+    void visitRenderQueue(const RenderQueue& queue);
+
+    /** Draws the quads batched so far, one draw call per material */
+    void flush();
+
+    /** rebuild the VBO when coming to foreground on Android */
+    void listenBackToForeground(Object *obj);
+
+    std::vector<RenderQueue> _renderGroups;
+    std::stack<int> _commandGroupStack;
+
+    RenderCommandPool<QuadCommand> _quadCommandPool;
+    RenderCommandPool<CustomCommand> _customCommandPool;
+    RenderCommandPool<GroupCommand> _groupCommandPool;
+
+    /** quads waiting to be drawn by flush(), in world coordinates */
+    V3F_C4B_T2F_Quad _quads[VBO_SIZE];
+    GLushort _indices[6 * VBO_SIZE];
+    GLuint _buffersVBO[2]; //0: vertex  1: indices
+    std::vector<const QuadCommand*> _batchedQuadCommands;
+    int _numQuads;
+
+    bool _enabled;
+    bool _materialSortEnabled;
+    bool _recording;
+    bool _glViewAssigned;
+
+    unsigned int _drawnBatches;
+    unsigned int _drawnQuads;
+};
+
+// end of renderer group
+/// @}
+
+NS_CC_END
+
+#endif // __CCRENDERER_H__
@@ -55,25 +55,22 @@ void AnimationCache::destroyInstance()
 
 bool AnimationCache::init()
 {
-    _animations = new Dictionary;
-    _animations->init();
+    _animations.reserve(20);
     return true;
 }
 
 AnimationCache::AnimationCache()
-: _animations(NULL)
 {
 }
 
 AnimationCache::~AnimationCache()
 {
     CCLOGINFO("deallocing AnimationCache: %p", this);
-    CC_SAFE_RELEASE(_animations);
 }
 
 void AnimationCache::addAnimation(Animation *animation, const char * name)
 {
-    _animations->setObject(animation, name);
+    _animations.insert(name, animation);
 }
 
 void AnimationCache::removeAnimationByName(const char* name)
@@ -83,12 +80,12 @@ void AnimationCache::removeAnimationByName(const char* name)
         return;
     }
 
-    _animations->removeObjectForKey(name);
+    _animations.erase(name);
 }
 
 Animation* AnimationCache::animationByName(const char* name)
 {
-    return (Animation*)_animations->objectForKey(name);
+    return _animations.at(name);
 }
 
 void AnimationCache::parseVersion1(Dictionary* animations)
@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include "cocoa/CCObject.h"
 #include "cocoa/CCDictionary.h"
+#include "cocoa/CCMap.h"
 
 #include <string>
 
@@ -98,7 +99,7 @@ private:
     void parseVersion2(Dictionary* animations);
 
 private:
-    Dictionary* _animations;
+    Map<std::string, Animation*> _animations;
     static AnimationCache* s_pSharedAnimationCache;
 };
 
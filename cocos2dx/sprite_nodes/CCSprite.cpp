@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include "cocoa/CCAffineTransform.h"
 #include "support/TransformUtils.h"
 #include "support/CCProfiling.h"
+#include "renderer/CCRenderer.h"
 // external
 #include "kazmath/GL/matrix.h"
 
@@ -549,6 +550,14 @@ void Sprite::draw(void)
 
     CCASSERT(!_batchNode, "If Sprite is being rendered by SpriteBatchNode, Sprite#draw SHOULD NOT be called");
 
+#if CC_USE_CULLING
+    if (!isInsideViewport())
+    {
+        CC_PROFILER_STOP_CATEGORY(kProfilerCategorySprite, "CCSprite - draw");
+        return;
+    }
+#endif // CC_USE_CULLING
+
     CC_NODE_DRAW_SETUP();
     
     GL::blendFunc( _blendFunc.src, _blendFunc.dst );
@@ -607,6 +616,47 @@ void Sprite::draw(void)
     CC_PROFILER_STOP_CATEGORY(kProfilerCategorySprite, "CCSprite - draw");
 }
 
+void Sprite::addRenderCommands(Renderer* renderer)
+{
+    CCASSERT(!_batchNode, "If Sprite is being rendered by SpriteBatchNode, Sprite#addRenderCommands SHOULD NOT be called");
+
+    if (!usesQuadCommand())
+    {
+        // draw() is overridden, it has to run in a CustomCommand
+        Node::addRenderCommands(renderer);
+        return;
+    }
+
+#if CC_USE_CULLING
+    if (!isInsideViewport())
+    {
+        return;
+    }
+#endif // CC_USE_CULLING
+
+    // like a CustomCommand, record the matrix on top of the stack: the one draw() would use
+    kmMat4 modelView;
+    kmGLGetMatrix(KM_GL_MODELVIEW, &modelView);
+
+    // the renderer merges this quad with its neighbours that use the same texture, shader and blend func
+    QuadCommand* command = renderer->newQuadCommand();
+    command->init(_globalZOrder, _texture->getName(), _shaderProgram, _blendFunc, _quad, modelView);
+    renderer->addCommand(command);
+}
+
+bool Sprite::usesQuadCommand() const
+{
+    return true;
+}
+
+bool Sprite::isInsideViewport() const
+{
+    kmMat4 modelViewProjection;
+    getCurrentModelViewProjection(&modelViewProjection);
+
+    return !isQuadOutsideClipVolume(modelViewProjection, _quad);
+}
+
 // Node overrides
 
 void Sprite::addChild(Node* child)
@@ -644,7 +694,7 @@ void Sprite::addChild(Node *child, int zOrder, int tag)
 void Sprite::reorderChild(Node *child, int zOrder)
 {
     CCASSERT(child != NULL, "");
-    CCASSERT(_children->containsObject(child), "");
+    CCASSERT(_children.contains(child), "");
 
     if (zOrder == child->getZOrder())
     {
@@ -675,8 +725,7 @@ void Sprite::removeAllChildrenWithCleanup(bool cleanup)
 {
     if (_batchNode)
     {
-        Object* object = NULL;
-        CCARRAY_FOREACH(_children, object)
+        for (const auto& object : _children)
         {
             Sprite* child = dynamic_cast<Sprite*>(object);
             if (child)
@@ -695,35 +744,14 @@ void Sprite::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-#if 0
-        int i = 0, j = 0, length = _children->count();
+        sortReorderedChildren();
 
-        // insertion sort
-        for(i=1; i<length; i++)
+        if ( _batchNode)
         {
-            j = i-1;
-            auto tempI = static_cast<Node*>( _children->getObjectAtIndex(i) );
-            auto tempJ = static_cast<Node*>( _children->getObjectAtIndex(j) );
-
-            //continue moving element downwards while zOrder is smaller or when zOrder is the same but mutatedIndex is smaller
-            while(j>=0 && ( tempI->getZOrder() < tempJ->getZOrder() ||
-                           ( tempI->getZOrder() == tempJ->getZOrder() &&
-                            tempI->getOrderOfArrival() < tempJ->getOrderOfArrival() ) ) )
+            for (const auto& child : _children)
             {
-                _children->fastSetObject( tempJ, j+1 );
-                j = j-1;
-                if(j>=0)
-                    tempJ = static_cast<Node*>( _children->getObjectAtIndex(j) );
+                static_cast<Sprite*>(child)->sortAllChildren();
             }
-            _children->fastSetObject(tempI, j+1);
-        }
-#else
-        std::sort(std::begin(*_children), std::end(*_children), nodeComparisonLess);
-#endif
-
-        if ( _batchNode)
-        {
-            arrayMakeObjectsPerformSelector(_children, sortAllChildren, Sprite*);
         }
 
         _reorderChildDirty = false;
@@ -758,8 +786,7 @@ void Sprite::setDirtyRecursively(bool bValue)
     // recursively set dirty
     if (_hasChildren)
     {
-        Object* object = NULL;
-        CCARRAY_FOREACH(_children, object)
+        for (const auto& object : _children)
         {
             Sprite* child = dynamic_cast<Sprite*>(object);
             if (child)
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "textures/CCTextureAtlas.h"
 #include "ccTypes.h"
 #include "cocoa/CCDictionary.h"
+#include "cocoa/CCObjectPool.h"
 #include <string>
 #ifdef EMSCRIPTEN
 #include "base_nodes/CCGLBufferedNode.h"
@@ -81,7 +82,7 @@ class CC_DLL Sprite : public NodeRGBA, public TextureProtocol
 , public GLBufferedNode
 #endif // EMSCRIPTEN
 {
-public:
+    CC_USE_OBJECT_POOL
 
     static const int INDEX_NOT_INITIALIZED = -1; /// Sprite invalid index on the SpriteBatchNode
 
@@ -480,6 +481,7 @@ public:
     virtual void ignoreAnchorPointForPosition(bool value) override;
     virtual void setVisible(bool bVisible) override;
     virtual void draw(void) override;
+    virtual void addRenderCommands(Renderer* renderer) override;
     /// @}
 
     /// @{
@@ -499,6 +501,16 @@ protected:
     virtual void setReorderChildDirtyRecursively(void);
     virtual void setDirtyRecursively(bool bValue);
 
+    /** Whether the quad is inside of the viewport, according to the projection and model-view matrices on top of the stacks */
+    bool isInsideViewport() const;
+
+    /**
+     * Whether addRenderCommands() can emit the quad of the sprite instead of calling draw().
+     * Subclasses which override draw() must override it to return false, otherwise their draw()
+     * isn't called when the render queue is enabled.
+     */
+    virtual bool usesQuadCommand() const;
+
     //
     // Data used when the sprite is rendered using a SpriteSheet
     //
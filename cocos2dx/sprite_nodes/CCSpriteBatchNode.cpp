@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "CCSpriteBatchNode.h"
 
 #include <algorithm>
+#include <string.h>
 
 #include "ccConfig.h"
 #include "CCSprite.h"
@@ -91,8 +92,7 @@ bool SpriteBatchNode::initWithTexture(Texture2D *tex, int capacity)
     updateBlendFunc();
 
     // no lazy alloc in this node
-    _children = new Array();
-    _children->initWithCapacity(capacity);
+    _children.reserve(capacity);
 
     _descendants = new Array();
     _descendants->initWithCapacity(capacity);
@@ -147,6 +147,13 @@ void SpriteBatchNode::visit(void)
         return;
     }
 
+    // the children are drawn by the batch node itself: record the whole visit
+    if (deferVisitToRenderer())
+    {
+        CC_PROFILER_STOP_CATEGORY(kProfilerCategoryBatchSprite, "CCSpriteBatchNode - visit");
+        return;
+    }
+
     kmGLPushMatrix();
 
     if (_grid && _grid->isActive())
@@ -198,7 +205,7 @@ void SpriteBatchNode::addChild(Node *child, int zOrder)
 void SpriteBatchNode::reorderChild(Node *child, int zOrder)
 {
     CCASSERT(child != NULL, "the child should not be null");
-    CCASSERT(_children->containsObject(child), "Child doesn't belong to Sprite");
+    CCASSERT(_children.contains(child), "Child doesn't belong to Sprite");
 
     if (zOrder == child->getZOrder())
     {
@@ -220,7 +227,7 @@ void SpriteBatchNode::removeChild(Node *child, bool cleanup)
         return;
     }
 
-    CCASSERT(_children->containsObject(sprite), "sprite batch node should contain the child");
+    CCASSERT(_children.contains(sprite), "sprite batch node should contain the child");
 
     // cleanup before removing
     removeSpriteFromAtlas(sprite);
@@ -230,8 +237,8 @@ void SpriteBatchNode::removeChild(Node *child, bool cleanup)
 
 void SpriteBatchNode::removeChildAtIndex(int index, bool doCleanup)
 {
-    CCASSERT(index>=0 && index < _children->count(), "Invalid index");
-    removeChild( static_cast<Sprite*>(_children->getObjectAtIndex(index)), doCleanup);
+    CCASSERT(index>=0 && index < _children.size(), "Invalid index");
+    removeChild( static_cast<Sprite*>(_children.at(index)), doCleanup);
 }
 
 void SpriteBatchNode::removeAllChildrenWithCleanup(bool doCleanup)
@@ -251,47 +258,33 @@ void SpriteBatchNode::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-#if 0
-        int i = 0,j = 0,length = _children->count();
+        int first = 0, last = -1;
+        sortReorderedChildren(&first, &last);
 
-        // insertion sort
-        for(i=1; i<length; i++)
+        //first sort all children recursively based on zOrder
+        for (int i = 0; i < _children.size(); ++i)
         {
-            j = i-1;
-            auto tempI = static_cast<Node*>( _children->getObjectAtIndex(i) );
-            auto tempJ = static_cast<Node*>( _children->getObjectAtIndex(j) );
-
-            //continue moving element downwards while zOrder is smaller or when zOrder is the same but mutatedIndex is smaller
-            while(j>=0 && ( tempI->getZOrder() < tempJ->getZOrder() ||
-                           ( tempI->getZOrder() == tempJ->getZOrder() &&
-                            tempI->getOrderOfArrival() < tempJ->getOrderOfArrival() ) ) )
+            Sprite* child = static_cast<Sprite*>(_children.at(i));
+            if (child->isReorderChildDirty())
             {
-                _children->fastSetObject( tempJ, j+1 );
-                j = j-1;
-                if(j>=0)
-                    tempJ = static_cast<Node*>( _children->getObjectAtIndex(j) );
+                // the sprites added to the child were appended to the atlas,
+                // so its quads may not be together any more: update up to the end
+                first = (first <= last) ? std::min(first, i) : i;
+                last = _children.size() - 1;
+                child->sortAllChildren();
             }
-            _children->fastSetObject(tempI, j+1);
         }
-#else
-        std::sort(std::begin(*_children), std::end(*_children), nodeComparisonLess);
-#endif
 
-        //sorted now check all children
-        if (_children->count() > 0)
+        //only the children between first and last moved, the quads of the others are in place
+        if (first <= last)
         {
-            //first sort all children recursively based on zOrder
-            arrayMakeObjectsPerformSelector(_children, sortAllChildren, Sprite*);
+            int index = (first == 0) ? 0 : highestAtlasIndexInChild(static_cast<Sprite*>(_children.at(first - 1))) + 1;
 
-            int index=0;
-
-            Object* obj = NULL;
             //fast dispatch, give every child a new atlasIndex based on their relative zOrder (keep parent -> child relations intact)
             // and at the same time reorder descendants and the quads to the right index
-            CCARRAY_FOREACH(_children, obj)
+            for (int i = first; i <= last; ++i)
             {
-                Sprite* child = static_cast<Sprite*>(obj);
-                updateAtlasIndex(child, &index);
+                updateAtlasIndex(static_cast<Sprite*>(_children.at(i)), &index);
             }
         }
 
@@ -301,12 +294,8 @@ void SpriteBatchNode::sortAllChildren()
 
 void SpriteBatchNode::updateAtlasIndex(Sprite* sprite, int* curIndex)
 {
-    int count = 0;
-    Array* array = sprite->getChildren();
-    if (array != NULL)
-    {
-        count = array->count();
-    }
+    auto& array = sprite->getChildren();
+    int count = array.size();
     
     int oldIndex = 0;
 
@@ -324,7 +313,7 @@ void SpriteBatchNode::updateAtlasIndex(Sprite* sprite, int* curIndex)
     {
         bool needNewIndex=true;
 
-        if (static_cast<Sprite*>(array->getObjectAtIndex(0) )->getZOrder() >= 0)
+        if (static_cast<Sprite*>(array.at(0))->getZOrder() >= 0)
         {
             //all children are in front of the parent
             oldIndex = sprite->getAtlasIndex();
@@ -339,8 +328,7 @@ void SpriteBatchNode::updateAtlasIndex(Sprite* sprite, int* curIndex)
             needNewIndex = false;
         }
 
-        Object* obj = NULL;
-        CCARRAY_FOREACH(array,obj)
+        for (const auto& obj : array)
         {
             Sprite* child = static_cast<Sprite*>(obj);
             if (needNewIndex && child->getZOrder() >= 0)
@@ -403,15 +391,62 @@ void SpriteBatchNode::draw(void)
 
     CC_NODE_DRAW_SETUP();
 
-    arrayMakeObjectsPerformSelector(_children, updateTransform, Sprite*);
+    for (const auto& child : _children)
+
+    {
+
+        static_cast<Sprite*>(child)->updateTransform();
+
+    }
 
     GL::blendFunc( _blendFunc.src, _blendFunc.dst );
 
+#if CC_USE_CULLING
+    drawVisibleQuads();
+#else
     _textureAtlas->drawQuads();
+#endif // CC_USE_CULLING
 
     CC_PROFILER_STOP("CCSpriteBatchNode - draw");
 }
 
+void SpriteBatchNode::drawVisibleQuads()
+{
+    kmMat4 modelViewProjection;
+    getCurrentModelViewProjection(&modelViewProjection);
+
+    V3F_C4B_T2F_Quad* quads = _textureAtlas->getQuads();
+    int totalQuads = _textureAtlas->getTotalQuads();
+
+    // The runs of visible quads are drawn straight from the atlas, nothing is copied.
+    // The culled gaps shorter than MIN_CULLED_QUADS are drawn too: they cost less than another draw call.
+    int runStart = -1;
+    int runEnd = -1;
+    for (int i = 0; i < totalQuads; ++i)
+    {
+        if (isQuadOutsideClipVolume(modelViewProjection, quads[i]))
+        {
+            continue;
+        }
+
+        if (runStart < 0)
+        {
+            runStart = i;
+        }
+        else if (i - runEnd >= MIN_CULLED_QUADS)
+        {
+            _textureAtlas->drawNumberOfQuads(runEnd - runStart, runStart);
+            runStart = i;
+        }
+        runEnd = i + 1;
+    }
+
+    if (runStart >= 0)
+    {
+        _textureAtlas->drawNumberOfQuads(runEnd - runStart, runStart);
+    }
+}
+
 void SpriteBatchNode::increaseAtlasCapacity(void)
 {
     // if we're going beyond the current TextureAtlas's capacity,
@@ -433,14 +468,13 @@ void SpriteBatchNode::increaseAtlasCapacity(void)
 
 int SpriteBatchNode::rebuildIndexInOrder(Sprite *parent, int index)
 {
-    CCASSERT(index>=0 && index < _children->count(), "Invalid index");
+    CCASSERT(index>=0 && index < _children.size(), "Invalid index");
 
-    Array *children = parent->getChildren();
+    auto& children = parent->getChildren();
 
-    if (children && children->count() > 0)
+    if (! children.empty())
     {
-        Object* object = NULL;
-        CCARRAY_FOREACH(children, object)
+        for (const auto& object : children)
         {
             Sprite* child = static_cast<Sprite*>(object);
             if (child && (child->getZOrder() < 0))
@@ -457,10 +491,9 @@ int SpriteBatchNode::rebuildIndexInOrder(Sprite *parent, int index)
         index++;
     }
 
-    if (children && children->count() > 0)
+    if (! children.empty())
     {
-        Object* object = NULL;
-        CCARRAY_FOREACH(children, object)
+        for (const auto& object : children)
         {
             Sprite* child = static_cast<Sprite*>(object);
             if (child && (child->getZOrder() >= 0))
@@ -475,43 +508,44 @@ int SpriteBatchNode::rebuildIndexInOrder(Sprite *parent, int index)
 
 int SpriteBatchNode::highestAtlasIndexInChild(Sprite *sprite)
 {
-    Array *children = sprite->getChildren();
+    auto& children = sprite->getChildren();
 
-    if (! children || children->count() == 0)
+    // the children with a negative z are before their parent in the atlas
+    if (children.empty() || children.back()->getZOrder() < 0)
     {
         return sprite->getAtlasIndex();
     }
     else
     {
-        return highestAtlasIndexInChild( static_cast<Sprite*>(children->getLastObject()));
+        return highestAtlasIndexInChild(static_cast<Sprite*>(children.back()));
     }
 }
 
 int SpriteBatchNode::lowestAtlasIndexInChild(Sprite *sprite)
 {
-    Array *children = sprite->getChildren();
+    auto& children = sprite->getChildren();
 
-    if (! children || children->count() == 0)
+    if (children.empty())
     {
         return sprite->getAtlasIndex();
     }
     else
     {
-        return lowestAtlasIndexInChild(static_cast<Sprite*>(children->getObjectAtIndex(0)));
+        return lowestAtlasIndexInChild(static_cast<Sprite*>(children.front()));
     }
 }
 
 int SpriteBatchNode::atlasIndexForChild(Sprite *sprite, int nZ)
 {
-    Array *siblings = sprite->getParent()->getChildren();
-    int childIndex = siblings->getIndexOfObject(sprite);
+    auto& siblings = sprite->getParent()->getChildren();
+    int childIndex = siblings.getIndex(sprite);
 
     // ignore parent Z if parent is spriteSheet
     bool ignoreParent = (SpriteBatchNode*)(sprite->getParent()) == this;
     Sprite *prev = NULL;
     if (childIndex > 0 && childIndex != -1)
     {
-        prev = static_cast<Sprite*>(siblings->getObjectAtIndex(childIndex - 1));
+        prev = static_cast<Sprite*>(siblings.at(childIndex - 1));
     }
 
     // first child of the sprite sheet
@@ -588,8 +622,7 @@ void SpriteBatchNode::insertChild(Sprite *sprite, int index)
     }
 
     // add children recursively
-    Object* obj = nullptr;
-    CCARRAY_FOREACH(sprite->getChildren(), obj)
+    for (const auto& obj : sprite->getChildren())
     {
         child = static_cast<Sprite*>(obj);
         int idx = atlasIndexForChild(child, child->getZOrder());
@@ -617,9 +650,7 @@ void SpriteBatchNode::appendChild(Sprite* sprite)
     _textureAtlas->insertQuad(&quad, index);
 
     // add children recursively
-    
-    Object* obj = nullptr;
-    CCARRAY_FOREACH(sprite->getChildren(), obj)
+    for (const auto& obj : sprite->getChildren())
     {
         Sprite* child = static_cast<Sprite*>(obj);
         appendChild(child);
@@ -650,11 +681,10 @@ void SpriteBatchNode::removeSpriteFromAtlas(Sprite *sprite)
     }
 
     // remove children recursively
-    Array *children = sprite->getChildren();
-    if (children && children->count() > 0)
+    auto& children = sprite->getChildren();
+    if (! children.empty())
     {
-        Object* object = NULL;
-        CCARRAY_FOREACH(children, object)
+        for (const auto& object : children)
         {
             Sprite* child = static_cast<Sprite*>(object);
             if (child)
@@ -159,6 +159,12 @@ protected:
     */
     SpriteBatchNode * addSpriteWithoutQuad(Sprite*child, int z, int aTag);
 
+    /** Draws the ranges of the texture atlas that contain quads inside of the viewport */
+    void drawVisibleQuads();
+
+    /** Smallest run of culled quads that splits the draw call of drawVisibleQuads() */
+    static const int MIN_CULLED_QUADS = 32;
+
 private:
     void updateAtlasIndex(Sprite* sprite, int* curIndex);
     void swap(int oldIndex, int newIndex);
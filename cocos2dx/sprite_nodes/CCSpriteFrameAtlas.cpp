@@ -0,0 +1,148 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CCSpriteFrameAtlas.h"
+#include "platform/CCFileUtils.h"
+#include "ccMacros.h"
+#include <string.h>
+
+NS_CC_BEGIN
+
+// The tables are read in place, so the atlas format is little-endian like all the supported targets.
+
+bool SpriteFrameAtlas::isAtlasFile(const std::string& fileName)
+{
+    static const char extension[] = ".ccsf";
+    const size_t length = sizeof(extension) - 1;
+    return fileName.size() > length && fileName.compare(fileName.size() - length, length, extension) == 0;
+}
+
+SpriteFrameAtlas::SpriteFrameAtlas()
+: _data(nullptr)
+, _size(0)
+, _header(nullptr)
+, _frames(nullptr)
+, _aliases(nullptr)
+, _strings(nullptr)
+, _ownsData(false)
+{
+}
+
+SpriteFrameAtlas::~SpriteFrameAtlas()
+{
+    close();
+}
+
+void SpriteFrameAtlas::close()
+{
+    if (_ownsData)
+    {
+        delete [] _data;
+    }
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _frames = nullptr;
+    _aliases = nullptr;
+    _strings = nullptr;
+    _ownsData = false;
+}
+
+bool SpriteFrameAtlas::initWithFile(const std::string& fullPath)
+{
+    close();
+
+    _data = FileUtils::getInstance()->getMappedFileData(fullPath.c_str(), &_size);
+    if (! _data)
+    {
+        _data = FileUtils::getInstance()->getFileData(fullPath.c_str(), "rb", &_size);
+        _ownsData = (_data != nullptr);
+    }
+
+    if (_data && readTables())
+    {
+        return true;
+    }
+
+    CCLOG("cocos2d: SpriteFrameAtlas: %s is not a valid sprite frame atlas", fullPath.c_str());
+    close();
+    return false;
+}
+
+bool SpriteFrameAtlas::readTables()
+{
+    if (_size < sizeof(Header))
+    {
+        return false;
+    }
+
+    const Header* header = (const Header*)_data;
+    if (memcmp(header->magic, "CCSF", 4) != 0 || header->version != VERSION)
+    {
+        return false;
+    }
+
+    // the tables are aligned on 4 bytes and must fit in the file
+    const uint64_t size = _size;
+    if (header->framesOffset % 4 || header->aliasesOffset % 4 ||
+        header->framesOffset + (uint64_t)header->frameCount * sizeof(Frame) > size ||
+        header->aliasesOffset + (uint64_t)header->aliasCount * sizeof(Alias) > size ||
+        header->stringsOffset + (uint64_t)header->stringsSize > size ||
+        header->textureNameOffset + (uint64_t)header->textureNameLength > header->stringsSize)
+    {
+        return false;
+    }
+
+    const Frame* frames = (const Frame*)(_data + header->framesOffset);
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        if (frames[i].nameOffset + (uint64_t)frames[i].nameLength > header->stringsSize)
+        {
+            return false;
+        }
+    }
+
+    const Alias* aliases = (const Alias*)(_data + header->aliasesOffset);
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        if (aliases[i].nameOffset + (uint64_t)aliases[i].nameLength > header->stringsSize ||
+            aliases[i].frameIndex >= header->frameCount)
+        {
+            return false;
+        }
+    }
+
+    _header = header;
+    _frames = frames;
+    _aliases = aliases;
+    _strings = (const char*)(_data + header->stringsOffset);
+    return true;
+}
+
+std::string SpriteFrameAtlas::getTextureFileName() const
+{
+    return _header ? getString(_header->textureNameOffset, _header->textureNameLength) : std::string();
+}
+
+NS_CC_END
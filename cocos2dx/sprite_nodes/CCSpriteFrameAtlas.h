@@ -0,0 +1,143 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __SPRITE_CCSPRITE_FRAME_ATLAS_H__
+#define __SPRITE_CCSPRITE_FRAME_ATLAS_H__
+
+#include <string>
+#include <stdint.h>
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup sprite_nodes
+ * @{
+ */
+
+/** Binary description of the sprite frames of a texture atlas.
+
+ It is the precompiled form of a sprite frames plist, built by tools/sprite-frame-compiler:
+ the frames are read in place, without parsing any XML or rect string. The values are
+ the ones passed to SpriteFrame::initWithTexture(), whatever the format of the plist was.
+
+ All the numbers are little-endian. The layout is:
+
+     Header      magic "CCSF", version, number of frames and aliases, offsets of the tables
+     Frames      one Frame per sprite frame, sorted by name
+     Aliases     one Alias per alias name, with the index of its frame
+     Strings     the names of the frames and aliases and the texture file name, not null-terminated
+
+ @see SpriteFrameCache::addSpriteFramesWithFile()
+ @since v3.0
+ */
+class CC_DLL SpriteFrameAtlas
+{
+public:
+    struct Header
+    {
+        char     magic[4];
+        uint32_t version;
+        uint32_t frameCount;
+        uint32_t aliasCount;
+        uint32_t framesOffset;
+        uint32_t aliasesOffset;
+        uint32_t stringsOffset;
+        uint32_t stringsSize;
+        uint32_t textureNameOffset;
+        uint32_t textureNameLength;
+    };
+
+    struct Frame
+    {
+        uint32_t nameOffset;
+        uint16_t nameLength;
+        uint16_t flags;
+        float    rect[4];
+        float    offset[2];
+        float    originalSize[2];
+    };
+
+    struct Alias
+    {
+        uint32_t nameOffset;
+        uint16_t nameLength;
+        uint16_t reserved;
+        uint32_t frameIndex;
+    };
+
+    enum
+    {
+        VERSION = 1,
+        /** the frame is rotated in the texture */
+        FRAME_ROTATED = 1 << 0,
+    };
+
+    /** Whether the file is a sprite frame atlas, recognized by its ".ccsf" extension */
+    static bool isAtlasFile(const std::string& fileName);
+
+    SpriteFrameAtlas();
+    ~SpriteFrameAtlas();
+
+    /** Loads the atlas at the given full path.
+     When the file is stored uncompressed in a resource pack, it is read in place without any copy.
+     @return false if the file can't be read or is not a valid atlas.
+     */
+    bool initWithFile(const std::string& fullPath);
+
+    /** Name of the texture file, relative to the atlas file. Empty if the atlas doesn't name it. */
+    std::string getTextureFileName() const;
+
+    unsigned int getFrameCount() const { return _header ? _header->frameCount : 0; }
+    const Frame& getFrame(unsigned int index) const { return _frames[index]; }
+    std::string getFrameName(unsigned int index) const { return getString(_frames[index].nameOffset, _frames[index].nameLength); }
+
+    unsigned int getAliasCount() const { return _header ? _header->aliasCount : 0; }
+    const Alias& getAlias(unsigned int index) const { return _aliases[index]; }
+    std::string getAliasName(unsigned int index) const { return getString(_aliases[index].nameOffset, _aliases[index].nameLength); }
+
+private:
+    std::string getString(uint32_t offset, uint32_t length) const { return std::string(_strings + offset, length); }
+    /** checks that the tables fit in the data, then points to them */
+    bool readTables();
+    void close();
+
+    const unsigned char* _data;
+    unsigned long _size;
+    const Header* _header;
+    const Frame* _frames;
+    const Alias* _aliases;
+    const char* _strings;
+    /** true when _data is a buffer owned by the atlas, false when it is in a resource pack */
+    bool _ownsData;
+
+    CC_DISABLE_COPY(SpriteFrameAtlas);
+};
+
+// end of sprite_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __SPRITE_CCSPRITE_FRAME_ATLAS_H__
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "textures/CCTextureCache.h"
 #include "CCSpriteFrameCache.h"
 #include "CCSpriteFrame.h"
+#include "CCSpriteFrameAtlas.h"
 #include "CCSprite.h"
 #include "support/TransformUtils.h"
 #include "platform/CCFileUtils.h"
@@ -63,18 +64,14 @@ void SpriteFrameCache::destroyInstance()
 
 bool SpriteFrameCache::init(void)
 {
-    _spriteFrames= new Dictionary();
-    _spriteFrames->init();
-    _spriteFramesAliases = new Dictionary();
-    _spriteFramesAliases->init();
+    _spriteFrames.reserve(20);
+    _spriteFramesAliases.reserve(20);
     _loadedFileNames = new std::set<std::string>();
     return true;
 }
 
 SpriteFrameCache::~SpriteFrameCache(void)
 {
-    CC_SAFE_RELEASE(_spriteFrames);
-    CC_SAFE_RELEASE(_spriteFramesAliases);
     CC_SAFE_DELETE(_loadedFileNames);
 }
 
@@ -107,7 +104,7 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(Dictionary* dictionary, Tex
     {
         Dictionary* frameDict = static_cast<Dictionary*>(pElement->getObject());
         std::string spriteFrameName = pElement->getStrKey();
-        SpriteFrame* spriteFrame = static_cast<SpriteFrame*>(_spriteFrames->objectForKey(spriteFrameName));
+        SpriteFrame* spriteFrame = _spriteFrames.at(spriteFrameName);
         if (spriteFrame)
         {
             continue;
@@ -174,20 +171,18 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(Dictionary* dictionary, Tex
 
             // get aliases
             Array* aliases = (Array*) (frameDict->objectForKey("aliases"));
-            String * frameKey = new String(spriteFrameName);
 
             Object* pObj = NULL;
             CCARRAY_FOREACH(aliases, pObj)
             {
                 std::string oneAlias = static_cast<String*>(pObj)->getCString();
-                if (_spriteFramesAliases->objectForKey(oneAlias.c_str()))
+                if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
                 {
                     CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
                 }
 
-                _spriteFramesAliases->setObject(frameKey, oneAlias.c_str());
+                _spriteFramesAliases[oneAlias] = spriteFrameName;
             }
-            frameKey->release();
             // create frame
             spriteFrame = new SpriteFrame();
             spriteFrame->initWithTexture(pobTexture,
@@ -198,14 +193,95 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(Dictionary* dictionary, Tex
         }
 
         // add sprite frame
-        _spriteFrames->setObject(spriteFrame, spriteFrameName);
+        _spriteFrames.insert(spriteFrameName, spriteFrame);
         spriteFrame->release();
     }
 }
 
+void SpriteFrameCache::addSpriteFramesWithAtlas(const SpriteFrameAtlas& atlas, Texture2D *texture)
+{
+    const unsigned int frameCount = atlas.getFrameCount();
+    _spriteFrames.reserve(_spriteFrames.size() + frameCount);
+
+    // the aliases of the frames already in the cache are skipped, like the frames
+    std::vector<bool> added(frameCount, false);
+    for (unsigned int i = 0; i < frameCount; ++i)
+    {
+        std::string spriteFrameName = atlas.getFrameName(i);
+        if (_spriteFrames.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        const SpriteFrameAtlas::Frame& frame = atlas.getFrame(i);
+        SpriteFrame* spriteFrame = new SpriteFrame();
+        spriteFrame->initWithTexture(texture,
+                                     Rect(frame.rect[0], frame.rect[1], frame.rect[2], frame.rect[3]),
+                                     (frame.flags & SpriteFrameAtlas::FRAME_ROTATED) != 0,
+                                     Point(frame.offset[0], frame.offset[1]),
+                                     Size(frame.originalSize[0], frame.originalSize[1]));
+
+        _spriteFrames.insert(spriteFrameName, spriteFrame);
+        spriteFrame->release();
+        added[i] = true;
+    }
+
+    for (unsigned int i = 0; i < atlas.getAliasCount(); ++i)
+    {
+        const SpriteFrameAtlas::Alias& alias = atlas.getAlias(i);
+        if (! added[alias.frameIndex])
+        {
+            continue;
+        }
+
+        std::string oneAlias = atlas.getAliasName(i);
+        if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+        }
+        _spriteFramesAliases[oneAlias] = atlas.getFrameName(alias.frameIndex);
+    }
+}
+
+// the texture named by the sprite frames file, relative to it, or the file with the .png extension
+static std::string texturePathForFile(const char* file, const std::string& textureFileName)
+{
+    std::string texturePath;
+    if (! textureFileName.empty())
+    {
+        // build texture path relative to plist file
+        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(textureFileName.c_str(), file);
+    }
+    else
+    {
+        // build texture path by replacing file extension
+        texturePath = file;
+
+        // remove .xxx
+        size_t startPos = texturePath.find_last_of("."); 
+        texturePath = texturePath.erase(startPos);
+
+        // append .png
+        texturePath = texturePath.append(".png");
+
+        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    }
+    return texturePath;
+}
+
 void SpriteFrameCache::addSpriteFramesWithFile(const char *pszPlist, Texture2D *pobTexture)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszPlist);
+    if (SpriteFrameAtlas::isAtlasFile(fullPath))
+    {
+        SpriteFrameAtlas atlas;
+        if (atlas.initWithFile(fullPath))
+        {
+            addSpriteFramesWithAtlas(atlas, pobTexture);
+        }
+        return;
+    }
+
     Dictionary *dict = Dictionary::createWithContentsOfFileThreadSafe(fullPath.c_str());
 
     addSpriteFramesWithDictionary(dict, pobTexture);
@@ -233,37 +309,41 @@ void SpriteFrameCache::addSpriteFramesWithFile(const char *pszPlist)
     if (_loadedFileNames->find(pszPlist) == _loadedFileNames->end())
     {
         std::string fullPath = FileUtils::getInstance()->fullPathForFilename(pszPlist);
+        if (SpriteFrameAtlas::isAtlasFile(fullPath))
+        {
+            SpriteFrameAtlas atlas;
+            if (! atlas.initWithFile(fullPath))
+            {
+                return;
+            }
+
+            std::string texturePath = texturePathForFile(pszPlist, atlas.getTextureFileName());
+            Texture2D *texture = TextureCache::getInstance()->addImage(texturePath.c_str());
+
+            if (texture)
+            {
+                addSpriteFramesWithAtlas(atlas, texture);
+                _loadedFileNames->insert(pszPlist);
+            }
+            else
+            {
+                CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+            }
+            return;
+        }
+
         Dictionary *dict = Dictionary::createWithContentsOfFileThreadSafe(fullPath.c_str());
 
-        string texturePath("");
+        string textureFileName("");
 
         Dictionary* metadataDict = static_cast<Dictionary*>( dict->objectForKey("metadata") );
         if (metadataDict)
         {
             // try to read  texture file name from meta data
-            texturePath = metadataDict->valueForKey("textureFileName")->getCString();
-        }
-
-        if (! texturePath.empty())
-        {
-            // build texture path relative to plist file
-            texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath.c_str(), pszPlist);
-        }
-        else
-        {
-            // build texture path by replacing file extension
-            texturePath = pszPlist;
-
-            // remove .xxx
-            size_t startPos = texturePath.find_last_of("."); 
-            texturePath = texturePath.erase(startPos);
-
-            // append .png
-            texturePath = texturePath.append(".png");
-
-            CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+            textureFileName = metadataDict->valueForKey("textureFileName")->getCString();
         }
 
+        std::string texturePath = texturePathForFile(pszPlist, textureFileName);
         Texture2D *texture = TextureCache::getInstance()->addImage(texturePath.c_str());
 
         if (texture)
@@ -280,29 +360,32 @@ void SpriteFrameCache::addSpriteFramesWithFile(const char *pszPlist)
 
 void SpriteFrameCache::addSpriteFrame(SpriteFrame *pobFrame, const char *pszFrameName)
 {
-    _spriteFrames->setObject(pobFrame, pszFrameName);
+    _spriteFrames.insert(pszFrameName, pobFrame);
 }
 
 void SpriteFrameCache::removeSpriteFrames(void)
 {
-    _spriteFrames->removeAllObjects();
-    _spriteFramesAliases->removeAllObjects();
+    _spriteFrames.clear();
+    _spriteFramesAliases.clear();
     _loadedFileNames->clear();
 }
 
 void SpriteFrameCache::removeUnusedSpriteFrames(void)
 {
     bool bRemoved = false;
-    DictElement* pElement = NULL;
-    CCDICT_FOREACH(_spriteFrames, pElement)
+    for (auto iter = _spriteFrames.begin(); iter != _spriteFrames.end(); )
     {
-        SpriteFrame* spriteFrame = static_cast<SpriteFrame*>(pElement->getObject());
+        SpriteFrame* spriteFrame = iter->second;
         if( spriteFrame->retainCount() == 1 ) 
         {
-            CCLOG("cocos2d: SpriteFrameCache: removing unused frame: %s", pElement->getStrKey());
-            _spriteFrames->removeObjectForElememt(pElement);
+            CCLOG("cocos2d: SpriteFrameCache: removing unused frame: %s", iter->first.c_str());
+            iter = _spriteFrames.erase(iter);
             bRemoved = true;
         }
+        else
+        {
+            ++iter;
+        }
     }
 
     // XXX. Since we don't know the .plist file that originated the frame, we must remove all .plist from the cache
@@ -322,16 +405,16 @@ void SpriteFrameCache::removeSpriteFrameByName(const char *pszName)
     }
 
     // Is this an alias ?
-    String* key = (String*)_spriteFramesAliases->objectForKey(pszName);
+    auto alias = _spriteFramesAliases.find(pszName);
 
-    if (key)
+    if (alias != _spriteFramesAliases.end())
     {
-        _spriteFrames->removeObjectForKey(key->getCString());
-        _spriteFramesAliases->removeObjectForKey(key->getCString());
+        _spriteFrames.erase(alias->second);
+        _spriteFramesAliases.erase(alias);
     }
     else
     {
-        _spriteFrames->removeObjectForKey(pszName);
+        _spriteFrames.erase(pszName);
     }
 
     // XXX. Since we don't know the .plist file that originated the frame, we must remove all .plist from the cache
@@ -341,9 +424,20 @@ void SpriteFrameCache::removeSpriteFrameByName(const char *pszName)
 void SpriteFrameCache::removeSpriteFramesFromFile(const char* plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    Dictionary* dict = Dictionary::createWithContentsOfFileThreadSafe(fullPath.c_str());
+    if (SpriteFrameAtlas::isAtlasFile(fullPath))
+    {
+        SpriteFrameAtlas atlas;
+        if (atlas.initWithFile(fullPath))
+        {
+            removeSpriteFramesFromAtlas(atlas);
+        }
+    }
+    else
+    {
+        Dictionary* dict = Dictionary::createWithContentsOfFileThreadSafe(fullPath.c_str());
 
-    removeSpriteFramesFromDictionary((Dictionary*)dict);
+        removeSpriteFramesFromDictionary((Dictionary*)dict);
+    }
 
     // remove it from the cache
     set<string>::iterator ret = _loadedFileNames->find(plist);
@@ -356,48 +450,47 @@ void SpriteFrameCache::removeSpriteFramesFromFile(const char* plist)
 void SpriteFrameCache::removeSpriteFramesFromDictionary(Dictionary* dictionary)
 {
     Dictionary* framesDict = static_cast<Dictionary*>(dictionary->objectForKey("frames"));
-    Array* keysToRemove = Array::create();
 
     DictElement* pElement = NULL;
     CCDICT_FOREACH(framesDict, pElement)
     {
-        if (_spriteFrames->objectForKey(pElement->getStrKey()))
-        {
-            keysToRemove->addObject(String::create(pElement->getStrKey()));
-        }
+        _spriteFrames.erase(pElement->getStrKey());
     }
+}
 
-    _spriteFrames->removeObjectsForKeys(keysToRemove);
+void SpriteFrameCache::removeSpriteFramesFromAtlas(const SpriteFrameAtlas& atlas)
+{
+    for (unsigned int i = 0; i < atlas.getFrameCount(); ++i)
+    {
+        _spriteFrames.erase(atlas.getFrameName(i));
+    }
 }
 
 void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
 {
-    Array* keysToRemove = Array::create();
-
-    DictElement* pElement = NULL;
-    CCDICT_FOREACH(_spriteFrames, pElement)
+    for (auto iter = _spriteFrames.begin(); iter != _spriteFrames.end(); )
     {
-        string key = pElement->getStrKey();
-        SpriteFrame* frame = static_cast<SpriteFrame*>(_spriteFrames->objectForKey(key.c_str()));
-        if (frame && (frame->getTexture() == texture))
+        if (iter->second->getTexture() == texture)
         {
-            keysToRemove->addObject(String::create(pElement->getStrKey()));
+            iter = _spriteFrames.erase(iter);
+        }
+        else
+        {
+            ++iter;
         }
     }
-
-    _spriteFrames->removeObjectsForKeys(keysToRemove);
 }
 
 SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const char *pszName)
 {
-    SpriteFrame* frame = (SpriteFrame*)_spriteFrames->objectForKey(pszName);
+    SpriteFrame* frame = _spriteFrames.at(pszName);
     if (!frame)
     {
         // try alias dictionary
-        String *key = (String*)_spriteFramesAliases->objectForKey(pszName);  
-        if (key)
+        auto alias = _spriteFramesAliases.find(pszName);
+        if (alias != _spriteFramesAliases.end())
         {
-            frame = (SpriteFrame*)_spriteFrames->objectForKey(key->getCString());
+            frame = _spriteFrames.at(alias->second);
             if (! frame)
             {
                 CCLOG("cocos2d: SpriteFrameCache: Frame '%s' not found", pszName);
@@ -37,14 +37,17 @@ THE SOFTWARE.
 #include "sprite_nodes/CCSpriteFrame.h"
 #include "textures/CCTexture2D.h"
 #include "cocoa/CCObject.h"
+#include "cocoa/CCMap.h"
 #include <set>
 #include <string>
+#include <unordered_map>
 
 NS_CC_BEGIN
 
 class Dictionary;
 class Array;
 class Sprite;
+class SpriteFrameAtlas;
 
 /**
  * @addtogroup sprite_nodes
@@ -72,7 +75,7 @@ public:
 
 protected:
     // MARMALADE: Made this protected not private, as deriving from this class is pretty useful
-    SpriteFrameCache() : _spriteFrames(NULL), _spriteFramesAliases(NULL){}
+    SpriteFrameCache() : _loadedFileNames(NULL){}
 
 public:
     virtual ~SpriteFrameCache();
@@ -82,6 +85,8 @@ public:
     /** Adds multiple Sprite Frames from a plist file.
      * A texture will be loaded automatically. The texture name will composed by replacing the .plist suffix with .png
      * If you want to use another texture, you should use the addSpriteFramesWithFile(const char *plist, const char *textureFileName) method.
+     * The files with the .ccsf extension are binary atlases compiled from the plist files by tools/sprite-frame-compiler,
+     * which load much faster (see SpriteFrameAtlas). This applies to all the methods taking a plist file.
      */
     void addSpriteFramesWithFile(const char *plist);
 
@@ -147,9 +152,18 @@ private:
     */
     void removeSpriteFramesFromDictionary(Dictionary* dictionary);
 
+    /* Adds the Sprite Frames of a binary atlas. The texture will be associated with the created sprite frames.
+     */
+    void addSpriteFramesWithAtlas(const SpriteFrameAtlas& atlas, Texture2D *texture);
+
+    /* Removes the Sprite Frames of a binary atlas.
+     */
+    void removeSpriteFramesFromAtlas(const SpriteFrameAtlas& atlas);
+
 protected:
-    Dictionary* _spriteFrames;
-    Dictionary* _spriteFramesAliases;
+    Map<std::string, SpriteFrame*> _spriteFrames;
+    /** the names of the frames, by alias */
+    std::unordered_map<std::string, std::string> _spriteFramesAliases;
     std::set<std::string>*  _loadedFileNames;
 };
 
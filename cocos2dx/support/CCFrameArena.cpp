@@ -0,0 +1,161 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "support/CCFrameArena.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <new>
+#include <atomic>
+#include <mutex>
+
+#include "ccMacros.h"
+
+NS_CC_BEGIN
+
+// getInstance() is reached from the loading threads too (e.g. by String), only the creation is locked
+static std::atomic<FrameArena*> s_sharedFrameArena(nullptr);
+static std::mutex s_sharedFrameArenaMutex;
+
+FrameArena* FrameArena::getInstance()
+{
+    FrameArena* arena = s_sharedFrameArena.load(std::memory_order_acquire);
+    if (! arena)
+    {
+        std::lock_guard<std::mutex> lock(s_sharedFrameArenaMutex);
+        arena = s_sharedFrameArena.load(std::memory_order_relaxed);
+        if (! arena)
+        {
+            arena = new FrameArena();
+            s_sharedFrameArena.store(arena, std::memory_order_release);
+        }
+    }
+    return arena;
+}
+
+void FrameArena::destroyInstance()
+{
+    std::lock_guard<std::mutex> lock(s_sharedFrameArenaMutex);
+    delete s_sharedFrameArena.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+FrameArena::FrameArena()
+: _currentBlock(0)
+, _offset(0)
+, _ownerThread(std::this_thread::get_id())
+{
+}
+
+FrameArena::~FrameArena()
+{
+    for (auto& block : _blocks)
+    {
+        free(block.data);
+    }
+}
+
+bool FrameArena::isOwnerThread() const
+{
+    return std::this_thread::get_id() == _ownerThread;
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+    CCASSERT(isOwnerThread(), "FrameArena can only be used by the thread running the Director");
+    CCASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "the alignment must be a power of 2");
+
+    // the next blocks were allocated by the previous frames: use the first one which is large enough
+    while (_currentBlock < _blocks.size())
+    {
+        const Block& block = _blocks[_currentBlock];
+        uintptr_t address = reinterpret_cast<uintptr_t>(block.data) + _offset;
+        size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+
+        if (_offset + padding + size <= block.size)
+        {
+            _offset += padding + size;
+            return block.data + _offset - size;
+        }
+
+        ++_currentBlock;
+        _offset = 0;
+    }
+
+    // malloc() aligns on 16 bytes, a larger alignment is padded
+    size_t blockSize = MAX(BLOCK_SIZE, size + alignment);
+    Block block;
+    block.data = static_cast<char*>(malloc(blockSize));
+    if (! block.data)
+    {
+        throw std::bad_alloc();
+    }
+    block.size = blockSize;
+    _blocks.push_back(block);
+
+    return allocate(size, alignment);
+}
+
+FrameArena::Marker FrameArena::getMarker() const
+{
+    Marker marker;
+    marker.block = _currentBlock;
+    marker.offset = _offset;
+    return marker;
+}
+
+void FrameArena::rewind(const Marker& marker)
+{
+    CCASSERT(marker.block < _currentBlock || (marker.block == _currentBlock && marker.offset <= _offset),
+             "the marker is ahead of the cursor");
+    _currentBlock = marker.block;
+    _offset = marker.offset;
+}
+
+void FrameArena::reset()
+{
+    _currentBlock = 0;
+    _offset = 0;
+}
+
+size_t FrameArena::getUsedSize() const
+{
+    size_t size = _offset;
+    for (size_t i = 0; i < _currentBlock && i < _blocks.size(); ++i)
+    {
+        size += _blocks[i].size;
+    }
+    return size;
+}
+
+size_t FrameArena::getCapacity() const
+{
+    size_t size = 0;
+    for (const auto& block : _blocks)
+    {
+        size += block.size;
+    }
+    return size;
+}
+
+NS_CC_END
@@ -0,0 +1,118 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __SUPPORT_CCFRAMEARENA_H__
+#define __SUPPORT_CCFRAMEARENA_H__
+
+#include <stddef.h>
+#include <thread>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+/** @brief Bump allocator for the memory needed until the end of the frame.
+
+ allocate() moves a cursor in blocks of BLOCK_SIZE bytes, and the Director reclaims all
+ the memory at once with reset() at the end of each frame, after the autorelease pool.
+ The blocks are kept from one frame to the next, so a frame doesn't touch the heap once
+ the arena has grown to the needs of the game. A scoped buffer can be given back before
+ the end of the frame by rewinding to a marker taken before its allocation.
+
+ Nothing is destructed: it is meant for plain data, such as temporary buffers.
+
+ It belongs to the thread which created it, the one running the Director: the other
+ threads must not use it, isOwnerThread() tells whether the calling thread can.
+ @since v3.0
+ */
+class CC_DLL FrameArena
+{
+public:
+    /** default size of the blocks, in bytes */
+    static const size_t BLOCK_SIZE = 256 * 1024;
+
+    /** position of the cursor, to rewind to */
+    struct Marker
+    {
+        size_t block;
+        size_t offset;
+    };
+
+    /** returns the arena of the Director thread */
+    static FrameArena* getInstance();
+
+    /** releases the blocks of the arena */
+    static void destroyInstance();
+
+    /** whether the calling thread is the one which can use the arena */
+    bool isOwnerThread() const;
+
+    /** Allocates size bytes aligned on alignment, a power of 2, valid until the end of the frame */
+    void* allocate(size_t size, size_t alignment = 16);
+
+    /** gets the current position of the cursor */
+    Marker getMarker() const;
+
+    /** frees everything allocated since the marker was taken */
+    void rewind(const Marker& marker);
+
+    /** frees everything allocated since the last reset, keeping the blocks */
+    void reset();
+
+    /** gets the number of bytes allocated since the last reset, the alignment padding included */
+    size_t getUsedSize() const;
+
+    /** gets the number of bytes of all the blocks */
+    size_t getCapacity() const;
+
+private:
+    FrameArena();
+    ~FrameArena();
+
+    struct Block
+    {
+        char* data;
+        size_t size;
+    };
+
+    std::vector<Block> _blocks;
+    size_t _currentBlock;
+    size_t _offset;
+    std::thread::id _ownerThread;
+
+    CC_DISABLE_COPY(FrameArena);
+};
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#endif // __SUPPORT_CCFRAMEARENA_H__
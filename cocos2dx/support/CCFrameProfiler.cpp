@@ -0,0 +1,364 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "support/CCFrameProfiler.h"
+
+#include <chrono>
+#include <stdio.h>
+
+#include "ccMacros.h"
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#define CC_PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+#include <pthread.h>
+#define CC_PROFILER_THREAD_LOCAL __thread
+#endif
+
+NS_CC_BEGIN
+
+namespace {
+
+// zone names: written once by registerZone(), then only read
+const char* s_zoneNames[FrameProfiler::MAX_ZONES] = {
+    "Director::drawScene",
+    "Scheduler::update",
+    "ActionManager::update",
+    "Node::visit",
+    "Texture upload",
+    "File read",
+};
+std::atomic<int> s_zoneCount(FrameProfiler::BUILTIN_ZONE_COUNT);
+std::mutex s_zonesMutex;
+
+// origin of the timestamps
+const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+// buffer of the calling thread, created by its first zone
+CC_PROFILER_THREAD_LOCAL FrameProfiler::ThreadBuffer* s_threadBuffer = nullptr;
+
+// hands the buffer of an exiting thread back to the profiler
+#if defined(_MSC_VER)
+DWORD s_threadExitKey = FLS_OUT_OF_INDEXES;
+
+void WINAPI onThreadExit(void* buffer)
+{
+    if (buffer)
+    {
+        FrameProfiler::getInstance()->retireThreadBuffer(static_cast<FrameProfiler::ThreadBuffer*>(buffer));
+    }
+}
+
+void createThreadExitKey()
+{
+    s_threadExitKey = FlsAlloc(onThreadExit);
+}
+
+void setThreadExitValue(FrameProfiler::ThreadBuffer* buffer)
+{
+    if (s_threadExitKey != FLS_OUT_OF_INDEXES)
+    {
+        FlsSetValue(s_threadExitKey, buffer);
+    }
+}
+#else
+pthread_key_t s_threadExitKey;
+
+void onThreadExit(void* buffer)
+{
+    FrameProfiler::getInstance()->retireThreadBuffer(static_cast<FrameProfiler::ThreadBuffer*>(buffer));
+}
+
+void createThreadExitKey()
+{
+    pthread_key_create(&s_threadExitKey, onThreadExit);
+}
+
+void setThreadExitValue(FrameProfiler::ThreadBuffer* buffer)
+{
+    pthread_setspecific(s_threadExitKey, buffer);
+}
+#endif
+
+// the zones deeper than the maximum depth
+const unsigned long long NOT_RECORDED = ~0ULL;
+
+} // namespace
+
+std::atomic<bool> FrameProfiler::s_enabled(false);
+
+FrameProfiler* FrameProfiler::getInstance()
+{
+    static FrameProfiler* s_sharedFrameProfiler = new FrameProfiler();
+    return s_sharedFrameProfiler;
+}
+
+FrameProfiler::FrameProfiler()
+: _maxDepth(32)
+, _threadBufferCapacity(1 << 16)
+, _nextThreadId(1)
+{
+    createThreadExitKey();
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    for (auto buffer : _threads)
+    {
+        delete [] buffer->events;
+        delete buffer;
+    }
+}
+
+FrameProfiler::ZoneId FrameProfiler::registerZone(const char* name)
+{
+    std::lock_guard<std::mutex> lock(s_zonesMutex);
+
+    int zone = s_zoneCount.load(std::memory_order_relaxed);
+    CCASSERT(zone < MAX_ZONES, "FrameProfiler: too many zones");
+    if (zone >= MAX_ZONES)
+    {
+        return MAX_ZONES - 1;
+    }
+
+    s_zoneNames[zone] = name;
+    s_zoneCount.store(zone + 1, std::memory_order_release);
+    return (ZoneId)zone;
+}
+
+const char* FrameProfiler::getZoneName(ZoneId zone)
+{
+    if (zone < s_zoneCount.load(std::memory_order_acquire) && s_zoneNames[zone])
+    {
+        return s_zoneNames[zone];
+    }
+    return "unknown";
+}
+
+void FrameProfiler::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void FrameProfiler::setThreadBufferCapacity(unsigned int capacity)
+{
+    unsigned int powerOfTwo = 1;
+    while (powerOfTwo < capacity && powerOfTwo < (1u << 31))
+    {
+        powerOfTwo <<= 1;
+    }
+    _threadBufferCapacity = powerOfTwo;
+}
+
+void FrameProfiler::setThreadName(const char* name)
+{
+    ThreadBuffer* buffer = getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    buffer->name = name;
+}
+
+unsigned long long FrameProfiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+FrameProfiler::ThreadBuffer* FrameProfiler::getThreadBuffer()
+{
+    if (s_threadBuffer == nullptr)
+    {
+        ThreadBuffer* buffer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_threadsMutex);
+            if (! _retiredThreads.empty())
+            {
+                // the zones of the thread that exited are dropped
+                buffer = _retiredThreads.back();
+                _retiredThreads.pop_back();
+                buffer->cleared = buffer->written.load(std::memory_order_relaxed);
+                buffer->name.clear();
+            }
+            else
+            {
+                // the events are allocated by the first zone: naming a thread is cheap
+                buffer = new ThreadBuffer();
+                buffer->events = nullptr;
+                buffer->mask = 0;
+                buffer->written.store(0, std::memory_order_relaxed);
+                buffer->cleared = 0;
+                _threads.push_back(buffer);
+            }
+            buffer->depth = 0;
+            buffer->threadId = _nextThreadId++;
+        }
+
+        s_threadBuffer = buffer;
+        setThreadExitValue(buffer);
+    }
+    return s_threadBuffer;
+}
+
+void FrameProfiler::retireThreadBuffer(ThreadBuffer* buffer)
+{
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    _retiredThreads.push_back(buffer);
+}
+
+FrameProfiler::ThreadBuffer* FrameProfiler::beginZone(unsigned long long* start)
+{
+    FrameProfiler* profiler = getInstance();
+    ThreadBuffer* buffer = profiler->getThreadBuffer();
+    if (buffer->events == nullptr)
+    {
+        // published to the exporter by the first update of written
+        buffer->events = new Event[profiler->_threadBufferCapacity];
+        buffer->mask = profiler->_threadBufferCapacity - 1;
+    }
+
+    ++buffer->depth;
+    if (profiler->_maxDepth > 0 && buffer->depth > profiler->_maxDepth)
+    {
+        *start = NOT_RECORDED;
+    }
+    else
+    {
+        // should be the last instruction in order to be more reliable
+        *start = now();
+    }
+    return buffer;
+}
+
+void FrameProfiler::endZone(ThreadBuffer* buffer, ZoneId zone, unsigned long long start)
+{
+    // should be the 1st instruction in order to be more reliable
+    unsigned long long end = now();
+
+    --buffer->depth;
+    if (start == NOT_RECORDED)
+    {
+        return;
+    }
+
+    // only this thread writes into the buffer: the exporter reads up to the published count
+    unsigned long long written = buffer->written.load(std::memory_order_relaxed);
+    Event& event = buffer->events[written & buffer->mask];
+    event.start = start;
+    event.duration = (unsigned int)MIN(end - start, 0xffffffffULL);
+    event.zone = zone;
+    event.depth = (unsigned short)buffer->depth;
+    buffer->written.store(written + 1, std::memory_order_release);
+}
+
+void FrameProfiler::clear()
+{
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    for (auto buffer : _threads)
+    {
+        buffer->cleared = buffer->written.load(std::memory_order_acquire);
+    }
+}
+
+static void appendJsonString(std::string& json, const char* str)
+{
+    json += '"';
+    for (const char* c = str; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            json += '\\';
+        }
+        json += *c;
+    }
+    json += '"';
+}
+
+std::string FrameProfiler::getChromeTrace()
+{
+    std::string json;
+    json.reserve(1024 * 1024);
+    json += "{\"traceEvents\":[";
+
+    char line[256];
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    for (auto buffer : _threads)
+    {
+        if (! buffer->name.empty())
+        {
+            snprintf(line, sizeof(line), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                     first ? "" : ",", buffer->threadId);
+            json += line;
+            appendJsonString(json, buffer->name.c_str());
+            json += "}}";
+            first = false;
+        }
+
+        // the oldest zones were overwritten by the ring buffer
+        unsigned long long written = buffer->written.load(std::memory_order_acquire);
+        unsigned long long capacity = (unsigned long long)buffer->mask + 1;
+        unsigned long long begin = written > capacity ? written - capacity : 0;
+        begin = MAX(begin, buffer->cleared);
+
+        for (unsigned long long i = begin; i < written; ++i)
+        {
+            const Event event = buffer->events[i & buffer->mask];
+
+            // the thread writes the slot of zone i + capacity before it publishes it: drop the zones it may have overwritten while they were copied
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer->written.load(std::memory_order_relaxed) - i >= capacity)
+            {
+                continue;
+            }
+
+            snprintf(line, sizeof(line), "%s\n{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u},\"name\":",
+                     first ? "" : ",", buffer->threadId, event.start / 1000.0, event.duration / 1000.0, (unsigned int)event.depth);
+            json += line;
+            appendJsonString(json, getZoneName(event.zone));
+            json += '}';
+            first = false;
+        }
+    }
+
+    json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return json;
+}
+
+bool FrameProfiler::writeChromeTrace(const std::string& path)
+{
+    std::string json = getChromeTrace();
+
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (! fp)
+    {
+        CCLOG("FrameProfiler: can't write %s", path.c_str());
+        return false;
+    }
+    bool ok = fwrite(json.data(), 1, json.size(), fp) == json.size();
+    fclose(fp);
+    return ok;
+}
+
+NS_CC_END
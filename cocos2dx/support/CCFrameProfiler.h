@@ -0,0 +1,212 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __SUPPORT_CCFRAMEPROFILER_H__
+#define __SUPPORT_CCFRAMEPROFILER_H__
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ccConfig.h"
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+/** @brief Hierarchical profiler of the frames, with low overhead.
+
+ The code is instrumented with zones: CC_PROFILE_ZONE(id) measures the enclosing scope.
+ Each thread records its zones into its own ring buffer, without lock nor allocation.
+ When a thread exits, its zones are still exported until a new thread reuses its buffer.
+ The zones are nested: a zone deeper than getMaxDepth() isn't recorded.
+
+ The built-in zones cover Director::drawScene(), Scheduler::update(), ActionManager::update(),
+ Node::visit(), the texture uploads and the file reads. Other zones are declared with
+ CC_PROFILE_ZONE_NAMED("name").
+
+ The recorded zones are exported to the trace event format of Chrome (chrome://tracing).
+
+ It is disabled by default. It can be enabled with setEnabled() or with the
+ "cocos2d.x.frame_profiler" key of the Configuration. The zones can be compiled out
+ with CC_ENABLE_FRAME_PROFILER.
+ @since v3.0
+ */
+class CC_DLL FrameProfiler
+{
+public:
+    typedef unsigned short ZoneId;
+
+    /** built-in zones */
+    enum : ZoneId
+    {
+        ZONE_DRAW_SCENE,
+        ZONE_SCHEDULER_UPDATE,
+        ZONE_ACTION_MANAGER_UPDATE,
+        ZONE_NODE_VISIT,
+        ZONE_TEXTURE_UPLOAD,
+        ZONE_FILE_READ,
+
+        BUILTIN_ZONE_COUNT,
+    };
+
+    /** maximum number of zones, built-in zones included */
+    static const int MAX_ZONES = 256;
+
+    /** returns the singleton. It is never destroyed, since other threads may still record zones */
+    static FrameProfiler* getInstance();
+
+    /** Returns the id of a new zone. Thread safe. Use CC_PROFILE_ZONE_NAMED() to declare it once */
+    static ZoneId registerZone(const char* name);
+    static const char* getZoneName(ZoneId zone);
+
+    static inline bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled);
+
+    /** Zones nested deeper than maxDepth aren't recorded. 0 means no limit. Default: 32 */
+    inline int getMaxDepth() const { return _maxDepth; }
+    inline void setMaxDepth(int maxDepth) { _maxDepth = maxDepth; }
+
+    /** Number of zones kept per thread (rounded up to a power of 2). Only applies to the threads
+     that record their first zone afterwards. Default: 65536
+     */
+    void setThreadBufferCapacity(unsigned int capacity);
+
+    /** Names the calling thread in the exported traces */
+    void setThreadName(const char* name);
+
+    /** Discards the zones recorded so far */
+    void clear();
+
+    /** The recorded zones, in the JSON trace event format of Chrome */
+    std::string getChromeTrace();
+    /** Writes getChromeTrace() into a file. Returns false if the file can't be written */
+    bool writeChromeTrace(const std::string& path);
+
+    /** A recorded zone */
+    struct Event
+    {
+        unsigned long long start;   // nanoseconds since the creation of the profiler
+        unsigned int duration;      // nanoseconds
+        ZoneId zone;
+        unsigned short depth;
+    };
+
+    /** Zones of one thread: written by the thread, read by the exporter */
+    struct ThreadBuffer
+    {
+        Event* events;                              // allocated by the first zone of the thread
+        unsigned int mask;                          // capacity - 1
+        std::atomic<unsigned long long> written;
+        unsigned long long cleared;                 // guarded by _threadsMutex
+        int depth;
+        unsigned int threadId;                      // guarded by _threadsMutex
+        std::string name;                           // guarded by _threadsMutex
+    };
+
+    // used by FrameProfileScope
+    static ThreadBuffer* beginZone(unsigned long long* start);
+    static void endZone(ThreadBuffer* buffer, ZoneId zone, unsigned long long start);
+
+    /** Called when a thread exits: its buffer is kept for the exporter until a new thread reuses it */
+    void retireThreadBuffer(ThreadBuffer* buffer);
+
+private:
+    FrameProfiler();
+    ~FrameProfiler();
+
+    CC_DISABLE_COPY(FrameProfiler);
+
+    static unsigned long long now();
+    ThreadBuffer* getThreadBuffer();
+
+    static std::atomic<bool> s_enabled;
+
+    int _maxDepth;
+    unsigned int _threadBufferCapacity;
+
+    std::mutex _threadsMutex;
+    std::vector<ThreadBuffer*> _threads;
+    /** buffers of the threads that exited, reused by the next threads */
+    std::vector<ThreadBuffer*> _retiredThreads;
+    unsigned int _nextThreadId;
+};
+
+/** Records the enclosing scope as a zone of FrameProfiler. Use CC_PROFILE_ZONE() */
+class CC_DLL FrameProfileScope
+{
+public:
+    explicit inline FrameProfileScope(FrameProfiler::ZoneId zone)
+    : _buffer(nullptr)
+    , _zone(zone)
+    {
+        if (FrameProfiler::isEnabled())
+        {
+            _buffer = FrameProfiler::beginZone(&_start);
+        }
+    }
+
+    inline ~FrameProfileScope()
+    {
+        if (_buffer)
+        {
+            FrameProfiler::endZone(_buffer, _zone, _start);
+        }
+    }
+
+private:
+    CC_DISABLE_COPY(FrameProfileScope);
+
+    FrameProfiler::ThreadBuffer* _buffer;
+    FrameProfiler::ZoneId _zone;
+    unsigned long long _start;
+};
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#define CC_PROFILE_CONCAT_(a, b) a##b
+#define CC_PROFILE_CONCAT(a, b) CC_PROFILE_CONCAT_(a, b)
+
+#if CC_ENABLE_FRAME_PROFILER
+/** measures the enclosing scope as the zone __zone__ of FrameProfiler */
+#define CC_PROFILE_ZONE(__zone__) \
+    cocos2d::FrameProfileScope CC_PROFILE_CONCAT(__profileScope, __LINE__)(__zone__)
+/** measures the enclosing scope as the zone named __name__, registered the first time */
+#define CC_PROFILE_ZONE_NAMED(__name__) \
+    static const cocos2d::FrameProfiler::ZoneId CC_PROFILE_CONCAT(__profileZone, __LINE__) = cocos2d::FrameProfiler::registerZone(__name__); \
+    CC_PROFILE_ZONE(CC_PROFILE_CONCAT(__profileZone, __LINE__))
+#else
+#define CC_PROFILE_ZONE(__zone__) do {} while (0)
+#define CC_PROFILE_ZONE_NAMED(__name__) do {} while (0)
+#endif
+
+#endif // __SUPPORT_CCFRAMEPROFILER_H__
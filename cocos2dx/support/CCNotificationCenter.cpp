@@ -26,6 +26,8 @@ THE SOFTWARE.
 #include "cocoa/CCArray.h"
 #include "script_support/CCScriptSupport.h"
 #include <string>
+#include <unordered_map>
+#include <algorithm>
 
 using namespace std;
 
@@ -33,16 +35,98 @@ NS_CC_BEGIN
 
 static NotificationCenter *s_sharedNotifCenter = NULL;
 
+// The names of the notifications, interned for all the notification centers: the id of a name
+// is its index. They are found by hash, so looking a name up doesn't allocate any string.
+namespace
+{
+class NotificationNames
+{
+public:
+    static NotificationNames& getInstance()
+    {
+        static NotificationNames s_names;
+        return s_names;
+    }
+
+    // returns false if the name was never interned
+    bool find(const char* name, unsigned int* notificationId) const
+    {
+        auto range = _ids.equal_range(hash(name));
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (_names[iter->second] == name)
+            {
+                *notificationId = iter->second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    unsigned int intern(const char* name)
+    {
+        unsigned int notificationId = 0;
+        if (!find(name, &notificationId))
+        {
+            notificationId = (unsigned int)_names.size();
+            _names.push_back(name);
+            _ids.insert(std::make_pair(hash(name), notificationId));
+        }
+        return notificationId;
+    }
+
+private:
+    static size_t hash(const char* name)
+    {
+        size_t hash = 2166136261u;
+        for (; *name; ++name)
+        {
+            hash = (hash ^ (unsigned char)*name) * 16777619u;
+        }
+        return hash;
+    }
+
+    std::vector<std::string> _names;
+    std::unordered_multimap<size_t, unsigned int> _ids;
+};
+}
+
+// observers are only ever visited through a reference to their list, so a post isn't affected
+// by the observers it adds or removes: the list is copied instead of changed while it is posted
+struct NotificationCenter::ObserverList
+{
+    ObserverList() {}
+
+    ObserverList(const ObserverList& other)
+    : observers(other.observers)
+    {
+        for (auto observer : observers)
+        {
+            observer->retain();
+        }
+    }
+
+    ~ObserverList()
+    {
+        for (auto observer : observers)
+        {
+            observer->release();
+        }
+    }
+
+    std::vector<NotificationObserver*> observers;
+
+private:
+    ObserverList& operator=(const ObserverList&);
+};
+
 NotificationCenter::NotificationCenter()
 : _scriptHandler(0)
 {
-    _observers = Array::createWithCapacity(3);
-    _observers->retain();
 }
 
 NotificationCenter::~NotificationCenter()
 {
-    _observers->release();
 }
 
 NotificationCenter *NotificationCenter::getInstance()
@@ -71,19 +155,54 @@ void NotificationCenter::purgeNotificationCenter(void)
     NotificationCenter::destroyInstance();
 }
 
+unsigned int NotificationCenter::getNotificationId(const char *name)
+{
+    return NotificationNames::getInstance().intern(name);
+}
+
 //
 // internal functions
 //
+NotificationCenter::ObserverList* NotificationCenter::getObservers(const char *name) const
+{
+    // the names never observed are not interned
+    unsigned int notificationId = 0;
+    if (!NotificationNames::getInstance().find(name, &notificationId) || notificationId >= _observers.size())
+    {
+        return NULL;
+    }
+    return _observers[notificationId].get();
+}
+
+NotificationCenter::ObserverList* NotificationCenter::getMutableObservers(unsigned int notificationId)
+{
+    if (notificationId >= _observers.size())
+    {
+        _observers.resize(notificationId + 1);
+    }
+
+    std::shared_ptr<ObserverList>& list = _observers[notificationId];
+    if (!list)
+    {
+        list = std::make_shared<ObserverList>();
+    }
+    else if (list.use_count() > 1)
+    {
+        // a post is dispatching the current list
+        list = std::make_shared<ObserverList>(*list);
+    }
+    return list.get();
+}
+
 bool NotificationCenter::observerExisted(Object *target,const char *name, Object *sender)
 {
-    Object* obj = NULL;
-    CCARRAY_FOREACH(_observers, obj)
+    ObserverList* list = getObservers(name);
+    if (!list)
+        return false;
+
+    for (auto observer : list->observers)
     {
-        NotificationObserver* observer = (NotificationObserver*) obj;
-        if (!observer)
-            continue;
-        
-        if (!strcmp(observer->getName(),name) && observer->getTarget() == target && observer->getSender() == sender)
+        if (observer->getTarget() == target && observer->getSender() == sender)
             return true;
     }
     return false;
@@ -92,6 +211,13 @@ bool NotificationCenter::observerExisted(Object *target,const char *name, Object
 //
 // observer functions
 //
+void NotificationCenter::addObserver(NotificationObserver *observer)
+{
+    ObserverList* list = getMutableObservers(getNotificationId(observer->getName()));
+    observer->retain();
+    list->observers.push_back(observer);
+}
+
 void NotificationCenter::addObserver(Object *target, 
                                        SEL_CallFuncO selector,
                                        const char *name,
@@ -104,22 +230,23 @@ void NotificationCenter::addObserver(Object *target,
     if (!observer)
         return;
     
-    observer->autorelease();
-    _observers->addObject(observer);
+    addObserver(observer);
+    observer->release();
 }
 
 void NotificationCenter::removeObserver(Object *target,const char *name)
 {
-    Object* obj = NULL;
-    CCARRAY_FOREACH(_observers, obj)
+    ObserverList* list = getObservers(name);
+    if (!list)
+        return;
+
+    for (size_t i = 0; i < list->observers.size(); ++i)
     {
-        NotificationObserver* observer = static_cast<NotificationObserver*>(obj);
-        if (!observer)
-            continue;
-        
-        if (!strcmp(observer->getName(),name) && observer->getTarget() == target)
+        if (list->observers[i]->getTarget() == target)
         {
-            _observers->removeObject(observer);
+            list = getMutableObservers(getNotificationId(name));
+            list->observers[i]->release();
+            list->observers.erase(list->observers.begin() + i);
             return;
         }
     }
@@ -127,23 +254,29 @@ void NotificationCenter::removeObserver(Object *target,const char *name)
 
 int NotificationCenter::removeAllObservers(Object *target)
 {
-    Object *obj = NULL;
-    Array *toRemove = Array::create();
+    int removed = 0;
 
-    CCARRAY_FOREACH(_observers, obj)
+    for (unsigned int notificationId = 0; notificationId < _observers.size(); ++notificationId)
     {
-        NotificationObserver *observer = static_cast<NotificationObserver *>(obj);
-        if (!observer)
+        if (!_observers[notificationId])
             continue;
 
-        if (observer->getTarget() == target)
+        auto& observers = _observers[notificationId]->observers;
+        auto hasTarget = [target](NotificationObserver* observer) { return observer->getTarget() == target; };
+        if (std::find_if(observers.begin(), observers.end(), hasTarget) == observers.end())
+            continue;
+
+        ObserverList* list = getMutableObservers(notificationId);
+        auto last = std::stable_partition(list->observers.begin(), list->observers.end(),
+                                          [target](NotificationObserver* observer) { return observer->getTarget() != target; });
+        for (auto iter = last; iter != list->observers.end(); ++iter)
         {
-            toRemove->addObject(observer);
+            (*iter)->release();
+            ++removed;
         }
+        list->observers.erase(last, list->observers.end());
     }
-
-    _observers->removeObjectsInArray(toRemove);
-    return toRemove->count();
+    return removed;
 }
 
 void NotificationCenter::registerScriptObserver( Object *target, int handler,const char* name)
@@ -157,42 +290,45 @@ void NotificationCenter::registerScriptObserver( Object *target, int handler,con
         return;
     
     observer->setHandler(handler);
-    observer->autorelease();
-    _observers->addObject(observer);
+    addObserver(observer);
+    observer->release();
 }
 
 void NotificationCenter::unregisterScriptObserver(Object *target,const char* name)
 {        
-    Object* obj = NULL;
-    CCARRAY_FOREACH(_observers, obj)
+    ObserverList* list = getObservers(name);
+    if (!list)
+        return;
+
+    for (size_t i = 0; i < list->observers.size(); )
     {
-        NotificationObserver* observer = static_cast<NotificationObserver*>(obj);
-        if (!observer)
-            continue;
-            
-        if ( !strcmp(observer->getName(),name) && observer->getTarget() == target)
+        if (list->observers[i]->getTarget() == target)
         {
-            _observers->removeObject(observer);
+            list = getMutableObservers(getNotificationId(name));
+            list->observers[i]->release();
+            list->observers.erase(list->observers.begin() + i);
+        }
+        else
+        {
+            ++i;
         }
     }
 }
 
-void NotificationCenter::postNotification(const char *name, Object *sender)
+void NotificationCenter::postNotificationWithId(unsigned int notificationId, Object *sender)
 {
-    Array* ObserversCopy = Array::createWithCapacity(_observers->count());
-    ObserversCopy->addObjectsFromArray(_observers);
-    Object* obj = NULL;
-    CCARRAY_FOREACH(ObserversCopy, obj)
+    if (notificationId >= _observers.size() || !_observers[notificationId])
+        return;
+
+    // the observers can add or remove observers: they change a copy of the list
+    std::shared_ptr<ObserverList> list = _observers[notificationId];
+    for (auto observer : list->observers)
     {
-        NotificationObserver* observer = static_cast<NotificationObserver*>(obj);
-        if (!observer)
-            continue;
-        
-        if (!strcmp(name,observer->getName()) && (observer->getSender() == sender || observer->getSender() == NULL || sender == NULL))
+        if (observer->getSender() == sender || observer->getSender() == NULL || sender == NULL)
         {
             if (0 != observer->getHandler())
             {
-                BasicScriptData data(this, (void*)name);
+                BasicScriptData data(this, (void*)observer->getName());
                 ScriptEvent scriptEvent(kNotificationEvent,(void*)&data);
                 ScriptEngineManager::getInstance()->getScriptEngine()->sendEvent(&scriptEvent);
             }
@@ -204,6 +340,16 @@ void NotificationCenter::postNotification(const char *name, Object *sender)
     }
 }
 
+void NotificationCenter::postNotification(const char *name, Object *sender)
+{
+    // the names nobody observes are not interned
+    unsigned int notificationId = 0;
+    if (NotificationNames::getInstance().find(name, &notificationId))
+    {
+        postNotificationWithId(notificationId, sender);
+    }
+}
+
 void NotificationCenter::postNotification(const char *name)
 {
     this->postNotification(name,NULL);
@@ -216,18 +362,10 @@ int NotificationCenter::getObserverHandlerByName(const char* name)
         return 0;
     }
     
-    Object* obj = NULL;
-    CCARRAY_FOREACH(_observers, obj)
+    ObserverList* list = getObservers(name);
+    if (list && !list->observers.empty())
     {
-        NotificationObserver* observer = static_cast<NotificationObserver*>(obj);
-        if (NULL == observer)
-            continue;
-        
-        if ( 0 == strcmp(observer->getName(),name) )
-        {
-            return observer->getHandler();
-            break;
-        }
+        return list->observers.front()->getHandler();
     }
     
     return 0;
@@ -27,10 +27,18 @@ THE SOFTWARE.
 
 #include "cocoa/CCObject.h"
 #include "cocoa/CCArray.h"
+#include <memory>
+#include <vector>
 
 NS_CC_BEGIN
 
 class ScriptHandlerMgr;
+class NotificationObserver;
+
+/** @brief Dispatches named notifications to the observers registered for them.
+ *  The observers are indexed by the id of their name, so posting only visits the observers of that name.
+ *  The names are interned: getNotificationId() returns the id, and postNotificationWithId() skips the lookup of the name.
+ */
 class CC_DLL NotificationCenter : public Object
 {
     friend class ScriptHandlerMgr;
@@ -96,6 +104,18 @@ public:
      *  @param sender The object posting the notification. Can be NULL
      */
     void postNotification(const char *name, Object *sender);
+
+    /** @brief Returns the id of a notification name. The names are interned: equal names have the same id.
+     *  @since v3.0
+     */
+    static unsigned int getNotificationId(const char *name);
+
+    /** @brief Posts one notification event by the id of its name, without looking the name up.
+     *  @param notificationId The id returned by getNotificationId().
+     *  @param sender The object posting the notification. Can be NULL
+     *  @since v3.0
+     */
+    void postNotificationWithId(unsigned int notificationId, Object *sender = NULL);
     
     /** @brief Gets script handler.
      *  @note Only supports Lua Binding now.
@@ -111,12 +131,25 @@ public:
 private:
     // internal functions
 
+    // the observers of one name, retained
+    struct ObserverList;
+
     // Check whether the observer exists by the specified target and name.
     bool observerExisted(Object *target,const char *name, Object *sender);
+
+    // Adds an observer to the list of its name.
+    void addObserver(NotificationObserver *observer);
+
+    // The observers of a name, or NULL if it has none.
+    ObserverList* getObservers(const char *name) const;
+
+    // The observers of a name, which can be changed: copied first if a notification is being posted with them.
+    ObserverList* getMutableObservers(unsigned int notificationId);
     
     // variables
     //
-    Array *_observers;
+    /** the observers by notification id; a post holds a reference to the list it dispatches */
+    std::vector<std::shared_ptr<ObserverList>> _observers;
     int     _scriptHandler;
 };
 
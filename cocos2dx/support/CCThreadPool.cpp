@@ -0,0 +1,224 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "support/CCThreadPool.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdio.h>
+
+#include "support/CCFrameProfiler.h"
+
+NS_CC_BEGIN
+
+int ThreadPool::getDefaultThreadCount()
+{
+    int count = (int)std::thread::hardware_concurrency() - 1;
+    return std::max(count, 1);
+}
+
+ThreadPool::ThreadPool(int threadCount)
+: _pendingTasks(0)
+, _nextWorker(0)
+, _quit(false)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = getDefaultThreadCount();
+    }
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _workers.push_back(new Worker());
+    }
+
+    // start the threads once all the queues exist, they can be stolen from
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _quit = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto worker : _workers)
+    {
+        worker->thread.join();
+    }
+
+    for (auto worker : _workers)
+    {
+        delete worker;
+    }
+}
+
+void ThreadPool::pushTask(const Task& task)
+{
+    Worker* worker = _workers[_nextWorker++ % _workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->tasks.push_back(task);
+    }
+    ++_pendingTasks;
+
+    // take the lock, so a worker can't miss the notification between its check and its wait
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+bool ThreadPool::popTask(int index, Task& task)
+{
+    // own queue first
+    {
+        Worker* worker = _workers[index];
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (!worker->tasks.empty())
+        {
+            task = std::move(worker->tasks.front());
+            worker->tasks.pop_front();
+            --_pendingTasks;
+            return true;
+        }
+    }
+
+    // then steal from the others
+    int count = (int)_workers.size();
+    for (int i = 1; i < count; ++i)
+    {
+        Worker* victim = _workers[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->tasks.empty())
+        {
+            task = std::move(victim->tasks.back());
+            victim->tasks.pop_back();
+            --_pendingTasks;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::workerLoop(int index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "ThreadPool worker %d", index);
+    FrameProfiler::getInstance()->setThreadName(name);
+
+    while (true)
+    {
+        Task task;
+        if (popTask(index, task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCondition.wait(lock, [this](){ return _quit || _pendingTasks > 0; });
+        if (_quit)
+        {
+            break;
+        }
+    }
+}
+
+namespace {
+
+// shared between the caller of parallelFor() and the helper tasks, which may start
+// after parallelFor() returned when the workers are busy
+struct ParallelForState
+{
+    std::function<void(int, int)> body;
+    int count;
+    int grainSize;
+    int chunks;
+    std::atomic<int> nextChunk;
+    std::atomic<int> doneChunks;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    void run()
+    {
+        int chunk;
+        while ((chunk = nextChunk++) < chunks)
+        {
+            int begin = chunk * grainSize;
+            body(begin, std::min(begin + grainSize, count));
+
+            if (++doneChunks == chunks)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                condition.notify_all();
+            }
+        }
+    }
+};
+
+} // namespace
+
+void ThreadPool::parallelFor(int count, int grainSize, const std::function<void(int, int)>& body)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    grainSize = std::max(grainSize, 1);
+    int chunks = (count + grainSize - 1) / grainSize;
+    if (chunks == 1)
+    {
+        body(0, count);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->body = body;
+    state->count = count;
+    state->grainSize = grainSize;
+    state->chunks = chunks;
+    state->nextChunk = 0;
+    state->doneChunks = 0;
+
+    int helpers = std::min(chunks - 1, getThreadCount());
+    for (int i = 0; i < helpers; ++i)
+    {
+        pushTask([state](){ state->run(); });
+    }
+
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&state](){ return state->doneChunks == state->chunks; });
+}
+
+NS_CC_END
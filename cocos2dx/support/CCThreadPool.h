@@ -0,0 +1,106 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __SUPPORT_CCTHREADPOOL_H__
+#define __SUPPORT_CCTHREADPOOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+/** @brief A pool of worker threads with work stealing.
+
+ Every worker owns a queue of tasks. pushTask() distributes the tasks round robin,
+ a worker runs the tasks of its own queue first and steals from the back of the
+ other queues when it runs out of work.
+
+ The tasks run outside of the cocos2d thread: they must not call OpenGL, and
+ must not retain / release / autorelease Objects.
+ @since v3.0
+ */
+class CC_DLL ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    /** Creates the pool.
+     @param threadCount number of worker threads. If it is 0, getDefaultThreadCount() is used.
+     */
+    explicit ThreadPool(int threadCount = 0);
+    /** Waits for the running tasks and discards the queued ones */
+    ~ThreadPool();
+
+    /** Number of hardware threads minus the calling thread, at least 1 */
+    static int getDefaultThreadCount();
+
+    inline int getThreadCount() const { return (int)_workers.size(); }
+
+    /** Queues a task. It will run on one of the workers */
+    void pushTask(const Task& task);
+
+    /** Runs body(begin, end) for every chunk of grainSize items in [0, count), and returns
+     once all the chunks are done. The calling thread works on the chunks too, so it is
+     safe to call it while the workers are busy with other tasks.
+     */
+    void parallelFor(int count, int grainSize, const std::function<void(int, int)>& body);
+
+private:
+    struct Worker
+    {
+        std::deque<Task> tasks;
+        std::mutex mutex;
+        std::thread thread;
+    };
+
+    void workerLoop(int index);
+    bool popTask(int index, Task& task);
+
+    std::vector<Worker*> _workers;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::atomic<int> _pendingTasks;
+    std::atomic<unsigned int> _nextWorker;
+    bool _quit;
+};
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#endif // __SUPPORT_CCTHREADPOOL_H__
@@ -25,6 +25,8 @@ THE SOFTWARE.
 
 #include "TransformUtils.h"
 #include "cocoa/CCAffineTransform.h"
+#include "ccTypes.h"
+#include "kazmath/GL/matrix.h"
 
 namespace cocos2d {
 
@@ -47,5 +49,42 @@ void GLToCGAffine(const GLfloat *m, AffineTransform *t)
     t->b = m[1]; t->d = m[5]; t->ty = m[13];
 }
 
+bool isQuadOutsideClipVolume(const kmMat4& modelViewProjection, const V3F_C4B_T2F_Quad& quad)
+{
+    const Vertex3F* vertices[4] = { &quad.bl.vertices, &quad.br.vertices, &quad.tl.vertices, &quad.tr.vertices };
+    const float* m = modelViewProjection.mat;
+
+    int left = 0, right = 0, bottom = 0, top = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        const Vertex3F& v = *vertices[i];
+
+        // clip coordinates, z is not needed
+        float x = m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12];
+        float y = m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13];
+        float w = m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15];
+
+        if (w <= 0)
+        {
+            return false;
+        }
+
+        left += (x < -w);
+        right += (x > w);
+        bottom += (y < -w);
+        top += (y > w);
+    }
+
+    return left == 4 || right == 4 || bottom == 4 || top == 4;
+}
+
+void getCurrentModelViewProjection(kmMat4* modelViewProjection)
+{
+    kmMat4 projection, modelView;
+    kmGLGetMatrix(KM_GL_PROJECTION, &projection);
+    kmGLGetMatrix(KM_GL_MODELVIEW, &modelView);
+    kmMat4Multiply(modelViewProjection, &projection, &modelView);
+}
+
 }//namespace   cocos2d 
 
@@ -29,13 +29,27 @@ THE SOFTWARE.
 // todo:
 // when in MAC or windows, it includes <OpenGL/gl.h>
 #include "CCGL.h"
+#include "kazmath/mat4.h"
 
 namespace   cocos2d {
 
 struct AffineTransform;
+struct V3F_C4B_T2F_Quad;
 
 void CGAffineToGL(const AffineTransform &t, GLfloat *m);
 void GLToCGAffine(const GLfloat *m, AffineTransform *t);
+
+/** Returns true when the 4 vertices of the quad, transformed by the model-view-projection matrix,
+ are beyond the same plane of the clip volume: the quad isn't visible in the viewport.
+ Quads with vertices behind the eye are never reported as outside.
+ */
+bool isQuadOutsideClipVolume(const kmMat4& modelViewProjection, const V3F_C4B_T2F_Quad& quad);
+
+/** Returns the product of the projection and model-view matrices on top of the kazmath stacks.
+ They are the matrices used by draw(), even when it isn't called by visit() (e.g. by a RenderTexture),
+ unlike the model-view matrix cached by Node::transform().
+ */
+void getCurrentModelViewProjection(kmMat4* modelViewProjection);
 }//namespace   cocos2d 
 
 #endif // __SUPPORT_TRANSFORM_UTILS_H__
@@ -26,6 +26,13 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 #include "../tinyxml2/tinyxml2.h"
 #include "support/base64.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <unordered_map>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
@@ -34,106 +41,313 @@ THE SOFTWARE.
 
 #define XML_FILE_NAME "UserDefault.xml"
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 using namespace std;
 
 NS_CC_BEGIN
 
+// the store writes the file after this delay, to coalesce the values set meanwhile
+#define USERDEFAULT_FLUSH_DELAY_MS          1000
+// or as soon as this number of values are waiting to be written
+#define USERDEFAULT_FLUSH_PENDING_WRITES    256
+
+// emscripten has no threads: the values are written as soon as they are set
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_EMSCRIPTEN)
+#define USERDEFAULT_USE_WRITER_THREAD       0
+#else
+#define USERDEFAULT_USE_WRITER_THREAD       1
+#endif
+
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * The values of the xml file, loaded once. They are written back by a background thread
+ * a moment after they change, to a temporary file that replaces the xml file.
+ * Without threads, they are written by each change instead.
+ * Defined here because we don't want to export it in "CCUserDefault.h".
  */
-
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+namespace
+{
+class UserDefaultStore
 {
-    tinyxml2::XMLElement* curNode = NULL;
+public:
+    explicit UserDefaultStore(const std::string& filePath)
+    : _filePath(filePath)
+    , _version(0)
+    , _savedVersion(0)
+    , _pendingWrites(0)
+    , _flushRequested(false)
+    , _quit(false)
+    {
+        load();
+#if USERDEFAULT_USE_WRITER_THREAD
+        _writer = std::thread(&UserDefaultStore::writerLoop, this);
+#endif
+    }
 
-    // check the key value
-    if (! pKey)
+    ~UserDefaultStore()
     {
-        return NULL;
+#if USERDEFAULT_USE_WRITER_THREAD
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _quit = true;
+        }
+        _condition.notify_all();
+        _writer.join();
+#endif
+
+        // the writer may have been stopped before the last values were written, at exit
+        if (_savedVersion != _version)
+        {
+            save();
+        }
     }
 
-    do 
+    bool getValue(const char* key, std::string* value)
     {
- 		tinyxml2::XMLDocument* xmlDoc = new tinyxml2::XMLDocument();
-		*doc = xmlDoc;
-		//CCFileData data(UserDefault::getInstance()->getXMLFilePath().c_str(),"rt");
-		unsigned long nSize;
-		const char* pXmlBuffer = (const char*)FileUtils::getInstance()->getFileData(UserDefault::getInstance()->getXMLFilePath().c_str(), "rb", &nSize);
-		//const char* pXmlBuffer = (const char*)data.getBuffer();
-		if(NULL == pXmlBuffer)
-		{
-			CCLOG("can not read xml file");
-			break;
-		}
-		xmlDoc->Parse(pXmlBuffer);
-        delete[] pXmlBuffer;
-		// get root node
-		*rootNode = xmlDoc->RootElement();
-		if (NULL == *rootNode)
-		{
-			CCLOG("read root node error");
-			break;
-		}
-		// find the node
-		curNode = (*rootNode)->FirstChildElement();
-		while (NULL != curNode)
-		{
-			const char* nodeName = curNode->Value();
-			if (!strcmp(nodeName, pKey))
-			{
-				break;
-			}
-
-			curNode = curNode->NextSiblingElement();
-		}
-	} while (0);
-
-	return curNode;
-}
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto iter = _indices.find(key);
+        // an element without text is read as a missing value, like the values set to ""
+        if (iter == _indices.end() || _entries[iter->second].second.empty())
+        {
+            return false;
+        }
+        *value = _entries[iter->second].second;
+        return true;
+    }
 
-static void setValueForKey(const char* pKey, const char* pValue)
-{
- 	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	// check the params
-	if (! pKey || ! pValue)
-	{
-		return;
-	}
-	// find the node
-	node = getXMLNodeForKey(pKey, &rootNode, &doc);
-	// if node exist, change the content
-	if (node)
-	{
-        if (node->FirstChild())
+    void setValue(const char* key, const char* value)
+    {
+        bool notify = false;
         {
-            node->FirstChild()->SetValue(pValue);
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto iter = _indices.find(key);
+            if (iter == _indices.end())
+            {
+                _indices.insert(std::make_pair(std::string(key), _entries.size()));
+                _entries.push_back(std::make_pair(std::string(key), std::string(value)));
+            }
+            else if (_entries[iter->second].second != value)
+            {
+                _entries[iter->second].second = value;
+            }
+            else
+            {
+                return;
+            }
+
+            // the delay starts with the first change since the last snapshot
+            if (_pendingWrites == 0)
+            {
+                _dirtyTime = std::chrono::steady_clock::now();
+            }
+            ++_version;
+            ++_pendingWrites;
+            notify = (_pendingWrites == 1 || _pendingWrites >= USERDEFAULT_FLUSH_PENDING_WRITES);
         }
-        else
+#if USERDEFAULT_USE_WRITER_THREAD
+        if (notify)
         {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
+            _condition.notify_all();
         }
-	}
-	else
-	{
-		if (rootNode)
-		{
-			tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-			rootNode->LinkEndChild(tmpNode);
-			tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-			tmpNode->LinkEndChild(content);
-		}	
-	}
+#else
+        CC_UNUSED_PARAM(notify);
+        save();
+#endif
+    }
 
-    // save file and free doc
-	if (doc)
-	{
-		doc->SaveFile(UserDefault::getInstance()->getXMLFilePath().c_str());
-		delete doc;
-	}
+    // writes the values on the writer thread and waits until they are on disk
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        const unsigned long long version = _version;
+        if (_savedVersion == version)
+        {
+            return;
+        }
+#if USERDEFAULT_USE_WRITER_THREAD
+        _flushRequested = true;
+        _condition.notify_all();
+        _savedCondition.wait(lock, [this, version]{ return _savedVersion >= version || _quit; });
+#else
+        lock.unlock();
+        save();
+#endif
+    }
+
+private:
+    void load()
+    {
+        unsigned long size = 0;
+        char* buffer = (char*)FileUtils::getInstance()->getFileData(_filePath.c_str(), "rb", &size);
+        if (NULL == buffer)
+        {
+            CCLOG("can not read xml file");
+            return;
+        }
+
+        tinyxml2::XMLDocument doc;
+        doc.Parse(buffer, size);
+        delete [] buffer;
+
+        tinyxml2::XMLElement* rootNode = doc.RootElement();
+        if (NULL == rootNode)
+        {
+            CCLOG("read root node error");
+            return;
+        }
+
+        for (tinyxml2::XMLElement* node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
+        {
+            // the first element of a key wins, as when the file was searched for each value
+            if (_indices.find(node->Value()) != _indices.end())
+            {
+                continue;
+            }
+            const char* value = node->FirstChild() ? node->FirstChild()->Value() : "";
+            _indices.insert(std::make_pair(std::string(node->Value()), _entries.size()));
+            _entries.push_back(std::make_pair(std::string(node->Value()), std::string(value)));
+        }
+    }
+
+#if USERDEFAULT_USE_WRITER_THREAD
+    void writerLoop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            if (_savedVersion == _version)
+            {
+                if (_quit)
+                {
+                    break;
+                }
+                _condition.wait(lock);
+                continue;
+            }
+
+            const auto deadline = _dirtyTime + std::chrono::milliseconds(USERDEFAULT_FLUSH_DELAY_MS);
+            if (! _quit && ! _flushRequested && _pendingWrites < USERDEFAULT_FLUSH_PENDING_WRITES &&
+                std::chrono::steady_clock::now() < deadline)
+            {
+                _condition.wait_until(lock, deadline);
+                continue;
+            }
+
+            lock.unlock();
+            save();
+            lock.lock();
+        }
+    }
+#endif
+
+    // writes a snapshot of the values, then marks them as saved even if the file couldn't be written
+    void save()
+    {
+        tinyxml2::XMLPrinter printer;
+        unsigned long long version;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            version = _version;
+            _pendingWrites = 0;
+            _flushRequested = false;
+
+            printer.PushDeclaration("xml version=\"1.0\" encoding=\"UTF-8\"");
+            printer.OpenElement(USERDEFAULT_ROOT_NAME);
+            for (const auto& entry : _entries)
+            {
+                printer.OpenElement(entry.first.c_str());
+                if (! entry.second.empty())
+                {
+                    printer.PushText(entry.second.c_str());
+                }
+                printer.CloseElement();
+            }
+            printer.CloseElement();
+        }
+
+        if (! writeFile(printer.CStr(), printer.CStrSize() - 1))
+        {
+            CCLOG("cocos2d: UserDefault: can not write %s", _filePath.c_str());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _savedVersion = version;
+        }
+        _savedCondition.notify_all();
+    }
+
+    // replaces the file atomically, so a crash while writing it doesn't lose the previous values
+    bool writeFile(const char* data, int size)
+    {
+        std::string tmpPath = _filePath + ".tmp";
+        FILE* fp = fopen(tmpPath.c_str(), "wb");
+        if (! fp)
+        {
+            return false;
+        }
+
+        bool written = (fwrite(data, 1, size, fp) == (size_t)size) && (fflush(fp) == 0);
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32)
+        written = written && (fsync(fileno(fp)) == 0);
+#endif
+        fclose(fp);
+
+        if (written)
+        {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+            written = MoveFileExA(tmpPath.c_str(), _filePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+            written = rename(tmpPath.c_str(), _filePath.c_str()) == 0;
+#endif
+        }
+        if (! written)
+        {
+            remove(tmpPath.c_str());
+        }
+        return written;
+    }
+
+    std::string _filePath;
+    /** the keys and values, in the order of the file */
+    std::vector<std::pair<std::string, std::string>> _entries;
+    std::unordered_map<std::string, size_t> _indices;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::condition_variable _savedCondition;
+#if USERDEFAULT_USE_WRITER_THREAD
+    std::thread _writer;
+#endif
+    /** incremented by each change, _savedVersion is the version of the file */
+    unsigned long long _version;
+    unsigned long long _savedVersion;
+    unsigned int _pendingWrites;
+    std::chrono::steady_clock::time_point _dirtyTime;
+    bool _flushRequested;
+    bool _quit;
+};
+}
+
+static std::unique_ptr<UserDefaultStore> s_store;
+
+static void setValueForKey(const char* pKey, const char* pValue)
+{
+    // check the params
+    if (! pKey || ! pValue || ! s_store)
+    {
+        return;
+    }
+    s_store->setValue(pKey, pValue);
+}
+
+static bool getValueForKey(const char* pKey, std::string* value)
+{
+    return pKey && s_store && s_store->getValue(pKey, value);
 }
 
 /**
@@ -166,27 +380,12 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = NULL;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
-	bool ret = defaultValue;
-
-	if (value)
-	{
-		ret = (! strcmp(value, "true"));
-	}
-
-    if (doc) delete doc;
-
-	return ret;
+    std::string value;
+    if (getValueForKey(pKey, &value))
+    {
+        return value == "true";
+    }
+    return defaultValue;
 }
 
 int UserDefault::getIntegerForKey(const char* pKey)
@@ -196,31 +395,12 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-	const char* value = NULL;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
-	int ret = defaultValue;
-
-	if (value)
-	{
-		ret = atoi(value);
-	}
-
-	if(doc)
-	{
-		delete doc;
-	}
-
-
-	return ret;
+    std::string value;
+    if (getValueForKey(pKey, &value))
+    {
+        return atoi(value.c_str());
+    }
+    return defaultValue;
 }
 
 float UserDefault::getFloatForKey(const char* pKey)
@@ -242,27 +422,12 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-	const char* value = NULL;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
-	double ret = defaultValue;
-
-	if (value)
-	{
-		ret = atof(value);
-	}
-
-    if (doc) delete doc;
-
-	return ret;
+    std::string value;
+    if (getValueForKey(pKey, &value))
+    {
+        return atof(value.c_str());
+    }
+    return defaultValue;
 }
 
 std::string UserDefault::getStringForKey(const char* pKey)
@@ -272,27 +437,12 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = NULL;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
-
-	string ret = defaultValue;
-
-	if (value)
-	{
-		ret = string(value);
-	}
-
-    if (doc) delete doc;
-
-	return ret;
+    std::string value;
+    if (getValueForKey(pKey, &value))
+    {
+        return value;
+    }
+    return defaultValue;
 }
 
 Data* UserDefault::getDataForKey(const char* pKey)
@@ -302,34 +452,22 @@ Data* UserDefault::getDataForKey(const char* pKey)
 
 Data* UserDefault::getDataForKey(const char* pKey, Data* defaultValue)
 {
-    const char* encodedData = NULL;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        encodedData = (const char*)(node->FirstChild()->Value());
-	}
-    
-	Data* ret = defaultValue;
-    
-	if (encodedData)
-	{
+    std::string encodedData;
+    Data* ret = defaultValue;
+
+    if (getValueForKey(pKey, &encodedData))
+    {
         unsigned char * decodedData = NULL;
-        int decodedDataLen = base64Decode((unsigned char*)encodedData, (unsigned int)strlen(encodedData), &decodedData);
+        int decodedDataLen = base64Decode((unsigned char*)encodedData.c_str(), (unsigned int)encodedData.size(), &decodedData);
         
         if (decodedData) {
             ret = Data::create(decodedData, decodedDataLen);
         
             delete decodedData;
         }
-	}
-    
-    if (doc) delete doc;
+    }
     
-	return ret;    
+    return ret;
 }
 
 
@@ -413,13 +551,19 @@ void UserDefault::setDataForKey(const char* pKey, const Data& value) {
 
 UserDefault* UserDefault::getInstance()
 {
-    initXMLFilePath();
-
-    // only create xml file one time
-    // the file exists after the program exit
-    if ((! isXMLFileExist()) && (! createXMLFile()))
+    // the file is loaded once, then the values are read and written in memory
+    if (! s_store)
     {
-        return NULL;
+        initXMLFilePath();
+
+        // only create xml file one time
+        // the file exists after the program exit
+        if ((! isXMLFileExist()) && (! createXMLFile()))
+        {
+            return NULL;
+        }
+
+        s_store.reset(new UserDefaultStore(_filePath));
     }
 
     if (! _userDefault)
@@ -432,6 +576,8 @@ UserDefault* UserDefault::getInstance()
 
 void UserDefault::destroyInstance()
 {
+    // writes the values left, the file is loaded again by the next getInstance()
+    s_store.reset();
     _userDefault = NULL;
 }
 
@@ -508,6 +654,10 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    if (s_store)
+    {
+        s_store->flush();
+    }
 }
 
 NS_CC_END
@@ -42,6 +42,11 @@ NS_CC_BEGIN
  * 
  * It supports the following base types:
  * bool, int, float, double, string
+ *
+ * Where the values are stored in UserDefault.xml, the file is loaded once and the values are read and written
+ * in memory. The changes are written back by a background thread a second after the first one, or sooner
+ * when many values change; the file is replaced atomically. On the platforms without threads (emscripten),
+ * each change is written at once.
  */
 class CC_DLL UserDefault
 {
@@ -115,6 +120,7 @@ public:
     void    setDataForKey(const char* pKey, const Data& value);
     /**
      @brief Save content to xml file
+     Blocks until the values set so far are written, instead of waiting for the background writes.
      */
     void    flush();
 
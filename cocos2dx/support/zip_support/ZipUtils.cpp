@@ -132,7 +132,7 @@ int ZipUtils::ccInflateMemoryWithHint(unsigned char *in, unsigned int inLength,
     /* ret value */
     int err = Z_OK;
     
-    int bufferSize = outLenghtHint;
+    unsigned int bufferSize = outLenghtHint > 0 ? outLenghtHint : 1;
     *out = new unsigned char[bufferSize];
     
     z_stream d_stream; /* decompression stream */
@@ -168,24 +168,22 @@ int ZipUtils::ccInflateMemoryWithHint(unsigned char *in, unsigned int inLength,
                 return err;
         }
         
-        // not enough memory ?
-        if (err != Z_STREAM_END)
+        // the data is truncated if there is room left but no progress
+        if (d_stream.avail_out > 0)
         {
-            delete [] *out;
-            *out = new unsigned char[bufferSize * BUFFER_INC_FACTOR];
-            
-            /* not enough memory, ouch */
-            if (! *out )
-            {
-                CCLOG("cocos2d: ZipUtils: realloc failed");
-                inflateEnd(&d_stream);
-                return Z_MEM_ERROR;
-            }
-            
-            d_stream.next_out = *out + bufferSize;
-            d_stream.avail_out = bufferSize;
-            bufferSize *= BUFFER_INC_FACTOR;
+            inflateEnd(&d_stream);
+            return Z_DATA_ERROR;
         }
+        
+        // not enough memory ?
+        unsigned char *grown = new unsigned char[bufferSize * BUFFER_INC_FACTOR];
+        memcpy(grown, *out, bufferSize);
+        delete [] *out;
+        *out = grown;
+        
+        d_stream.next_out = *out + bufferSize;
+        d_stream.avail_out = bufferSize * (BUFFER_INC_FACTOR - 1);
+        bufferSize *= BUFFER_INC_FACTOR;
     }
     
     *outLength = bufferSize - d_stream.avail_out;
@@ -224,80 +222,188 @@ int ZipUtils::ccInflateMemoryWithHint(unsigned char *in, unsigned int inLength,
     return outLength;
 }
 
+// The trailer of gzip data ends with the inflated length, modulo 2^32.
+static unsigned int getGZipLengthHint(const unsigned char *in, unsigned int inLength)
+{
+    if (! ZipUtils::ccIsGZipBuffer(in, inLength) || inLength < 18)
+    {
+        return 0;
+    }
+    
+    const unsigned char *trailer = in + inLength - 4;
+    unsigned int length = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | ((unsigned int)trailer[3] << 24);
+    
+    // deflate can't shrink data more than about 1032 times
+    return length / 1032 <= inLength ? length : 0;
+}
+
 int ZipUtils::ccInflateMemory(unsigned char *in, unsigned int inLength, unsigned char **out)
 {
+    unsigned int hint = getGZipLengthHint(in, inLength);
+    
     // 256k for hint
-    return ccInflateMemoryWithHint(in, inLength, out, 256 * 1024);
+    return ccInflateMemoryWithHint(in, inLength, out, hint > 0 ? hint : 256 * 1024);
 }
 
-int ZipUtils::ccInflateGZipFile(const char *path, unsigned char **out)
+int ZipUtils::ccInflateMemoryToBuffer(const unsigned char *in, unsigned int inLength, unsigned char *out, unsigned int outLength)
 {
-    int len;
-    unsigned int offset = 0;
+    z_stream d_stream; /* decompression stream */
+    d_stream.zalloc = (alloc_func)0;
+    d_stream.zfree = (free_func)0;
+    d_stream.opaque = (voidpf)0;
     
-    CCASSERT(out, "");
-    CCASSERT(&*out, "");
+    d_stream.next_in  = const_cast<Bytef*>(in);
+    d_stream.avail_in = inLength;
+    d_stream.next_out = out;
+    d_stream.avail_out = outLength;
     
-    gzFile inFile = gzopen(path, "rb");
-    if( inFile == NULL ) {
-        CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path);
+    if (inflateInit2(&d_stream, 15 + 32) != Z_OK)
+    {
+        CCLOG("cocos2d: ZipUtils: Incompatible zlib version!");
         return -1;
     }
     
-    /* 512k initial decompress buffer */
-    unsigned int bufferSize = 512 * 1024;
-    unsigned int totalBufferSize = bufferSize;
+    // with enough room, the whole data is inflated at once
+    int err = inflate(&d_stream, Z_FINISH);
+    unsigned int length = outLength - d_stream.avail_out;
+    inflateEnd(&d_stream);
     
-    *out = (unsigned char*)malloc( bufferSize );
-    if( ! out )
+    if (err != Z_STREAM_END)
     {
-        CCLOG("cocos2d: ZipUtils: out of memory");
+        CCLOG("cocos2d: ZipUtils: %s", err == Z_BUF_ERROR && d_stream.avail_out == 0
+              ? "The inflated data doesn't fit in the buffer!" : "Incorrect zlib compressed data!");
         return -1;
     }
     
-    for (;;) {
-        len = gzread(inFile, *out + offset, bufferSize);
-        if (len < 0)
-        {
-            CCLOG("cocos2d: ZipUtils: error in gzread");
-            free( *out );
-            *out = NULL;
-            return -1;
-        }
-        if (len == 0)
+    return length;
+}
+
+int ZipUtils::ccInflateMemoryStream(const unsigned char *in, unsigned int inLength,
+                                    const std::function<bool(const unsigned char *data, unsigned int length)> &callback,
+                                    unsigned int chunkSize)
+{
+    CCASSERT(chunkSize > 0, "chunkSize must be positive");
+    
+    z_stream d_stream; /* decompression stream */
+    d_stream.zalloc = (alloc_func)0;
+    d_stream.zfree = (free_func)0;
+    d_stream.opaque = (voidpf)0;
+    
+    d_stream.next_in  = const_cast<Bytef*>(in);
+    d_stream.avail_in = inLength;
+    
+    if (inflateInit2(&d_stream, 15 + 32) != Z_OK)
+    {
+        CCLOG("cocos2d: ZipUtils: Incompatible zlib version!");
+        return -1;
+    }
+    
+    unsigned char *chunk = new unsigned char[chunkSize];
+    int length = 0;
+    int err = Z_OK;
+    
+    do
+    {
+        d_stream.next_out = chunk;
+        d_stream.avail_out = chunkSize;
+        
+        // Z_BUF_ERROR means no progress, i.e. the data is truncated
+        err = inflate(&d_stream, Z_NO_FLUSH);
+        if (err != Z_OK && err != Z_STREAM_END)
         {
+            CCLOG("cocos2d: ZipUtils: Incorrect zlib compressed data!");
             break;
         }
         
-        offset += len;
-        
-        // finish reading the file
-        if( (unsigned int)len < bufferSize )
+        unsigned int produced = chunkSize - d_stream.avail_out;
+        length += produced;
+        if (produced > 0 && ! callback(chunk, produced))
         {
             break;
         }
+    } while (err != Z_STREAM_END);
+    
+    inflateEnd(&d_stream);
+    delete [] chunk;
+    
+    return err == Z_STREAM_END ? length : -1;
+}
+
+int ZipUtils::ccInflateGZipFile(const char *path, unsigned char **out)
+{
+    CCASSERT(out, "");
+    CCASSERT(&*out, "");
+    *out = NULL;
+    
+    // the data of the files stored uncompressed in a resource pack is read in place
+    unsigned long fileLen = 0;
+    unsigned char *compressed = NULL;
+    const unsigned char *data = FileUtils::getInstance()->getMappedFileData(path, &fileLen);
+    if (! data)
+    {
+        data = compressed = FileUtils::getInstance()->getFileData(path, "rb", &fileLen);
+    }
+    
+    if (NULL == data)
+    {
+        CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path);
+        return -1;
+    }
+    
+    int len = -1;
+    if (! ccIsGZipBuffer(data, fileLen))
+    {
+        // like gzread(), read the files which aren't compressed as they are
+        *out = (unsigned char*)malloc(fileLen > 0 ? fileLen : 1);
+        if (*out)
+        {
+            memcpy(*out, data, fileLen);
+            len = fileLen;
+        }
+    }
+    else
+    {
+        /* 512k initial decompress buffer, unless the trailer tells the length */
+        unsigned int hint = getGZipLengthHint(data, fileLen);
+        unsigned int bufferSize = hint > 0 ? hint : 512 * 1024;
+        unsigned int offset = 0;
         
-        bufferSize *= BUFFER_INC_FACTOR;
-        totalBufferSize += bufferSize;
-        unsigned char *tmp = (unsigned char*)realloc(*out, totalBufferSize );
+        *out = (unsigned char*)malloc(bufferSize);
+        
+        auto append = [&](const unsigned char *chunk, unsigned int chunkLength) -> bool {
+            if (offset + chunkLength > bufferSize)
+            {
+                while (offset + chunkLength > bufferSize)
+                {
+                    bufferSize *= BUFFER_INC_FACTOR;
+                }
+                unsigned char *tmp = (unsigned char*)realloc(*out, bufferSize);
+                if (! tmp)
+                {
+                    CCLOG("cocos2d: ZipUtils: out of memory");
+                    return false;
+                }
+                *out = tmp;
+            }
+            memcpy(*out + offset, chunk, chunkLength);
+            offset += chunkLength;
+            return true;
+        };
         
-        if( ! tmp )
+        if (! *out || ccInflateMemoryStream(data, fileLen, append) < 0)
         {
-            CCLOG("cocos2d: ZipUtils: out of memory");
-            free( *out );
+            CCLOG("cocos2d: ZipUtils: error in gzread");
+            free(*out);
             *out = NULL;
-            return -1;
         }
-        
-        *out = tmp;
-    }
-    
-    if (gzclose(inFile) != Z_OK)
-    {
-        CCLOG("cocos2d: ZipUtils: gzclose failed");
+        else
+        {
+            len = offset;
+        }
     }
     
-    return offset;
+    CC_SAFE_DELETE_ARRAY(compressed);
+    return len;
 }
 
 bool ZipUtils::ccIsCCZFile(const char *path)
@@ -311,10 +417,13 @@ bool ZipUtils::ccIsCCZFile(const char *path)
     if(NULL == compressed || 0 == fileLen)
     {
         CCLOG("cocos2d: ZipUtils: loading file failed");
+        CC_SAFE_DELETE_ARRAY(compressed);
         return false;
     }
 
-    return ccIsCCZBuffer(compressed, fileLen);
+    bool ret = ccIsCCZBuffer(compressed, fileLen);
+    delete [] compressed;
+    return ret;
 }
 
 bool ZipUtils::ccIsCCZBuffer(const unsigned char *buffer, int len)
@@ -340,10 +449,13 @@ bool ZipUtils::ccIsGZipFile(const char *path)
     if(NULL == compressed || 0 == fileLen)
     {
         CCLOG("cocos2d: ZipUtils: loading file failed");
+        CC_SAFE_DELETE_ARRAY(compressed);
         return false;
     }
 
-    return ccIsGZipBuffer(compressed, fileLen);
+    bool ret = ccIsGZipBuffer(compressed, fileLen);
+    delete [] compressed;
+    return ret;
 }
 
 bool ZipUtils::ccIsGZipBuffer(const unsigned char *buffer, int len)
@@ -357,93 +469,114 @@ bool ZipUtils::ccIsGZipBuffer(const unsigned char *buffer, int len)
 }
 
 
-int ZipUtils::ccInflateCCZBuffer(const unsigned char *buffer, int bufferLen, unsigned char **out)
+int ZipUtils::ccGetCCZBufferLength(const unsigned char *buffer, int bufferLen)
 {
-    struct CCZHeader *header = (struct CCZHeader*) buffer;
+    if (! ccIsCCZBuffer(buffer, bufferLen))
+    {
+        CCLOG("cocos2d: Invalid CCZ file");
+        return -1;
+    }
+
+    const struct CCZHeader *header = (const struct CCZHeader*) buffer;
+    bool encrypted = header->sig[3] == 'p';
 
-    // verify header
-    if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == '!' )
+    // verify header version
+    unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
+    if( version > (encrypted ? 0 : 2) )
     {
-        // verify header version
-        unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
-        if( version > 2 )
-        {
-            CCLOG("cocos2d: Unsupported CCZ header format");
-            return -1;
-        }
+        CCLOG("cocos2d: Unsupported CCZ header format");
+        return -1;
+    }
 
-        // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
-        {
-            CCLOG("cocos2d: CCZ Unsupported compression method");
-            return -1;
-        }
+    // verify compression format
+    if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
+    {
+        CCLOG("cocos2d: CCZ Unsupported compression method");
+        return -1;
     }
-    else if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == 'p' )
+
+    unsigned int len = header->len;
+    if (encrypted)
     {
-        // encrypted ccz file
-        header = (struct CCZHeader*) buffer;
+        // the encryption starts with the length, on its own it is decrypted by the first key word
+        ccDecodeEncodedPvr(&len, 1);
+    }
+    return CC_SWAP_INT32_BIG_TO_HOST( len );
+}
 
-        // verify header version
-        unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
-        if( version > 0 )
-        {
-            CCLOG("cocos2d: Unsupported CCZ header format");
-            return -1;
-        }
+int ZipUtils::ccInflateCCZBufferToBuffer(const unsigned char *buffer, int bufferLen, unsigned char *out, unsigned int outLength)
+{
+    int len = ccGetCCZBufferLength(buffer, bufferLen);
+    if (len < 0 || (unsigned int)len > outLength)
+    {
+        return -1;
+    }
 
-        // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
-        {
-            CCLOG("cocos2d: CCZ Unsupported compression method");
-            return -1;
-        }
+    const struct CCZHeader *header = (const struct CCZHeader*) buffer;
+    const unsigned char *source = buffer + sizeof(*header);
+    unsigned int sourceLen = bufferLen - sizeof(*header);
+    unsigned int *decrypted = NULL;
 
-        // decrypt
-        unsigned int* ints = (unsigned int*)(buffer+12);
+    if (header->sig[3] == 'p')
+    {
+        // decrypt a copy of the compressed data, the buffer may be read-only
         int enclen = (bufferLen-12)/4;
+        decrypted = new unsigned int[(bufferLen-12+3)/4];
+        memcpy(decrypted, buffer+12, bufferLen-12);
 
-        ccDecodeEncodedPvr(ints, enclen);
+        ccDecodeEncodedPvr(decrypted, enclen);
 
 #if COCOS2D_DEBUG > 0
         // verify checksum in debug mode
-        unsigned int calculated = ccChecksumPvr(ints, enclen);
+        unsigned int calculated = ccChecksumPvr(decrypted, enclen);
         unsigned int required = CC_SWAP_INT32_BIG_TO_HOST( header->reserved );
 
         if(calculated != required)
         {
             CCLOG("cocos2d: Can't decrypt image file. Is the decryption key valid?");
+            delete [] decrypted;
             return -1;
         }
 #endif
+        // the compressed data follows the length
+        source = (const unsigned char*)decrypted + sizeof(*header) - 12;
     }
-    else
+
+    uLongf destlen = len;
+    int ret = uncompress(out, &destlen, (const Bytef*)source, sourceLen);
+    delete [] decrypted;
+
+    if( ret != Z_OK )
     {
-        CCLOG("cocos2d: Invalid CCZ file");
+        CCLOG("cocos2d: CCZ: Failed to uncompress data");
         return -1;
     }
 
-    unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header->len );
+    return destlen;
+}
 
-    *out = (unsigned char*)malloc( len );
+int ZipUtils::ccInflateCCZBuffer(const unsigned char *buffer, int bufferLen, unsigned char **out)
+{
+    *out = NULL;
+    int len = ccGetCCZBufferLength(buffer, bufferLen);
+    if (len < 0)
+    {
+        return -1;
+    }
+
+    *out = (unsigned char*)malloc( len > 0 ? len : 1 );
     if(! *out )
     {
         CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
         return -1;
     }
 
-    unsigned long destlen = len;
-    unsigned long source = (unsigned long) buffer + sizeof(*header);
-    int ret = uncompress(*out, &destlen, (Bytef*)source, bufferLen - sizeof(*header) );
-
-    if( ret != Z_OK )
+    len = ccInflateCCZBufferToBuffer(buffer, bufferLen, *out, len);
+    if (len < 0)
     {
-        CCLOG("cocos2d: CCZ: Failed to uncompress data");
         free( *out );
         *out = NULL;
-        return -1;
     }
-
     return len;
 }
 
@@ -452,19 +585,25 @@ int ZipUtils::ccInflateCCZFile(const char *path, unsigned char **out)
     CCAssert(out, "");
     CCAssert(&*out, "");
     
-    // load file into memory
-    unsigned char* compressed = NULL;
-    
+    // the data of the files stored uncompressed in a resource pack is read in place
     unsigned long fileLen = 0;
-    compressed = FileUtils::getInstance()->getFileData(path, "rb", &fileLen);
+    unsigned char* compressed = NULL;
+    const unsigned char* data = FileUtils::getInstance()->getMappedFileData(path, &fileLen);
+    if (! data)
+    {
+        data = compressed = FileUtils::getInstance()->getFileData(path, "rb", &fileLen);
+    }
     
-    if(NULL == compressed || 0 == fileLen)
+    if(NULL == data || 0 == fileLen)
     {
         CCLOG("cocos2d: Error loading CCZ compressed file");
+        CC_SAFE_DELETE_ARRAY(compressed);
         return -1;
     }
     
-    return ccInflateCCZBuffer(compressed, fileLen, out);
+    int len = ccInflateCCZBuffer(data, fileLen, out);
+    CC_SAFE_DELETE_ARRAY(compressed);
+    return len;
 }
 
 void ZipUtils::ccSetPvrEncryptionKeyPart(int index, unsigned int value)
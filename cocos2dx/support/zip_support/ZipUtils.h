@@ -25,6 +25,7 @@ THE SOFTWARE.
 #define __SUPPORT_ZIPUTILS_H__
 
 #include <string>
+#include <functional>
 #include "platform/CCPlatformConfig.h"
 #include "CCPlatformDefine.h"
 
@@ -59,7 +60,8 @@ namespace cocos2d
         * Inflates either zlib or gzip deflated memory. The inflated memory is
         * expected to be freed by the caller.
         *
-        * It will allocate 256k for the destination buffer. If it is not enough it will multiply the previous buffer size per 2, until there is enough memory.
+        * It will allocate 256k for the destination buffer, or the length stated by the trailer of gzip data.
+        * If it is not enough it will multiply the previous buffer size per 2, until there is enough memory.
         * @returns the length of the deflated buffer
         *
         @since v0.8.1
@@ -78,8 +80,35 @@ namespace cocos2d
         */
         static int ccInflateMemoryWithHint(unsigned char *in, unsigned int inLength, unsigned char **out, unsigned int outLenghtHint);
 
+        /** 
+        * Inflates either zlib or gzip deflated memory into a buffer provided by the caller,
+        * e.g. when the inflated length is known beforehand.
+        *
+        * @returns the length of the inflated data, or -1 if the data is invalid or doesn't fit in outLength bytes
+        *
+        @since v3.0
+        */
+        static int ccInflateMemoryToBuffer(const unsigned char *in, unsigned int inLength, unsigned char *out, unsigned int outLength);
+
+        /** 
+        * Inflates either zlib or gzip deflated memory chunk by chunk, so that the inflated data
+        * can be consumed without being held in memory at once.
+        *
+        * The callback is given each chunk of at most chunkSize bytes, and returns false to stop.
+        *
+        * @returns the length of the inflated data, or -1 on error or if the callback stopped it
+        *
+        @since v3.0
+        */
+        static int ccInflateMemoryStream(const unsigned char *in, unsigned int inLength,
+                                         const std::function<bool(const unsigned char *data, unsigned int length)> &callback,
+                                         unsigned int chunkSize = 64 * 1024);
+
         /** inflates a GZip file into memory
         *
+        * The file is read with FileUtils, so it can be in a resource pack.
+        * The inflated memory is expected to be freed by the caller with free().
+        *
         * @returns the length of the deflated buffer
         *
         * @since v0.99.5
@@ -104,6 +133,8 @@ namespace cocos2d
 
         /** inflates a CCZ file into memory
         *
+        * The inflated memory is expected to be freed by the caller with free().
+        *
         * @returns the length of the deflated buffer
         *
         * @since v0.99.5
@@ -117,6 +148,23 @@ namespace cocos2d
         * @since v3.0
         */
         static int ccInflateCCZBuffer(const unsigned char *buffer, int len, unsigned char **out);
+
+        /** gets the length of the data in a buffer with CCZ format, as stated by its header
+        *
+        * @returns the length of the inflated data, or -1 if the buffer isn't a supported CCZ buffer
+        *
+        * @since v3.0
+        */
+        static int ccGetCCZBufferLength(const unsigned char *buffer, int len);
+
+        /** inflates a buffer with CCZ format into a buffer provided by the caller,
+        * which can hold ccGetCCZBufferLength() bytes. The buffer with CCZ format is never modified.
+        *
+        * @returns the length of the inflated data, or -1 on error
+        *
+        * @since v3.0
+        */
+        static int ccInflateCCZBufferToBuffer(const unsigned char *buffer, int len, unsigned char *out, unsigned int outLength);
         
         /** test a file is a CCZ format file or not
         *
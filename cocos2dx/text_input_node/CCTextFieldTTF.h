@@ -158,6 +158,7 @@ protected:
 protected:
 
     virtual void draw();
+    virtual bool usesQuadCommand() const { return false; }
 
     //////////////////////////////////////////////////////////////////////////
     // IMEDelegate interface
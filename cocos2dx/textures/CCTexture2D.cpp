@@ -31,6 +31,7 @@ THE SOFTWARE.
 */
 
 #include "CCTexture2D.h"
+#include "CCTexture2DConvert.h"
 #include "ccConfig.h"
 #include "ccMacros.h"
 #include "CCConfiguration.h"
@@ -42,6 +43,7 @@ THE SOFTWARE.
 #include "shaders/CCGLProgram.h"
 #include "shaders/ccGLStateCache.h"
 #include "shaders/CCShaderCache.h"
+#include "support/CCFrameProfiler.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     #include "CCTextureCache.h"
@@ -115,308 +117,6 @@ static Texture2D::PixelFormat g_defaultAlphaPixelFormat = Texture2D::PixelFormat
 
 static bool _PVRHaveAlphaPremultiplied = false;
 
-//////////////////////////////////////////////////////////////////////////
-//conventer function
-
-// IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBB
-void Texture2D::convertI8ToRGB888(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i=0; i < dataLen; ++i)
-    {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
-    }
-}
-
-// IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
-void Texture2D::convertAI88ToRGB888(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
-    }
-}
-
-// IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
-void Texture2D::convertI8ToRGBA8888(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0; i < dataLen; ++i)
-    {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
-        *outData++ = 0xFF;        //A
-    }
-}
-
-// IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
-void Texture2D::convertAI88ToRGBA8888(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
-        *outData++ = data[i + 1]; //A
-    }
-}
-
-// IIIIIIII -> RRRRRGGGGGGBBBBB
-void Texture2D::convertI8ToRGB565(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0; i < dataLen; ++i)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i] & 0x00FC) << 3         //G
-            | (data[i] & 0x00F8) >> 3;        //B
-    }
-}
-
-// IIIIIIIIAAAAAAAA -> RRRRRGGGGGGBBBBB
-void Texture2D::convertAI88ToRGB565(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i] & 0x00FC) << 3         //G
-            | (data[i] & 0x00F8) >> 3;        //B
-    }
-}
-
-// IIIIIIII -> RRRRGGGGBBBBAAAA
-void Texture2D::convertI8ToRGBA4444(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0; i < dataLen; ++i)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i] & 0x00F0) << 4             //G
-        | (data[i] & 0x00F0)                  //B
-        | 0x000F;                             //A
-    }
-}
-
-// IIIIIIIIAAAAAAAA -> RRRRGGGGBBBBAAAA
-void Texture2D::convertAI88ToRGBA4444(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i] & 0x00F0) << 4             //G
-        | (data[i] & 0x00F0)                  //B
-        | (data[i+1] & 0x00F0) >> 4;          //A
-    }
-}
-
-// IIIIIIII -> RRRRRGGGGGBBBBBA
-void Texture2D::convertI8ToRGB5A1(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0; i < dataLen; ++i)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i] & 0x00F8) << 3         //G
-            | (data[i] & 0x00F8) >> 2         //B
-            | 0x0001;                         //A
-    }
-}
-
-// IIIIIIIIAAAAAAAA -> RRRRRGGGGGBBBBBA
-void Texture2D::convertAI88ToRGB5A1(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i] & 0x00F8) << 3         //G
-            | (data[i] & 0x00F8) >> 2         //B
-            | (data[i + 1] & 0x0080) >> 7;    //A
-    }
-}
-
-// IIIIIIII -> IIIIIIIIAAAAAAAA
-void Texture2D::convertI8ToAI88(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0; i < dataLen; ++i)
-    {
-        *out16++ = 0xFF00     //A
-        | data[i];            //I
-    }
-}
-
-// IIIIIIIIAAAAAAAA -> AAAAAAAA
-void Texture2D::convertAI88ToA8(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 1; i < dataLen; i += 2)
-    {
-        *outData++ = data[i]; //A
-    }
-}
-
-// IIIIIIIIAAAAAAAA -> IIIIIIII
-void Texture2D::convertAI88ToI8(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *outData++ = data[i]; //R
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
-void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = data[i];         //R
-        *outData++ = data[i + 1];     //G
-        *outData++ = data[i + 2];     //B
-        *outData++ = 0xFF;            //A
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
-void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *outData++ = data[i];         //R
-        *outData++ = data[i + 1];     //G
-        *outData++ = data[i + 2];     //B
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGGBBBBB
-void Texture2D::convertRGB888ToRGB565(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00FC) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 3;    //B
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
-void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00FC) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 3;    //B
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIII
-void Texture2D::convertRGB888ToI8(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIII
-void Texture2D::convertRGBA8888ToI8(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
-void Texture2D::convertRGBA8888ToA8(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen -3; i < l; i += 4)
-    {
-        *outData++ = data[i + 3]; //A
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIIIAAAAAAAA
-void Texture2D::convertRGB888ToAI88(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-        *outData++ = 0xFF;
-    }
-}
-
-
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIIIAAAAAAAA
-void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    for (int i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-        *outData++ = data[i + 3];
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRGGGGBBBBAAAA
-void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *out16++ = ((data[i] & 0x00F0) << 8           //R
-                    | (data[i + 1] & 0x00F0) << 4     //G
-                    | (data[i + 2] & 0xF0)            //B
-                    |  0x0F);                         //A
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
-void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i + 1] & 0x00F0) << 4         //G
-        | (data[i + 2] & 0xF0)                //B
-        |  (data[i + 3] & 0xF0) >> 4;         //A
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
-void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00F8) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 2     //B
-            |  0x01;                          //A
-    }
-}
-
-// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
-void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, int dataLen, unsigned char* outData)
-{
-    unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0, l = dataLen - 2; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00F8) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 2     //B
-            |  (data[i + 3] & 0x0080) >> 7;   //A
-    }
-}
-// conventer function end
-//////////////////////////////////////////////////////////////////////////
 
 Texture2D::Texture2D()
 : _pixelFormat(Texture2D::PixelFormat::DEFAULT)
@@ -546,6 +246,8 @@ bool Texture2D::initWithData(const void *data, int dataLen, Texture2D::PixelForm
 
 bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat pixelFormat, unsigned int pixelsWide, unsigned int pixelsHigh)
 {
+    CC_PROFILE_ZONE(FrameProfiler::ZONE_TEXTURE_UPLOAD);
+
     //the pixelFormat must be a certain value 
     CCAssert(pixelFormat != PixelFormat::NONE && pixelFormat != PixelFormat::AUTO, "the \"pixelFormat\" param must be a certain value!");
 
@@ -773,37 +475,39 @@ bool Texture2D::initWithImage(Image *image, PixelFormat format)
 
 Texture2D::PixelFormat Texture2D::convertI8ToFormat(const unsigned char* data, int dataLen, PixelFormat format, unsigned char** outData, int* outDataLen)
 {
+    const PixelConverters& converters = getPixelConverters();
+
     switch (format)
     {
     case PixelFormat::RGBA8888:
         *outDataLen = dataLen*4;
         *outData = new unsigned char[*outDataLen];
-        convertI8ToRGBA8888(data, dataLen, *outData);
+        converters.i8ToRGBA8888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB888:
         *outDataLen = dataLen*3;
         *outData = new unsigned char[*outDataLen];
-        convertI8ToRGB888(data, dataLen, *outData);
+        converters.i8ToRGB888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen*2;
         *outData = new unsigned char[*outDataLen];
-        convertI8ToRGB565(data, dataLen, *outData);
+        converters.i8ToRGB565(data, dataLen, *outData);
         break;
     case PixelFormat::AI88:
         *outDataLen = dataLen*2;
         *outData = new unsigned char[*outDataLen];
-        convertI8ToAI88(data, dataLen, *outData);
+        converters.i8ToAI88(data, dataLen, *outData);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen*2;
         *outData = new unsigned char[*outDataLen];
-        convertI8ToRGBA4444(data, dataLen, *outData);
+        converters.i8ToRGBA4444(data, dataLen, *outData);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen*2;
         *outData = new unsigned char[*outDataLen];
-        convertI8ToRGB5A1(data, dataLen, *outData);
+        converters.i8ToRGB5A1(data, dataLen, *outData);
         break;
     default:
         // unsupport convertion or don't need to convert
@@ -822,42 +526,44 @@ Texture2D::PixelFormat Texture2D::convertI8ToFormat(const unsigned char* data, i
 
 Texture2D::PixelFormat Texture2D::convertAI88ToFormat(const unsigned char* data, int dataLen, PixelFormat format, unsigned char** outData, int* outDataLen)
 {
+    const PixelConverters& converters = getPixelConverters();
+
     switch (format)
     {
     case PixelFormat::RGBA8888:
         *outDataLen = dataLen*2;
         *outData = new unsigned char[*outDataLen];
-        convertAI88ToRGBA8888(data, dataLen, *outData);
+        converters.ai88ToRGBA8888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB888:
         *outDataLen = dataLen/2*3;
         *outData = new unsigned char[*outDataLen];
-        convertAI88ToRGB888(data, dataLen, *outData);
+        converters.ai88ToRGB888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen;
         *outData = new unsigned char[*outDataLen];
-        convertAI88ToRGB565(data, dataLen, *outData);
+        converters.ai88ToRGB565(data, dataLen, *outData);
         break;
     case PixelFormat::A8:
         *outDataLen = dataLen/2;
         *outData = new unsigned char[*outDataLen];
-        convertAI88ToA8(data, dataLen, *outData);
+        converters.ai88ToA8(data, dataLen, *outData);
         break;
     case PixelFormat::I8:
         *outDataLen = dataLen/2;
         *outData = new unsigned char[*outDataLen];
-        convertAI88ToI8(data, dataLen, *outData);
+        converters.ai88ToI8(data, dataLen, *outData);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen;
         *outData = new unsigned char[*outDataLen];
-        convertAI88ToRGBA4444(data, dataLen, *outData);
+        converters.ai88ToRGBA4444(data, dataLen, *outData);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen;
         *outData = new unsigned char[*outDataLen];
-        convertAI88ToRGB5A1(data, dataLen, *outData);
+        converters.ai88ToRGB5A1(data, dataLen, *outData);
         break;
     default:
         // unsupport convertion or don't need to convert
@@ -877,37 +583,39 @@ Texture2D::PixelFormat Texture2D::convertAI88ToFormat(const unsigned char* data,
 
 Texture2D::PixelFormat Texture2D::convertRGB888ToFormat(const unsigned char* data, int dataLen, PixelFormat format, unsigned char** outData, int* outDataLen)
 {
+    const PixelConverters& converters = getPixelConverters();
+
     switch (format)
     {
     case PixelFormat::RGBA8888:
         *outDataLen = dataLen/3*4;
         *outData = new unsigned char[*outDataLen];
-        convertRGB888ToRGBA8888(data, dataLen, *outData);
+        converters.rgb888ToRGBA8888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen/3*2;
         *outData = new unsigned char[*outDataLen];
-        convertRGB888ToRGB565(data, dataLen, *outData);
+        converters.rgb888ToRGB565(data, dataLen, *outData);
         break;
     case PixelFormat::I8:
         *outDataLen = dataLen/3;
         *outData = new unsigned char[*outDataLen];
-        convertRGB888ToI8(data, dataLen, *outData);
+        converters.rgb888ToI8(data, dataLen, *outData);
         break;
     case PixelFormat::AI88:
         *outDataLen = dataLen/3*2;
         *outData = new unsigned char[*outDataLen];
-        convertRGB888ToAI88(data, dataLen, *outData);
+        converters.rgb888ToAI88(data, dataLen, *outData);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen/3*2;
         *outData = new unsigned char[*outDataLen];
-        convertRGB888ToRGBA4444(data, dataLen, *outData);
+        converters.rgb888ToRGBA4444(data, dataLen, *outData);
         break;
     case PixelFormat::RGB5A1:
-        *outDataLen = dataLen;
+        *outDataLen = dataLen/3*2;
         *outData = new unsigned char[*outDataLen];
-        convertRGB888ToRGB5A1(data, dataLen, *outData);
+        converters.rgb888ToRGB5A1(data, dataLen, *outData);
         break;
     default:
         // unsupport convertion or don't need to convert
@@ -925,43 +633,44 @@ Texture2D::PixelFormat Texture2D::convertRGB888ToFormat(const unsigned char* dat
 
 Texture2D::PixelFormat Texture2D::convertRGBA8888ToFormat(const unsigned char* data, int dataLen, PixelFormat format, unsigned char** outData, int* outDataLen)
 {
+    const PixelConverters& converters = getPixelConverters();
 
     switch (format)
     {
     case PixelFormat::RGB888:
         *outDataLen = dataLen/4*3;
         *outData = new unsigned char[*outDataLen];
-        convertRGBA8888ToRGB888(data, dataLen, *outData);
+        converters.rgba8888ToRGB888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen/2;
         *outData = new unsigned char[*outDataLen];
-        convertRGBA8888ToRGB565(data, dataLen, *outData);
+        converters.rgba8888ToRGB565(data, dataLen, *outData);
         break;
     case PixelFormat::A8:
         *outDataLen = dataLen/4;
         *outData = new unsigned char[*outDataLen];
-        convertRGBA8888ToA8(data, dataLen, *outData);
+        converters.rgba8888ToA8(data, dataLen, *outData);
         break;
     case PixelFormat::I8:
         *outDataLen = dataLen/4;
         *outData = new unsigned char[*outDataLen];
-        convertRGBA8888ToI8(data, dataLen, *outData);
+        converters.rgba8888ToI8(data, dataLen, *outData);
         break;
     case PixelFormat::AI88:
         *outDataLen = dataLen/2;
         *outData = new unsigned char[*outDataLen];
-        convertRGBA8888ToAI88(data, dataLen, *outData);
+        converters.rgba8888ToAI88(data, dataLen, *outData);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen/2;
         *outData = new unsigned char[*outDataLen];
-        convertRGBA8888ToRGBA4444(data, dataLen, *outData);
+        converters.rgba8888ToRGBA4444(data, dataLen, *outData);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen/2;
         *outData = new unsigned char[*outDataLen];
-        convertRGBA8888ToRGB5A1(data, dataLen, *outData);
+        converters.rgba8888ToRGB5A1(data, dataLen, *outData);
         break;
     default:
         // unsupport convertion or don't need to convert
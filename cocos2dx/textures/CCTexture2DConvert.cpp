@@ -0,0 +1,549 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CCTexture2DConvert.h"
+#include "ccConfig.h"
+
+#if CC_USE_TEXTURE_CONVERT_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CC_TEXTURE_CONVERT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace {
+
+// I = (R*299 + G*587 + B*114 + 500) / 1000
+inline unsigned char intensity(unsigned char r, unsigned char g, unsigned char b)
+{
+    return (unsigned char)((r * 299 + g * 587 + b * 114 + 500) / 1000);
+}
+
+// One pixel at a time
+struct ScalarFormats
+{
+    struct Pixels
+    {
+        unsigned char r, g, b, a;
+    };
+
+    // IIIIIIII
+    struct I8
+    {
+        enum { BYTES = 1, LANES = 1 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            Pixels p = { data[0], data[0], data[0], 0xFF };
+            return p;
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            out[0] = intensity(p.r, p.g, p.b);
+        }
+        static void storeGray(const Pixels& p, unsigned char* out)
+        {
+            out[0] = p.r;
+        }
+    };
+
+    // IIIIIIIIAAAAAAAA
+    struct AI88
+    {
+        enum { BYTES = 2, LANES = 1 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            Pixels p = { data[0], data[0], data[0], data[1] };
+            return p;
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            out[0] = intensity(p.r, p.g, p.b);
+            out[1] = p.a;
+        }
+        static void storeGray(const Pixels& p, unsigned char* out)
+        {
+            out[0] = p.r;
+            out[1] = p.a;
+        }
+    };
+
+    // RRRRRRRRGGGGGGGGBBBBBBBB
+    struct RGB888
+    {
+        enum { BYTES = 3, LANES = 1 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            Pixels p = { data[0], data[1], data[2], 0xFF };
+            return p;
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            out[0] = p.r;
+            out[1] = p.g;
+            out[2] = p.b;
+        }
+    };
+
+    // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
+    struct RGBA8888
+    {
+        enum { BYTES = 4, LANES = 1 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            Pixels p = { data[0], data[1], data[2], data[3] };
+            return p;
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            out[0] = p.r;
+            out[1] = p.g;
+            out[2] = p.b;
+            out[3] = p.a;
+        }
+    };
+
+    // RRRRRGGGGGGBBBBB
+    struct RGB565
+    {
+        enum { BYTES = 2 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            unsigned short v = (p.r & 0x00F8) << 8
+                | (p.g & 0x00FC) << 3
+                | (p.b & 0x00F8) >> 3;
+            memcpy(out, &v, sizeof(v));
+        }
+    };
+
+    // RRRRGGGGBBBBAAAA
+    struct RGBA4444
+    {
+        enum { BYTES = 2 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            unsigned short v = (p.r & 0x00F0) << 8
+                | (p.g & 0x00F0) << 4
+                | (p.b & 0x00F0)
+                | (p.a & 0x00F0) >> 4;
+            memcpy(out, &v, sizeof(v));
+        }
+    };
+
+    // RRRRRGGGGGBBBBBA
+    struct RGB5A1
+    {
+        enum { BYTES = 2 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            unsigned short v = (p.r & 0x00F8) << 8
+                | (p.g & 0x00F8) << 3
+                | (p.b & 0x00F8) >> 2
+                | (p.a & 0x0080) >> 7;
+            memcpy(out, &v, sizeof(v));
+        }
+    };
+
+    // AAAAAAAA
+    struct A8
+    {
+        enum { BYTES = 1 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            out[0] = p.a;
+        }
+    };
+
+    // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA, with the colors multiplied by the alpha
+    struct PremultipliedRGBA8888
+    {
+        enum { BYTES = 4 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            out[0] = (unsigned char)((p.r * (p.a + 1)) >> 8);
+            out[1] = (unsigned char)((p.g * (p.a + 1)) >> 8);
+            out[2] = (unsigned char)((p.b * (p.a + 1)) >> 8);
+            out[3] = p.a;
+        }
+    };
+};
+
+#if CC_TEXTURE_CONVERT_SSE2
+
+// 16 pixels at a time, one byte per color in each lane
+struct SSE2Formats
+{
+    struct Pixels
+    {
+        __m128i r, g, b, a;
+    };
+
+    // the 16 pixels of 32 bits in x0 to x3 as planar colors, with 3 rounds of unpacking:
+    // each round interleaves the pixels of two registers, until each half holds a single color
+    static Pixels deinterleave(__m128i x0, __m128i x1, __m128i x2, __m128i x3)
+    {
+        __m128i a0 = _mm_unpacklo_epi8(x0, x1);
+        __m128i a1 = _mm_unpackhi_epi8(x0, x1);
+        __m128i a2 = _mm_unpacklo_epi8(x2, x3);
+        __m128i a3 = _mm_unpackhi_epi8(x2, x3);
+
+        __m128i b0 = _mm_unpacklo_epi8(a0, a1);
+        __m128i b1 = _mm_unpackhi_epi8(a0, a1);
+        __m128i b2 = _mm_unpacklo_epi8(a2, a3);
+        __m128i b3 = _mm_unpackhi_epi8(a2, a3);
+
+        // RG and BA of the pixels 0 to 7 and 8 to 15
+        __m128i rg0 = _mm_unpacklo_epi8(b0, b1);
+        __m128i ba0 = _mm_unpackhi_epi8(b0, b1);
+        __m128i rg1 = _mm_unpacklo_epi8(b2, b3);
+        __m128i ba1 = _mm_unpackhi_epi8(b2, b3);
+
+        Pixels p;
+        p.r = _mm_unpacklo_epi64(rg0, rg1);
+        p.g = _mm_unpackhi_epi64(rg0, rg1);
+        p.b = _mm_unpacklo_epi64(ba0, ba1);
+        p.a = _mm_unpackhi_epi64(ba0, ba1);
+        return p;
+    }
+
+    // writes the pixels as 32 bits, 4 pixels in each of x
+    static void interleave(const Pixels& p, __m128i x[4])
+    {
+        __m128i rgLow = _mm_unpacklo_epi8(p.r, p.g);
+        __m128i rgHigh = _mm_unpackhi_epi8(p.r, p.g);
+        __m128i baLow = _mm_unpacklo_epi8(p.b, p.a);
+        __m128i baHigh = _mm_unpackhi_epi8(p.b, p.a);
+        x[0] = _mm_unpacklo_epi16(rgLow, baLow);
+        x[1] = _mm_unpackhi_epi16(rgLow, baLow);
+        x[2] = _mm_unpacklo_epi16(rgHigh, baHigh);
+        x[3] = _mm_unpackhi_epi16(rgHigh, baHigh);
+    }
+
+    static __m128i intensity(const Pixels& p)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i weightsRG = _mm_set1_epi32(299 | (587 << 16));
+        const __m128i weightsB = _mm_set1_epi32(114 | (500 << 16));
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 scale = _mm_set1_ps(0.001f);
+
+        __m128i r16[2] = { _mm_unpacklo_epi8(p.r, zero), _mm_unpackhi_epi8(p.r, zero) };
+        __m128i g16[2] = { _mm_unpacklo_epi8(p.g, zero), _mm_unpackhi_epi8(p.g, zero) };
+        __m128i b16[2] = { _mm_unpacklo_epi8(p.b, zero), _mm_unpackhi_epi8(p.b, zero) };
+        __m128i i16[2];
+
+        for (int h = 0; h < 2; ++h)
+        {
+            // R*299 + G*587 + B*114 + 500 for 4 pixels, from the pairs (R, G) and (B, 1)
+            __m128i sumLow = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(r16[h], g16[h]), weightsRG),
+                                           _mm_madd_epi16(_mm_unpacklo_epi16(b16[h], one), weightsB));
+            __m128i sumHigh = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(r16[h], g16[h]), weightsRG),
+                                            _mm_madd_epi16(_mm_unpackhi_epi16(b16[h], one), weightsB));
+
+            // the sums are below 2^18, so (sum + 0.5) * 0.001 truncates to the same value as sum / 1000
+            __m128i iLow = _mm_cvttps_epi32(_mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(sumLow), half), scale));
+            __m128i iHigh = _mm_cvttps_epi32(_mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(sumHigh), half), scale));
+            i16[h] = _mm_packs_epi32(iLow, iHigh);
+        }
+        return _mm_packus_epi16(i16[0], i16[1]);
+    }
+
+    struct I8
+    {
+        enum { BYTES = 1, LANES = 16 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            Pixels p;
+            p.r = p.g = p.b = _mm_loadu_si128((const __m128i*)data);
+            p.a = _mm_set1_epi8((char)0xFF);
+            return p;
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            _mm_storeu_si128((__m128i*)out, intensity(p));
+        }
+        static void storeGray(const Pixels& p, unsigned char* out)
+        {
+            _mm_storeu_si128((__m128i*)out, p.r);
+        }
+    };
+
+    struct AI88
+    {
+        enum { BYTES = 2, LANES = 16 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            const __m128i mask = _mm_set1_epi16(0xFF);
+            __m128i x0 = _mm_loadu_si128((const __m128i*)data);
+            __m128i x1 = _mm_loadu_si128((const __m128i*)(data + 16));
+            Pixels p;
+            p.r = p.g = p.b = _mm_packus_epi16(_mm_and_si128(x0, mask), _mm_and_si128(x1, mask));
+            p.a = _mm_packus_epi16(_mm_srli_epi16(x0, 8), _mm_srli_epi16(x1, 8));
+            return p;
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            store(intensity(p), p.a, out);
+        }
+        static void storeGray(const Pixels& p, unsigned char* out)
+        {
+            store(p.r, p.a, out);
+        }
+        static void store(__m128i i, __m128i a, unsigned char* out)
+        {
+            _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(i, a));
+            _mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi8(i, a));
+        }
+    };
+
+    struct RGB888
+    {
+        enum { BYTES = 3, LANES = 16 };
+
+        // the 4 pixels of 3 bytes at the beginning of x, as 32 bits with an opaque alpha
+        static __m128i expand(__m128i x)
+        {
+            const __m128i lane0 = _mm_setr_epi32(0xFFFFFF, 0, 0, 0);
+            const __m128i lane1 = _mm_setr_epi32(0, 0xFFFFFF, 0, 0);
+            const __m128i lane2 = _mm_setr_epi32(0, 0, 0xFFFFFF, 0);
+            const __m128i lane3 = _mm_setr_epi32(0, 0, 0, 0xFFFFFF);
+            const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+
+            __m128i x01 = _mm_or_si128(_mm_and_si128(x, lane0), _mm_and_si128(_mm_slli_si128(x, 1), lane1));
+            __m128i x23 = _mm_or_si128(_mm_and_si128(_mm_slli_si128(x, 2), lane2), _mm_and_si128(_mm_slli_si128(x, 3), lane3));
+            return _mm_or_si128(_mm_or_si128(x01, x23), alpha);
+        }
+
+        // the 4 pixels of 32 bits in x, as 3 bytes each in the first 12 bytes
+        static __m128i pack(__m128i x)
+        {
+            const __m128i bytes0 = _mm_setr_epi8(-1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i bytes1 = _mm_setr_epi8(0, 0, 0, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i bytes2 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i bytes3 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, -1, -1, -1, 0, 0, 0, 0);
+
+            __m128i x01 = _mm_or_si128(_mm_and_si128(x, bytes0), _mm_and_si128(_mm_srli_si128(x, 1), bytes1));
+            __m128i x23 = _mm_or_si128(_mm_and_si128(_mm_srli_si128(x, 2), bytes2), _mm_and_si128(_mm_srli_si128(x, 3), bytes3));
+            return _mm_or_si128(x01, x23);
+        }
+
+        static Pixels load(const unsigned char* data)
+        {
+            // the last load starts 4 bytes early, so that it stays inside the 48 bytes
+            __m128i x0 = _mm_loadu_si128((const __m128i*)data);
+            __m128i x1 = _mm_loadu_si128((const __m128i*)(data + 12));
+            __m128i x2 = _mm_loadu_si128((const __m128i*)(data + 24));
+            __m128i x3 = _mm_srli_si128(_mm_loadu_si128((const __m128i*)(data + 32)), 4);
+            return deinterleave(expand(x0), expand(x1), expand(x2), expand(x3));
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            __m128i x[4];
+            interleave(p, x);
+            __m128i x0 = pack(x[0]);
+            __m128i x1 = pack(x[1]);
+            __m128i x2 = pack(x[2]);
+            __m128i x3 = pack(x[3]);
+            _mm_storeu_si128((__m128i*)out, _mm_or_si128(x0, _mm_slli_si128(x1, 12)));
+            _mm_storeu_si128((__m128i*)(out + 16), _mm_or_si128(_mm_srli_si128(x1, 4), _mm_slli_si128(x2, 8)));
+            _mm_storeu_si128((__m128i*)(out + 32), _mm_or_si128(_mm_srli_si128(x2, 8), _mm_slli_si128(x3, 4)));
+        }
+    };
+
+    struct RGBA8888
+    {
+        enum { BYTES = 4, LANES = 16 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            return deinterleave(_mm_loadu_si128((const __m128i*)data),
+                                _mm_loadu_si128((const __m128i*)(data + 16)),
+                                _mm_loadu_si128((const __m128i*)(data + 32)),
+                                _mm_loadu_si128((const __m128i*)(data + 48)));
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            __m128i x[4];
+            interleave(p, x);
+            for (int i = 0; i < 4; ++i)
+            {
+                _mm_storeu_si128((__m128i*)(out + i * 16), x[i]);
+            }
+        }
+    };
+
+    struct RGB565
+    {
+        enum { BYTES = 2 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i mask5 = _mm_set1_epi16(0xF8);
+            const __m128i mask6 = _mm_set1_epi16(0xFC);
+
+            __m128i r16[2] = { _mm_unpacklo_epi8(p.r, zero), _mm_unpackhi_epi8(p.r, zero) };
+            __m128i g16[2] = { _mm_unpacklo_epi8(p.g, zero), _mm_unpackhi_epi8(p.g, zero) };
+            __m128i b16[2] = { _mm_unpacklo_epi8(p.b, zero), _mm_unpackhi_epi8(p.b, zero) };
+            for (int h = 0; h < 2; ++h)
+            {
+                __m128i v = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(r16[h], mask5), 8),
+                                         _mm_or_si128(_mm_slli_epi16(_mm_and_si128(g16[h], mask6), 3),
+                                                      _mm_srli_epi16(b16[h], 3)));
+                _mm_storeu_si128((__m128i*)(out + h * 16), v);
+            }
+        }
+    };
+
+    struct RGBA4444
+    {
+        enum { BYTES = 2 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            // the shifts of 16 bits move the high half of the next byte in the high half of
+            // each byte, which is masked away
+            const __m128i high = _mm_set1_epi8((char)0xF0);
+            const __m128i low = _mm_set1_epi8(0x0F);
+
+            __m128i rg = _mm_or_si128(_mm_and_si128(p.r, high), _mm_and_si128(_mm_srli_epi16(p.g, 4), low));
+            __m128i ba = _mm_or_si128(_mm_and_si128(p.b, high), _mm_and_si128(_mm_srli_epi16(p.a, 4), low));
+            _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(ba, rg));
+            _mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi8(ba, rg));
+        }
+    };
+
+    struct RGB5A1
+    {
+        enum { BYTES = 2 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i mask5 = _mm_set1_epi16(0xF8);
+
+            __m128i r16[2] = { _mm_unpacklo_epi8(p.r, zero), _mm_unpackhi_epi8(p.r, zero) };
+            __m128i g16[2] = { _mm_unpacklo_epi8(p.g, zero), _mm_unpackhi_epi8(p.g, zero) };
+            __m128i b16[2] = { _mm_unpacklo_epi8(p.b, zero), _mm_unpackhi_epi8(p.b, zero) };
+            __m128i a16[2] = { _mm_unpacklo_epi8(p.a, zero), _mm_unpackhi_epi8(p.a, zero) };
+            for (int h = 0; h < 2; ++h)
+            {
+                __m128i rg = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(r16[h], mask5), 8),
+                                          _mm_slli_epi16(_mm_and_si128(g16[h], mask5), 3));
+                __m128i ba = _mm_or_si128(_mm_srli_epi16(_mm_and_si128(b16[h], mask5), 2),
+                                          _mm_srli_epi16(a16[h], 7));
+                _mm_storeu_si128((__m128i*)(out + h * 16), _mm_or_si128(rg, ba));
+            }
+        }
+    };
+
+    struct A8
+    {
+        enum { BYTES = 1 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            _mm_storeu_si128((__m128i*)out, p.a);
+        }
+    };
+
+    struct PremultipliedRGBA8888
+    {
+        enum { BYTES = 4 };
+
+        // C * (A + 1) is at most 65280, so it fits in 16 bits
+        static __m128i premultiply(__m128i c, __m128i alphaLow, __m128i alphaHigh)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i low = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), alphaLow), 8);
+            __m128i high = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), alphaHigh), 8);
+            return _mm_packus_epi16(low, high);
+        }
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i one = _mm_set1_epi16(1);
+            __m128i alphaLow = _mm_add_epi16(_mm_unpacklo_epi8(p.a, zero), one);
+            __m128i alphaHigh = _mm_add_epi16(_mm_unpackhi_epi8(p.a, zero), one);
+
+            Pixels premultiplied;
+            premultiplied.r = premultiply(p.r, alphaLow, alphaHigh);
+            premultiplied.g = premultiply(p.g, alphaLow, alphaHigh);
+            premultiplied.b = premultiply(p.b, alphaLow, alphaHigh);
+            premultiplied.a = p.a;
+            RGBA8888::store(premultiplied, out);
+        }
+    };
+};
+
+#endif // CC_TEXTURE_CONVERT_SSE2
+
+PixelConverters createScalarPixelConverters()
+{
+    PixelConverters converters;
+    setPixelConverters<ScalarFormats>(converters, "scalar");
+    return converters;
+}
+
+PixelConverters createPixelConverters()
+{
+    PixelConverters converters = createScalarPixelConverters();
+#if CC_USE_TEXTURE_CONVERT_SIMD
+    if (! initNEONPixelConverters(converters))
+    {
+#if CC_TEXTURE_CONVERT_SSE2
+        setPixelConverters<SSE2Formats>(converters, "SSE2");
+#endif
+    }
+#endif
+    return converters;
+}
+
+} // namespace
+
+const PixelConverters& getPixelConverters()
+{
+    static const PixelConverters s_converters = createPixelConverters();
+    return s_converters;
+}
+
+const PixelConverters& getScalarPixelConverters()
+{
+    static const PixelConverters s_converters = createScalarPixelConverters();
+    return s_converters;
+}
+
+NS_CC_END
@@ -0,0 +1,184 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __TEXTURES_CCTEXTURE2D_CONVERT_H__
+#define __TEXTURES_CCTEXTURE2D_CONVERT_H__
+
+#include "platform/CCPlatformMacros.h"
+#include <string.h>
+
+NS_CC_BEGIN
+
+/** Converts the dataLen bytes of pixels at data to another pixel format, and writes them to outData.
+ The conversions which don't change the size of the pixels may convert in place.
+ */
+typedef void (*PixelConvertFunction)(const unsigned char* data, int dataLen, unsigned char* outData);
+
+/** The pixel format conversions used by Texture2D, one function per pair of formats.
+
+ getPixelConverters() returns the fastest ones for the running CPU: the SSE2 or NEON kernels
+ convert 16 pixels at a time, and give the same results as the scalar ones.
+ @since v3.0
+ */
+struct PixelConverters
+{
+    /** name of the instruction set used by the conversions: "scalar", "SSE2" or "NEON" */
+    const char* instructionSet;
+
+    PixelConvertFunction i8ToRGB888;
+    PixelConvertFunction i8ToRGBA8888;
+    PixelConvertFunction i8ToRGB565;
+    PixelConvertFunction i8ToRGBA4444;
+    PixelConvertFunction i8ToRGB5A1;
+    PixelConvertFunction i8ToAI88;
+
+    PixelConvertFunction ai88ToRGB888;
+    PixelConvertFunction ai88ToRGBA8888;
+    PixelConvertFunction ai88ToRGB565;
+    PixelConvertFunction ai88ToRGBA4444;
+    PixelConvertFunction ai88ToRGB5A1;
+    PixelConvertFunction ai88ToA8;
+    PixelConvertFunction ai88ToI8;
+
+    PixelConvertFunction rgb888ToRGBA8888;
+    PixelConvertFunction rgb888ToRGB565;
+    PixelConvertFunction rgb888ToI8;
+    PixelConvertFunction rgb888ToAI88;
+    PixelConvertFunction rgb888ToRGBA4444;
+    PixelConvertFunction rgb888ToRGB5A1;
+
+    PixelConvertFunction rgba8888ToRGB888;
+    PixelConvertFunction rgba8888ToRGB565;
+    PixelConvertFunction rgba8888ToI8;
+    PixelConvertFunction rgba8888ToA8;
+    PixelConvertFunction rgba8888ToAI88;
+    PixelConvertFunction rgba8888ToRGBA4444;
+    PixelConvertFunction rgba8888ToRGB5A1;
+
+    /** multiplies the color of RGBA8888 pixels by their alpha, like CC_RGB_PREMULTIPLY_ALPHA; it may work in place */
+    PixelConvertFunction rgba8888ToPremultipliedRGBA8888;
+};
+
+/** Returns the conversions selected for the running CPU. They are selected on the first call. */
+const PixelConverters& getPixelConverters();
+
+/** Returns the scalar conversions, to compare them with the SIMD ones. */
+const PixelConverters& getScalarPixelConverters();
+
+/** Fill the converters with the NEON kernels, and return false when they are not built for this CPU.
+ Implemented in CCTexture2DConvertNEON.cpp, which is built with the NEON instructions enabled.
+ */
+bool initNEONPixelConverters(PixelConverters& converters);
+
+/** Converts the pixels with Source::load() and Destination::store(), Source::LANES pixels at a time.
+
+ The formats are structures of one instruction set, which load or store LANES pixels as planar colors.
+ The last pixels go through a buffer, so that the kernels never read or write past the ends of the data.
+ */
+template <typename Source, typename Destination>
+void convertPixels(const unsigned char* data, int dataLen, unsigned char* outData)
+{
+    const int pixels = dataLen / Source::BYTES;
+    int i = 0;
+
+    for (; i + Source::LANES <= pixels; i += Source::LANES)
+    {
+        Destination::store(Source::load(data + i * Source::BYTES), outData + i * Destination::BYTES);
+    }
+
+    if (i < pixels)
+    {
+        unsigned char in[Source::LANES * 4] = { 0 };
+        unsigned char out[Source::LANES * 4];
+        memcpy(in, data + i * Source::BYTES, (pixels - i) * Source::BYTES);
+        Destination::store(Source::load(in), out);
+        memcpy(outData + i * Destination::BYTES, out, (pixels - i) * Destination::BYTES);
+    }
+}
+
+/** Stores the pixels of I8 or AI88 as another gray format, without computing their intensity again. */
+template <typename Destination>
+struct GrayDestination
+{
+    enum { BYTES = Destination::BYTES };
+
+    template <typename Pixels>
+    static void store(const Pixels& p, unsigned char* out)
+    {
+        Destination::storeGray(p, out);
+    }
+};
+
+/** Fills the converters with the formats of one instruction set. */
+template <typename Formats>
+void setPixelConverters(PixelConverters& converters, const char* instructionSet)
+{
+    typedef typename Formats::I8 I8;
+    typedef typename Formats::AI88 AI88;
+    typedef typename Formats::RGB888 RGB888;
+    typedef typename Formats::RGBA8888 RGBA8888;
+    typedef typename Formats::RGB565 RGB565;
+    typedef typename Formats::RGBA4444 RGBA4444;
+    typedef typename Formats::RGB5A1 RGB5A1;
+    typedef typename Formats::A8 A8;
+    typedef typename Formats::PremultipliedRGBA8888 PremultipliedRGBA8888;
+
+    converters.instructionSet = instructionSet;
+
+    converters.i8ToRGB888 = convertPixels<I8, RGB888>;
+    converters.i8ToRGBA8888 = convertPixels<I8, RGBA8888>;
+    converters.i8ToRGB565 = convertPixels<I8, RGB565>;
+    converters.i8ToRGBA4444 = convertPixels<I8, RGBA4444>;
+    converters.i8ToRGB5A1 = convertPixels<I8, RGB5A1>;
+    converters.i8ToAI88 = convertPixels<I8, GrayDestination<AI88> >;
+
+    converters.ai88ToRGB888 = convertPixels<AI88, RGB888>;
+    converters.ai88ToRGBA8888 = convertPixels<AI88, RGBA8888>;
+    converters.ai88ToRGB565 = convertPixels<AI88, RGB565>;
+    converters.ai88ToRGBA4444 = convertPixels<AI88, RGBA4444>;
+    converters.ai88ToRGB5A1 = convertPixels<AI88, RGB5A1>;
+    converters.ai88ToA8 = convertPixels<AI88, A8>;
+    converters.ai88ToI8 = convertPixels<AI88, GrayDestination<I8> >;
+
+    converters.rgb888ToRGBA8888 = convertPixels<RGB888, RGBA8888>;
+    converters.rgb888ToRGB565 = convertPixels<RGB888, RGB565>;
+    converters.rgb888ToI8 = convertPixels<RGB888, I8>;
+    converters.rgb888ToAI88 = convertPixels<RGB888, AI88>;
+    converters.rgb888ToRGBA4444 = convertPixels<RGB888, RGBA4444>;
+    converters.rgb888ToRGB5A1 = convertPixels<RGB888, RGB5A1>;
+
+    converters.rgba8888ToRGB888 = convertPixels<RGBA8888, RGB888>;
+    converters.rgba8888ToRGB565 = convertPixels<RGBA8888, RGB565>;
+    converters.rgba8888ToI8 = convertPixels<RGBA8888, I8>;
+    converters.rgba8888ToA8 = convertPixels<RGBA8888, A8>;
+    converters.rgba8888ToAI88 = convertPixels<RGBA8888, AI88>;
+    converters.rgba8888ToRGBA4444 = convertPixels<RGBA8888, RGBA4444>;
+    converters.rgba8888ToRGB5A1 = convertPixels<RGBA8888, RGB5A1>;
+
+    converters.rgba8888ToPremultipliedRGBA8888 = convertPixels<RGBA8888, PremultipliedRGBA8888>;
+}
+
+NS_CC_END
+
+#endif // __TEXTURES_CCTEXTURE2D_CONVERT_H__
@@ -0,0 +1,267 @@
+/****************************************************************************
+ Copyright (c) 2013 cocos2d-x.org
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// This file is built with the NEON instructions enabled, on the CPUs which may have them.
+// On Android armeabi-v7a, the kernels are only used when the CPU reports NEON at runtime.
+
+#include "CCTexture2DConvert.h"
+#include "ccConfig.h"
+
+#if CC_USE_TEXTURE_CONVERT_SIMD && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define CC_TEXTURE_CONVERT_NEON 1
+#include <arm_neon.h>
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) && defined(__arm__)
+#include <cpu-features.h>
+#endif
+#endif
+
+NS_CC_BEGIN
+
+#if CC_TEXTURE_CONVERT_NEON
+
+namespace {
+
+// 16 pixels at a time, one byte per color in each lane
+struct NEONFormats
+{
+    typedef uint8x16x4_t Pixels;
+
+    static uint8x16_t intensity(const Pixels& p)
+    {
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        const float32x4_t scale = vdupq_n_f32(0.001f);
+        uint16x8_t i16[2];
+
+        for (int h = 0; h < 2; ++h)
+        {
+            uint16x8_t r16 = vmovl_u8(h == 0 ? vget_low_u8(p.val[0]) : vget_high_u8(p.val[0]));
+            uint16x8_t g16 = vmovl_u8(h == 0 ? vget_low_u8(p.val[1]) : vget_high_u8(p.val[1]));
+            uint16x8_t b16 = vmovl_u8(h == 0 ? vget_low_u8(p.val[2]) : vget_high_u8(p.val[2]));
+
+            // R*299 + G*587 + B*114 + 500 for 4 pixels
+            uint32x4_t sumLow = vmlal_n_u16(vmlal_n_u16(vmlal_n_u16(vdupq_n_u32(500), vget_low_u16(r16), 299),
+                                                        vget_low_u16(g16), 587), vget_low_u16(b16), 114);
+            uint32x4_t sumHigh = vmlal_n_u16(vmlal_n_u16(vmlal_n_u16(vdupq_n_u32(500), vget_high_u16(r16), 299),
+                                                         vget_high_u16(g16), 587), vget_high_u16(b16), 114);
+
+            // the sums are below 2^18, so (sum + 0.5) * 0.001 truncates to the same value as sum / 1000
+            uint32x4_t iLow = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vcvtq_f32_u32(sumLow), half), scale));
+            uint32x4_t iHigh = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vcvtq_f32_u32(sumHigh), half), scale));
+            i16[h] = vcombine_u16(vmovn_u32(iLow), vmovn_u32(iHigh));
+        }
+        return vcombine_u8(vmovn_u16(i16[0]), vmovn_u16(i16[1]));
+    }
+
+    struct I8
+    {
+        enum { BYTES = 1, LANES = 16 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            Pixels p;
+            p.val[0] = p.val[1] = p.val[2] = vld1q_u8(data);
+            p.val[3] = vdupq_n_u8(0xFF);
+            return p;
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            vst1q_u8(out, intensity(p));
+        }
+        static void storeGray(const Pixels& p, unsigned char* out)
+        {
+            vst1q_u8(out, p.val[0]);
+        }
+    };
+
+    struct AI88
+    {
+        enum { BYTES = 2, LANES = 16 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            uint8x16x2_t x = vld2q_u8(data);
+            Pixels p;
+            p.val[0] = p.val[1] = p.val[2] = x.val[0];
+            p.val[3] = x.val[1];
+            return p;
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            uint8x16x2_t x;
+            x.val[0] = intensity(p);
+            x.val[1] = p.val[3];
+            vst2q_u8(out, x);
+        }
+        static void storeGray(const Pixels& p, unsigned char* out)
+        {
+            uint8x16x2_t x;
+            x.val[0] = p.val[0];
+            x.val[1] = p.val[3];
+            vst2q_u8(out, x);
+        }
+    };
+
+    struct RGB888
+    {
+        enum { BYTES = 3, LANES = 16 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            uint8x16x3_t x = vld3q_u8(data);
+            Pixels p;
+            p.val[0] = x.val[0];
+            p.val[1] = x.val[1];
+            p.val[2] = x.val[2];
+            p.val[3] = vdupq_n_u8(0xFF);
+            return p;
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            uint8x16x3_t x;
+            x.val[0] = p.val[0];
+            x.val[1] = p.val[1];
+            x.val[2] = p.val[2];
+            vst3q_u8(out, x);
+        }
+    };
+
+    struct RGBA8888
+    {
+        enum { BYTES = 4, LANES = 16 };
+
+        static Pixels load(const unsigned char* data)
+        {
+            return vld4q_u8(data);
+        }
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            vst4q_u8(out, p);
+        }
+    };
+
+    struct RGB565
+    {
+        enum { BYTES = 2 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            // RRRRRGGG GGGBBBBB, as the high and low bytes
+            uint8x16x2_t x;
+            x.val[1] = vorrq_u8(vandq_u8(p.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(p.val[1], 5));
+            x.val[0] = vorrq_u8(vshlq_n_u8(vshrq_n_u8(p.val[1], 2), 5), vshrq_n_u8(p.val[2], 3));
+            vst2q_u8(out, x);
+        }
+    };
+
+    struct RGBA4444
+    {
+        enum { BYTES = 2 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            uint8x16x2_t x;
+            x.val[1] = vorrq_u8(vandq_u8(p.val[0], vdupq_n_u8(0xF0)), vshrq_n_u8(p.val[1], 4));
+            x.val[0] = vorrq_u8(vandq_u8(p.val[2], vdupq_n_u8(0xF0)), vshrq_n_u8(p.val[3], 4));
+            vst2q_u8(out, x);
+        }
+    };
+
+    struct RGB5A1
+    {
+        enum { BYTES = 2 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            // RRRRRGGG GGBBBBBA, as the high and low bytes
+            uint8x16x2_t x;
+            x.val[1] = vorrq_u8(vandq_u8(p.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(p.val[1], 5));
+            x.val[0] = vorrq_u8(vorrq_u8(vshlq_n_u8(vshrq_n_u8(p.val[1], 3), 6), vshlq_n_u8(vshrq_n_u8(p.val[2], 3), 1)),
+                                vshrq_n_u8(p.val[3], 7));
+            vst2q_u8(out, x);
+        }
+    };
+
+    struct A8
+    {
+        enum { BYTES = 1 };
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            vst1q_u8(out, p.val[3]);
+        }
+    };
+
+    struct PremultipliedRGBA8888
+    {
+        enum { BYTES = 4 };
+
+        // C * (A + 1) is at most 65280, so it fits in 16 bits
+        static uint8x16_t premultiply(uint8x16_t c, uint16x8_t alphaLow, uint16x8_t alphaHigh)
+        {
+            uint16x8_t low = vmulq_u16(vmovl_u8(vget_low_u8(c)), alphaLow);
+            uint16x8_t high = vmulq_u16(vmovl_u8(vget_high_u8(c)), alphaHigh);
+            return vcombine_u8(vshrn_n_u16(low, 8), vshrn_n_u16(high, 8));
+        }
+
+        static void store(const Pixels& p, unsigned char* out)
+        {
+            uint16x8_t alphaLow = vaddw_u8(vdupq_n_u16(1), vget_low_u8(p.val[3]));
+            uint16x8_t alphaHigh = vaddw_u8(vdupq_n_u16(1), vget_high_u8(p.val[3]));
+
+            Pixels premultiplied;
+            premultiplied.val[0] = premultiply(p.val[0], alphaLow, alphaHigh);
+            premultiplied.val[1] = premultiply(p.val[1], alphaLow, alphaHigh);
+            premultiplied.val[2] = premultiply(p.val[2], alphaLow, alphaHigh);
+            premultiplied.val[3] = p.val[3];
+            vst4q_u8(out, premultiplied);
+        }
+    };
+};
+
+} // namespace
+
+bool initNEONPixelConverters(PixelConverters& converters)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) && defined(__arm__)
+    if (android_getCpuFamily() != ANDROID_CPU_FAMILY_ARM || (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) == 0)
+    {
+        return false;
+    }
+#endif
+
+    setPixelConverters<NEONFormats>(converters, "NEON");
+    return true;
+}
+
+#else
+
+bool initNEONPixelConverters(PixelConverters& converters)
+{
+    CC_UNUSED_PARAM(converters);
+    return false;
+}
+
+#endif // CC_TEXTURE_CONVERT_NEON
+
+NS_CC_END
@@ -603,6 +603,9 @@ void TextureAtlas::drawNumberOfQuads(int numberOfQuads, int start)
 
     GL::bindTexture2D(_texture->getName());
 
+    // the whole atlas is uploaded, so the other ranges are up to date when several ranges are drawn
+    int uploadedQuads = MAX(_totalQuads, start + numberOfQuads);
+
 #if CC_TEXTURE_ATLAS_USE_VAO
 
     //
@@ -620,9 +623,9 @@ void TextureAtlas::drawNumberOfQuads(int numberOfQuads, int start)
         //		glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
 		
 		// option 3: orphaning + glMapBuffer
-		glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * (numberOfQuads-start), NULL, GL_DYNAMIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * uploadedQuads, NULL, GL_DYNAMIC_DRAW);
 		void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-		memcpy(buf, _quads, sizeof(_quads[0])* (numberOfQuads-start));
+		memcpy(buf, _quads, sizeof(_quads[0]) * uploadedQuads);
 		glUnmapBuffer(GL_ARRAY_BUFFER);
 		
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -660,7 +663,7 @@ void TextureAtlas::drawNumberOfQuads(int numberOfQuads, int start)
     // XXX: update is done in draw... perhaps it should be done in a timer
     if (_dirty) 
     {
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * numberOfQuads , &_quads[start] );
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(_quads[0]) * uploadedQuads, _quads);
         _dirty = false;
     }
 
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <chrono>
 
 #include "CCTextureCache.h"
 #include "CCTexture2D.h"
@@ -37,7 +39,10 @@ THE SOFTWARE.
 #include "platform/CCThread.h"
 #include "support/ccUtils.h"
 #include "CCScheduler.h"
+#include "CCConfiguration.h"
 #include "cocoa/CCString.h"
+#include "support/CCThreadPool.h"
+#include "support/CCFrameProfiler.h"
 
 
 #ifdef EMSCRIPTEN
@@ -67,57 +72,83 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _asyncStructQueue(nullptr)
-, _imageInfoQueue(nullptr)
+: _asyncThreadCount(0)
+, _asyncSequence(0)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _cancelledRequestCount(0)
+, _uploadBudgetBytes(0)
+, _uploadBudgetTime(0)
 {
     CCASSERT(_sharedTextureCache == nullptr, "Attempted to allocate a second instance of a singleton.");
 
-    _textures = new Dictionary();
-    _textures->init();
-
+    _textures.reserve(30);
 }
 
 TextureCache::~TextureCache()
 {
     CCLOGINFO("deallocing TextureCache: %p", this);
 
-    CC_SAFE_RELEASE(_textures);
+    for (auto& thread : _loadingThreads)
+    {
+        delete thread;
+    }
+    _loadingThreads.clear();
+
+    // the requests that were never delivered
+    for (auto& request : _requestQueue)
+    {
+        deleteAsyncRequest(request);
+    }
+    _requestQueue.clear();
+    for (auto& request : _decodedQueue)
+    {
+        deleteAsyncRequest(request);
+    }
+    _decodedQueue.clear();
+    _asyncRequests.clear();
 
-    CC_SAFE_DELETE(_loadingThread);
     _sharedTextureCache = nullptr;
 }
 
 void TextureCache::destroyInstance()
 {
-    // notify sub thread to quick
-    _sharedTextureCache->_needQuit = true;
-    _sharedTextureCache->_sleepCondition.notify_one();
-    if (_sharedTextureCache->_loadingThread) _sharedTextureCache->_loadingThread->join();
+    if (_sharedTextureCache == nullptr)
+    {
+        return;
+    }
+
+    // notify sub threads to quit
+    {
+        std::lock_guard<std::mutex> lock(_sharedTextureCache->_requestQueueMutex);
+        _sharedTextureCache->_needQuit = true;
+    }
+    _sharedTextureCache->_sleepCondition.notify_all();
+    for (auto& thread : _sharedTextureCache->_loadingThreads)
+    {
+        thread->join();
+    }
 
     CC_SAFE_RELEASE_NULL(_sharedTextureCache);
 }
 
 const char* TextureCache::description() const
 {
-    return String::createWithFormat("<TextureCache | Number of textures = %u>", _textures->count())->getCString();
+    return String::createWithFormat("<TextureCache | Number of textures = %d>", (int)_textures.size())->getCString();
 }
 
 Dictionary* TextureCache::snapshotTextures()
 { 
     Dictionary* pRet = new Dictionary();
-    DictElement* pElement = NULL;
-    CCDICT_FOREACH(_textures, pElement)
+    for (const auto& element : _textures)
     {
-        pRet->setObject(pElement->getObject(), pElement->getStrKey());
+        pRet->setObject(element.second, element.first);
     }
     pRet->autorelease();
     return pRet;
 }
 
-void TextureCache::addImageAsync(const char *path, Object *target, SEL_CallFuncO selector)
+void TextureCache::addImageAsync(const char *path, Object *target, SEL_CallFuncO selector, int priority)
 {
     CCASSERT(path != NULL, "TextureCache: fileimage MUST not be NULL");    
 
@@ -128,7 +159,7 @@ void TextureCache::addImageAsync(const char *path, Object *target, SEL_CallFuncO
     std::string pathKey = path;
 
     pathKey = FileUtils::getInstance()->fullPathForFilename(pathKey.c_str());
-    texture = static_cast<Texture2D*>(_textures->objectForKey(pathKey.c_str()));
+    texture = _textures.at(pathKey);
 
     std::string fullpath = pathKey;
     if (texture != NULL)
@@ -142,18 +173,12 @@ void TextureCache::addImageAsync(const char *path, Object *target, SEL_CallFuncO
     }
 
     // lazy init
-    if (_asyncStructQueue == NULL)
-    {             
-        _asyncStructQueue = new queue<AsyncStruct*>();
-        _imageInfoQueue   = new queue<ImageInfo*>();        
-
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
-
-        _needQuit = false;
+    if (_loadingThreads.empty())
+    {
+        startLoadingThreads();
     }
 
-    if (0 == _asyncRefCount)
+    if (0 == _asyncRefCount && 0 == _cancelledRequestCount)
     {
         Director::getInstance()->getScheduler()->scheduleSelector(schedule_selector(TextureCache::addImageAsyncCallBack), this, 0, false);
     }
@@ -168,126 +193,348 @@ void TextureCache::addImageAsync(const char *path, Object *target, SEL_CallFuncO
     // generate async struct
     AsyncStruct *data = new AsyncStruct(fullpath, target, selector);
 
-    // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
+    // the file is already requested: share the decoding
+    auto it = _asyncRequests.find(fullpath);
+    if (it != _asyncRequests.end())
+    {
+        AsyncRequest *request = it->second;
+        request->callbacks.push_back(data);
+
+        std::lock_guard<std::mutex> lock(_requestQueueMutex);
+        if (request->priority < priority)
+        {
+            request->priority = priority;
+        }
+        return;
+    }
+
+    AsyncRequest *request = new AsyncRequest();
+    request->filename = fullpath;
+    request->callbacks.push_back(data);
+    request->priority = priority;
+    request->sequence = _asyncSequence++;
+    request->state = AsyncRequest::State::QUEUED;
+    request->image = nullptr;
+    _asyncRequests[fullpath] = request;
+
+    // add async request into queue
+    {
+        std::lock_guard<std::mutex> lock(_requestQueueMutex);
+        _requestQueue.push_back(request);
+    }
 
     _sleepCondition.notify_one();
 }
 
+void TextureCache::cancelImageAsync(const char *path, Object *target)
+{
+    CCASSERT(path != NULL, "TextureCache: fileimage MUST not be NULL");
+
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(path);
+    auto it = _asyncRequests.find(fullpath);
+    if (it != _asyncRequests.end())
+    {
+        removeAsyncCallbacks(it->second, target);
+    }
+}
+
+void TextureCache::cancelAllImageAsync(Object *target)
+{
+    // removeAsyncCallbacks() may erase the request from the map
+    std::vector<AsyncRequest*> requests;
+    requests.reserve(_asyncRequests.size());
+    for (auto& element : _asyncRequests)
+    {
+        requests.push_back(element.second);
+    }
+
+    for (auto& request : requests)
+    {
+        removeAsyncCallbacks(request, target);
+    }
+}
+
+void TextureCache::removeAsyncCallbacks(AsyncRequest *request, Object *target)
+{
+    auto& callbacks = request->callbacks;
+    for (auto it = callbacks.begin(); it != callbacks.end(); )
+    {
+        AsyncStruct *data = *it;
+        if (target == nullptr || data->target == target)
+        {
+            CC_SAFE_RELEASE(data->target);
+            delete data;
+            it = callbacks.erase(it);
+            --_asyncRefCount;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (callbacks.empty())
+    {
+        _asyncRequests.erase(request->filename);
+
+        // not decoded yet: remove it from the queue
+        bool queued = false;
+        {
+            std::lock_guard<std::mutex> lock(_requestQueueMutex);
+            if (request->state == AsyncRequest::State::QUEUED)
+            {
+                _requestQueue.erase(std::find(_requestQueue.begin(), _requestQueue.end(), request));
+                queued = true;
+            }
+        }
+
+        // already decoded: remove it from the decoded queue,
+        // otherwise it is released by addImageAsyncCallBack() once the loading thread is done
+        bool decoded = false;
+        if (! queued)
+        {
+            std::lock_guard<std::mutex> lock(_decodedQueueMutex);
+            if (request->state == AsyncRequest::State::DECODED)
+            {
+                _decodedQueue.erase(std::find(_decodedQueue.begin(), _decodedQueue.end(), request));
+                decoded = true;
+            }
+            else
+            {
+                request->state = AsyncRequest::State::CANCELLED;
+                ++_cancelledRequestCount;
+            }
+        }
+
+        if (queued || decoded)
+        {
+            deleteAsyncRequest(request);
+        }
+    }
+
+    if (0 == _asyncRefCount && 0 == _cancelledRequestCount)
+    {
+        Director::getInstance()->getScheduler()->unscheduleSelector(schedule_selector(TextureCache::addImageAsyncCallBack), this);
+    }
+}
+
+void TextureCache::deleteAsyncRequest(AsyncRequest *request)
+{
+    for (auto& data : request->callbacks)
+    {
+        CC_SAFE_RELEASE(data->target);
+        delete data;
+    }
+    CC_SAFE_RELEASE(request->image);
+    delete request;
+}
+
+void TextureCache::setAsyncThreadCount(int threadCount)
+{
+    CCASSERT(threadCount >= 0, "TextureCache: the number of threads can't be negative");
+    _asyncThreadCount = threadCount;
+
+    // already started: only add the missing threads
+    if (! _loadingThreads.empty())
+    {
+        startLoadingThreads();
+    }
+}
+
+int TextureCache::getAsyncThreadCount() const
+{
+    if (! _loadingThreads.empty())
+    {
+        return (int)_loadingThreads.size();
+    }
+    return _asyncThreadCount > 0 ? _asyncThreadCount : ThreadPool::getDefaultThreadCount();
+}
+
+void TextureCache::setAsyncUploadBudget(int bytesPerFrame, float millisecondsPerFrame)
+{
+    CCASSERT(bytesPerFrame >= 0 && millisecondsPerFrame >= 0, "TextureCache: the upload budget can't be negative");
+    _uploadBudgetBytes = bytesPerFrame;
+    _uploadBudgetTime = millisecondsPerFrame;
+}
+
+void TextureCache::startLoadingThreads()
+{
+    if (_loadingThreads.empty() && _asyncThreadCount == 0)
+    {
+        _asyncThreadCount = (int)Configuration::getInstance()->getNumber("cocos2d.x.texture_async_threads", 0);
+    }
+
+    int threadCount = getAsyncThreadCount();
+    while ((int)_loadingThreads.size() < threadCount)
+    {
+        // create a new thread to load images
+        _loadingThreads.push_back(new std::thread(&TextureCache::loadImage, this));
+    }
+}
+
 void TextureCache::loadImage()
 {
-    AsyncStruct *pAsyncStruct = nullptr;
+    // create autorelease pool for iOS
+    Thread thread;
+    thread.createAutoreleasePool();
+    FrameProfiler::getInstance()->setThreadName("TextureCache loader");
 
     while (true)
     {
-        // create autorelease pool for iOS
-        Thread thread;
-        thread.createAutoreleasePool();
-
-        std::queue<AsyncStruct*> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock();
-        if (pQueue->empty())
+        AsyncRequest *request = nullptr;
         {
-            _asyncStructQueueMutex.unlock();
-            if (_needQuit) {
+            std::unique_lock<std::mutex> lock(_requestQueueMutex);
+            _sleepCondition.wait(lock, [this]{ return _needQuit || ! _requestQueue.empty(); });
+            if (_needQuit)
+            {
                 break;
             }
-            else {
-                std::unique_lock<std::mutex> lk(_sleepMutex);
-                _sleepCondition.wait(lk);
-                continue;
+
+            // highest priority first, then first requested
+            auto best = _requestQueue.begin();
+            for (auto it = best + 1; it != _requestQueue.end(); ++it)
+            {
+                if ((*it)->priority > (*best)->priority
+                    || ((*it)->priority == (*best)->priority && (*it)->sequence < (*best)->sequence))
+                {
+                    best = it;
+                }
             }
+            request = *best;
+            _requestQueue.erase(best);
+            request->state = AsyncRequest::State::DECODING;
         }
-        else
-        {
-            pAsyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
-        }        
 
-        const char *filename = pAsyncStruct->filename.c_str();
+        const char *filename = request->filename.c_str();
         
         // generate image            
         Image *pImage = new Image();
         if (pImage && !pImage->initWithImageFileThreadSafe(filename))
         {
-            CC_SAFE_RELEASE(pImage);
+            CC_SAFE_RELEASE_NULL(pImage);
             CCLOG("can not load %s", filename);
-            continue;
         }
+        request->image = pImage;
 
-        // generate image info
-        ImageInfo *pImageInfo = new ImageInfo();
-        pImageInfo->asyncStruct = pAsyncStruct;
-        pImageInfo->image = pImage;
-
-        // put the image info into the queue
-        _imageInfoMutex.lock();
-        _imageInfoQueue->push(pImageInfo);
-        _imageInfoMutex.unlock();
-    }
-    
-	if(_asyncStructQueue != nullptr)
-    {
-        delete _asyncStructQueue;
-	    _asyncStructQueue = nullptr;
-        delete _imageInfoQueue;
-	    _imageInfoQueue = nullptr;
+        // put the request into the decoded queue, even on failure so that the callbacks are released
+        {
+            std::lock_guard<std::mutex> lock(_decodedQueueMutex);
+            if (request->state != AsyncRequest::State::CANCELLED)
+            {
+                request->state = AsyncRequest::State::DECODED;
+            }
+            _decodedQueue.push_back(request);
+        }
     }
 }
 
 void TextureCache::addImageAsyncCallBack(float dt)
 {
-    // the image is generated in loading thread
-    std::queue<ImageInfo*> *imagesQueue = _imageInfoQueue;
+    const bool budgeted = _uploadBudgetBytes > 0 || _uploadBudgetTime > 0;
+    const auto start = std::chrono::steady_clock::now();
+    int uploadedBytes = 0;
 
-    _imageInfoMutex.lock();
-    if (imagesQueue->empty())
-    {
-        _imageInfoMutex.unlock();
-    }
-    else
+    while (true)
     {
-        ImageInfo *pImageInfo = imagesQueue->front();
-        imagesQueue->pop();
-        _imageInfoMutex.unlock();
+        // the image is generated in loading thread
+        AsyncRequest *request = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_decodedQueueMutex);
+            if (_decodedQueue.empty())
+            {
+                break;
+            }
+            request = _decodedQueue.front();
+            _decodedQueue.pop_front();
+        }
+
+        // cancelled while decoding
+        if (request->state == AsyncRequest::State::CANCELLED)
+        {
+            deleteAsyncRequest(request);
+            --_cancelledRequestCount;
+            if (0 == _asyncRefCount && 0 == _cancelledRequestCount)
+            {
+                Director::getInstance()->getScheduler()->unscheduleSelector(schedule_selector(TextureCache::addImageAsyncCallBack), this);
+                break;
+            }
+            continue;
+        }
 
-        AsyncStruct *pAsyncStruct = pImageInfo->asyncStruct;
-        Image *pImage = pImageInfo->image;
+        _asyncRequests.erase(request->filename);
 
-        Object *target = pAsyncStruct->target;
-        SEL_CallFuncO selector = pAsyncStruct->selector;
-        const char* filename = pAsyncStruct->filename.c_str();
+        Image *pImage = request->image;
+        const char* filename = request->filename.c_str();
 
-        // generate texture in render thread
-        Texture2D *texture = new Texture2D();
+        Texture2D *texture = nullptr;
+        bool uploaded = false;
+        if (pImage)
+        {
+            // loaded synchronously in the meantime
+            texture = _textures.at(filename);
+            if (texture == nullptr)
+            {
+                // generate texture in render thread
+                texture = new Texture2D();
 
-        texture->initWithImage(pImage);
+                texture->initWithImage(pImage);
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-       // cache the texture file name
-       VolatileTexture::addImageTexture(texture, filename);
+               // cache the texture file name
+               VolatileTexture::addImageTexture(texture, filename);
 #endif
-        // cache the texture
-        _textures->setObject(texture, filename);
-        texture->autorelease();
+                // cache the texture
+                _textures.insert(filename, texture);
+                texture->autorelease();
 
-        if (target && selector)
+                uploadedBytes += pImage->getDataLen();
+                uploaded = true;
+            }
+        }
+
+        for (auto& data : request->callbacks)
         {
-            (target->*selector)(texture);
-            target->release();
-        }        
+            Object *target = data->target;
+            SEL_CallFuncO selector = data->selector;
+
+            // the callbacks of an image that can't be loaded aren't called
+            if (texture && target && selector)
+            {
+                (target->*selector)(texture);
+            }
+            CC_SAFE_RELEASE(target);
+            delete data;
 
-        pImage->release();
-        delete pAsyncStruct;
-        delete pImageInfo;
+            --_asyncRefCount;
+        }
+        request->callbacks.clear();
+        deleteAsyncRequest(request);
 
-        --_asyncRefCount;
-        if (0 == _asyncRefCount)
+        if (0 == _asyncRefCount && 0 == _cancelledRequestCount)
         {
             Director::getInstance()->getScheduler()->unscheduleSelector(schedule_selector(TextureCache::addImageAsyncCallBack), this);
+            break;
+        }
+
+        // one upload per frame by default, the rest waits for the next frames
+        if (uploaded)
+        {
+            if (! budgeted)
+            {
+                break;
+            }
+            if (_uploadBudgetBytes > 0 && uploadedBytes >= _uploadBudgetBytes)
+            {
+                break;
+            }
+            if (_uploadBudgetTime > 0)
+            {
+                std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                if (elapsed.count() >= _uploadBudgetTime)
+                {
+                    break;
+                }
+            }
         }
     }
 }
@@ -309,7 +556,7 @@ Texture2D * TextureCache::addImage(const char * path)
     {
         return NULL;
     }
-    texture = static_cast<Texture2D*>(_textures->objectForKey(pathKey.c_str()));
+    texture = _textures.at(pathKey);
 
     std::string fullpath = pathKey;
     if (! texture) 
@@ -337,7 +584,7 @@ Texture2D * TextureCache::addImage(const char * path)
                 // cache the texture file name
                 VolatileTexture::addImageTexture(texture, fullpath.c_str());
 #endif
-                _textures->setObject(texture, pathKey.c_str());
+                _textures.insert(pathKey, texture);
                 texture->release();
             }
             else
@@ -352,6 +599,52 @@ Texture2D * TextureCache::addImage(const char * path)
     return texture;
 }
 
+int TextureCache::preloadImages(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> fullpaths;
+    fullpaths.reserve(paths.size());
+    for (const auto& path : paths)
+    {
+        std::string fullpath = FileUtils::getInstance()->fullPathForFilename(path.c_str());
+        if (fullpath.size() == 0 || _textures.at(fullpath) ||
+            std::find(fullpaths.begin(), fullpaths.end(), fullpath) != fullpaths.end())
+        {
+            continue;
+        }
+        fullpaths.push_back(fullpath);
+    }
+
+    std::vector<Image*> images = Image::decodeBatch(fullpaths);
+
+    int created = 0;
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        if (images[i] == nullptr)
+        {
+            CCLOG("cocos2d: Couldn't load image file:%s in TextureCache", fullpaths[i].c_str());
+            continue;
+        }
+
+        Texture2D* texture = new Texture2D();
+        if (texture->initWithImage(images[i]))
+        {
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+            // cache the texture file name
+            VolatileTexture::addImageTexture(texture, fullpaths[i].c_str());
+#endif
+            _textures.insert(fullpaths[i], texture);
+            ++created;
+        }
+        else
+        {
+            CCLOG("cocos2d: Couldn't create texture for file:%s in TextureCache", fullpaths[i].c_str());
+        }
+        texture->release();
+        images[i]->release();
+    }
+    return created;
+}
+
 Texture2D* TextureCache::addUIImage(Image *image, const char *key)
 {
     CCASSERT(image != NULL, "TextureCache: image MUST not be nil");
@@ -370,7 +663,7 @@ Texture2D* TextureCache::addUIImage(Image *image, const char *key)
     do 
     {
         // If key is nil, then create a new texture each time
-        if(key && (texture = (Texture2D *)_textures->objectForKey(forKey.c_str())))
+        if(key && (texture = _textures.at(forKey)))
         {
             break;
         }
@@ -381,7 +674,7 @@ Texture2D* TextureCache::addUIImage(Image *image, const char *key)
 
         if(key && texture)
         {
-            _textures->setObject(texture, forKey.c_str());
+            _textures.insert(forKey, texture);
             texture->autorelease();
         }
         else
@@ -402,47 +695,23 @@ Texture2D* TextureCache::addUIImage(Image *image, const char *key)
 
 void TextureCache::removeAllTextures()
 {
-    _textures->removeAllObjects();
+    _textures.clear();
 }
 
 void TextureCache::removeUnusedTextures()
 {
-    /*
-    DictElement* pElement = NULL;
-    CCDICT_FOREACH(_textures, pElement)
+    for (auto iter = _textures.begin(); iter != _textures.end(); )
     {
-        CCLOG("cocos2d: TextureCache: texture: %s", pElement->getStrKey());
-        Texture2D *value = static_cast<Texture2D*>(pElement->getObject());
+        CCLOG("cocos2d: TextureCache: texture: %s", iter->first.c_str());
+        Texture2D *value = iter->second;
         if (value->retainCount() == 1)
         {
-            CCLOG("cocos2d: TextureCache: removing unused texture: %s", pElement->getStrKey());
-            _textures->removeObjectForElememt(pElement);
-        }
-    }
-     */
-    
-    /** Inter engineer zhuoshi sun finds that this way will get better performance
-     */    
-    if (_textures->count())
-    {   
-        // find elements to be removed
-        DictElement* pElement = NULL;
-        list<DictElement*> elementToRemove;
-        CCDICT_FOREACH(_textures, pElement)
-        {
-            CCLOG("cocos2d: TextureCache: texture: %s", pElement->getStrKey());
-            Texture2D *value = static_cast<Texture2D*>(pElement->getObject());
-            if (value->retainCount() == 1)
-            {
-                elementToRemove.push_back(pElement);
-            }
+            CCLOG("cocos2d: TextureCache: removing unused texture: %s", iter->first.c_str());
+            iter = _textures.erase(iter);
         }
-        
-        // remove elements
-        for (auto iter = elementToRemove.begin(); iter != elementToRemove.end(); ++iter)
+        else
         {
-            CCLOG("cocos2d: TextureCache: removing unused texture: %s", (*iter)->getStrKey());
-            _textures->removeObjectForElememt(*iter);
+            ++iter;
         }
     }
 }
@@ -454,8 +723,7 @@ void TextureCache::removeTexture(Texture2D* texture)
         return;
     }
 
-    Array* keys = _textures->allKeysForObject(texture);
-    _textures->removeObjectsForKeys(keys);
+    _textures.erase(_textures.keys(texture));
 }
 
 void TextureCache::removeTextureForKey(const char *textureKeyName)
@@ -466,12 +734,12 @@ void TextureCache::removeTextureForKey(const char *textureKeyName)
     }
 
     string fullPath = FileUtils::getInstance()->fullPathForFilename(textureKeyName);
-    _textures->removeObjectForKey(fullPath);
+    _textures.erase(fullPath);
 }
 
 Texture2D* TextureCache::textureForKey(const char* key)
 {
-    return static_cast<Texture2D*>(_textures->objectForKey(FileUtils::getInstance()->fullPathForFilename(key)));
+    return _textures.at(FileUtils::getInstance()->fullPathForFilename(key));
 }
 
 void TextureCache::reloadAllTextures()
@@ -486,17 +754,16 @@ void TextureCache::dumpCachedTextureInfo()
     unsigned int count = 0;
     unsigned int totalBytes = 0;
 
-    DictElement* pElement = NULL;
-    CCDICT_FOREACH(_textures, pElement)
+    for (const auto& element : _textures)
     {
-        Texture2D* tex = static_cast<Texture2D*>(pElement->getObject());
+        Texture2D* tex = element.second;
         unsigned int bpp = tex->getBitsPerPixelForFormat();
         // Each texture takes up width * height * bytesPerPixel bytes.
         unsigned int bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
         totalBytes += bytes;
         count++;
         CCLOG("cocos2d: \"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB",
-               pElement->getStrKey(),
+               element.first.c_str(),
                (long)tex->retainCount(),
                (long)tex->getName(),
                (long)tex->getPixelsWide(),
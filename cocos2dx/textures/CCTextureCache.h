@@ -31,11 +31,13 @@ THE SOFTWARE.
 #include <mutex>
 #include <thread>
 #include <condition_variable>
-#include <queue>
-#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
 
 #include "cocoa/CCObject.h"
 #include "cocoa/CCDictionary.h"
+#include "cocoa/CCMap.h"
 #include "textures/CCTexture2D.h"
 #include "platform/CCImage.h"
 
@@ -93,14 +95,50 @@ public:
     */
     Texture2D* addImage(const char* fileimage);
 
+    /** Loads the textures of several image files at once, to fill the cache before they are needed.
+    * The images are decoded in parallel by Image::decodeBatch(), then the textures are created on the calling thread.
+    * The files already in the cache are skipped. Returns the number of textures created.
+    * @since v3.0
+    */
+    int preloadImages(const std::vector<std::string>& paths);
+
     /* Returns a Texture2D object given a file image
     * If the file image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will load a texture in a new thread, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
     * The callback will be called from the main thread, so it is safe to create any cocos2d object from the callback.
+    * The images are decoded by a pool of threads, the requests with the highest priority first.
+    * Concurrent requests for the same file share the same decoding: the priority of the request is raised if needed.
     * Supported image extensions: .png, .jpg
-    * @since v0.8
+    * @since v0.8, priority added in v3.0
+    */
+    virtual void addImageAsync(const char *path, Object *target, SEL_CallFuncO selector, int priority = 0);
+
+    /** Cancels the callbacks of target for an image requested with addImageAsync().
+    * If target is NULL, all the callbacks of the image are cancelled.
+    * When an image has no callback left, it is removed from the queue if it isn't decoded yet, and it isn't uploaded otherwise.
+    * @since v3.0
+    */
+    void cancelImageAsync(const char *path, Object *target);
+
+    /** Cancels all the callbacks of target requested with addImageAsync(). If target is NULL, all the requests are cancelled.
+    * @since v3.0
+    */
+    void cancelAllImageAsync(Object *target);
+
+    /** Sets the number of threads that decode the images requested with addImageAsync().
+    * 0 uses one thread per core, minus one. It can be set with the "cocos2d.x.texture_async_threads" key of the Configuration.
+    * The threads are started by the first request: the number of threads can only grow after that.
+    * @since v3.0
+    */
+    void setAsyncThreadCount(int threadCount);
+    int getAsyncThreadCount() const;
+
+    /** Limits the uploads of the images decoded by addImageAsync() per frame, to avoid hitches.
+    * The textures are uploaded until one of the limits is reached, but at least one is uploaded per frame.
+    * 0 means no limit. When both are 0 (default), one texture is uploaded per frame.
+    * @since v3.0
     */
-    virtual void addImageAsync(const char *path, Object *target, SEL_CallFuncO selector);
+    void setAsyncUploadBudget(int bytesPerFrame, float millisecondsPerFrame);
 
     /** Returns a Texture2D object given an UIImage image
     * If the image was not previously loaded, it will create a new Texture2D object and it will return it.
@@ -162,28 +200,54 @@ public:
     };
 
 protected:
-    typedef struct _ImageInfo
+    // All the callbacks waiting for the same file
+    struct AsyncRequest
     {
-        AsyncStruct *asyncStruct;
-        Image        *image;
-    } ImageInfo;
-    
-    std::thread* _loadingThread;
+        enum class State
+        {
+            QUEUED,     // in _requestQueue
+            DECODING,   // taken by a loading thread
+            DECODED,    // in _decodedQueue
+            CANCELLED,  // no callbacks left while it was decoded, released by addImageAsyncCallBack()
+        };
+
+        std::string filename;
+        std::vector<AsyncStruct*> callbacks;    // main thread only
+        int priority;                           // guarded by _requestQueueMutex
+        unsigned int sequence;                  // keeps the requests with the same priority in FIFO order
+        State state;                            // guarded by _requestQueueMutex, then _decodedQueueMutex once decoding
+        Image *image;                           // NULL if the image can't be loaded
+    };
 
-    std::queue<AsyncStruct*>* _asyncStructQueue;
-    std::queue<ImageInfo*>* _imageInfoQueue;
+    void startLoadingThreads();
+    void removeAsyncCallbacks(AsyncRequest *request, Object *target);
+    void deleteAsyncRequest(AsyncRequest *request);
 
-    std::mutex _asyncStructQueueMutex;
-    std::mutex _imageInfoMutex;
+    std::vector<std::thread*> _loadingThreads;
+    int _asyncThreadCount;
+
+    // main thread only: the requests that weren't delivered yet, by full path
+    std::unordered_map<std::string, AsyncRequest*> _asyncRequests;
+    unsigned int _asyncSequence;
+
+    std::vector<AsyncRequest*> _requestQueue;
+    std::deque<AsyncRequest*> _decodedQueue;
+
+    std::mutex _requestQueueMutex;
+    std::mutex _decodedQueueMutex;
 
-    std::mutex _sleepMutex;
     std::condition_variable _sleepCondition;
 
     bool _needQuit;
 
     int _asyncRefCount;
+    // requests cancelled while they were decoded: addImageAsyncCallBack() stays scheduled to release them
+    int _cancelledRequestCount;
+
+    int _uploadBudgetBytes;
+    float _uploadBudgetTime;
 
-    Dictionary* _textures;
+    Map<std::string, Texture2D*> _textures;
 
     static TextureCache *_sharedTextureCache;
 };
@@ -31,10 +31,19 @@ THE SOFTWARE.
 #include "shaders/CCShaderCache.h"
 #include "shaders/CCGLProgram.h"
 #include "support/data_support/ccCArray.h"
+#include "support/TransformUtils.h"
+#include "support/CCProfiling.h"
+#include "textures/CCTextureAtlas.h"
+#include "shaders/ccGLStateCache.h"
 #include "CCDirector.h"
+#include "ccConfig.h"
+#include "kazmath/GL/matrix.h"
+#include <algorithm>
 
 NS_CC_BEGIN
 
+// initial capacity of the atlas, which only holds the tiles that became a Sprite
+static const int TILE_SPRITES_CAPACITY = 16;
 
 // TMXLayer - init & alloc & dealloc
 
@@ -50,10 +59,7 @@ TMXLayer * TMXLayer::create(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *layerInfo
 }
 bool TMXLayer::initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo)
 {    
-    // XXX: is 35% a good estimate ?
     Size size = layerInfo->_layerSize;
-    float totalNumberOfTiles = size.width * size.height;
-    float capacity = totalNumberOfTiles * 0.35f + 1; // 35 percent is occupied ?
 
     Texture2D *texture = NULL;
     if( tilesetInfo )
@@ -61,7 +67,7 @@ bool TMXLayer::initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *la
         texture = TextureCache::getInstance()->addImage(tilesetInfo->_sourceImage.c_str());
     }
 
-    if (SpriteBatchNode::initWithTexture(texture, (unsigned int)capacity))
+    if (SpriteBatchNode::initWithTexture(texture, TILE_SPRITES_CAPACITY))
     {
         // layerInfo
         _layerName = layerInfo->_name;
@@ -85,7 +91,7 @@ bool TMXLayer::initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *la
         Point offset = this->calculateLayerOffset(layerInfo->_offset);
         this->setPosition(CC_POINT_PIXELS_TO_POINTS(offset));
 
-        _atlasIndexArray = ccCArrayNew((unsigned int)totalNumberOfTiles);
+        _atlasIndexArray = ccCArrayNew(TILE_SPRITES_CAPACITY);
 
         this->setContentSize(CC_SIZE_PIXELS_TO_POINTS(Size(_layerSize.width * _mapTileSize.width, _layerSize.height * _mapTileSize.height)));
 
@@ -104,8 +110,9 @@ TMXLayer::TMXLayer()
 ,_maxGID(0)
 ,_vertexZvalue(0)
 ,_useAutomaticVertexZ(false)
-,_reusedTile(NULL)
 ,_atlasIndexArray(NULL)
+,_chunksWide(0)
+,_chunkPrefetchDistance(0)
 ,_contentScaleFactor(1.0f)
 ,_layerSize(Size::ZERO)
 ,_mapTileSize(Size::ZERO)
@@ -118,9 +125,13 @@ TMXLayer::TMXLayer()
 TMXLayer::~TMXLayer()
 {
     CC_SAFE_RELEASE(_tileSet);
-    CC_SAFE_RELEASE(_reusedTile);
     CC_SAFE_RELEASE(_properties);
 
+    for (auto& chunk : _chunks)
+    {
+        CC_SAFE_RELEASE(chunk.atlas);
+    }
+
     if (_atlasIndexArray)
     {
         ccCArrayFree(_atlasIndexArray);
@@ -132,6 +143,15 @@ TMXLayer::~TMXLayer()
 
 void TMXLayer::releaseMap()
 {
+    // the chunks can't be rebuilt without the map
+    for (int i = 0; i < (int)_chunks.size(); ++i)
+    {
+        if (_chunks[i].dirty)
+        {
+            buildChunk(i);
+        }
+    }
+
     if (_tiles)
     {
         delete [] _tiles;
@@ -179,8 +199,6 @@ void TMXLayer::setupTiles()
             // XXX: gid == 0 --> empty tile
             if (gid != 0) 
             {
-                this->appendTileForGID(gid, Point(x, y));
-
                 // Optimization: update min and max GID rendered by the layer
                 _minGID = MIN(gid, _minGID);
                 _maxGID = MAX(gid, _maxGID);
@@ -190,6 +208,310 @@ void TMXLayer::setupTiles()
 
     CCASSERT( _maxGID >= _tileSet->_firstGid &&
         _minGID >= _tileSet->_firstGid, "TMX: Only 1 tileset per layer is supported");    
+
+    // the quads are built when the chunks are drawn
+    this->setupChunks();
+}
+
+// TMXLayer - chunks
+void TMXLayer::setupChunks()
+{
+    int width = (int)_layerSize.width;
+    int height = (int)_layerSize.height;
+    _chunksWide = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    int chunksHigh = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    for (auto& chunk : _chunks)
+    {
+        CC_SAFE_RELEASE(chunk.atlas);
+    }
+    _chunks.assign(_chunksWide * chunksHigh, TileChunk());
+
+    // tiles can be bigger than the map tiles and can be rotated, grow the bounds in every direction
+    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
+    Size mapTileSize = CC_SIZE_PIXELS_TO_POINTS(_mapTileSize);
+    float margin = MAX(MAX(tileSize.width, tileSize.height), MAX(mapTileSize.width, mapTileSize.height));
+
+    for (int i = 0; i < (int)_chunks.size(); ++i)
+    {
+        float x0 = (float)((i % _chunksWide) * CHUNK_SIZE);
+        float y0 = (float)((i / _chunksWide) * CHUNK_SIZE);
+        float x1 = (float)(MIN((i % _chunksWide + 1) * CHUNK_SIZE, width) - 1);
+        float y1 = (float)(MIN((i / _chunksWide + 1) * CHUNK_SIZE, height) - 1);
+
+        // the tile positions are affine in the tile coordinate, so the corners bound the whole chunk
+        Point corners[4] = { getPositionAt(Point(x0, y0)), getPositionAt(Point(x1, y0)), getPositionAt(Point(x0, y1)), getPositionAt(Point(x1, y1)) };
+        Point minCorner = corners[0];
+        Point maxCorner = corners[0];
+        for (int c = 1; c < 4; ++c)
+        {
+            minCorner = Point(MIN(minCorner.x, corners[c].x), MIN(minCorner.y, corners[c].y));
+            maxCorner = Point(MAX(maxCorner.x, corners[c].x), MAX(maxCorner.y, corners[c].y));
+        }
+
+        _chunks[i].bounds = Rect(minCorner.x - margin, minCorner.y - margin,
+                                 maxCorner.x - minCorner.x + 2 * margin, maxCorner.y - minCorner.y + 2 * margin);
+    }
+}
+
+void TMXLayer::buildChunk(int index)
+{
+    TileChunk& chunk = _chunks[index];
+    int x0 = (index % _chunksWide) * CHUNK_SIZE;
+    int y0 = (index / _chunksWide) * CHUNK_SIZE;
+    int x1 = MIN(x0 + CHUNK_SIZE, (int)_layerSize.width);
+    int y1 = MIN(y0 + CHUNK_SIZE, (int)_layerSize.height);
+
+    int count = 0;
+    V3F_C4B_T2F_Quad quads[CHUNK_SIZE];
+    for (int y = y0; y < y1; ++y)
+    {
+        int rowCount = 0;
+        for (int x = x0; x < x1; ++x)
+        {
+            if (setupTileQuad(&quads[rowCount], Point(x, y)))
+            {
+                ++rowCount;
+            }
+        }
+
+        if (rowCount == 0)
+        {
+            continue;
+        }
+
+        if (! chunk.atlas)
+        {
+            chunk.atlas = new TextureAtlas();
+            chunk.atlas->initWithTexture(getTexture(), (y1 - y) * (x1 - x0));
+        }
+        else if (count == 0)
+        {
+            chunk.atlas->removeAllQuads();
+        }
+
+        if (count + rowCount > chunk.atlas->getCapacity())
+        {
+            chunk.atlas->resizeCapacity(count + (y1 - y) * (x1 - x0));
+        }
+
+        for (int i = 0; i < rowCount; ++i)
+        {
+            chunk.atlas->updateQuad(&quads[i], count++);
+        }
+    }
+
+    if (count == 0 && chunk.atlas)
+    {
+        chunk.atlas->removeAllQuads();
+    }
+    chunk.dirty = false;
+}
+
+void TMXLayer::markChunksNearVisibleOnes()
+{
+    int chunkCount = (int)_chunks.size();
+    int chunksHigh = chunkCount / _chunksWide;
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        if (_chunkVisibility[i] != CHUNK_VISIBLE)
+        {
+            continue;
+        }
+
+        int column = i % _chunksWide;
+        int row = i / _chunksWide;
+        for (int y = MAX(row - _chunkPrefetchDistance, 0); y <= MIN(row + _chunkPrefetchDistance, chunksHigh - 1); ++y)
+        {
+            for (int x = MAX(column - _chunkPrefetchDistance, 0); x <= MIN(column + _chunkPrefetchDistance, _chunksWide - 1); ++x)
+            {
+                unsigned char& visibility = _chunkVisibility[x + y * _chunksWide];
+                if (visibility == CHUNK_HIDDEN)
+                {
+                    visibility = CHUNK_NEAR;
+                }
+            }
+        }
+    }
+}
+
+void TMXLayer::setChunkDirtyAt(const Point& pos)
+{
+    if (! _chunks.empty())
+    {
+        int index = ((int)pos.x / CHUNK_SIZE) + ((int)pos.y / CHUNK_SIZE) * _chunksWide;
+        _chunks[index].dirty = true;
+    }
+}
+
+void TMXLayer::setAllChunksDirty()
+{
+    for (auto& chunk : _chunks)
+    {
+        chunk.dirty = true;
+    }
+}
+
+bool TMXLayer::setupTileQuad(V3F_C4B_T2F_Quad* quad, const Point& pos)
+{
+    unsigned int z = (unsigned int)(pos.x + pos.y * _layerSize.width);
+    unsigned int gidAndFlags = _tiles[z];
+    unsigned int gid = gidAndFlags & kFlippedMask;
+    if (gid == 0 || hasTileSpriteAt(z))
+    {
+        return false;
+    }
+
+    // same texture coordinates as Sprite::setTextureCoords()
+    Rect rect = _tileSet->rectForGID(gid);
+    Texture2D* texture = getTexture();
+    float atlasWidth = (float)texture->getPixelsWide();
+    float atlasHeight = (float)texture->getPixelsHigh();
+
+#if CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+    float left    = (2*rect.origin.x+1)/(2*atlasWidth);
+    float right   = left + (rect.size.width*2-2)/(2*atlasWidth);
+    float top     = (2*rect.origin.y+1)/(2*atlasHeight);
+    float bottom  = top + (rect.size.height*2-2)/(2*atlasHeight);
+#else
+    float left    = rect.origin.x/atlasWidth;
+    float right   = (rect.origin.x + rect.size.width) / atlasWidth;
+    float top     = rect.origin.y/atlasHeight;
+    float bottom  = (rect.origin.y + rect.size.height) / atlasHeight;
+#endif // ! CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+
+    // The texture coordinates of the bl, br, tl and tr corners, as setupTileSprite() rotates and flips the Sprite.
+    // "u" is 0 on the left of the tile and 1 on its right, "v" is 0 at its bottom and 1 at its top.
+    static const unsigned char cornerU[8][4] = {
+        { 0, 1, 0, 1 }, { 1, 0, 1, 0 }, { 0, 1, 0, 1 }, { 1, 0, 1, 0 },    // not rotated, H, V, H | V
+        { 1, 1, 0, 0 }, { 1, 1, 0, 0 }, { 0, 0, 1, 1 }, { 0, 0, 1, 1 },    // diagonal, then H, V, H | V
+    };
+    static const unsigned char cornerV[8][4] = {
+        { 0, 0, 1, 1 }, { 0, 0, 1, 1 }, { 1, 1, 0, 0 }, { 1, 1, 0, 0 },
+        { 1, 0, 1, 0 }, { 0, 1, 0, 1 }, { 1, 0, 1, 0 }, { 0, 1, 0, 1 },
+    };
+    int orientation = ((gidAndFlags & kTMXTileHorizontalFlag) ? 1 : 0) | ((gidAndFlags & kTMXTileVerticalFlag) ? 2 : 0) | ((gidAndFlags & kTMXTileDiagonalFlag) ? 4 : 0);
+
+    Size size = CC_SIZE_PIXELS_TO_POINTS(rect.size);
+    if (gidAndFlags & kTMXTileDiagonalFlag)
+    {
+        // rotated by 90 or 270 degrees, the tile covers a height x width area from its position
+        std::swap(size.width, size.height);
+    }
+
+    Point origin = getPositionAt(pos);
+    float vertexZ = (float)getVertexZForPos(pos);
+    V3F_C4B_T2F* corners[4] = { &quad->bl, &quad->br, &quad->tl, &quad->tr };
+    for (int i = 0; i < 4; ++i)
+    {
+        corners[i]->vertices = Vertex3F(origin.x + ((i & 1) ? size.width : 0), origin.y + ((i & 2) ? size.height : 0), vertexZ);
+        corners[i]->texCoords.u = cornerU[orientation][i] ? right : left;
+        corners[i]->texCoords.v = cornerV[orientation][i] ? top : bottom;
+    }
+
+    // same color as the Sprite of the tile
+    Color4B color(255, 255, 255, _opacity);
+    if (texture->hasPremultipliedAlpha())
+    {
+        color.r = color.g = color.b = _opacity;
+    }
+    quad->bl.colors = quad->br.colors = quad->tl.colors = quad->tr.colors = color;
+
+    return true;
+}
+
+void TMXLayer::draw()
+{
+    CC_PROFILER_START("CCTMXLayer - draw");
+
+    if (! _chunks.empty())
+    {
+        CC_NODE_DRAW_SETUP();
+
+        GL::blendFunc( _blendFunc.src, _blendFunc.dst );
+
+        kmMat4 modelViewProjection;
+        getCurrentModelViewProjection(&modelViewProjection);
+
+        // with an automatic vertex Z the depth of the tiles moves them on screen, don't cull them
+        bool cull = CC_USE_CULLING && ! _useAutomaticVertexZ;
+        float vertexZ = (float)_vertexZvalue;
+        unsigned int frame = Director::getInstance()->getTotalFrames();
+        int chunkCount = (int)_chunks.size();
+
+        _chunkVisibility.assign(chunkCount, cull ? CHUNK_HIDDEN : CHUNK_VISIBLE);
+        if (cull)
+        {
+            for (int i = 0; i < chunkCount; ++i)
+            {
+                const Rect& rect = _chunks[i].bounds;
+                V3F_C4B_T2F_Quad bounds;
+                bounds.bl.vertices = Vertex3F(rect.getMinX(), rect.getMinY(), vertexZ);
+                bounds.br.vertices = Vertex3F(rect.getMaxX(), rect.getMinY(), vertexZ);
+                bounds.tl.vertices = Vertex3F(rect.getMinX(), rect.getMaxY(), vertexZ);
+                bounds.tr.vertices = Vertex3F(rect.getMaxX(), rect.getMaxY(), vertexZ);
+
+                if (! isQuadOutsideClipVolume(modelViewProjection, bounds))
+                {
+                    _chunkVisibility[i] = CHUNK_VISIBLE;
+                }
+            }
+
+            if (_chunkPrefetchDistance > 0)
+            {
+                markChunksNearVisibleOnes();
+            }
+        }
+
+        bool prefetched = false;
+        for (int i = 0; i < chunkCount; ++i)
+        {
+            TileChunk& chunk = _chunks[i];
+
+            if (_chunkVisibility[i] == CHUNK_HIDDEN)
+            {
+                // release the quads of the chunks which left the view for a while, they are rebuilt from the map when they come back
+                if (chunk.atlas && _tiles && frame - chunk.lastDrawnFrame > CHUNK_EXPIRATION_FRAMES)
+                {
+                    CC_SAFE_RELEASE_NULL(chunk.atlas);
+                    chunk.dirty = true;
+                }
+                continue;
+            }
+
+            if (_chunkVisibility[i] == CHUNK_NEAR)
+            {
+                // page in one of the chunks around the view per frame
+                if (chunk.dirty && ! prefetched && _tiles)
+                {
+                    buildChunk(i);
+                    prefetched = true;
+                }
+                chunk.lastDrawnFrame = frame;
+                continue;
+            }
+
+            if (chunk.dirty)
+            {
+                buildChunk(i);
+            }
+
+            if (chunk.atlas && chunk.atlas->getTotalQuads() > 0)
+            {
+                if (chunk.atlas->getTexture() != getTexture())
+                {
+                    chunk.atlas->setTexture(getTexture());
+                }
+                chunk.atlas->drawQuads();
+            }
+            chunk.lastDrawnFrame = frame;
+        }
+    }
+
+    // the tiles which became a Sprite
+    SpriteBatchNode::draw();
+
+    CC_PROFILER_STOP("CCTMXLayer - draw");
 }
 
 // TMXLayer - Properties
@@ -290,30 +612,6 @@ void TMXLayer::setupTileSprite(Sprite* sprite, Point pos, unsigned int gid)
     }
 }
 
-Sprite* TMXLayer::reusedTileWithRect(Rect rect)
-{
-    if (! _reusedTile) 
-    {
-        _reusedTile = new Sprite();
-        _reusedTile->initWithTexture(_textureAtlas->getTexture(), rect, false);
-        _reusedTile->setBatchNode(this);
-    }
-    else
-    {
-        // XXX HACK: Needed because if "batch node" is nil,
-		// then the Sprite'squad will be reset
-        _reusedTile->setBatchNode(NULL);
-        
-		// Re-init the sprite
-        _reusedTile->setTextureRect(rect, false, rect.size);
-        
-		// restore the batch node
-        _reusedTile->setBatchNode(this);
-    }
-
-    return _reusedTile;
-}
-
 // TMXLayer - obtaining tiles/gids
 Sprite * TMXLayer::getTileAt(const Point& pos)
 {
@@ -327,7 +625,10 @@ Sprite * TMXLayer::getTileAt(const Point& pos)
     if (gid) 
     {
         int z = (int)(pos.x + pos.y * _layerSize.width);
-        tile = static_cast<Sprite*>(this->getChildByTag(z));
+        if (hasTileSpriteAt(z))
+        {
+            tile = static_cast<Sprite*>(this->getChildByTag(z));
+        }
 
         // tile not created yet. create it
         if (! tile) 
@@ -338,14 +639,29 @@ Sprite * TMXLayer::getTileAt(const Point& pos)
             tile = new Sprite();
             tile->initWithTexture(this->getTexture(), rect);
             tile->setBatchNode(this);
-            tile->setPosition(getPositionAt(pos));
-            tile->setVertexZ((float)getVertexZForPos(pos));
-            tile->setAnchorPoint(Point::ZERO);
-            tile->setOpacity(_opacity);
+            setupTileSprite(tile, pos, _tiles[z]);
+
+            // get atlas index
+            unsigned int indexForZ = atlasIndexForNewZ(z);
+
+            // the quad of the tile moves from its chunk to the atlas
+            this->insertQuadFromSprite(tile, indexForZ);
+            ccCArrayInsertValueAtIndex(_atlasIndexArray, (void*)(intptr_t)z, indexForZ);
+
+            // update possible children
+            for (const auto& pObject : _children)
+            {
+                Sprite* child = static_cast<Sprite*>(pObject);
+                unsigned int ai = child->getAtlasIndex();
+                if ( ai >= indexForZ )
+                {
+                    child->setAtlasIndex(ai+1);
+                }
+            }
 
-            unsigned int indexForZ = atlasIndexForExistantZ(z);
             this->addSpriteWithoutQuad(tile, indexForZ, z);
             tile->release();
+            setChunkDirtyAt(pos);
         }
     }
     
@@ -370,94 +686,6 @@ unsigned int TMXLayer::getTileGIDAt(const Point& pos, ccTMXTileFlags* flags/* =
     return (tile & kFlippedMask);
 }
 
-// TMXLayer - adding helper methods
-Sprite * TMXLayer::insertTileForGID(unsigned int gid, const Point& pos)
-{
-    Rect rect = _tileSet->rectForGID(gid);
-    rect = CC_RECT_PIXELS_TO_POINTS(rect);
-
-    intptr_t z = (intptr_t)(pos.x + pos.y * _layerSize.width);
-
-    Sprite *tile = reusedTileWithRect(rect);
-
-    setupTileSprite(tile, pos, gid);
-
-    // get atlas index
-    unsigned int indexForZ = atlasIndexForNewZ(z);
-
-    // Optimization: add the quad without adding a child
-    this->insertQuadFromSprite(tile, indexForZ);
-
-    // insert it into the local atlasindex array
-    ccCArrayInsertValueAtIndex(_atlasIndexArray, (void*)z, indexForZ);
-
-    // update possible children
-    if (_children && _children->count()>0)
-    {
-        Object* pObject = nullptr;
-        CCARRAY_FOREACH(_children, pObject)
-        {
-            Sprite* child = static_cast<Sprite*>(pObject);
-            if (child)
-            {
-                unsigned int ai = child->getAtlasIndex();
-                if ( ai >= indexForZ )
-                {
-                    child->setAtlasIndex(ai+1);
-                }
-            }
-        }
-    }
-    _tiles[z] = gid;
-    return tile;
-}
-Sprite * TMXLayer::updateTileForGID(unsigned int gid, const Point& pos)    
-{
-    Rect rect = _tileSet->rectForGID(gid);
-    rect = Rect(rect.origin.x / _contentScaleFactor, rect.origin.y / _contentScaleFactor, rect.size.width/ _contentScaleFactor, rect.size.height/ _contentScaleFactor);
-    int z = (int)(pos.x + pos.y * _layerSize.width);
-
-    Sprite *tile = reusedTileWithRect(rect);
-
-    setupTileSprite(tile ,pos ,gid);
-
-    // get atlas index
-    unsigned int indexForZ = atlasIndexForExistantZ(z);
-    tile->setAtlasIndex(indexForZ);
-    tile->setDirty(true);
-    tile->updateTransform();
-    _tiles[z] = gid;
-
-    return tile;
-}
-
-// used only when parsing the map. useless after the map was parsed
-// since lot's of assumptions are no longer true
-Sprite * TMXLayer::appendTileForGID(unsigned int gid, const Point& pos)
-{
-    Rect rect = _tileSet->rectForGID(gid);
-    rect = CC_RECT_PIXELS_TO_POINTS(rect);
-
-    intptr_t z = (intptr_t)(pos.x + pos.y * _layerSize.width);
-
-    Sprite *tile = reusedTileWithRect(rect);
-
-    setupTileSprite(tile ,pos ,gid);
-
-    // optimization:
-    // The difference between appendTileForGID and insertTileforGID is that append is faster, since
-    // it appends the tile at the end of the texture atlas
-    unsigned int indexForZ = _atlasIndexArray->num;
-
-    // don't add it using the "standard" way.
-    insertQuadFromSprite(tile, indexForZ);
-
-    // append should be after addQuadFromSprite since it modifies the quantity values
-    ccCArrayInsertValueAtIndex(_atlasIndexArray, (void*)z, indexForZ);
-
-    return tile;
-}
-
 // TMXLayer - atlasIndex and Z
 static inline int compareInts(const void * a, const void * b)
 {
@@ -488,6 +716,16 @@ unsigned int TMXLayer::atlasIndexForNewZ(int z)
     
     return i;
 }
+bool TMXLayer::hasTileSpriteAt(unsigned int z)
+{
+    if (! _atlasIndexArray || _atlasIndexArray->num == 0)
+    {
+        return false;
+    }
+
+    int key=z;
+    return bsearch((void*)&key, (void*)&_atlasIndexArray->arr[0], _atlasIndexArray->num, sizeof(void*), compareInts) != NULL;
+}
 
 // TMXLayer - adding / remove tiles
 void TMXLayer::setTileGID(unsigned int gid, const Point& pos)
@@ -513,32 +751,29 @@ void TMXLayer::setTileGID(unsigned int gid, const Point& pos, ccTMXTileFlags fla
         {
             removeTileAt(pos);
         }
-        // empty tile. create a new one
-        else if (currentGID == 0)
-        {
-            insertTileForGID(gidAndFlags, pos);
-        }
-        // modifying an existing tile with a non-empty tile
         else 
         {
             unsigned int z = (unsigned int)(pos.x + pos.y * _layerSize.width);
-            Sprite *sprite = static_cast<Sprite*>(getChildByTag(z));
-            if (sprite)
+
+            // modifying a tile which became a Sprite
+            if (currentGID != 0 && hasTileSpriteAt(z))
             {
+                Sprite *sprite = static_cast<Sprite*>(getChildByTag(z));
                 Rect rect = _tileSet->rectForGID(gid);
                 rect = CC_RECT_PIXELS_TO_POINTS(rect);
 
                 sprite->setTextureRect(rect, false, rect.size);
                 if (flags) 
                 {
-                    setupTileSprite(sprite, sprite->getPosition(), gidAndFlags);
+                    setupTileSprite(sprite, pos, gidAndFlags);
                 }
-                _tiles[z] = gidAndFlags;
             } 
+            // only the chunk of the tile is rebuilt
             else 
             {
-                updateTileForGID(gidAndFlags, pos);
+                setChunkDirtyAt(pos);
             }
+            _tiles[z] = gidAndFlags;
         }
     }
 }
@@ -560,7 +795,7 @@ void TMXLayer::removeChild(Node* node, bool cleanup)
         return;
     }
 
-    CCASSERT(_children->containsObject(sprite), "Tile does not belong to TMXLayer");
+    CCASSERT(_children.contains(sprite), "Tile does not belong to TMXLayer");
 
     unsigned int atlasIndex = sprite->getAtlasIndex();
     unsigned int zz = (size_t)_atlasIndexArray->arr[atlasIndex];
@@ -579,41 +814,22 @@ void TMXLayer::removeTileAt(const Point& pos)
     if (gid) 
     {
         unsigned int z = (unsigned int)(pos.x + pos.y * _layerSize.width);
-        unsigned int atlasIndex = atlasIndexForExistantZ(z);
 
         // remove tile from GID map
         _tiles[z] = 0;
 
-        // remove tile from atlas position array
-        ccCArrayRemoveValueAtIndex(_atlasIndexArray, atlasIndex);
-
-        // remove it from sprites and/or texture atlas
-        Sprite *sprite = (Sprite*)getChildByTag(z);
-        if (sprite)
+        // remove it from sprites or from its chunk
+        if (hasTileSpriteAt(z))
         {
-            SpriteBatchNode::removeChild(sprite, true);
+            // remove tile from atlas position array
+            unsigned int atlasIndex = atlasIndexForExistantZ(z);
+            ccCArrayRemoveValueAtIndex(_atlasIndexArray, atlasIndex);
+
+            SpriteBatchNode::removeChild(getChildByTag(z), true);
         }
         else 
         {
-            _textureAtlas->removeQuadAtIndex(atlasIndex);
-
-            // update possible children
-            if (_children && _children->count()>0)
-            {
-                Object* pObject = nullptr;
-                CCARRAY_FOREACH(_children, pObject)
-                {
-                    Sprite* child = static_cast<Sprite*>(pObject);
-                    if (child)
-                    {
-                        unsigned int ai = child->getAtlasIndex();
-                        if ( ai >= atlasIndex )
-                        {
-                            child->setAtlasIndex(ai-1);
-                        }
-                    }
-                }
-            }
+            setChunkDirtyAt(pos);
         }
     }
 }
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include "sprite_nodes/CCSpriteBatchNode.h"
 #include "CCTMXXMLParser.h"
 #include "support/data_support/ccCArray.h"
+#include <vector>
+
 NS_CC_BEGIN
 
 class TMXMapInfo;
@@ -45,10 +47,14 @@ struct _ccCArray;
 
 /** @brief TMXLayer represents the TMX layer.
 
-It is a subclass of SpriteBatchNode. By default the tiles are rendered using a TextureAtlas.
-If you modify a tile on runtime, then, that tile will become a Sprite, otherwise no Sprite objects are created.
+It is a subclass of SpriteBatchNode. The tiles are stored as a grid of GIDs, and are rendered by chunks of
+CHUNK_SIZE x CHUNK_SIZE tiles. Each chunk keeps its quads in its own TextureAtlas, which is built the first time
+the chunk is visible and rebuilt only when one of its tiles is changed with setTileGID() or removeTileAt().
+Only the chunks intersecting the view are drawn. The chunks around them can be built ahead of time, see setChunkPrefetchDistance().
+If you ask for a tile with getTileAt(), then, that tile will become a Sprite, otherwise no Sprite objects are created.
 The benefits of using Sprite objects as tiles are:
 - tiles (Sprite) can be rotated/scaled/moved with a nice API
+The tiles which became a Sprite are drawn after the chunks.
 
 If the layer contains a property named "cc_vertexz" with an integer (in can be positive or negative),
 then all the tiles belonging to the layer will use that value as their OpenGL vertex Z for depth.
@@ -75,6 +81,16 @@ Tiles can have tile flags for additional properties. At the moment only flip hor
 class CC_DLL TMXLayer : public SpriteBatchNode
 {
 public:
+    /** number of tiles in each row and each column of a chunk
+     @since v3.0
+     */
+    static const int CHUNK_SIZE = 32;
+
+    /** number of frames a chunk can stay outside of the view before its quads are released
+     @since v3.0
+     */
+    static const unsigned int CHUNK_EXPIRATION_FRAMES = 600;
+
     /** creates a TMXLayer with an tileset info, a layer info and a map info */
     static TMXLayer * create(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
     
@@ -87,6 +103,7 @@ public:
     /** dealloc the map that contains the tile position from memory.
     Unless you want to know at runtime the tiles positions, you can safely call this method.
     If you are going to call layer->tileGIDAt() then, don't release the map
+    The quads of all the chunks are built before the map is released, and are kept from then on.
     */
     void releaseMap();
 
@@ -150,8 +167,16 @@ public:
     
     /** pointer to the map of tiles */
     inline unsigned int* getTiles() const { return _tiles; };
-    inline void setTiles(unsigned int* tiles) { _tiles = tiles; };
+    inline void setTiles(unsigned int* tiles) { _tiles = tiles; setAllChunksDirty(); };
     
+    /** Number of chunks around the visible ones that are built before they enter the view, 0 by default.
+     One of them is built per frame, and they are kept while the view stays near them, so the view can move
+     without building several chunks in the same frame.
+     @since v3.0
+     */
+    inline int getChunkPrefetchDistance() const { return _chunkPrefetchDistance; };
+    inline void setChunkPrefetchDistance(int distance) { _chunkPrefetchDistance = distance; };
+
     /** Tileset information for the layer */
     inline TMXTilesetInfo* getTileSet() const { return _tileSet; };
     inline void setTileSet(TMXTilesetInfo* info) {
@@ -180,29 +205,57 @@ public:
     virtual void addChild(Node * child, int zOrder, int tag) override;
     // super method
     void removeChild(Node* child, bool cleanup) override;
+    /** draws the visible chunks, then the tiles which became a Sprite */
+    virtual void draw() override;
 
 
 private:
+    /** The quads of a CHUNK_SIZE x CHUNK_SIZE region of the layer */
+    struct TileChunk
+    {
+        TileChunk() : atlas(nullptr), lastDrawnFrame(0), dirty(true) {}
+
+        //! created the first time the chunk is drawn, NULL if the chunk never had any tile
+        TextureAtlas* atlas;
+        //! in points, contains every tile of the chunk
+        Rect bounds;
+        unsigned int lastDrawnFrame;
+        //! the quads need to be rebuilt from the tiles
+        bool dirty;
+    };
+
     Point getPositionForIsoAt(const Point& pos);
     Point getPositionForOrthoAt(const Point& pos);
     Point getPositionForHexAt(const Point& pos);
 
     Point calculateLayerOffset(const Point& offset);
 
-    /* optimization methods */
-    Sprite* appendTileForGID(unsigned int gid, const Point& pos);
-    Sprite* insertTileForGID(unsigned int gid, const Point& pos);
-    Sprite* updateTileForGID(unsigned int gid, const Point& pos);
+    //! visibility of a chunk during draw()
+    enum
+    {
+        CHUNK_HIDDEN,
+        CHUNK_NEAR,     //!< within the prefetch distance of a visible chunk
+        CHUNK_VISIBLE,
+    };
+
+    /* chunks */
+    void setupChunks();
+    void buildChunk(int index);
+    void markChunksNearVisibleOnes();
+    void setChunkDirtyAt(const Point& pos);
+    void setAllChunksDirty();
+    /** fills the quad the Sprite of a tile would have, returns false if the tile is empty or is a Sprite */
+    bool setupTileQuad(V3F_C4B_T2F_Quad* quad, const Point& pos);
 
     /* The layer recognizes some special properties, like cc_vertez */
     void parseInternalProperties();
     void setupTileSprite(Sprite* sprite, Point pos, unsigned int gid);
-    Sprite* reusedTileWithRect(Rect rect);
     int getVertexZForPos(const Point& pos);
 
     // index
     unsigned int atlasIndexForExistantZ(unsigned int z);
     unsigned int atlasIndexForNewZ(int z);
+    bool hasTileSpriteAt(unsigned int z);
     
 protected:
     //! name of the layer
@@ -217,9 +270,15 @@ protected:
     int                    _vertexZvalue;
     bool                _useAutomaticVertexZ;
 
-    //! used for optimization
-    Sprite            *_reusedTile;
+    //! sorted positions of the tiles which became a Sprite, in the order of their quads
     ccCArray            *_atlasIndexArray;
+
+    //! chunks of the layer, row by row
+    std::vector<TileChunk> _chunks;
+    int _chunksWide;
+    int _chunkPrefetchDistance;
+    //! visibility of the chunks during draw()
+    std::vector<unsigned char> _chunkVisibility;
     
     // used for retina display
     float               _contentScaleFactor;
@@ -35,8 +35,8 @@ TMXObjectGroup::TMXObjectGroup()
     : _groupName("")
     , _positionOffset(Point::ZERO)
 {
-    _objects = Array::create();
-    _objects->retain();
+    _objects = new Array();
+    _objects->init();
     _properties = new Dictionary();
     _properties->init();
 }
@@ -27,11 +27,302 @@ THE SOFTWARE.
 #include "CCTMXXMLParser.h"
 #include "CCTMXLayer.h"
 #include "sprite_nodes/CCSprite.h"
+#include "platform/CCImage.h"
+#include "textures/CCTextureCache.h"
+#include "CCDirector.h"
+#include "CCScheduler.h"
+#include "platform/CCFileUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 NS_CC_BEGIN
 
+// TMXTiledMap::AsyncLoader
+
+/** Parses a map on a loading thread and hands its parts to the map on the main thread.
+ It is retained by the scheduler until the loading thread is done, even if the map was released in the meantime.
+ The loading thread stops early once the loader is detached from its map.
+ */
+class TMXTiledMap::AsyncLoader : public Object
+{
+public:
+    AsyncLoader(TMXTiledMap* map, const char* tmxFile, const std::function<void(TMXTiledMap*, bool)>& callback);
+    virtual ~AsyncLoader();
+
+    void start();
+    /** the map was released: the loading thread stops, and the parts already parsed are dropped as they arrive */
+    inline void detach() { _map = nullptr; _cancelled = true; }
+    /** stops the loading thread and waits for it, then releases the loader. The callback isn't called */
+    void cancel();
+    /** cancels the loaders whose loading thread is running */
+    static void cancelAll();
+
+private:
+    enum EventType
+    {
+        EVENT_TILESET,
+        EVENT_LAYER,
+        EVENT_OBJECT_GROUP,
+        EVENT_DONE,
+    };
+
+    struct Event
+    {
+        EventType type;
+        Object* element;
+        //! image of a tileset, or tileset of a layer
+        Object* data;
+        bool loaded;
+    };
+
+    void parse();
+    bool elementParsed(const char* elementName, Object* element);
+    void pushEvent(const Event& event);
+    void update(float dt);
+
+    TMXTiledMap* _map;
+    std::string _tmxFile;
+    std::function<void(TMXTiledMap*, bool)> _callback;
+    //! only used by the loading thread until EVENT_DONE
+    TMXMapInfo* _mapInfo;
+    int _layerIndex;
+
+    std::thread _thread;
+    std::atomic<bool> _cancelled;
+
+    std::mutex _eventsMutex;
+    std::deque<Event> _events;
+
+    //! main thread only: the loaders whose loading thread wasn't joined yet
+    static std::vector<AsyncLoader*> _runningLoaders;
+};
+
+std::vector<TMXTiledMap::AsyncLoader*> TMXTiledMap::AsyncLoader::_runningLoaders;
+
+TMXTiledMap::AsyncLoader::AsyncLoader(TMXTiledMap* map, const char* tmxFile, const std::function<void(TMXTiledMap*, bool)>& callback)
+: _map(map)
+, _tmxFile(tmxFile)
+, _callback(callback)
+, _mapInfo(new TMXMapInfo())
+, _layerIndex(0)
+, _cancelled(false)
+{
+}
+
+TMXTiledMap::AsyncLoader::~AsyncLoader()
+{
+    // the images of the tilesets that weren't handed to the map
+    for (const auto& event : _events)
+    {
+        if (event.type == EVENT_TILESET)
+        {
+            CC_SAFE_RELEASE(event.data);
+        }
+    }
+    CC_SAFE_RELEASE(_mapInfo);
+}
+
+void TMXTiledMap::AsyncLoader::start()
+{
+    Director::getInstance()->getScheduler()->scheduleSelector(schedule_selector(TMXTiledMap::AsyncLoader::update), this, 0, false);
+
+    // the scheduler keeps the loader alive until EVENT_DONE, the thread is joined then
+    _runningLoaders.push_back(this);
+    _thread = std::thread(&TMXTiledMap::AsyncLoader::parse, this);
+}
+
+void TMXTiledMap::AsyncLoader::cancel()
+{
+    if (_map)
+    {
+        _map->_asyncLoader = nullptr;
+    }
+    detach();
+    _thread.join();
+    _runningLoaders.erase(std::find(_runningLoaders.begin(), _runningLoaders.end(), this));
+
+    // releases the loader
+    Director::getInstance()->getScheduler()->unscheduleSelector(schedule_selector(TMXTiledMap::AsyncLoader::update), this);
+}
+
+void TMXTiledMap::AsyncLoader::cancelAll()
+{
+    // cancel() removes the loader from the list
+    const std::vector<AsyncLoader*> loaders = _runningLoaders;
+    for (const auto& loader : loaders)
+    {
+        loader->cancel();
+    }
+}
+
+// loading thread
+void TMXTiledMap::AsyncLoader::parse()
+{
+    _mapInfo->setElementParsedCallback(std::bind(&TMXTiledMap::AsyncLoader::elementParsed, this, std::placeholders::_1, std::placeholders::_2));
+    bool loaded = ! _cancelled && _mapInfo->initWithTMXFile(_tmxFile.c_str()) && _mapInfo->getTilesets()->count() != 0;
+    if (! loaded && ! _cancelled)
+    {
+        CCLOG("cocos2d: TMXTiledMap: can't load %s", _tmxFile.c_str());
+    }
+
+    Event event = { EVENT_DONE, nullptr, nullptr, loaded };
+    pushEvent(event);
+}
+
+// loading thread, returns false to stop the parsing
+bool TMXTiledMap::AsyncLoader::elementParsed(const char* elementName, Object* element)
+{
+    if (_cancelled)
+    {
+        return false;
+    }
+
+    Event event = { EVENT_DONE, element, nullptr, true };
+
+    if (strcmp(elementName, "tileset") == 0)
+    {
+        // decode the image here, only the texture is created on the main thread
+        TMXTilesetInfo* tileset = static_cast<TMXTilesetInfo*>(element);
+        std::string fullPath = FileUtils::getInstance()->fullPathForFilename(tileset->_sourceImage.c_str());
+        Image* image = new Image();
+        if (! image->initWithImageFileThreadSafe(fullPath.c_str()))
+        {
+            CC_SAFE_RELEASE_NULL(image);
+        }
+
+        event.type = EVENT_TILESET;
+        event.data = image;
+    }
+    else if (strcmp(elementName, "layer") == 0)
+    {
+        TMXLayerInfo* layerInfo = static_cast<TMXLayerInfo*>(element);
+        // invisible layers aren't created, and the tiles are missing if they couldn't be decoded
+        if (! layerInfo->_visible || ! layerInfo->_tiles)
+        {
+            return true;
+        }
+
+        event.type = EVENT_LAYER;
+        event.data = TMXTiledMap::tilesetForLayer(layerInfo, _mapInfo);
+    }
+    else if (strcmp(elementName, "objectgroup") == 0)
+    {
+        event.type = EVENT_OBJECT_GROUP;
+    }
+    else
+    {
+        return true;
+    }
+
+    pushEvent(event);
+    return true;
+}
+
+void TMXTiledMap::AsyncLoader::pushEvent(const Event& event)
+{
+    std::lock_guard<std::mutex> lock(_eventsMutex);
+    _events.push_back(event);
+}
+
+// main thread
+void TMXTiledMap::AsyncLoader::update(float dt)
+{
+    CC_UNUSED_PARAM(dt);
+
+    bool layerAdded = false;
+    Event event;
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_eventsMutex);
+            if (_events.empty())
+            {
+                return;
+            }
+            event = _events.front();
+
+            // one layer per frame
+            if (event.type == EVENT_LAYER && layerAdded && _map)
+            {
+                return;
+            }
+            _events.pop_front();
+        }
+
+        if (event.type == EVENT_DONE)
+        {
+            break;
+        }
+
+        if (event.type == EVENT_TILESET)
+        {
+            Image* image = static_cast<Image*>(event.data);
+            if (image && _map)
+            {
+                TextureCache::getInstance()->addUIImage(image, static_cast<TMXTilesetInfo*>(event.element)->_sourceImage.c_str());
+            }
+            CC_SAFE_RELEASE(image);
+        }
+        else if (_map)
+        {
+            // the header of the map is parsed before its tilesets, layers and object groups
+            _map->setMapInfoSizes(_mapInfo);
+
+            if (event.type == EVENT_LAYER)
+            {
+                TMXLayer* layer = _map->parseLayer(static_cast<TMXLayerInfo*>(event.element), static_cast<TMXTilesetInfo*>(event.data), _mapInfo);
+                _map->addLayer(layer, _layerIndex++);
+                layerAdded = true;
+            }
+            else
+            {
+                _map->_objectGroups->addObject(event.element);
+            }
+        }
+    }
+
+    // the loading thread is done
+    if (_map)
+    {
+        TMXTiledMap* map = _map;
+        map->setMapInfoSizes(_mapInfo);
+
+        CC_SAFE_RELEASE(map->_properties);
+        map->_properties = _mapInfo->getProperties();
+        CC_SAFE_RETAIN(map->_properties);
+
+        CC_SAFE_RELEASE(map->_tileProperties);
+        map->_tileProperties = _mapInfo->getTileProperties();
+        CC_SAFE_RETAIN(map->_tileProperties);
+
+        map->_asyncLoader = nullptr;
+        _map = nullptr;
+
+        if (_callback)
+        {
+            _callback(map, event.loaded);
+        }
+    }
+
+    // EVENT_DONE is the last thing the loading thread does
+    _thread.join();
+    _runningLoaders.erase(std::find(_runningLoaders.begin(), _runningLoaders.end(), this));
+
+    // releases the loader
+    Director::getInstance()->getScheduler()->unscheduleSelector(schedule_selector(TMXTiledMap::AsyncLoader::update), this);
+}
+
 // implementation TMXTiledMap
 
+void TMXTiledMap::cancelAllAsyncLoads()
+{
+    AsyncLoader::cancelAll();
+}
+
 TMXTiledMap * TMXTiledMap::create(const char *tmxFile)
 {
     TMXTiledMap *pRet = new TMXTiledMap();
@@ -74,6 +365,45 @@ bool TMXTiledMap::initWithTMXFile(const char *tmxFile)
     return true;
 }
 
+TMXTiledMap* TMXTiledMap::createAsync(const char *tmxFile, const std::function<void(TMXTiledMap*, bool)>& callback)
+{
+    TMXTiledMap *pRet = new TMXTiledMap();
+    if (pRet->initWithTMXFileAsync(tmxFile, callback))
+    {
+        pRet->autorelease();
+        return pRet;
+    }
+    CC_SAFE_DELETE(pRet);
+    return NULL;
+}
+
+bool TMXTiledMap::initWithTMXFileAsync(const char *tmxFile, const std::function<void(TMXTiledMap*, bool)>& callback)
+{
+    CCASSERT(tmxFile != NULL && strlen(tmxFile)>0, "TMXTiledMap: tmx file should not bi NULL");
+    CCASSERT(_asyncLoader == nullptr, "TMXTiledMap: the map is already loading");
+
+    setContentSize(Size::ZERO);
+
+    // empty until the loading thread is done
+    CC_SAFE_RELEASE(_objectGroups);
+    _objectGroups = new Array();
+    _objectGroups->initWithCapacity(4);
+
+    CC_SAFE_RELEASE(_properties);
+    _properties = new Dictionary();
+    _properties->init();
+
+    CC_SAFE_RELEASE(_tileProperties);
+    _tileProperties = new Dictionary();
+    _tileProperties->init();
+
+    _asyncLoader = new AsyncLoader(this, tmxFile, callback);
+    _asyncLoader->start();
+    _asyncLoader->release();
+
+    return true;
+}
+
 bool TMXTiledMap::initWithXML(const char* tmxString, const char* resourcePath)
 {
     setContentSize(Size::ZERO);
@@ -92,19 +422,25 @@ TMXTiledMap::TMXTiledMap()
     ,_objectGroups(NULL)
     ,_properties(NULL)
     ,_tileProperties(NULL)
+    ,_asyncLoader(NULL)
+    ,_chunkPrefetchDistance(0)
 {
 }
 TMXTiledMap::~TMXTiledMap()
 {
+    if (_asyncLoader)
+    {
+        _asyncLoader->detach();
+    }
+
     CC_SAFE_RELEASE(_properties);
     CC_SAFE_RELEASE(_objectGroups);
     CC_SAFE_RELEASE(_tileProperties);
 }
 
 // private
-TMXLayer * TMXTiledMap::parseLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo)
+TMXLayer * TMXTiledMap::parseLayer(TMXLayerInfo *layerInfo, TMXTilesetInfo *tileset, TMXMapInfo *mapInfo)
 {
-    TMXTilesetInfo *tileset = tilesetForLayer(layerInfo, mapInfo);
     TMXLayer *layer = TMXLayer::create(tileset, layerInfo, mapInfo);
 
     // tell the layerinfo to release the ownership of the tiles map.
@@ -159,11 +495,29 @@ TMXTilesetInfo * TMXTiledMap::tilesetForLayer(TMXLayerInfo *layerInfo, TMXMapInf
     return NULL;
 }
 
-void TMXTiledMap::buildWithMapInfo(TMXMapInfo* mapInfo)
+void TMXTiledMap::addLayer(TMXLayer *layer, int index)
+{
+    layer->setChunkPrefetchDistance(_chunkPrefetchDistance);
+    addChild((Node*)layer, index, index);
+
+    // update content size with the max size
+    const Size& childSize = layer->getContentSize();
+    Size currentSize = this->getContentSize();
+    currentSize.width = MAX( currentSize.width, childSize.width );
+    currentSize.height = MAX( currentSize.height, childSize.height );
+    this->setContentSize(currentSize);
+}
+
+void TMXTiledMap::setMapInfoSizes(TMXMapInfo* mapInfo)
 {
     _mapSize = mapInfo->getMapSize();
     _tileSize = mapInfo->getTileSize();
     _mapOrientation = mapInfo->getOrientation();
+}
+
+void TMXTiledMap::buildWithMapInfo(TMXMapInfo* mapInfo)
+{
+    setMapInfoSizes(mapInfo);
 
     CC_SAFE_RELEASE(_objectGroups);
     _objectGroups = mapInfo->getObjectGroups();
@@ -189,15 +543,8 @@ void TMXTiledMap::buildWithMapInfo(TMXMapInfo* mapInfo)
             layerInfo = static_cast<TMXLayerInfo*>(pObj);
             if (layerInfo && layerInfo->_visible)
             {
-                TMXLayer *child = parseLayer(layerInfo, mapInfo);
-                addChild((Node*)child, idx, idx);
-
-                // update content size with the max size
-                const Size& childSize = child->getContentSize();
-                Size currentSize = this->getContentSize();
-                currentSize.width = MAX( currentSize.width, childSize.width );
-                currentSize.height = MAX( currentSize.height, childSize.height );
-                this->setContentSize(currentSize);
+                TMXLayer *child = parseLayer(layerInfo, tilesetForLayer(layerInfo, mapInfo), mapInfo);
+                addLayer(child, idx);
 
                 idx++;
             }
@@ -206,11 +553,23 @@ void TMXTiledMap::buildWithMapInfo(TMXMapInfo* mapInfo)
 }
 
 // public
+void TMXTiledMap::setChunkPrefetchDistance(int distance)
+{
+    _chunkPrefetchDistance = distance;
+    for (const auto& child : _children)
+    {
+        TMXLayer* layer = dynamic_cast<TMXLayer*>(child);
+        if (layer)
+        {
+            layer->setChunkPrefetchDistance(distance);
+        }
+    }
+}
+
 TMXLayer * TMXTiledMap::getLayer(const char *layerName) const
 {
     CCASSERT(layerName != NULL && strlen(layerName) > 0, "Invalid layer name!");
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(_children, pObj) 
+    for (const auto& pObj : _children)
     {
         TMXLayer* layer = dynamic_cast<TMXLayer*>(pObj);
         if(layer)
@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include "base_nodes/CCNode.h"
 #include "CCTMXObjectGroup.h"
+#include <functional>
 
 NS_CC_BEGIN
 
@@ -96,6 +97,8 @@ You can obtain the object groups at runtime by:
 
 Each object is a TMXObject.
 
+A map can be loaded on a background thread with createAsync(). Its layers and object groups are then added as they are decoded.
+
 Each property is stored as a key-value pair in an MutableDictionary.
 You can obtain the properties at runtime by:
 
@@ -124,6 +127,39 @@ public:
     /** initializes a TMX Tiled Map with a TMX formatted XML string and a path to TMX resources */
     bool initWithXML(const char* tmxString, const char* resourcePath);
 
+    /** creates an empty TMX Tiled Map, and loads the TMX file on a background thread.
+     The file is parsed and its tiles are decoded on the loading thread, and so are the images of the tilesets.
+     The textures, the layers and the object groups are added on the main thread as soon as they are ready,
+     in the order of the file, one layer per frame.
+     The callback is called on the main thread once the whole map is loaded, with false if the file couldn't be parsed.
+     The map can be released before the end of the loading, the callback isn't called then.
+     @since v3.0
+     */
+    static TMXTiledMap* createAsync(const char *tmxFile, const std::function<void(TMXTiledMap*, bool)>& callback = nullptr);
+
+    /** initializes an empty TMX Tiled Map and loads the TMX file on a background thread, see createAsync()
+     @since v3.0
+     */
+    bool initWithTMXFileAsync(const char *tmxFile, const std::function<void(TMXTiledMap*, bool)>& callback);
+
+    /** stops the loading threads of the maps loaded by createAsync() and waits for them. Their callbacks aren't called,
+     and the maps keep the parts already added. Called by Director::purgeDirector().
+     @since v3.0
+     */
+    static void cancelAllAsyncLoads();
+
+    /** returns false while the map is loaded by createAsync()
+     @since v3.0
+     */
+    inline bool isLoaded() const { return _asyncLoader == nullptr; };
+
+    /** sets the chunk prefetch distance of the layers, including the layers which are still loading.
+     The chunks of a layer around the view are then built ahead of time, see TMXLayer::setChunkPrefetchDistance().
+     @since v3.0
+     */
+    void setChunkPrefetchDistance(int distance);
+    inline int getChunkPrefetchDistance() const { return _chunkPrefetchDistance; };
+
     /** return the TMXLayer for the specific layer */
     TMXLayer* getLayer(const char *layerName) const;
     CC_DEPRECATED_ATTRIBUTE TMXLayer* layerNamed(const char *layerName) const { return getLayer(layerName); };
@@ -169,8 +205,12 @@ public:
     };
     
 private:
-    TMXLayer * parseLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
-    TMXTilesetInfo * tilesetForLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
+    class AsyncLoader;
+
+    TMXLayer * parseLayer(TMXLayerInfo *layerInfo, TMXTilesetInfo *tileset, TMXMapInfo *mapInfo);
+    static TMXTilesetInfo * tilesetForLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
+    void addLayer(TMXLayer *layer, int index);
+    void setMapInfoSizes(TMXMapInfo* mapInfo);
     void buildWithMapInfo(TMXMapInfo* mapInfo);
 protected:
     /** the map's size property measured in tiles */
@@ -187,6 +227,9 @@ protected:
     //! tile properties
     Dictionary* _tileProperties;
 
+    //! loads the map when it is created by createAsync(), NULL once it is loaded
+    AsyncLoader* _asyncLoader;
+    int _chunkPrefetchDistance;
 };
 
 // end of tilemap_parallax_nodes group
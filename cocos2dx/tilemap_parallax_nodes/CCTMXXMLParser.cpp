@@ -138,11 +138,12 @@ TMXMapInfo * TMXMapInfo::createWithXML(const char* tmxString, const char* resour
 
 void TMXMapInfo::internalInit(const char* tmxFileName, const char* resourcePath)
 {
-    _tilesets = Array::create();
-    _tilesets->retain();
+    // nothing is autoreleased while parsing, so that a map can be parsed on another thread
+    _tilesets = new Array();
+    _tilesets->init();
 
-    _layers = Array::create();
-    _layers->retain();
+    _layers = new Array();
+    _layers->init();
 
     if (tmxFileName != NULL)
     {
@@ -154,8 +155,8 @@ void TMXMapInfo::internalInit(const char* tmxFileName, const char* resourcePath)
         _resources = resourcePath;
     }
     
-    _objectGroups = Array::createWithCapacity(4);
-    _objectGroups->retain();
+    _objectGroups = new Array();
+    _objectGroups->initWithCapacity(4);
 
     _properties = new Dictionary();
     _properties->init();
@@ -192,6 +193,7 @@ TMXMapInfo::TMXMapInfo()
 , _properties(NULL)
 , _tileProperties(NULL)
 , _currentFirstGID(0)
+, _parsingStopped(false)
 {
 }
 
@@ -222,7 +224,7 @@ bool TMXMapInfo::parseXMLString(const char *xmlString)
 
     parser.setDelegator(this);
 
-    return parser.parse(xmlString, len);
+    return parser.parse(xmlString, len) && ! _parsingStopped;
 }
 
 bool TMXMapInfo::parseXMLFile(const char *xmlFilename)
@@ -236,7 +238,7 @@ bool TMXMapInfo::parseXMLFile(const char *xmlFilename)
     
     parser.setDelegator(this);
 
-    return parser.parse(FileUtils::getInstance()->fullPathForFilename(xmlFilename).c_str());
+    return parser.parse(FileUtils::getInstance()->fullPathForFilename(xmlFilename).c_str()) && ! _parsingStopped;
 }
 
 
@@ -244,6 +246,10 @@ bool TMXMapInfo::parseXMLFile(const char *xmlFilename)
 void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
 {    
     CC_UNUSED_PARAM(ctx);
+    if (_parsingStopped)
+    {
+        return;
+    }
     TMXMapInfo *pTMXMapInfo = this;
     std::string elementName = (char*)name;
     std::map<std::string, std::string> *attributeDict = new std::map<std::string, std::string>();
@@ -516,8 +522,8 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
             String* obj = new String(valueForKey(key, attributeDict));
             if( obj )
             {
-                obj->autorelease();
                 dict->setObject(obj, key);
+                obj->release();
             }
         }
 
@@ -530,8 +536,8 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
             int x = atoi(value) + (int)objectGroup->getPositionOffset().x;
             sprintf(buffer, "%d", x);
             String* pStr = new String(buffer);
-            pStr->autorelease();
             dict->setObject(pStr, "x");
+            pStr->release();
         }
 
         // Y
@@ -543,8 +549,8 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
             y = (int)(_mapSize.height * _tileSize.height) - y - atoi(valueForKey("height", attributeDict));
             sprintf(buffer, "%d", y);
             String* pStr = new String(buffer);
-            pStr->autorelease();
             dict->setObject(pStr, "y");
+            pStr->release();
         }
 
         // Add the object to the objectGroup
@@ -623,7 +629,8 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
         const char* value = valueForKey("points", attributeDict);
         if(value)
         {
-            Array* pointsArray = Array::createWithCapacity(10);
+            Array* pointsArray = new Array();
+            pointsArray->initWithCapacity(10);
 
             // parse points string into a space-separated set of points
             stringstream pointsStream(value);
@@ -644,8 +651,8 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
                     int x = atoi(xStr.c_str()) + (int)objectGroup->getPositionOffset().x;
                     sprintf(buffer, "%d", x);
                     String* pStr = new String(buffer);
-                    pStr->autorelease();
                     pointDict->setObject(pStr, "x");
+                    pStr->release();
                 }
 
                 // set y
@@ -654,8 +661,8 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
                     int y = atoi(yStr.c_str()) + (int)objectGroup->getPositionOffset().y;
                     sprintf(buffer, "%d", y);
                     String* pStr = new String(buffer);
-                    pStr->autorelease();
                     pointDict->setObject(pStr, "y");
+                    pStr->release();
                 }
                 
                 // add to points array
@@ -664,6 +671,7 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
             }
             
             dict->setObject(pointsArray, "points");
+            pointsArray->release();
         }
     } 
     else if (elementName == "polyline")
@@ -684,6 +692,10 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
 void TMXMapInfo::endElement(void *ctx, const char *name)
 {
     CC_UNUSED_PARAM(ctx);
+    if (_parsingStopped)
+    {
+        return;
+    }
     TMXMapInfo *pTMXMapInfo = this;
     std::string elementName = (char*)name;
 
@@ -697,9 +709,9 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
             
             TMXLayerInfo* layer = (TMXLayerInfo*)pTMXMapInfo->getLayers()->getLastObject();
             
-            std::string currentString = pTMXMapInfo->getCurrentString();
             unsigned char *buffer;
-            len = base64Decode((unsigned char*)currentString.c_str(), (unsigned int)currentString.length(), &buffer);
+            len = base64Decode((unsigned char*)_currentString.c_str(), (unsigned int)_currentString.length(), &buffer);
+            _currentString.clear();
             if( ! buffer )
             {
                 CCLOG("cocos2d: TiledMap: decode data error");
@@ -708,33 +720,29 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
             
             if( pTMXMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib) )
             {
-                unsigned char *deflated;
                 Size s = layer->_layerSize;
-                // int sizeHint = s.width * s.height * sizeof(uint32_t);
-                int sizeHint = (int)(s.width * s.height * sizeof(unsigned int));
-                
-                int inflatedLen = ZipUtils::ccInflateMemoryWithHint(buffer, len, &deflated, sizeHint);
-                CCASSERT(inflatedLen == sizeHint, "");
+                int tilesAmount = (int)(s.width * s.height);
                 
-                inflatedLen = (size_t)&inflatedLen; // XXX: to avoid warnings in compiler
+                // the layer size gives the inflated length, so the tiles are inflated in place
+                unsigned int *tiles = new unsigned int[tilesAmount];
+                int inflatedLen = ZipUtils::ccInflateMemoryToBuffer(buffer, len, (unsigned char*)tiles, tilesAmount * sizeof(unsigned int));
                 
                 delete [] buffer;
                 buffer = NULL;
                 
-                if( ! deflated )
+                if( inflatedLen != (int)(tilesAmount * sizeof(unsigned int)) )
                 {
                     CCLOG("cocos2d: TiledMap: inflate data error");
+                    delete [] tiles;
                     return;
                 }
                 
-                layer->_tiles = (unsigned int*) deflated;
+                layer->_tiles = tiles;
             }
             else
             {
                 layer->_tiles = (unsigned int*) buffer;
             }
-            
-            pTMXMapInfo->setCurrentString("");
         }
         else if (pTMXMapInfo->getLayerAttribs() & TMXLayerAttribNone)
         {
@@ -755,15 +763,33 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
         // The map element has ended
         pTMXMapInfo->setParentElement(TMXPropertyNone);
     }    
+    else if (elementName == "image")
+    {
+        // The image of the last tileset is known
+        if (_elementParsedCallback && ! _elementParsedCallback("tileset", _tilesets->getLastObject()))
+        {
+            _parsingStopped = true;
+        }
+    }
     else if (elementName == "layer")
     {
         // The layer element has ended
         pTMXMapInfo->setParentElement(TMXPropertyNone);
+
+        if (_elementParsedCallback && ! _elementParsedCallback("layer", _layers->getLastObject()))
+        {
+            _parsingStopped = true;
+        }
     }
     else if (elementName == "objectgroup")
     {
         // The objectgroup element has ended
         pTMXMapInfo->setParentElement(TMXPropertyNone);
+
+        if (_elementParsedCallback && ! _elementParsedCallback("objectgroup", _objectGroups->getLastObject()))
+        {
+            _parsingStopped = true;
+        }
     } 
     else if (elementName == "object") 
     {
@@ -775,14 +801,9 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
 void TMXMapInfo::textHandler(void *ctx, const char *ch, int len)
 {
     CC_UNUSED_PARAM(ctx);
-    TMXMapInfo *pTMXMapInfo = this;
-    std::string pText((char*)ch,0,len);
-
-    if (pTMXMapInfo->isStoringCharacters())
+    if (! _parsingStopped && isStoringCharacters())
     {
-        std::string currentString = pTMXMapInfo->getCurrentString();
-        currentString += pText;
-        pTMXMapInfo->setCurrentString(currentString.c_str());
+        _currentString.append(ch, len);
     }
 }
 
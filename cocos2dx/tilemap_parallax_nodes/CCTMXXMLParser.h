@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "platform/CCSAXParser.h"
 
 #include <string>
+#include <functional>
 
 NS_CC_BEGIN
 
@@ -250,6 +251,16 @@ public:
     inline void setCurrentString(const char *currentString){ _currentString = currentString; }
     inline const char* getTMXFileName(){ return _TMXFileName.c_str(); }
     inline void setTMXFileName(const char *fileName){ _TMXFileName = fileName; }
+
+    /** Called by the parser, on the parsing thread, as soon as an element of the map is complete:
+     "tileset" with a TMXTilesetInfo once its image is known, "layer" with a TMXLayerInfo once its tiles are decoded,
+     and "objectgroup" with a TMXObjectGroup.
+     The parser doesn't autorelease any object, so a map can be parsed on another thread and streamed from there.
+     The callback returns false to stop the parsing: the rest of the file is skipped and the parsing fails.
+     @since v3.0
+     */
+    typedef std::function<bool(const char* elementName, Object* element)> ElementParsedCallback;
+    inline void setElementParsedCallback(const ElementParsedCallback& callback) { _elementParsedCallback = callback; }
 private:
     void internalInit(const char* tmxFileName, const char* resourcePath);
 protected:
@@ -286,6 +297,10 @@ protected:
     //! tile properties
     Dictionary* _tileProperties;
     unsigned int _currentFirstGID;
+    //! called when a tileset, a layer or an object group is complete
+    ElementParsedCallback _elementParsedCallback;
+    //! set when _elementParsedCallback returns false, the elements left are ignored
+    bool _parsingStopped;
 };
 
 // end of tilemap_parallax_nodes group
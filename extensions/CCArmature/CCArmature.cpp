@@ -304,7 +304,7 @@ void Armature::changeBoneParent(Bone *bone, const char *parentName)
 {
     CCASSERT(bone != NULL, "bone must be added to the bone dictionary!");
 
-    bone->getParentBone()->getChildren()->removeObject(bone);
+    bone->getParentBone()->getChildBones().eraseObject(bone);
     bone->setParentBone(NULL);
 
     if (parentName != NULL)
@@ -430,8 +430,7 @@ void Armature::draw()
         GL::blendFunc(_blendFunc.src, _blendFunc.dst);
     }
 
-    Object *object = NULL;
-    CCARRAY_FOREACH(_children, object)
+    for (const auto& object : _children)
     {
         Bone *bone = static_cast<Bone *>(object);
 
@@ -501,6 +500,12 @@ void Armature::visit()
     {
         return;
     }
+
+    // the bones are drawn by draw() itself: record the whole visit
+    if (deferVisitToRenderer())
+    {
+        return;
+    }
     kmGLPushMatrix();
 
     if (_grid && _grid->isActive())
@@ -531,8 +536,7 @@ Rect Armature::getBoundingBox() const
 
     Rect boundingBox = Rect(0, 0, 0, 0);
 
-    Object *object = NULL;
-    CCARRAY_FOREACH(_children, object)
+    for (const auto& object : _children)
     {
         Bone *bone = static_cast<Bone *>(object);
         Rect r = bone->getDisplayManager()->getBoundingBox();
@@ -562,12 +566,12 @@ Rect Armature::getBoundingBox() const
 
 Bone *Armature::getBoneAtPoint(float x, float y)
 {
-    int length = _children->count();
+    int length = _children.size();
     Bone *bs;
 
     for(int i = length - 1; i >= 0; i--)
     {
-        bs = static_cast<Bone*>( _children->getObjectAtIndex(i) );
+        bs = static_cast<Bone*>( _children.at(i) );
         if(bs->getDisplayManager()->containPoint(x, y))
         {
             return bs;
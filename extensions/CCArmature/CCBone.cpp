@@ -67,18 +67,16 @@ Bone::Bone()
     _boneData = NULL;
     _tween = NULL;
     _tween = NULL;
-    _children = NULL;
     _displayManager = NULL;
     _ignoreMovementBoneData = false;
     _worldTransform = AffineTransformMake(1, 0, 0, 1, 0, 0);
-    _transformDirty = true;
+    _boneTransformDirty = true;
 }
 
 
 Bone::~Bone(void)
 {
     CC_SAFE_DELETE(_tweenData);
-    CC_SAFE_DELETE(_children);
     CC_SAFE_DELETE(_tween);
     CC_SAFE_DELETE(_displayManager);
 
@@ -159,9 +157,9 @@ Armature *Bone::getArmature()
 void Bone::update(float delta)
 {
     if (_parent)
-        _transformDirty = _transformDirty || _parent->isTransformDirty();
+        _boneTransformDirty = _boneTransformDirty || _parent->isTransformDirty();
 
-    if (_transformDirty)
+    if (_boneTransformDirty)
     {
         float cosX	= cos(_tweenData->skewX);
         float cosY	= cos(_tweenData->skewY);
@@ -183,16 +181,14 @@ void Bone::update(float delta)
         }
     }
 
-    DisplayFactory::updateDisplay(this, _displayManager->getCurrentDecorativeDisplay(), delta, _transformDirty);
+    DisplayFactory::updateDisplay(this, _displayManager->getCurrentDecorativeDisplay(), delta, _boneTransformDirty);
 
-    Object *object = NULL;
-    CCARRAY_FOREACH(_children, object)
+    for (const auto& childBone : _childBones)
     {
-        Bone *childBone = static_cast<Bone *>(object);
         childBone->update(delta);
     }
 
-    _transformDirty = false;
+    _boneTransformDirty = false;
 }
 
 
@@ -225,30 +221,24 @@ void Bone::addChildBone(Bone *child)
     CCASSERT( NULL != child, "Argument must be non-nil");
     CCASSERT( NULL == child->_parent, "child already added. It can't be added again");
 
-    if(!_children)
+    if (! _childBones.contains(child))
     {
-        childrenAlloc();
-    }
-
-    if (_children->getIndexOfObject(child) == UINT_MAX)
-    {
-        _children->addObject(child);
+        _childBones.pushBack(child);
         child->setParentBone(this);
     }
 }
 
 void Bone::removeChildBone(Bone *bone, bool recursion)
 {
-    if ( _children->getIndexOfObject(bone) != UINT_MAX )
+    if (_childBones.contains(bone))
     {
         if(recursion)
         {
-            Array *_ccbones = bone->_children;
-            Object *_object = NULL;
-            CCARRAY_FOREACH(_ccbones, _object)
+            // iterate over a copy, removeChildBone() shrinks the bone's children
+            Vector<Bone*> ccbones = bone->_childBones;
+            for (const auto& ccBone : ccbones)
             {
-                Bone *_ccBone = static_cast<Bone *>(_object);
-                bone->removeChildBone(_ccBone, recursion);
+                bone->removeChildBone(ccBone, recursion);
             }
         }
 
@@ -256,7 +246,7 @@ void Bone::removeChildBone(Bone *bone, bool recursion)
 
         bone->getDisplayManager()->setCurrentDecorativeDisplay(NULL);
 
-        _children->removeObject(bone);
+        _childBones.eraseObject(bone);
     }
 }
 
@@ -278,14 +268,6 @@ Bone *Bone::getParentBone()
     return _parent;
 }
 
-void Bone::childrenAlloc(void)
-{
-    CC_SAFE_DELETE(_children);
-    _children = Array::createWithCapacity(4);
-    _children->retain();
-}
-
-
 void Bone::setChildArmature(Armature *armature)
 {
     if (_childArmature != armature)
@@ -301,9 +283,9 @@ Armature *Bone::getChildArmature()
     return _childArmature;
 }
 
-Array *Bone::getChildren()
+Vector<Bone*>& Bone::getChildBones()
 {
-    return _children;
+    return _childBones;
 }
 
 Tween *Bone::getTween()
@@ -319,12 +301,12 @@ void Bone::setZOrder(int zOrder)
 
 void Bone::setTransformDirty(bool dirty)
 {
-	_transformDirty = dirty;
+	_boneTransformDirty = dirty;
 }
 
 bool Bone::isTransformDirty()
 {
-	return _transformDirty;
+	return _boneTransformDirty;
 }
 
 AffineTransform Bone::nodeToArmatureTransform()
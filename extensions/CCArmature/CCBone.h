@@ -124,7 +124,7 @@ public:
     //! Update color to render display
     void updateColor();
 
-    Array *getChildren();
+    Vector<Bone*>& getChildBones();
     Tween *getTween();
 
     virtual void setZOrder(int zOrder);
@@ -166,12 +166,10 @@ protected:
 
     CC_SYNTHESIZE_PASS_BY_REF(std::string, _name, Name);
 
-    //! Lazy allocs
-    void childrenAlloc(void);
-    Array *_children;
+    Vector<Bone*> _childBones;
 
     Bone *_parent;				//! A weak reference to it's parent
-    bool _transformDirty;			//! Whether or not transform dirty
+    bool _boneTransformDirty;			//! Whether or not transform dirty
 
     //! self Transform, use this to change display's state
     AffineTransform _worldTransform;
@@ -69,6 +69,12 @@ void BatchNode::visit()
     {
         return;
     }
+
+    // the bones are drawn by draw() itself: record the whole visit
+    if (deferVisitToRenderer())
+    {
+        return;
+    }
     kmGLPushMatrix();
 
     if (_grid && _grid->isActive())
@@ -94,8 +100,7 @@ void BatchNode::visit()
 void BatchNode::draw()
 {
     CC_NODE_DRAW_SETUP();
-    Object *object = NULL;
-    CCARRAY_FOREACH(_children, object)
+    for (const auto& object : _children)
     {
         Armature *armature = dynamic_cast<Armature *>(object);
         if (armature)
@@ -40,6 +40,7 @@ public:
 
     void updateTransform();
     void draw();
+    virtual bool usesQuadCommand() const { return false; }
 
     CC_PROPERTY_PASS_BY_REF(BaseData, _skinData, SkinData);
     CC_SYNTHESIZE(Bone *, _bone, Bone);
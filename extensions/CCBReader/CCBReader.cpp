@@ -326,10 +326,9 @@ void CCBReader::cleanUpNodeGraph(Node *pNode)
 {
     pNode->setUserObject(NULL);
     
-    Object *pChild = NULL;
-    CCARRAY_FOREACH(pNode->getChildren(), pChild)
+    for (const auto& pChild : pNode->getChildren())
     {
-        cleanUpNodeGraph(static_cast<Node*>(pChild));
+        cleanUpNodeGraph(pChild);
     }
 }
 
@@ -232,9 +232,7 @@ void Control::removeTargetWithActionForControlEvent(Object* target, Handler acti
 void Control::setOpacityModifyRGB(bool bOpacityModifyRGB)
 {
     _isOpacityModifyRGB=bOpacityModifyRGB;
-    Object* child;
-    Array* children=getChildren();
-    CCARRAY_FOREACH(children, child)
+    for (const auto& child : getChildren())
     {
         RGBAProtocol* pNode = dynamic_cast<RGBAProtocol*>(child);        
         if (pNode)
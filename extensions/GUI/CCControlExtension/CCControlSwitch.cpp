@@ -44,6 +44,7 @@ public:
         LabelTTF* onLabel, 
         LabelTTF* offLabel);
     void draw();
+    virtual bool usesQuadCommand() const { return false; }
     void needsLayout();
     void setSliderXPosition(float sliderXPosition);
     float getSliderXPosition() {return _sliderXPosition;}
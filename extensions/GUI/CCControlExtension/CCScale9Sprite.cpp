@@ -688,9 +688,7 @@ void Scale9Sprite::updateCapInset()
 void Scale9Sprite::setOpacityModifyRGB(bool var)
 {
     _opacityModifyRGB = var;
-    Object* child;
-    Array* children = _scale9Image->getChildren();
-    CCARRAY_FOREACH(children, child)
+    for (const auto& child : _scale9Image->getChildren())
     {
         RGBAProtocol* pNode = dynamic_cast<RGBAProtocol*>(child);
         if (pNode)
@@ -773,9 +771,7 @@ void Scale9Sprite::visit()
 void Scale9Sprite::setColor(const Color3B& color)
 {
     NodeRGBA::setColor(color);
-    Object* child;
-    Array* children = _scale9Image->getChildren();
-    CCARRAY_FOREACH(children, child)
+    for (const auto& child : _scale9Image->getChildren())
     {
         RGBAProtocol* pNode = dynamic_cast<RGBAProtocol*>(child);
         if (pNode)
@@ -793,9 +789,7 @@ const Color3B& Scale9Sprite::getColor() const
 void Scale9Sprite::setOpacity(GLubyte opacity)
 {
     NodeRGBA::setOpacity(opacity);
-    Object* child;
-    Array* children = _scale9Image->getChildren();
-    CCARRAY_FOREACH(children, child)
+    for (const auto& child : _scale9Image->getChildren())
     {
         RGBAProtocol* pNode = dynamic_cast<RGBAProtocol*>(child);
         if (pNode)
@@ -813,9 +807,7 @@ GLubyte Scale9Sprite::getOpacity() const
 void Scale9Sprite::updateDisplayedColor(const cocos2d::Color3B &parentColor)
 {
     NodeRGBA::updateDisplayedColor(parentColor);
-    Object* child;
-    Array* children = _scale9Image->getChildren();
-    CCARRAY_FOREACH(children, child)
+    for (const auto& child : _scale9Image->getChildren())
     {
         RGBAProtocol* pNode = dynamic_cast<RGBAProtocol*>(child);
         if (pNode)
@@ -828,9 +820,7 @@ void Scale9Sprite::updateDisplayedColor(const cocos2d::Color3B &parentColor)
 void Scale9Sprite::updateDisplayedOpacity(GLubyte parentOpacity)
 {
     NodeRGBA::updateDisplayedOpacity(parentOpacity);
-    Object* child;
-    Array* children = _scale9Image->getChildren();
-    CCARRAY_FOREACH(children, child)
+    for (const auto& child : _scale9Image->getChildren())
     {
         RGBAProtocol* pNode = dynamic_cast<RGBAProtocol*>(child);
         if (pNode)
@@ -154,24 +154,16 @@ void ScrollView::pause(Object* sender)
 {
     _container->pauseSchedulerAndActions();
 
-    Object* pObj = NULL;
-    Array* pChildren = _container->getChildren();
-
-    CCARRAY_FOREACH(pChildren, pObj)
+    for (const auto& pChild : _container->getChildren())
     {
-        Node* pChild = static_cast<Node*>(pObj);
         pChild->pauseSchedulerAndActions();
     }
 }
 
 void ScrollView::resume(Object* sender)
 {
-    Object* pObj = NULL;
-    Array* pChildren = _container->getChildren();
-
-    CCARRAY_FOREACH(pChildren, pObj)
+    for (const auto& pChild : _container->getChildren())
     {
-        Node* pChild = static_cast<Node*>(pObj);
         pChild->resumeSchedulerAndActions();
     }
 
@@ -543,6 +535,12 @@ void ScrollView::visit()
 		return;
     }
 
+    // the scissor test can't be changed while the commands are recorded: record the whole visit
+    if (deferVisitToRenderer())
+    {
+        return;
+    }
+
 	kmGLPushMatrix();
 	
     if (_grid && _grid->isActive())
@@ -554,14 +552,14 @@ void ScrollView::visit()
 	this->transform();
     this->beforeDraw();
 
-	if(_children)
+	if(! _children.empty())
     {
-		unsigned int i=0;
+		int i=0;
 		
 		// draw children zOrder < 0
-		for( ; i < _children->count(); i++ )
+		for( ; i < _children.size(); i++ )
         {
-			Node *child = static_cast<Node*>( _children->getObjectAtIndex(i) );
+			Node *child = _children.at(i);
 			if ( child->getZOrder() < 0 )
             {
 				child->visit();
@@ -576,9 +574,9 @@ void ScrollView::visit()
 		this->draw();
 		
 		// draw children zOrder >= 0
-		for( ; i < _children->count(); i++ )
+		for( ; i < _children.size(); i++ )
         {
-			Node *child = static_cast<Node*>( _children->getObjectAtIndex(i) );
+			Node *child = _children.at(i);
 			child->visit();
 		}
         
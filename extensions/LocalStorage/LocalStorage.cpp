@@ -35,13 +35,57 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <sqlite3.h>
+#include <string>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "LocalStorage.h"
+
+// the changes are written in one transaction this long after the first one
+#define LOCALSTORAGE_WRITE_INTERVAL_MS 50
 
 static int _initialized = 0;
 static sqlite3 *_db;
-static sqlite3_stmt *_stmt_select;
 static sqlite3_stmt *_stmt_remove;
 static sqlite3_stmt *_stmt_update;
 
+// all the items, read from the DB once: the reads never wait for the writes
+static std::unordered_map<std::string, std::string> _items;
+static std::string _lastItem;
+
+// the changes not written yet, the last one for each key. A removed item has no value.
+struct PendingChange
+{
+	bool removed;
+	std::string value;
+};
+static std::unordered_map<std::string, PendingChange> _pending;
+static std::chrono::steady_clock::time_point _pendingTime;
+
+static std::mutex _mutex;
+static std::condition_variable _condition;
+static std::condition_variable _writtenCondition;
+static bool _quit = false;
+static bool _flushRequested = false;
+// incremented by each change, _writtenVersion is the version in the DB
+static unsigned long long _version = 0;
+static unsigned long long _writtenVersion = 0;
+
+// a joinable std::thread terminates the program when it is destroyed: if localStorageFree() wasn't called,
+// the writer is stopped at exit, after the changes left are written. Defined after the state it uses.
+struct LocalStorageWriter
+{
+	std::thread thread;
+
+	~LocalStorageWriter()
+	{
+		localStorageFree();
+	}
+};
+static LocalStorageWriter _writer;
 
 static void localStorageCreateTable()
 {
@@ -55,6 +99,97 @@ static void localStorageCreateTable()
 		printf("Error in CREATE TABLE\n");
 }
 
+static void localStorageLoadItems()
+{
+	const char *sql_select = "SELECT key, value FROM data;";
+	sqlite3_stmt *stmt;
+	if( sqlite3_prepare_v2(_db, sql_select, -1, &stmt, NULL) != SQLITE_OK ) {
+		printf("Error reading DB\n");
+		return;
+	}
+
+	while( sqlite3_step(stmt) == SQLITE_ROW ) {
+		const char *key = (const char*)sqlite3_column_text(stmt, 0);
+		const char *value = (const char*)sqlite3_column_text(stmt, 1);
+		if( key && value )
+			_items[key] = value;
+	}
+	sqlite3_finalize(stmt);
+}
+
+static void localStorageExec( const char *sql )
+{
+	if( sqlite3_exec(_db, sql, NULL, NULL, NULL) != SQLITE_OK )
+		printf("Error in %s: %s\n", sql, sqlite3_errmsg(_db));
+}
+
+// writes the changes in one transaction, on the writer thread
+static void localStorageWriteChanges( const std::unordered_map<std::string, PendingChange>& changes )
+{
+	localStorageExec("BEGIN;");
+
+	for( const auto& change : changes ) {
+		sqlite3_stmt *stmt = change.second.removed ? _stmt_remove : _stmt_update;
+		int ok = sqlite3_bind_text(stmt, 1, change.first.c_str(), (int)change.first.size(), SQLITE_STATIC);
+		if( ! change.second.removed )
+			ok |= sqlite3_bind_text(stmt, 2, change.second.value.c_str(), (int)change.second.value.size(), SQLITE_STATIC);
+
+		ok |= sqlite3_step(stmt);
+		ok |= sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+
+		if( ok != SQLITE_OK && ok != SQLITE_DONE)
+			printf("Error in localStorage.%s()\n", change.second.removed ? "removeItem" : "setItem");
+	}
+
+	localStorageExec("COMMIT;");
+}
+
+static void localStorageWriterLoop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while( true ) {
+		if( _pending.empty() ) {
+			if( _quit )
+				break;
+			_condition.wait(lock);
+			continue;
+		}
+
+		const auto deadline = _pendingTime + std::chrono::milliseconds(LOCALSTORAGE_WRITE_INTERVAL_MS);
+		if( ! _quit && ! _flushRequested && std::chrono::steady_clock::now() < deadline ) {
+			_condition.wait_until(lock, deadline);
+			continue;
+		}
+
+		std::unordered_map<std::string, PendingChange> changes;
+		changes.swap(_pending);
+		const unsigned long long version = _version;
+		_flushRequested = false;
+
+		lock.unlock();
+		localStorageWriteChanges(changes);
+		lock.lock();
+
+		_writtenVersion = version;
+		_writtenCondition.notify_all();
+	}
+}
+
+// queues a change, with the lock held
+static void localStorageQueueChange( const char *key, const char *value )
+{
+	if( _pending.empty() ) {
+		_pendingTime = std::chrono::steady_clock::now();
+		_condition.notify_one();
+	}
+
+	PendingChange& change = _pending[key];
+	change.removed = (value == NULL);
+	change.value = value ? value : "";
+	++_version;
+}
+
 void localStorageInit( const char *fullpath)
 {
 	if( ! _initialized ) {
@@ -66,11 +201,14 @@ void localStorageInit( const char *fullpath)
 		else
 			ret = sqlite3_open(fullpath, &_db);
 
-		localStorageCreateTable();
+		// the writer doesn't block the readers of the file, and commits don't sync the journal
+		if (fullpath) {
+			localStorageExec("PRAGMA journal_mode=WAL;");
+			localStorageExec("PRAGMA synchronous=NORMAL;");
+		}
 
-		// SELECT
-		const char *sql_select = "SELECT value FROM data WHERE key=?;";
-		ret |= sqlite3_prepare_v2(_db, sql_select, -1, &_stmt_select, NULL);
+		localStorageCreateTable();
+		localStorageLoadItems();
 
 		// REPLACE
 		const char *sql_update = "REPLACE INTO data (key, value) VALUES (?,?);";
@@ -85,6 +223,8 @@ void localStorageInit( const char *fullpath)
 			// report error
 		}
 		
+		_quit = false;
+		_writer.thread = std::thread(localStorageWriterLoop);
 		_initialized = 1;
 	}
 }
@@ -92,11 +232,21 @@ void localStorageInit( const char *fullpath)
 void localStorageFree()
 {
 	if( _initialized ) {
-		sqlite3_finalize(_stmt_select);
+		// the writer writes the changes left before it stops
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_quit = true;
+		}
+		_condition.notify_one();
+		_writer.thread.join();
+
 		sqlite3_finalize(_stmt_remove);
 		sqlite3_finalize(_stmt_update);		
 
 		sqlite3_close(_db);
+
+		_items.clear();
+		_lastItem.clear();
 		
 		_initialized = 0;
 	}
@@ -106,16 +256,13 @@ void localStorageFree()
 void localStorageSetItem( const char *key, const char *value)
 {
 	assert( _initialized );
-	
-	int ok = sqlite3_bind_text(_stmt_update, 1, key, -1, SQLITE_TRANSIENT);
-	ok |= sqlite3_bind_text(_stmt_update, 2, value, -1, SQLITE_TRANSIENT);
 
-	ok |= sqlite3_step(_stmt_update);
-	
-	ok |= sqlite3_reset(_stmt_update);
-	
-	if( ok != SQLITE_OK && ok != SQLITE_DONE)
-		printf("Error in localStorage.setItem()\n");
+	if( ! key || ! value )
+		return;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_items[key] = value;
+	localStorageQueueChange(key, value);
 }
 
 /** gets an item from the LS */
@@ -123,17 +270,16 @@ const char* localStorageGetItem( const char *key )
 {
 	assert( _initialized );
 
-	int ok = sqlite3_reset(_stmt_select);
+	if( ! key )
+		return NULL;
 
-	ok |= sqlite3_bind_text(_stmt_select, 1, key, -1, SQLITE_TRANSIENT);
-	ok |= sqlite3_step(_stmt_select);
-	const unsigned char *ret = sqlite3_column_text(_stmt_select, 0);
-	
-
-	if( ok != SQLITE_OK && ok != SQLITE_DONE && ok != SQLITE_ROW)
-		printf("Error in localStorage.getItem()\n");
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto iter = _items.find(key);
+	if( iter == _items.end() )
+		return NULL;
 
-	return (const char*)ret;
+	_lastItem = iter->second;
+	return _lastItem.c_str();
 }
 
 /** removes an item from the LS */
@@ -141,14 +287,54 @@ void localStorageRemoveItem( const char *key )
 {
 	assert( _initialized );
 
-	int ok = sqlite3_bind_text(_stmt_remove, 1, key, -1, SQLITE_TRANSIENT);
-	
-	ok |= sqlite3_step(_stmt_remove);
-	
-	ok |= sqlite3_reset(_stmt_remove);
+	if( ! key )
+		return;
 
-	if( ok != SQLITE_OK && ok != SQLITE_DONE)
-		printf("Error in localStorage.removeItem()\n");
+	std::lock_guard<std::mutex> lock(_mutex);
+	_items.erase(key);
+	localStorageQueueChange(key, NULL);
+}
+
+/** sets several items in the LS at once */
+void localStorageSetItems( const std::map<std::string, std::string>& items )
+{
+	assert( _initialized );
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for( const auto& item : items ) {
+		_items[item.first] = item.second;
+		localStorageQueueChange(item.first.c_str(), item.second.c_str());
+	}
+}
+
+/** gets several items from the LS at once */
+std::map<std::string, std::string> localStorageGetItems( const std::vector<std::string>& keys )
+{
+	assert( _initialized );
+
+	std::map<std::string, std::string> result;
+	std::lock_guard<std::mutex> lock(_mutex);
+	for( const auto& key : keys ) {
+		auto iter = _items.find(key);
+		if( iter != _items.end() )
+			result[key] = iter->second;
+	}
+	return result;
+}
+
+/** writes the items set so far and waits until they are stored */
+void localStorageFlush()
+{
+	assert( _initialized );
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	const unsigned long long version = _version;
+	if( _writtenVersion >= version )
+		return;
+
+	_flushRequested = true;
+	_condition.notify_one();
+	_writtenCondition.wait(lock, [version]{ return _writtenVersion >= version; });
 }
 
 #endif // #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
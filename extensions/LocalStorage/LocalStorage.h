@@ -32,20 +32,34 @@ THE SOFTWARE.
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <map>
+#include <string>
+#include <vector>
 
-/** Initializes the database. If path is null, it will create an in-memory DB */
+/** Initializes the database. If path is null, it will create an in-memory DB
+ Where the LS is a sqlite database, the items are read from memory and the changes are written
+ by a background thread, grouped in one transaction every few milliseconds. */
 void localStorageInit( const char *fullpath);
 
-/** Frees the allocated resources */
+/** Frees the allocated resources, after writing the changes left. Called at exit if it wasn't before */
 void localStorageFree();
 
 /** sets an item in the LS */
 void localStorageSetItem( const char *key, const char *value);
 
-/** gets an item from the LS */
+/** gets an item from the LS. The value is valid until the next call to localStorageGetItem() */
 const char* localStorageGetItem( const char *key );
 
 /** removes an item from the LS */
 void localStorageRemoveItem( const char *key );
 
+/** sets several items in the LS at once */
+void localStorageSetItems( const std::map<std::string, std::string>& items );
+
+/** gets several items from the LS at once. The keys not found are left out of the result */
+std::map<std::string, std::string> localStorageGetItems( const std::vector<std::string>& keys );
+
+/** writes the items set so far and waits until they are stored */
+void localStorageFlush();
+
 #endif // __JSB_LOCALSTORAGE_H
@@ -36,6 +36,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string>
+#include "LocalStorage.h"
 #include "jni.h"
 #include "jni/JniHelper.h"
 
@@ -141,4 +142,33 @@ void localStorageRemoveItem( const char *key )
 
 }
 
+/** sets several items in the LS at once */
+void localStorageSetItems( const std::map<std::string, std::string>& items )
+{
+	for (auto iter = items.begin(); iter != items.end(); ++iter)
+	{
+		localStorageSetItem(iter->first.c_str(), iter->second.c_str());
+	}
+}
+
+/** gets several items from the LS at once */
+std::map<std::string, std::string> localStorageGetItems( const std::vector<std::string>& keys )
+{
+	std::map<std::string, std::string> result;
+	for (auto iter = keys.begin(); iter != keys.end(); ++iter)
+	{
+		const char* value = localStorageGetItem(iter->c_str());
+		if (value)
+		{
+			result[*iter] = value;
+		}
+	}
+	return result;
+}
+
+/** the Java side stores the items itself */
+void localStorageFlush()
+{
+}
+
 #endif // #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
@@ -39,6 +39,7 @@ PhysicsSprite::PhysicsSprite()
 , _CPBody(NULL)
 , _pB2Body(NULL)
 , _PTMRatio(0.0f)
+, _visitedBodyTransform(AffineTransformMakeIdentity())
 {}
 
 PhysicsSprite* PhysicsSprite::create()
@@ -341,8 +342,41 @@ void PhysicsSprite::setRotation(float fRotation)
 
 }
 
-// returns the transform matrix according the Chipmunk Body values
 const AffineTransform& PhysicsSprite::getNodeToParentTransform() const
+{
+    _transform = getBodyTransform();
+    _transformDirty = false;
+    return _transform;
+}
+
+void PhysicsSprite::visit()
+{
+#if CC_ENABLE_CHIPMUNK_INTEGRATION
+    bool hasBody = _CPBody != NULL;
+#elif CC_ENABLE_BOX2D_INTEGRATION
+    bool hasBody = _pB2Body != NULL;
+#else
+    bool hasBody = false;
+#endif
+
+    // The body moves without notifying the sprite: the cached model-view matrix
+    // of the sprite is computed again only when the body transform changed.
+    if (hasBody)
+    {
+        AffineTransform bodyTransform = getBodyTransform();
+        if (! AffineTransformEqualToTransform(bodyTransform, _visitedBodyTransform))
+        {
+            _visitedBodyTransform = bodyTransform;
+            _transformDirty = true;
+            markBranchTransformDirty();
+        }
+    }
+
+    Sprite::visit();
+}
+
+// returns the transform matrix according the Chipmunk Body values
+AffineTransform PhysicsSprite::getBodyTransform() const
 {
     // Although scale is not used by physics engines, it is calculated just in case
 	// the sprite is animated (scaled up/down) using actions.
@@ -360,9 +394,9 @@ const AffineTransform& PhysicsSprite::getNodeToParentTransform() const
 		y += _anchorPointInPoints.y;
 	}
 
-	return (_transform = AffineTransformMake(rot.x * _scaleX, rot.y * _scaleX,
-                                             -rot.y * _scaleY, rot.x * _scaleY,
-                                             x,	y));
+	return AffineTransformMake(rot.x * _scaleX, rot.y * _scaleX,
+                               -rot.y * _scaleY, rot.x * _scaleY,
+                               x,	y);
 
 
 #elif CC_ENABLE_BOX2D_INTEGRATION
@@ -390,11 +424,9 @@ const AffineTransform& PhysicsSprite::getNodeToParentTransform() const
 	}
 
 	// Rot, Translate Matrix
-	_transform = AffineTransformMake( c * _scaleX,	s * _scaleX,
-                                     -s * _scaleY,	c * _scaleY,
-                                     x,	y );
-
-	return _transform;
+	return AffineTransformMake( c * _scaleX,	s * _scaleX,
+                               -s * _scaleY,	c * _scaleY,
+                               x,	y );
 #endif
 }
 
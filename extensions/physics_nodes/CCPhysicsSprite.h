@@ -112,9 +112,12 @@ public:
     virtual float getRotation() const override;
     virtual void setRotation(float fRotation) override;
     virtual const AffineTransform& getNodeToParentTransform() const override;
+    virtual void visit() override;
 
 protected:
     const Point& getPosFromPhysics() const;
+    // the transform of the node according to the body
+    AffineTransform getBodyTransform() const;
 
 protected:
     bool    _ignoreBodyRotation;
@@ -125,7 +128,9 @@ protected:
     // box2d specific
     b2Body  *_pB2Body;
     float   _PTMRatio;
-    
+
+    // the body transform of the last visit, to know when the cached model-view matrix is outdated
+    AffineTransform _visitedBodyTransform;
 
 };
 
@@ -47,9 +47,8 @@ void Bug422Layer::reset()
 
 void Bug422Layer::check(Node* t)
 {
-    auto array = t->getChildren();
-    Object* pChild = NULL;
-    CCARRAY_FOREACH(array, pChild)
+    auto& array = t->getChildren();
+    for (const auto& pChild : array)
     {
         CC_BREAK_IF(! pChild);
         auto node = static_cast<Node*>(pChild);
@@ -125,9 +125,8 @@ static void setEnableRecursiveCascading(Node* node, bool enable)
         rgba->setCascadeOpacityEnabled(enable);
     }
     
-    Object* obj;
-    auto children = node->getChildren();
-    CCARRAY_FOREACH(children, obj)
+    auto& children = node->getChildren();
+    for (const auto& obj : children)
     {
         auto child = static_cast<Node*>(obj);
         setEnableRecursiveCascading(child, enable);
@@ -86,9 +86,8 @@ MenuLayerMainMenu::MenuLayerMainMenu()
     
     int i=0;
     Node* child;
-    auto pArray = menu->getChildren();
-    Object* pObject = NULL;
-    CCARRAY_FOREACH(pArray, pObject)
+    auto& pArray = menu->getChildren();
+    for (const auto& pObject : pArray)
     {
         if(pObject == NULL)
             break;
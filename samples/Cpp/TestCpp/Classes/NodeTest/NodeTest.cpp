@@ -1,5 +1,6 @@
 #include "NodeTest.h"
 #include "../testResource.h"
+#include "support/TransformUtils.h"
 
 enum 
 {
@@ -22,7 +23,7 @@ Layer* restartCocosNodeAction();
 
 static int sceneIdx = -1; 
 
-#define MAX_LAYER    14
+#define MAX_LAYER    15
 
 Layer* createCocosNodeLayer(int nIndex)
 {
@@ -42,6 +43,7 @@ Layer* createCocosNodeLayer(int nIndex)
         case 11: return new ConvertToNode();
         case 12: return new NodeOpaqueTest();
         case 13: return new NodeNonOpaqueTest();
+        case 14: return new NodeCachedTransformTest();
     }
 
     return NULL;
@@ -838,6 +840,82 @@ std::string NodeNonOpaqueTest::subtitle()
     return "Node rendered with GL_BLEND enabled";
 }
 
+/// NodeCachedTransformTest
+
+NodeCachedTransformTest::NodeCachedTransformTest()
+: _step(0)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    _parentNode = Node::create();
+    _parentNode->setPosition(Point(s.width/4, s.height/2));
+    addChild(_parentNode);
+
+    _child = Sprite::create(s_pathGrossini);
+    _child->setPosition(Point(20, 10));
+    _child->setRotation(30);
+    _parentNode->addChild(_child);
+
+    _result = LabelTTF::create("", "Arial", 24);
+    _result->setPosition(Point(s.width/2, s.height/4));
+    addChild(_result);
+
+    // one step per frame at most, so that every change is visited before the next one
+    schedule(schedule_selector(NodeCachedTransformTest::step), 0.25f);
+}
+
+void NodeCachedTransformTest::step(float dt)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    switch (_step++)
+    {
+        case 0:
+            // the parent moves and its child is hidden in the same frame
+            _parentNode->setPosition(Point(s.width/2, s.height/2));
+            _child->setVisible(false);
+            break;
+        case 1:
+            // the parent moves while the child isn't visited
+            _parentNode->setPosition(Point(s.width*3/4, s.height/2));
+            _parentNode->setRotation(45);
+            break;
+        case 2:
+            _child->setVisible(true);
+            break;
+        default:
+        {
+            // the cached matrix of the child must be based on the last matrix of the parent
+            kmMat4 transform4x4, expected;
+            CGAffineToGL(_child->getNodeToParentTransform(), transform4x4.mat);
+            transform4x4.mat[14] = _child->getVertexZ();
+            kmMat4Multiply(&expected, &_parentNode->getModelViewTransform(), &transform4x4);
+
+            bool ok = true;
+            const kmMat4& cached = _child->getModelViewTransform();
+            for (int i = 0; i < 16; i++)
+            {
+                ok = ok && fabsf(cached.mat[i] - expected.mat[i]) < 0.001f;
+            }
+
+            CCLOG("NodeCachedTransformTest: %s", ok ? "passed" : "failed");
+            _result->setString(ok ? "Passed" : "Failed: the matrix of the child is stale");
+            unschedule(schedule_selector(NodeCachedTransformTest::step));
+            break;
+        }
+    }
+}
+
+std::string NodeCachedTransformTest::title()
+{
+    return "Node Cached Transform Test";
+}
+
+std::string NodeCachedTransformTest::subtitle()
+{
+    return "The child is shown after its parent moved";
+}
+
 void CocosNodeTestScene::runThisTest()
 {
     auto layer = nextCocosNodeAction();
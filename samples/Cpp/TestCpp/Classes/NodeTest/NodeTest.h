@@ -146,6 +146,21 @@ public:
     virtual std::string subtitle();
 };
 
+class NodeCachedTransformTest : public TestCocosNodeDemo
+{
+public:
+    NodeCachedTransformTest();
+    void step(float dt);
+    virtual std::string title();
+    virtual std::string subtitle();
+
+private:
+    Node* _parentNode;
+    Sprite* _child;
+    LabelTTF* _result;
+    int _step;
+};
+
 class CocosNodeTestScene : public TestScene
 {
 public:
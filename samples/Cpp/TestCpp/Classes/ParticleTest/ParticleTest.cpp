@@ -1531,8 +1531,7 @@ void MultipleParticleSystems::update(float dt)
 
     unsigned int count = 0; 
     
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(getChildren(), pObj)
+    for (const auto& pObj : getChildren())
     {
         auto item = dynamic_cast<ParticleSystem*>(pObj);
         if (item != NULL)
@@ -1583,8 +1582,7 @@ void MultipleParticleSystemsBatched::update(float dt)
     unsigned count = 0; 
     
     auto batchNode = getChildByTag(2);
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(batchNode->getChildren(), pObj)
+    for (const auto& pObj : batchNode->getChildren())
     {
         auto item = dynamic_cast<ParticleSystem*>(pObj);
         if (item != NULL)
@@ -1644,12 +1642,12 @@ void AddAndDeleteParticleSystems::onEnter()
 
 void AddAndDeleteParticleSystems::removeSystem(float dt)
 {
-    int nChildrenCount = _batchNode->getChildren()->count();
+    int nChildrenCount = _batchNode->getChildren().size();
     if (nChildrenCount > 0) 
     {
         CCLOG("remove random system");
         unsigned int uRand = rand() % (nChildrenCount - 1);
-        _batchNode->removeChild((Node*)_batchNode->getChildren()->getObjectAtIndex(uRand), true);
+        _batchNode->removeChild((Node*)_batchNode->getChildren().at(uRand), true);
 
         auto particleSystem = ParticleSystemQuad::create("Particles/Spiral.plist");
         //add new
@@ -1672,8 +1670,7 @@ void AddAndDeleteParticleSystems::update(float dt)
     unsigned int count = 0; 
     
     auto batchNode = getChildByTag(2);
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(batchNode->getChildren(), pObj)
+    for (const auto& pObj : batchNode->getChildren())
     {
         auto item = dynamic_cast<ParticleSystem*>(pObj);
         if (item != NULL)
@@ -1796,7 +1793,7 @@ void ReorderParticleSystems::onEnter()
 
 void ReorderParticleSystems::reorderSystem(float time)
 {
-    auto system = (ParticleSystem*)_batchNode->getChildren()->getObjectAtIndex(1);
+    auto system = (ParticleSystem*)_batchNode->getChildren().at(1);
     _batchNode->reorderChild(system, system->getZOrder() - 1);     
 }
 
@@ -1808,8 +1805,7 @@ void ReorderParticleSystems::update(float dt)
     unsigned int count = 0; 
     
     auto batchNode = getChildByTag(2);
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(batchNode->getChildren(), pObj)
+    for (const auto& pObj : batchNode->getChildren())
     {
         auto item = dynamic_cast<ParticleSystem*>(pObj);
         if (item != NULL)
@@ -0,0 +1,294 @@
+#include "PerformanceBenchmark.h"
+#include "PerformanceNodeChildrenTest.h"
+#include "PerformanceParticleTest.h"
+#include "PerformanceSpriteTest.h"
+#include "PerformanceTextureTest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+struct Scenario
+{
+    const char *name;
+    std::function<Scene*()> create;
+};
+
+template <typename T>
+Scene* createSpriteScene(int subtest, int nodes)
+{
+    auto scene = new T;
+    scene->initWithSubTest(subtest, nodes);
+    scene->autorelease();
+    return scene;
+}
+
+template <typename T>
+Scene* createParticleScene(int subtest, int particles)
+{
+    auto scene = new T;
+    scene->initWithSubTest(subtest, particles);
+    scene->autorelease();
+    return scene;
+}
+
+template <typename T>
+Scene* createNodeChildrenScene(int nodes)
+{
+    auto scene = new T;
+    scene->initWithQuantityOfNodes(nodes);
+    scene->autorelease();
+    return scene;
+}
+
+// Long tweens run by the action manager, on nodes which don't draw anything
+Scene* createTweensScene(int nodes)
+{
+    auto scene = Scene::create();
+    auto size = Director::getInstance()->getWinSize();
+
+    for (int i = 0; i < nodes; ++i)
+    {
+        auto node = Node::create();
+        node->runAction(MoveTo::create(1000.0f, Point(rand() % (int)size.width, rand() % (int)size.height)));
+        node->runAction(RotateBy::create(1000.0f, 360.0f));
+        node->runAction(ScaleTo::create(1000.0f, 2.0f));
+        scene->addChild(node);
+    }
+
+    return scene;
+}
+
+// The touches tests are left out: they only measure the handling of real input events.
+const Scenario s_scenarios[] =
+{
+    { "sprite-position-1000",           []{ return createSpriteScene<SpritePerformTest1>(1, 1000); } },
+    { "sprite-scale-1000",              []{ return createSpriteScene<SpritePerformTest2>(1, 1000); } },
+    { "sprite-scale-rotation-1000",     []{ return createSpriteScene<SpritePerformTest3>(1, 1000); } },
+    { "sprite-outside-1000",            []{ return createSpriteScene<SpritePerformTest4>(1, 1000); } },
+    { "sprite-80-outside-1000",         []{ return createSpriteScene<SpritePerformTest5>(1, 1000); } },
+    { "sprite-actions-1000",            []{ return createSpriteScene<SpritePerformTest6>(1, 1000); } },
+    { "sprite-actions-80-outside-1000", []{ return createSpriteScene<SpritePerformTest7>(1, 1000); } },
+    { "sprite-batch-position-5000",     []{ return createSpriteScene<SpritePerformTest1>(2, 5000); } },
+    { "sprite-batch-actions-5000",      []{ return createSpriteScene<SpritePerformTest6>(2, 5000); } },
+
+    { "particle-size4-2000",            []{ return createParticleScene<ParticlePerformTest1>(1, 2000); } },
+    { "particle-size8-2000",            []{ return createParticleScene<ParticlePerformTest2>(1, 2000); } },
+    { "particle-size32-2000",           []{ return createParticleScene<ParticlePerformTest3>(1, 2000); } },
+    { "particle-size64-2000",           []{ return createParticleScene<ParticlePerformTest4>(1, 2000); } },
+    { "particle-emitters-serial-500",   []{ return createParticleScene<ParticlePerformTest5>(1, 500); } },
+    { "particle-emitters-parallel-500", []{
+        // ParticlePerformTest5::onExit() disables the simulator again
+        Director::getInstance()->getParticleSimulator()->setEnabled(true);
+        return createParticleScene<ParticlePerformTest5>(1, 500);
+    } },
+
+    { "children-iterate-for-5000",      []{ return createNodeChildrenScene<IterateSpriteSheetForLoop>(5000); } },
+    { "children-iterate-carray-5000",   []{ return createNodeChildrenScene<IterateSpriteSheetCArray>(5000); } },
+    { "children-iterate-iterator-5000", []{ return createNodeChildrenScene<IterateSpriteSheetIterator>(5000); } },
+    { "children-foreach-5000",          []{ return createNodeChildrenScene<CallFuncsSpriteSheetForEach>(5000); } },
+    { "children-perform-selector-5000", []{ return createNodeChildrenScene<CallFuncsSpriteSheetCMacro>(5000); } },
+    { "children-add-sprite-500",        []{ return createNodeChildrenScene<AddSprite>(500); } },
+    { "children-add-batch-500",         []{ return createNodeChildrenScene<AddSpriteSheet>(500); } },
+    { "children-get-batch-500",         []{ return createNodeChildrenScene<GetSpriteSheet>(500); } },
+    { "children-remove-sprite-500",     []{ return createNodeChildrenScene<RemoveSprite>(500); } },
+    { "children-remove-batch-500",      []{ return createNodeChildrenScene<RemoveSpriteSheet>(500); } },
+    { "children-reorder-batch-500",     []{ return createNodeChildrenScene<ReorderSpriteSheet>(500); } },
+    { "children-sort-batch-500",        []{ return createNodeChildrenScene<SortAllChildrenSpriteSheet>(500); } },
+    { "children-visit-2000",            []{ return createNodeChildrenScene<VisitSceneGraph>(2000); } },
+    { "children-visit-static-2000",     []{ return createNodeChildrenScene<VisitStaticSceneGraph>(2000); } },
+
+    { "actions-tweens-20000",           []{ return createTweensScene(20000); } },
+
+    { "texture-load",                   []{ return TextureTest::scene(); } },
+    { "texture-convert",                []{ return TextureConvertTest::scene(); } },
+};
+
+struct Options
+{
+    Options()
+    : frames(300)
+    , warmupFrames(30)
+    , dt(1.0f / 60)
+    , filter("")
+    , output(nullptr)
+    , list(false)
+    {}
+
+    int frames;
+    int warmupFrames;
+    float dt;
+    const char *filter;
+    const char *output;
+    bool list;
+};
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--benchmark") == 0)
+        {
+            continue;
+        }
+        else if (strcmp(arg, "--list") == 0)
+        {
+            options.list = true;
+            continue;
+        }
+        else if (! value)
+        {
+            fprintf(stderr, "missing value for option '%s'\n", arg);
+            return false;
+        }
+
+        if (strcmp(arg, "--frames") == 0)
+            options.frames = atoi(value);
+        else if (strcmp(arg, "--warmup") == 0)
+            options.warmupFrames = atoi(value);
+        else if (strcmp(arg, "--dt") == 0)
+            options.dt = (float)atof(value);
+        else if (strcmp(arg, "--filter") == 0)
+            options.filter = value;
+        else if (strcmp(arg, "--output") == 0)
+            options.output = value;
+        else
+        {
+            fprintf(stderr, "unknown option '%s'\n", arg);
+            return false;
+        }
+        ++i;
+    }
+
+    if (options.frames <= 0 || options.warmupFrames < 0 || options.dt <= 0)
+    {
+        fprintf(stderr, "--frames and --dt must be positive, --warmup must not be negative\n");
+        return false;
+    }
+    return true;
+}
+
+double millisecondsSince(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void runScenario(const Scenario& scenario, const Options& options, FILE *out)
+{
+    auto director = Director::getInstance();
+
+    // the scenarios use rand() for their layouts
+    srand(0);
+    srandom(0);
+
+    // the setup includes the first frame, in which the scene enters the stage
+    auto setupStart = std::chrono::steady_clock::now();
+    director->replaceScene(scenario.create());
+    director->mainLoop();
+    double setup = millisecondsSince(setupStart);
+
+    for (int i = 0; i < options.warmupFrames; ++i)
+    {
+        director->mainLoop();
+    }
+
+    double update = 0, visit = 0, render = 0, total = 0;
+    std::vector<double> frames;
+    frames.reserve(options.frames);
+
+    for (int i = 0; i < options.frames; ++i)
+    {
+        auto frameStart = std::chrono::steady_clock::now();
+        director->mainLoop();
+        double frame = millisecondsSince(frameStart);
+
+        const Director::FrameTimes& times = director->getLastFrameTimes();
+        update += times.update * 1000.0;
+        visit += times.visit * 1000.0;
+        render += times.render * 1000.0;
+        total += frame;
+        frames.push_back(frame);
+    }
+
+    std::sort(frames.begin(), frames.end());
+    double p95 = frames[std::min(frames.size() - 1, frames.size() * 95 / 100)];
+    double n = options.frames;
+
+    fprintf(out, "%s,%d,%.6f,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+            scenario.name, options.frames, options.dt, setup,
+            update / n, visit / n, render / n, total / n, p95);
+    fflush(out);
+}
+
+} // namespace
+
+int runPerformanceBenchmark(int argc, char** argv)
+{
+    Options options;
+    if (! parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+
+    if (options.list)
+    {
+        for (const auto& scenario : s_scenarios)
+        {
+            printf("%s\n", scenario.name);
+        }
+        return 0;
+    }
+
+    FILE *out = stdout;
+    if (options.output)
+    {
+        out = fopen(options.output, "w");
+        if (! out)
+        {
+            fprintf(stderr, "can not open '%s'\n", options.output);
+            return 1;
+        }
+    }
+
+    auto director = Director::getInstance();
+    director->setDisplayStats(false);
+    director->setFixedDeltaTime(options.dt);
+
+    // the phases are reported in milliseconds per frame;
+    // when the render queue is disabled, the draw calls are part of the visit
+    fprintf(out, "scenario,frames,dt,setup_ms,update_ms,visit_ms,render_ms,frame_ms,frame_p95_ms\n");
+
+    int count = 0;
+    for (const auto& scenario : s_scenarios)
+    {
+        if (strstr(scenario.name, options.filter))
+        {
+            runScenario(scenario, options, out);
+            ++count;
+        }
+    }
+
+    // leave the last scenario, so that its scene exits before the process does
+    director->replaceScene(Scene::create());
+    director->mainLoop();
+    director->setFixedDeltaTime(0);
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    if (count == 0)
+    {
+        fprintf(stderr, "no scenario matches '%s'\n", options.filter);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef __PERFORMANCE_BENCHMARK_H__
+#define __PERFORMANCE_BENCHMARK_H__
+
+#include "PerformanceTest.h"
+
+/** Runs the performance scenarios without any interaction, each one for a fixed number of
+ frames at a fixed delta time, and writes the time spent in each phase of the frame as CSV.
+
+ Options:
+    --frames N      measured frames per scenario (300)
+    --warmup N      frames run before measuring (30)
+    --dt SECONDS    fixed delta time (1/60)
+    --filter TEXT   only runs the scenarios whose name contains TEXT
+    --output FILE   writes the results to FILE instead of stdout
+    --list          prints the names of the scenarios and exits
+
+ The Director must already run a scene. Returns the exit code of the process.
+ */
+int runPerformanceBenchmark(int argc, char** argv);
+
+#endif
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "support/TransformUtils.h"
+
 // Enable profiles for this file
 #undef CC_PROFILER_DISPLAY_TIMERS
 #define CC_PROFILER_DISPLAY_TIMERS() Profiler::getInstance()->displayTimers()
@@ -47,6 +49,7 @@ static std::function<NodeChildrenMainScene*()> createFunctions[] =
     CL(SortAllChildrenSpriteSheet),
 
     CL(VisitSceneGraph),
+    CL(VisitStaticSceneGraph),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -285,11 +288,11 @@ const char*  IterateSpriteSheet::testName()
 void IterateSpriteSheetForLoop::update(float dt)
 {
     // iterate using fast enumeration protocol
-    auto children = batchNode->getChildren();
+    auto& children = batchNode->getChildren();
 
     CC_PROFILER_START(this->profilerName());
 
-    for( const auto &object : *children )
+    for( const auto &object : children )
     {
         auto o = static_cast<Object*>(object);
         auto sprite = static_cast<Sprite*>(o);
@@ -322,12 +325,11 @@ const char*  IterateSpriteSheetForLoop::testName()
 void IterateSpriteSheetCArray::update(float dt)
 {
     // iterate using fast enumeration protocol
-    auto children = batchNode->getChildren();
-    Object* object = NULL;
+    auto& children = batchNode->getChildren();
 
     CC_PROFILER_START(this->profilerName());
 
-    CCARRAY_FOREACH(children, object)
+    for (const auto& object : children)
     {
         auto sprite = static_cast<Sprite*>(object);
         sprite->setVisible(false);
@@ -360,11 +362,11 @@ const char*  IterateSpriteSheetCArray::testName()
 void IterateSpriteSheetIterator::update(float dt)
 {
     // iterate using fast enumeration protocol
-    auto children = batchNode->getChildren();
+    auto& children = batchNode->getChildren();
 
     CC_PROFILER_START(this->profilerName());
 
-    for( auto it=std::begin(*children); it != std::end(*children); ++it)
+    for( auto it=std::begin(children); it != std::end(children); ++it)
     {
         auto obj = static_cast<Object*>(*it);
         auto sprite = static_cast<Sprite*>(obj);
@@ -398,19 +400,13 @@ const char*  IterateSpriteSheetIterator::testName()
 void CallFuncsSpriteSheetForEach::update(float dt)
 {
     // iterate using fast enumeration protocol
-    auto children = batchNode->getChildren();
+    auto& children = batchNode->getChildren();
 
     CC_PROFILER_START(this->profilerName());
 
-#if CC_USE_ARRAY_VECTOR
-    std::for_each(std::begin(*children), std::end(*children), [](const RCPtr<Object>& obj) {
-        static_cast<Node*>( static_cast<Object*>(obj) )->getPosition();
-    });
-#else
-    std::for_each(std::begin(*children), std::end(*children), [](Object* obj) {
-        static_cast<Node*>(obj)->getPosition();
+    std::for_each(std::begin(children), std::end(children), [](Node* node) {
+        node->getPosition();
     });
-#endif
 
     CC_PROFILER_STOP(this->profilerName());
 }
@@ -439,11 +435,14 @@ const char*  CallFuncsSpriteSheetForEach::testName()
 void CallFuncsSpriteSheetCMacro::update(float dt)
 {
     // iterate using fast enumeration protocol
-    auto children = batchNode->getChildren();
+    auto& children = batchNode->getChildren();
 
     CC_PROFILER_START(this->profilerName());
 
-    arrayMakeObjectsPerformSelector(children, getPosition, Node*);
+    for (int i = 0; i < children.size(); ++i)
+    {
+        children.at(i)->getPosition();
+    }
 
     CC_PROFILER_STOP(this->profilerName());
 }
@@ -456,12 +455,12 @@ std::string CallFuncsSpriteSheetCMacro::title()
 
 std::string CallFuncsSpriteSheetCMacro::subtitle()
 {
-    return "Using 'arrayMakeObjectsPerformSelector'. See console";
+    return "Using 'Vector::at()'. See console";
 }
 
 const char*  CallFuncsSpriteSheetCMacro::testName()
 {
-    return "Map: arrayMakeObjectsPerformSelector";
+    return "Map: Vector::at";
 }
 ////////////////////////////////////////////////////////
 //
@@ -1008,6 +1007,116 @@ const char*  VisitSceneGraph::testName()
     return "visit()";
 }
 
+////////////////////////////////////////////////////////
+//
+// VisitStaticSceneGraph
+//
+////////////////////////////////////////////////////////
+
+enum {
+    kStaticGroupSize = 10,
+};
+
+void VisitStaticSceneGraph::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _root = Node::create();
+    addChild(_root);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+    scheduleUpdate();
+}
+
+void VisitStaticSceneGraph::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    int currentGroups = currentQuantityOfNodes / kStaticGroupSize;
+    int groups = quantityOfNodes / kStaticGroupSize;
+
+    // increase nodes: groups of one rotated parent and its children
+    if( currentGroups < groups )
+    {
+        for(int i = currentGroups; i < groups; i++)
+        {
+            auto parent = Node::create();
+            parent->setPosition(Point(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            parent->setRotation(CCRANDOM_0_1() * 360);
+            parent->setScale(0.5f + CCRANDOM_0_1());
+            _root->addChild(parent, 0, 1000 + i);
+
+            for(int j = 1; j < kStaticGroupSize; j++)
+            {
+                auto child = Node::create();
+                child->setPosition(Point(j * 10, j * 5));
+                child->setRotation(j * 36);
+                parent->addChild(child);
+            }
+        }
+    }
+
+    // decrease nodes
+    else if ( currentGroups > groups )
+    {
+        for(int i = currentGroups - 1; i >= groups; i--)
+        {
+            _root->removeChildByTag(1000 + i);
+        }
+    }
+
+    currentQuantityOfNodes = groups * kStaticGroupSize;
+}
+
+// Node::visit() as it was before the model-view matrices were cached
+void VisitStaticSceneGraph::visitWithoutCache(Node* node)
+{
+    kmGLPushMatrix();
+
+    kmMat4 transform4x4;
+    CGAffineToGL(node->getNodeToParentTransform(), transform4x4.mat);
+    transform4x4.mat[14] = node->getVertexZ();
+    kmGLMultMatrix(&transform4x4);
+
+    node->sortAllChildren();
+    node->draw();
+
+    for (const auto& child : node->getChildren())
+    {
+        visitWithoutCache(static_cast<Node*>(child));
+    }
+
+    kmGLPopMatrix();
+}
+
+void VisitStaticSceneGraph::update(float dt)
+{
+    // nothing moves: with the cached model-view matrices, visit() only loads them
+    char name[256];
+    snprintf(name, sizeof(name)-1, "%s cached", profilerName());
+    CC_PROFILER_START(name);
+    _root->visit();
+    CC_PROFILER_STOP(name);
+
+    snprintf(name, sizeof(name)-1, "%s uncached", profilerName());
+    CC_PROFILER_START(name);
+    visitWithoutCache(_root);
+    CC_PROFILER_STOP(name);
+}
+
+std::string VisitStaticSceneGraph::title()
+{
+    return "Visiting a static scene graph";
+}
+
+std::string VisitStaticSceneGraph::subtitle()
+{
+    return "cached vs uncached model-view matrices. See console";
+}
+
+const char*  VisitStaticSceneGraph::testName()
+{
+    return "visit() static";
+}
+
 ///----------------------------------------
 void runNodeChildrenTest()
 {
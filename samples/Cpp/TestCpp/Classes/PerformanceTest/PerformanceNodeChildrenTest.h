@@ -207,6 +207,23 @@ public:
     virtual const char* testName() override;
 };
 
+class VisitStaticSceneGraph : public NodeChildrenMainScene
+{
+public:
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() override;
+    virtual std::string subtitle() override;
+    virtual const char* testName() override;
+
+protected:
+    void visitWithoutCache(Node* node);
+
+    Node* _root;
+};
+
 void runNodeChildrenTest();
 
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
@@ -6,9 +6,11 @@ enum {
     kTagMainLayer = 2,
     kTagParticleSystem = 3,
     kTagLabelAtlas = 4,
+    kTagEmitters = 5,
+    kTagSimulatorMenu = 6,
     kTagMenuLayer = 1000,
 
-    TEST_COUNT = 4,
+    TEST_COUNT = 5,
 };
 
 enum {
@@ -51,6 +53,9 @@ void ParticleMenuLayer::showCurrentTest()
     case 3:
         pNewScene = new ParticlePerformTest4;
         break;
+    case 4:
+        pNewScene = new ParticlePerformTest5;
+        break;
     }
 
     s_nParCurIdx = _curCase;
@@ -557,6 +562,99 @@ void ParticlePerformTest4::doTest()
 
 }
 
+////////////////////////////////////////////////////////
+//
+// ParticlePerformTest5
+//
+////////////////////////////////////////////////////////
+
+enum {
+    kEmitters = 50,
+};
+
+std::string ParticlePerformTest5::title()
+{
+    char str[40] = {0};
+    sprintf(str, "E (%d) %d emitters", subtestNumber, kEmitters);
+    std::string strRet = str;
+    return strRet;
+}
+
+void ParticlePerformTest5::doTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto particleSystem = (ParticleSystem*)getChildByTag(kTagParticleSystem);
+
+    // the first emitter is created by createParticleSystem(), the other ones are copies of it
+    while (getChildByTag(kTagEmitters))
+    {
+        removeChildByTag(kTagEmitters, true);
+    }
+
+    for (int i = 0; i < kEmitters; ++i)
+    {
+        ParticleSystem* emitter = particleSystem;
+        if (i > 0)
+        {
+            emitter = ParticleSystemQuad::createWithTotalParticles(particleSystem->getTotalParticles());
+            emitter->setTexture(particleSystem->getTexture());
+            addChild(emitter, 0, kTagEmitters);
+        }
+
+        emitter->setDuration(-1);
+        emitter->setGravity(Point(0,-90));
+        emitter->setAngle(90);
+        emitter->setAngleVar(20);
+        emitter->setRadialAccel(0);
+        emitter->setRadialAccelVar(0);
+        emitter->setTangentialAccel(10);
+        emitter->setTangentialAccelVar(5);
+        emitter->setSpeed(180);
+        emitter->setSpeedVar(50);
+        emitter->setPosition(Point(s.width * (i + 0.5f) / kEmitters, 100));
+        emitter->setPosVar(Point(s.width / kEmitters, 0));
+        emitter->setLife(2.0f);
+        emitter->setLifeVar(1);
+        emitter->setEmissionRate(emitter->getTotalParticles() / emitter->getLife());
+        emitter->setStartColor(Color4F(0.5f, 0.5f, 0.5f, 1.0f));
+        emitter->setStartColorVar(Color4F(0.5f, 0.5f, 0.5f, 1.0f));
+        emitter->setEndColor(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+        emitter->setEndColorVar(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+        emitter->setStartSize(4.0f);
+        emitter->setStartSizeVar(2.0f);
+        emitter->setEndSize(8.0f);
+        emitter->setEndSizeVar(0);
+        emitter->setStartSpinVar(90);
+        emitter->setBlendAdditive(false);
+    }
+
+    // serial or parallel simulation of the emitters
+    if (! getChildByTag(kTagSimulatorMenu))
+    {
+        MenuItemFont::setFontSize(30);
+        auto toggle = MenuItemToggle::createWithCallback(CC_CALLBACK_1(ParticlePerformTest5::toggleSimulatorCallback, this),
+                                                         MenuItemFont::create("Serial"),
+                                                         MenuItemFont::create("Parallel"),
+                                                         NULL);
+        toggle->setSelectedIndex(Director::getInstance()->getParticleSimulator()->isEnabled() ? 1 : 0);
+        auto menu = Menu::create(toggle, NULL);
+        menu->setPosition(Point(s.width/2, s.height/2 - 40));
+        addChild(menu, 1, kTagSimulatorMenu);
+    }
+}
+
+void ParticlePerformTest5::toggleSimulatorCallback(Object* sender)
+{
+    auto toggle = static_cast<MenuItemToggle*>(sender);
+    Director::getInstance()->getParticleSimulator()->setEnabled(toggle->getSelectedIndex() == 1);
+}
+
+void ParticlePerformTest5::onExit()
+{
+    Director::getInstance()->getParticleSimulator()->setEnabled(false);
+    ParticleMainScene::onExit();
+}
+
 void runParticleTest()
 {
     auto scene = new ParticlePerformTest1;
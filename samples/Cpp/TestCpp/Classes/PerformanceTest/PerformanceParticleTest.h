@@ -58,6 +58,16 @@ public:
     virtual void doTest();
 };
 
+class ParticlePerformTest5 : public ParticleMainScene
+{
+public:
+    virtual std::string title();
+    virtual void doTest();
+    virtual void onExit();
+
+    void toggleSimulatorCallback(Object* sender);
+};
+
 void runParticleTest();
 
 #endif
@@ -1,8 +1,12 @@
 #include "PerformanceTextureTest.h"
+#include "textures/CCTexture2DConvert.h"
+
+#include <chrono>
+#include <vector>
 
 enum
 {
-    TEST_COUNT = 1,
+    TEST_COUNT = 2,
 };
 
 static int s_nTexCurCase = 0;
@@ -32,6 +36,9 @@ void TextureMenuLayer::showCurrentTest()
     case 0:
         scene = TextureTest::scene();
         break;
+    case 1:
+        scene = TextureConvertTest::scene();
+        break;
     }
     s_nTexCurCase = _curCase;
 
@@ -345,7 +352,117 @@ std::string TextureTest::subtitle()
 Scene* TextureTest::scene()
 {
     auto scene = Scene::create();
-    TextureTest *layer = new TextureTest(false, TEST_COUNT, s_nTexCurCase);
+    TextureTest *layer = new TextureTest(true, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureConvertTest
+//
+////////////////////////////////////////////////////////
+namespace {
+
+struct ConvertPair
+{
+    const char *name;
+    int bytesPerPixel;
+    PixelConvertFunction PixelConverters::*function;
+};
+
+const ConvertPair s_convertPairs[] =
+{
+    { "I8 -> RGB888",               1, &PixelConverters::i8ToRGB888 },
+    { "I8 -> RGBA8888",             1, &PixelConverters::i8ToRGBA8888 },
+    { "I8 -> RGB565",               1, &PixelConverters::i8ToRGB565 },
+    { "I8 -> RGBA4444",             1, &PixelConverters::i8ToRGBA4444 },
+    { "I8 -> RGB5A1",               1, &PixelConverters::i8ToRGB5A1 },
+    { "I8 -> AI88",                 1, &PixelConverters::i8ToAI88 },
+    { "AI88 -> RGB888",             2, &PixelConverters::ai88ToRGB888 },
+    { "AI88 -> RGBA8888",           2, &PixelConverters::ai88ToRGBA8888 },
+    { "AI88 -> RGB565",             2, &PixelConverters::ai88ToRGB565 },
+    { "AI88 -> RGBA4444",           2, &PixelConverters::ai88ToRGBA4444 },
+    { "AI88 -> RGB5A1",             2, &PixelConverters::ai88ToRGB5A1 },
+    { "AI88 -> A8",                 2, &PixelConverters::ai88ToA8 },
+    { "AI88 -> I8",                 2, &PixelConverters::ai88ToI8 },
+    { "RGB888 -> RGBA8888",         3, &PixelConverters::rgb888ToRGBA8888 },
+    { "RGB888 -> RGB565",           3, &PixelConverters::rgb888ToRGB565 },
+    { "RGB888 -> I8",               3, &PixelConverters::rgb888ToI8 },
+    { "RGB888 -> AI88",             3, &PixelConverters::rgb888ToAI88 },
+    { "RGB888 -> RGBA4444",         3, &PixelConverters::rgb888ToRGBA4444 },
+    { "RGB888 -> RGB5A1",           3, &PixelConverters::rgb888ToRGB5A1 },
+    { "RGBA8888 -> RGB888",         4, &PixelConverters::rgba8888ToRGB888 },
+    { "RGBA8888 -> RGB565",         4, &PixelConverters::rgba8888ToRGB565 },
+    { "RGBA8888 -> I8",             4, &PixelConverters::rgba8888ToI8 },
+    { "RGBA8888 -> A8",             4, &PixelConverters::rgba8888ToA8 },
+    { "RGBA8888 -> AI88",           4, &PixelConverters::rgba8888ToAI88 },
+    { "RGBA8888 -> RGBA4444",       4, &PixelConverters::rgba8888ToRGBA4444 },
+    { "RGBA8888 -> RGB5A1",         4, &PixelConverters::rgba8888ToRGB5A1 },
+    { "RGBA8888 -> premultiplied",  4, &PixelConverters::rgba8888ToPremultipliedRGBA8888 },
+};
+
+// the best time of a few runs, in milliseconds
+double timeConversion(PixelConvertFunction convert, const unsigned char* data, int dataLen, unsigned char* outData)
+{
+    double best = 0;
+    for (int run = 0; run < 5; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        convert(data, dataLen, outData);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0 || ms < best)
+        {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+void TextureConvertTest::performTests()
+{
+    const int pixels = 2048 * 2048;
+    const PixelConverters& scalar = getScalarPixelConverters();
+    const PixelConverters& selected = getPixelConverters();
+
+    std::vector<unsigned char> data(pixels * 4);
+    std::vector<unsigned char> outData(pixels * 4);
+    srand(0);
+    for (auto& value : data)
+    {
+        value = (unsigned char)rand();
+    }
+
+    log("--------");
+    log("--- 2048x2048, scalar / %s ---", selected.instructionSet);
+
+    for (const auto& pair : s_convertPairs)
+    {
+        int dataLen = pixels * pair.bytesPerPixel;
+        double scalarTime = timeConversion(scalar.*pair.function, &data[0], dataLen, &outData[0]);
+        double selectedTime = timeConversion(selected.*pair.function, &data[0], dataLen, &outData[0]);
+        log("%-26s ms:%8.3f /%8.3f  x%.1f", pair.name, scalarTime, selectedTime, scalarTime / selectedTime);
+    }
+}
+
+std::string TextureConvertTest::title()
+{
+    return "Texture Conversion Test";
+}
+
+std::string TextureConvertTest::subtitle()
+{
+    return "Converts 2048x2048 pixels. See console for results";
+}
+
+Scene* TextureConvertTest::scene()
+{
+    auto scene = Scene::create();
+    TextureConvertTest *layer = new TextureConvertTest(true, TEST_COUNT, s_nTexCurCase);
     scene->addChild(layer);
     layer->release();
 
@@ -35,6 +35,24 @@ public:
     static Scene* scene();
 };
 
+/** Converts a 2048x2048 image between all the pixel formats Texture2D converts,
+ with the scalar conversions and with the ones selected for the CPU, and logs their times.
+ */
+class TextureConvertTest : public TextureMenuLayer
+{
+public:
+    TextureConvertTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title();
+    virtual std::string subtitle();
+
+    static Scene* scene();
+};
+
 void runTextureTest();
 
 #endif
@@ -106,6 +106,7 @@ class SimpleSprite : public Sprite
     public:
         SimpleSprite();
         virtual void draw();
+        virtual bool usesQuadCommand() const { return false; }
         
         static SimpleSprite* create(const char* filename, const Rect &rect);
         
@@ -1,5 +1,6 @@
 #include "SchedulerTest.h"
 #include "../testResource.h"
+#include <algorithm>
 
 enum {
     kTagAnimationDance = 1,
@@ -27,6 +28,10 @@ TESTLAYER_CREATE_FUNC(SchedulerUpdateFromCustom)
 TESTLAYER_CREATE_FUNC(RescheduleSelector)
 TESTLAYER_CREATE_FUNC(SchedulerDelayAndRepeat)
 TESTLAYER_CREATE_FUNC(SchedulerIssue2268)
+TESTLAYER_CREATE_FUNC(SchedulerHeapEqualDeadlines)
+TESTLAYER_CREATE_FUNC(SchedulerHeapUnscheduleInCallback)
+TESTLAYER_CREATE_FUNC(SchedulerHeapPauseResume)
+TESTLAYER_CREATE_FUNC(SchedulerHeapChangeInterval)
 
 static NEWTESTFUNC createFunctions[] = {
     CF(SchedulerTimeScale),
@@ -44,7 +49,11 @@ static NEWTESTFUNC createFunctions[] = {
     CF(SchedulerUpdateFromCustom),
     CF(RescheduleSelector),
     CF(SchedulerDelayAndRepeat),
-    CF(SchedulerIssue2268)
+    CF(SchedulerIssue2268),
+    CF(SchedulerHeapEqualDeadlines),
+    CF(SchedulerHeapUnscheduleInCallback),
+    CF(SchedulerHeapPauseResume),
+    CF(SchedulerHeapChangeInterval)
 };
 
 #define MAX_LAYER (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -694,9 +703,9 @@ void SchedulerUpdate::onEnter()
 
 void SchedulerUpdate::removeUpdates(float dt)
 {
-    auto children = getChildren();
+    auto& children = getChildren();
 
-    for (auto c : *children)
+    for (auto c : children)
     {
         auto obj = static_cast<Object*>(c);
         auto node = static_cast<Node*>(obj);
@@ -1147,6 +1156,218 @@ std::string SchedulerIssue2268::subtitle()
 {
     return "Should not crash";
 }
+//------------------------------------------------------------------
+//
+// HeapTimerTarget
+//
+//------------------------------------------------------------------
+HeapTimerTarget::HeapTimerTarget(Scheduler* scheduler, char name, std::string* log)
+: other(nullptr)
+, _scheduler(scheduler)
+, _name(name)
+, _log(log)
+{
+}
+
+void HeapTimerTarget::tick(float dt)
+{
+    _log->push_back(_name);
+}
+
+void HeapTimerTarget::tickAndUnschedule(float dt)
+{
+    tick(dt);
+    _scheduler->unscheduleSelector(schedule_selector(HeapTimerTarget::tickAndUnschedule), this);
+    _scheduler->unscheduleSelector(schedule_selector(HeapTimerTarget::tick), other);
+}
+
+//------------------------------------------------------------------
+//
+// SchedulerHeapTest
+//
+//------------------------------------------------------------------
+void SchedulerHeapTest::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    auto scheduler = new Scheduler();
+    scheduler->setTimerHeapEnabled(true);
+    bool passed = runTest(scheduler);
+    scheduler->release();
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = LabelTTF::create(passed ? "Passed" : "Failed", "Arial", 32);
+    label->setColor(passed ? Color3B::GREEN : Color3B::RED);
+    label->setPosition(Point(s.width/2, s.height/2));
+    addChild(label);
+}
+
+void SchedulerHeapTest::advance(Scheduler* scheduler, float duration)
+{
+    // 1/16 is exact: the deadlines don't depend on rounding errors
+    for (float time = 0; time < duration; time += 1.0f / 16)
+    {
+        scheduler->update(1.0f / 16);
+    }
+}
+
+//------------------------------------------------------------------
+//
+// SchedulerHeapEqualDeadlines
+//
+//------------------------------------------------------------------
+bool SchedulerHeapEqualDeadlines::runTest(Scheduler* scheduler)
+{
+    std::string calls;
+    // created in the reverse order, so the order of the calls doesn't come from the allocations
+    HeapTimerTarget* targets[3];
+    for (int i = 2; i >= 0; --i)
+    {
+        targets[i] = new HeapTimerTarget(scheduler, 'a' + i, &calls);
+    }
+    for (const auto& target : targets)
+    {
+        scheduler->scheduleSelector(schedule_selector(HeapTimerTarget::tick), target, 0.5f, false);
+        target->release();
+    }
+
+    advance(scheduler, 2);
+    log("SchedulerHeapEqualDeadlines: %s", calls.c_str());
+
+    // the timers with the same deadline are called in the order they were scheduled
+    return calls == "abcabcabc";
+}
+
+std::string SchedulerHeapEqualDeadlines::title()
+{
+    return "Timer heap: equal deadlines";
+}
+
+std::string SchedulerHeapEqualDeadlines::subtitle()
+{
+    return "Timers with the same deadline are called in the order they were scheduled";
+}
+
+//------------------------------------------------------------------
+//
+// SchedulerHeapUnscheduleInCallback
+//
+//------------------------------------------------------------------
+bool SchedulerHeapUnscheduleInCallback::runTest(Scheduler* scheduler)
+{
+    std::string calls;
+    auto a = new HeapTimerTarget(scheduler, 'a', &calls);
+    auto b = new HeapTimerTarget(scheduler, 'b', &calls);
+    auto c = new HeapTimerTarget(scheduler, 'c', &calls);
+    a->other = b;
+
+    // a unschedules itself and b, which is due in the same update
+    scheduler->scheduleSelector(schedule_selector(HeapTimerTarget::tickAndUnschedule), a, 0.5f, false);
+    scheduler->scheduleSelector(schedule_selector(HeapTimerTarget::tick), b, 0.5f, false);
+    scheduler->scheduleSelector(schedule_selector(HeapTimerTarget::tick), c, 0.5f, false);
+    a->release();
+    b->release();
+    c->release();
+
+    advance(scheduler, 2);
+    log("SchedulerHeapUnscheduleInCallback: %s", calls.c_str());
+
+    return calls == "accc" && ! scheduler->isScheduledForTarget(schedule_selector(HeapTimerTarget::tick), b);
+}
+
+std::string SchedulerHeapUnscheduleInCallback::title()
+{
+    return "Timer heap: unschedule in a callback";
+}
+
+std::string SchedulerHeapUnscheduleInCallback::subtitle()
+{
+    return "A timer unschedules itself and a timer due in the same frame";
+}
+
+//------------------------------------------------------------------
+//
+// SchedulerHeapPauseResume
+//
+//------------------------------------------------------------------
+bool SchedulerHeapPauseResume::runTest(Scheduler* scheduler)
+{
+    std::string calls;
+    auto a = new HeapTimerTarget(scheduler, 'a', &calls);
+    auto b = new HeapTimerTarget(scheduler, 'b', &calls);
+    scheduler->scheduleSelector(schedule_selector(HeapTimerTarget::tick), a, 0.5f, false);
+    scheduler->scheduleSelector(schedule_selector(HeapTimerTarget::tick), b, 0.5f, false);
+
+    advance(scheduler, 1.25f);
+    std::string beforePause = calls;
+
+    // b keeps running while a is paused
+    scheduler->pauseTarget(a);
+    advance(scheduler, 1);
+    std::string whilePaused = calls.substr(beforePause.size());
+
+    // a had 0.3125 seconds left before its next call when it was paused
+    scheduler->resumeTarget(a);
+    advance(scheduler, 0.25f);
+    std::string afterResume = calls.substr(beforePause.size() + whilePaused.size());
+    advance(scheduler, 0.125f);
+    std::string afterTimeLeft = calls.substr(beforePause.size() + whilePaused.size() + afterResume.size());
+
+    log("SchedulerHeapPauseResume: %s | %s | %s | %s", beforePause.c_str(), whilePaused.c_str(), afterResume.c_str(), afterTimeLeft.c_str());
+    bool passed = beforePause == "abab" && whilePaused == "bb"
+        && afterResume.find('a') == std::string::npos
+        && std::count(afterTimeLeft.begin(), afterTimeLeft.end(), 'a') == 1;
+
+    a->release();
+    b->release();
+    return passed;
+}
+
+std::string SchedulerHeapPauseResume::title()
+{
+    return "Timer heap: pause and resume";
+}
+
+std::string SchedulerHeapPauseResume::subtitle()
+{
+    return "A paused timer isn't called, and resumes with the time it had left";
+}
+
+//------------------------------------------------------------------
+//
+// SchedulerHeapChangeInterval
+//
+//------------------------------------------------------------------
+bool SchedulerHeapChangeInterval::runTest(Scheduler* scheduler)
+{
+    std::string calls;
+    auto a = new HeapTimerTarget(scheduler, 'a', &calls);
+    auto b = new HeapTimerTarget(scheduler, 'b', &calls);
+    scheduler->scheduleSelector(schedule_selector(HeapTimerTarget::tick), a, 1, false);
+    scheduler->scheduleSelector(schedule_selector(HeapTimerTarget::tick), b, 0.625f, false);
+    a->release();
+    b->release();
+
+    // a is scheduled again with a shorter interval: it moves ahead of b in the heap
+    advance(scheduler, 0.25f);
+    scheduler->scheduleSelector(schedule_selector(HeapTimerTarget::tick), a, 0.5f, false);
+
+    advance(scheduler, 1.5f);
+    log("SchedulerHeapChangeInterval: %s", calls.c_str());
+
+    return calls == "ababa";
+}
+
+std::string SchedulerHeapChangeInterval::title()
+{
+    return "Timer heap: changed interval";
+}
+
+std::string SchedulerHeapChangeInterval::subtitle()
+{
+    return "A timer scheduled again with a shorter interval is called sooner";
+}
+
 //------------------------------------------------------------------
 //
 // SchedulerTestScene
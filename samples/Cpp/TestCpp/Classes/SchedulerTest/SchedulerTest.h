@@ -263,6 +263,72 @@ class SchedulerIssue2268 : public SchedulerTestLayer
 		Node *testNode;
 };
 
+// Records its calls in a log shared by several targets, for the tests of the timer heap
+class HeapTimerTarget : public Object
+{
+public:
+    HeapTimerTarget(Scheduler* scheduler, char name, std::string* log);
+
+    void tick(float dt);
+    // unschedules its tick and the one of the other target
+    void tickAndUnschedule(float dt);
+
+    HeapTimerTarget* other;
+private:
+    Scheduler* _scheduler;
+    char _name;
+    std::string* _log;
+};
+
+// Updates a scheduler with the timer heap by hand, and shows if its selectors were called as expected
+class SchedulerHeapTest : public SchedulerTestLayer
+{
+public:
+    virtual void onEnter();
+
+protected:
+    /** returns true if the test passed */
+    virtual bool runTest(Scheduler* scheduler) = 0;
+    /** updates the scheduler during duration seconds, in frames of 1/16 second */
+    void advance(Scheduler* scheduler, float duration);
+};
+
+class SchedulerHeapEqualDeadlines : public SchedulerHeapTest
+{
+public:
+    virtual std::string title();
+    virtual std::string subtitle();
+protected:
+    virtual bool runTest(Scheduler* scheduler);
+};
+
+class SchedulerHeapUnscheduleInCallback : public SchedulerHeapTest
+{
+public:
+    virtual std::string title();
+    virtual std::string subtitle();
+protected:
+    virtual bool runTest(Scheduler* scheduler);
+};
+
+class SchedulerHeapPauseResume : public SchedulerHeapTest
+{
+public:
+    virtual std::string title();
+    virtual std::string subtitle();
+protected:
+    virtual bool runTest(Scheduler* scheduler);
+};
+
+class SchedulerHeapChangeInterval : public SchedulerHeapTest
+{
+public:
+    virtual std::string title();
+    virtual std::string subtitle();
+protected:
+    virtual bool runTest(Scheduler* scheduler);
+};
+
 class SchedulerTestScene : public TestScene
 {
 public:
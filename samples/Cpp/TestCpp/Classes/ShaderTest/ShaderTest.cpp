@@ -428,6 +428,7 @@ public:
     void setBlurSize(float f);
     bool initWithTexture(Texture2D* texture, const Rect&  rect);
     void draw();
+    virtual bool usesQuadCommand() const { return false; }
     void initProgram();
     void listenBackToForeground(Object *obj);
 
@@ -678,11 +679,10 @@ void ShaderRetroEffect::update(float dt)
 {
     _accum += dt;
 
-    auto pArray = _label->getChildren();
+    auto& pArray = _label->getChildren();
 
     int i=0;
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(pArray, pObj)
+    for (const auto& pObj : pArray)
     {
         auto sprite = static_cast<Sprite*>(pObj);
         i++;
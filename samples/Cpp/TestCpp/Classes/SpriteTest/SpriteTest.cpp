@@ -642,10 +642,10 @@ SpriteBatchNodeReorder::SpriteBatchNodeReorder()
     }
     
     int CC_UNUSED prev = -1;
-    auto children = asmtest->getChildren();
+    auto& children = asmtest->getChildren();
     Sprite* child;
     Object* pObject = NULL;
-    CCARRAY_FOREACH(children, pObject)
+    for (const auto& pObject : children)
     {
         child = static_cast<Sprite*>(pObject);
         if(! child )
@@ -1447,13 +1447,12 @@ void SpriteNewTexture::ccTouchesEnded(Set* touches, Event* event)
 
     auto node = getChildByTag( kTagSpriteBatchNode );
 
-    auto children = node->getChildren();
+    auto& children = node->getChildren();
     Sprite* sprite;
-    Object* pObject;
 
     if( _usingTexture1 )                          //--> win32 : Let's it make just simple sentence
     {
-        CCARRAY_FOREACH(children, pObject)
+        for (const auto& pObject : children)
         {
             sprite = static_cast<Sprite*>( pObject );
             if(! sprite)
@@ -1466,7 +1465,7 @@ void SpriteNewTexture::ccTouchesEnded(Set* touches, Event* event)
     } 
     else 
     {
-        CCARRAY_FOREACH(children, pObject)
+        for (const auto& pObject : children)
         {
             sprite = static_cast<Sprite*>( pObject );
             if(! sprite)
@@ -2207,8 +2206,8 @@ void SpriteHybrid::reparentSprite(float dt)
     
     Node* node;
     Object* pObject;
-    auto children = p1->getChildren();
-    CCARRAY_FOREACH(children, pObject)
+    auto& children = p1->getChildren();
+    for (const auto& pObject : children)
     {
         node = static_cast<Node*>( pObject );
         if(! node )
@@ -4140,18 +4139,17 @@ void NodeSort::reorderSprite(float dt)
 
     log("Before reorder--");
     
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(_node->getChildren(), pObj)
+    for (const auto& pObj : _node->getChildren())
     {
         auto child = static_cast<Sprite*>( pObj );
         log("tag %i z %i",(int)child->getTag(),(int)child->getZOrder());
     }
     //z-4
-    _node->reorderChild( static_cast<Node*>( _node->getChildren()->getObjectAtIndex(0) ), -6);
+    _node->reorderChild( static_cast<Node*>( _node->getChildren().at(0) ), -6);
 
     _node->sortAllChildren();
     log("After reorder--");
-    CCARRAY_FOREACH(_node->getChildren(), pObj)
+    for (const auto& pObj : _node->getChildren())
     {
         auto child = static_cast<Sprite*>( pObj );
         log("tag %i z %i",(int)child->getTag(),(int)child->getZOrder());
@@ -128,10 +128,9 @@ TMXOrthoTest::TMXOrthoTest()
     Size CC_UNUSED s = map->getContentSize();
     CCLOG("ContentSize: %f, %f", s.width,s.height);
     
-    auto pChildrenArray = map->getChildren();
+    auto& pChildrenArray = map->getChildren();
     SpriteBatchNode* child = NULL;
-    Object* pObject = NULL;
-    CCARRAY_FOREACH(pChildrenArray, pObject)
+    for (const auto& pObject : pChildrenArray)
     {
         child = static_cast<SpriteBatchNode*>(pObject);
 
@@ -177,10 +176,9 @@ TMXOrthoTest2::TMXOrthoTest2()
     Size CC_UNUSED s = map->getContentSize();
     CCLOG("ContentSize: %f, %f", s.width,s.height);
 
-    auto pChildrenArray = map->getChildren();
+    auto& pChildrenArray = map->getChildren();
     SpriteBatchNode* child = NULL;
-    Object* pObject = NULL;
-    CCARRAY_FOREACH(pChildrenArray, pObject)
+    for (const auto& pObject : pChildrenArray)
     {
         child = static_cast<SpriteBatchNode*>(pObject);
 
@@ -211,10 +209,9 @@ TMXOrthoTest3::TMXOrthoTest3()
     Size CC_UNUSED s = map->getContentSize();
     CCLOG("ContentSize: %f, %f", s.width,s.height);
     
-    auto pChildrenArray = map->getChildren();
+    auto& pChildrenArray = map->getChildren();
     SpriteBatchNode* child = NULL;
-    Object* pObject = NULL;
-    CCARRAY_FOREACH(pChildrenArray, pObject)
+    for (const auto& pObject : pChildrenArray)
     {
         child = static_cast<SpriteBatchNode*>(pObject);
 
@@ -246,10 +243,9 @@ TMXOrthoTest4::TMXOrthoTest4()
     Size CC_UNUSED s1 = map->getContentSize();
     CCLOG("ContentSize: %f, %f", s1.width,s1.height);
     
-    auto pChildrenArray = map->getChildren();
+    auto& pChildrenArray = map->getChildren();
     SpriteBatchNode* child = NULL;
-    Object* pObject = NULL;
-    CCARRAY_FOREACH(pChildrenArray, pObject)
+    for (const auto& pObject : pChildrenArray)
     {
         child = static_cast<SpriteBatchNode*>(pObject);
 
@@ -358,7 +354,7 @@ TMXReadWriteTest::TMXReadWriteTest()
     schedule(schedule_selector(TMXReadWriteTest::removeTiles), 1.0f); 
 
     ////----CCLOG("++++atlas quantity: %d", layer->textureAtlas()->getTotalQuads());
-    ////----CCLOG("++++children: %d", layer->getChildren()->count() );
+    ////----CCLOG("++++children: %d", layer->getChildren().size() );
     
     _gid2 = 0;
 }
@@ -382,7 +378,7 @@ void TMXReadWriteTest::updateCol(float dt)
     auto layer = (TMXLayer*)map->getChildByTag(0);
 
     ////----CCLOG("++++atlas quantity: %d", layer->textureAtlas()->getTotalQuads());
-    ////----CCLOG("++++children: %d", layer->getChildren()->count() );
+    ////----CCLOG("++++children: %d", layer->getChildren().size() );
 
 
     auto s = layer->getLayerSize();
@@ -551,10 +547,9 @@ TMXUncompressedTest::TMXUncompressedTest()
     map->runAction(MoveTo::create(1.0f, Point( -ms.width * ts.width/2, -ms.height * ts.height/2 ) ));
     
     // testing release map
-    auto pChildrenArray = map->getChildren();
+    auto& pChildrenArray = map->getChildren();
     TMXLayer* layer;
-    Object* pObject = NULL;
-    CCARRAY_FOREACH(pChildrenArray, pObject)
+    for (const auto& pObject : pChildrenArray)
     {
         layer= static_cast<TMXLayer*>(pObject);
 
@@ -809,7 +804,7 @@ TMXIsoZorder::TMXIsoZorder()
     map->setPosition(Point(-s.width/2,0));
     
     _tamara = Sprite::create(s_pathSister1);
-    map->addChild(_tamara, map->getChildren()->count() );
+    map->addChild(_tamara, map->getChildren().size() );
     _tamara->retain();
     int mapWidth = map->getMapSize().width * map->getTileSize().width;
     _tamara->setPosition(CC_POINT_PIXELS_TO_POINTS(Point( mapWidth/2,0)));
@@ -877,7 +872,7 @@ TMXOrthoZorder::TMXOrthoZorder()
     CCLOG("ContentSize: %f, %f", s.width,s.height);
     
     _tamara = Sprite::create(s_pathSister1);
-    map->addChild(_tamara,  map->getChildren()->count());
+    map->addChild(_tamara,  map->getChildren().size());
     _tamara->retain();
     _tamara->setAnchorPoint(Point(0.5f,0));
 
@@ -1154,8 +1149,7 @@ TMXOrthoFlipTest::TMXOrthoFlipTest()
     Size CC_UNUSED s = map->getContentSize();
     log("ContentSize: %f, %f", s.width,s.height);
 
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(map->getChildren(), pObj)
+    for (const auto& pObj : map->getChildren())
     {
         auto child = static_cast<SpriteBatchNode*>(pObj);
         child->getTexture()->setAntiAliasTexParameters();
@@ -1184,8 +1178,7 @@ TMXOrthoFlipRunTimeTest::TMXOrthoFlipRunTimeTest()
     auto s = map->getContentSize();
     log("ContentSize: %f, %f", s.width,s.height);
 
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(map->getChildren(), pObj)
+    for (const auto& pObj : map->getChildren())
     {
         auto child = static_cast<SpriteBatchNode*>(pObj);
         child->getTexture()->setAntiAliasTexParameters();
@@ -1263,8 +1256,7 @@ TMXOrthoFromXMLTest::TMXOrthoFromXMLTest()
     auto s = map->getContentSize();
     log("ContentSize: %f, %f", s.width,s.height);
 
-    Object* pObj = NULL;
-    CCARRAY_FOREACH(map->getChildren(), pObj)
+    for (const auto& pObj : map->getChildren())
     {
         auto child = static_cast<SpriteBatchNode*>(pObj);
         child->getTexture()->setAntiAliasTexParameters();
@@ -1292,10 +1284,9 @@ TMXBug987::TMXBug987()
     Size CC_UNUSED s1 = map->getContentSize();
     CCLOG("ContentSize: %f, %f", s1.width,s1.height);
 
-    auto childs = map->getChildren();
+    auto& childs = map->getChildren();
     TMXLayer* node;
-    Object* pObject = NULL;
-    CCARRAY_FOREACH(childs, pObject)
+    for (const auto& pObject : childs)
     {
         node = static_cast<TMXLayer*>(pObject);
         CC_BREAK_IF(!node);
@@ -1355,7 +1346,7 @@ enum
 
 static int sceneIdx = -1; 
 
-#define MAX_LAYER    28
+#define MAX_LAYER    29
 
 Layer* createTileMalayer(int nIndex)
 {
@@ -1389,6 +1380,7 @@ Layer* createTileMalayer(int nIndex)
         case 25: return new TMXBug987();
         case 26: return new TMXBug787();
         case 27: return new TMXGIDObjectsTest();
+        case 28: return new TMXAsyncLoadTest();
     }
 
     return NULL;
@@ -1558,3 +1550,58 @@ string TMXGIDObjectsTest::subtitle()
 {
     return "Tiles are created from an object group";
 }
+
+//------------------------------------------------------------------
+//
+// TMXAsyncLoadTest
+//
+//------------------------------------------------------------------
+TMXAsyncLoadTest::TMXAsyncLoadTest()
+: _elapsed(0)
+{
+    // the layers are added while the camera moves
+    auto map = TMXTiledMap::createAsync("TileMaps/orthogonal-test2.tmx", CC_CALLBACK_2(TMXAsyncLoadTest::mapLoaded, this));
+    map->setChunkPrefetchDistance(1);
+    addChild(map, 0, kTagTileMap);
+
+    auto s = Director::getInstance()->getWinSize();
+    _status = LabelTTF::create("Loading...", "Arial", 20);
+    _status->setPosition(Point(s.width/2, 80));
+    addChild(_status, 1);
+
+    schedule(schedule_selector(TMXAsyncLoadTest::moveCamera));
+}
+
+void TMXAsyncLoadTest::mapLoaded(TMXTiledMap* map, bool loaded)
+{
+    char str[64] = {0};
+    sprintf(str, loaded ? "Loaded, %d layers" : "Failed", (int)map->getChildrenCount());
+    _status->setString(str);
+}
+
+void TMXAsyncLoadTest::moveCamera(float dt)
+{
+    _elapsed += dt;
+
+    // back and forth over the map: the chunks of the layers are paged in and out
+    auto map = static_cast<TMXTiledMap*>(getChildByTag(kTagTileMap));
+    auto s = Director::getInstance()->getWinSize();
+    Size range = map->getContentSize() - s;
+    float x = MAX(range.width, 0) * (1 - cosf(_elapsed * 0.4f)) / 2;
+    float y = MAX(range.height, 0) * (1 - cosf(_elapsed * 0.3f)) / 2;
+
+    float eyeX, eyeY, eyeZ;
+    map->getCamera()->getEyeXYZ(&eyeX, &eyeY, &eyeZ);
+    map->getCamera()->setEyeXYZ(x, y, eyeZ);
+    map->getCamera()->setCenterXYZ(x, y, 0);
+}
+
+std::string TMXAsyncLoadTest::title()
+{
+    return "TMX Async Load";
+}
+
+std::string TMXAsyncLoadTest::subtitle()
+{
+    return "Layers are added while the camera moves";
+}
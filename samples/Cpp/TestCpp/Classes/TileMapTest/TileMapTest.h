@@ -281,6 +281,21 @@ public:
     virtual void draw();
 };
 
+class TMXAsyncLoadTest : public TileDemo
+{
+public:
+    TMXAsyncLoadTest();
+    virtual std::string title();
+    virtual std::string subtitle();
+
+    void mapLoaded(TMXTiledMap* map, bool loaded);
+    void moveCamera(float dt);
+
+protected:
+    LabelTTF* _status;
+    float _elapsed;
+};
+
 class TileMapTestScene : public TestScene
 {
 public:
@@ -1,7 +1,7 @@
 #include "ZwoptexTest.h"
 #include "../testResource.h"
 
-#define MAX_LAYER    1
+#define MAX_LAYER    2
 
 static int sceneIdx = -1;
 
@@ -14,6 +14,7 @@ Layer* createZwoptexLayer(int nIndex)
     switch(nIndex)
     {
     case 0: return new ZwoptexGenericTest();
+    case 1: return new ZwoptexCompiledTest();
     }
 
     return NULL;
@@ -208,6 +209,123 @@ std::string ZwoptexGenericTest::subtitle()
     return "Coordinate Formats, Rotation, Trimming, flipX/Y";
 }
 
+//------------------------------------------------------------------
+//
+// ZwoptexCompiledTest
+//
+//------------------------------------------------------------------
+static const char* s_compiledSheets[] = {
+    "zwoptex/grossini",
+    "zwoptex/grossini-generic",
+    "animations/grossini-aliases",
+};
+
+void ZwoptexCompiledTest::onEnter()
+{
+    ZwoptexTest::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    bool passed = true;
+    for (const auto& name : s_compiledSheets)
+    {
+        passed = compareWithPlist(name) && passed;
+    }
+
+    auto label = LabelTTF::create(passed ? "Passed" : "Failed", "Arial", 26);
+    label->setColor(passed ? Color3B::GREEN : Color3B::RED);
+    label->setPosition(Point(s.width/2, s.height/2 - 80));
+    addChild(label);
+
+    auto cache = SpriteFrameCache::getInstance();
+    cache->addSpriteFramesWithFile("zwoptex/grossini.ccsf");
+    cache->addSpriteFramesWithFile("zwoptex/grossini-generic.ccsf");
+
+    auto sprite1 = Sprite::createWithSpriteFrameName("grossini_dance_01.png");
+    sprite1->setPosition(Point(s.width/2 - 80, s.height/2 + 20));
+    addChild(sprite1);
+
+    auto sprite2 = Sprite::createWithSpriteFrameName("grossini_dance_generic_01.png");
+    sprite2->setPosition(Point(s.width/2 + 80, s.height/2 + 20));
+    addChild(sprite2);
+}
+
+bool ZwoptexCompiledTest::compareWithPlist(const std::string& name)
+{
+    auto cache = SpriteFrameCache::getInstance();
+    std::string plist = name + ".plist";
+    std::string compiled = name + ".ccsf";
+
+    // the names of the frames and of their aliases
+    std::vector<std::string> frameNames;
+    auto dict = Dictionary::createWithContentsOfFile(plist.c_str());
+    auto framesDict = static_cast<Dictionary*>(dict->objectForKey("frames"));
+    DictElement* element = nullptr;
+    CCDICT_FOREACH(framesDict, element)
+    {
+        frameNames.push_back(element->getStrKey());
+
+        auto aliases = static_cast<Array*>(static_cast<Dictionary*>(element->getObject())->objectForKey("aliases"));
+        Object* alias = nullptr;
+        CCARRAY_FOREACH(aliases, alias)
+        {
+            frameNames.push_back(static_cast<String*>(alias)->getCString());
+        }
+    }
+
+    Map<std::string, SpriteFrame*> plistFrames;
+    cache->addSpriteFramesWithFile(plist.c_str());
+    for (const auto& frameName : frameNames)
+    {
+        auto frame = cache->getSpriteFrameByName(frameName.c_str());
+        if (frame)
+        {
+            plistFrames.insert(frameName, frame);
+        }
+    }
+    cache->removeSpriteFramesFromFile(plist.c_str());
+
+    cache->addSpriteFramesWithFile(compiled.c_str());
+
+    bool passed = plistFrames.size() == (int)frameNames.size();
+    for (const auto& frameName : frameNames)
+    {
+        auto expected = plistFrames.at(frameName);
+        auto frame = cache->getSpriteFrameByName(frameName.c_str());
+        if (!expected || !frame
+            || !frame->getRect().equals(expected->getRect())
+            || frame->isRotated() != expected->isRotated()
+            || !frame->getOffset().equals(expected->getOffset())
+            || !frame->getOriginalSize().equals(expected->getOriginalSize())
+            || frame->getTexture() != expected->getTexture())
+        {
+            CCLOG("ZwoptexCompiledTest: frame %s of %s differs from %s", frameName.c_str(), compiled.c_str(), plist.c_str());
+            passed = false;
+        }
+    }
+    // the sheets share some frame names
+    cache->removeSpriteFramesFromFile(compiled.c_str());
+
+    return passed;
+}
+
+ZwoptexCompiledTest::~ZwoptexCompiledTest()
+{
+    auto cache = SpriteFrameCache::getInstance();
+    cache->removeSpriteFramesFromFile("zwoptex/grossini.ccsf");
+    cache->removeSpriteFramesFromFile("zwoptex/grossini-generic.ccsf");
+}
+
+std::string ZwoptexCompiledTest::title()
+{
+    return "Compiled sprite frames";
+}
+
+std::string ZwoptexCompiledTest::subtitle()
+{
+    return "The .ccsf frames must match the .plist ones";
+}
+
 void ZwoptexTestScene::runThisTest()
 {
     auto layer = nextZwoptexTest();
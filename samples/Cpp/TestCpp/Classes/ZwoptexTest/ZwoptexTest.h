@@ -34,6 +34,20 @@ protected:
     int counter;
 };
 
+class ZwoptexCompiledTest : public ZwoptexTest
+{
+public:
+    ~ZwoptexCompiledTest();
+    virtual void onEnter();
+
+    virtual std::string title();
+    virtual std::string subtitle();
+
+protected:
+    // Compares the frames of a compiled .ccsf file with the ones of the .plist it was compiled from
+    bool compareWithPlist(const std::string& name);
+};
+
 class ZwoptexTestScene : public TestScene
 {
 public:
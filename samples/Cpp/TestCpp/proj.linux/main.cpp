@@ -1,10 +1,12 @@
 #include "../Classes/AppDelegate.h"
+#include "../Classes/PerformanceTest/PerformanceBenchmark.h"
 #include "cocos2d.h"
 #include "CCEGLView.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <string.h>
 #include <string>
 
 USING_NS_CC;
@@ -15,5 +17,20 @@ int main(int argc, char **argv)
     AppDelegate app;
     auto eglView = EGLView::getInstance();
     eglView->setFrameSize(800, 480);
+
+#if CC_HEADLESS
+    // headless builds have nothing to interact with: they only run the benchmark
+    bool benchmark = true;
+#else
+    bool benchmark = (argc > 1 && strcmp(argv[1], "--benchmark") == 0);
+#endif
+    if (benchmark)
+    {
+        if (! app.applicationDidFinishLaunching())
+        {
+            return 1;
+        }
+        return runPerformanceBenchmark(argc, argv);
+    }
     return Application::getInstance()->run();
 }
@@ -153,20 +153,12 @@ local function MenuLayerMainMenu()
     -- elastic effect
     local s = cc.Director:getInstance():getWinSize()
 
-    local i        = 0
-    local child    = nil
-    local pArray   = menu:getChildren()
-    local len      = table.getn(pArray)
-    local pObject  = nil
-    for i = 0, len-1 do
-        pObject = pArray[i + 1]
-        if pObject == nil then
-            break
-        end
-        child = tolua.cast(pObject, "Node")
+    local children = menu:getChildren()
+    for i = 1, #children do
+        local child = children[i]
         local dstPointX, dstPointY = child:getPosition()
         local offset = s.width/2 + 50
-        if  i % 2 == 0 then
+        if  i % 2 == 1 then
             offset = 0-offset
         end
         child:setPosition( cc.p( dstPointX + offset, dstPointY) )
@@ -1204,11 +1204,12 @@ local AddAndDeleteParticleSystems_batchNode = nil
 local function removeSystem(dt)
 	update(dt)
 
-	local ChildrenCount = table.getn(AddAndDeleteParticleSystems_batchNode:getChildren())
-    if ChildrenCount > 0 then
+	local children = AddAndDeleteParticleSystems_batchNode:getChildren()
+    if #children > 0 then
         cclog("remove random system")
-        local rand = math.mod(math.random(1, 999999), ChildrenCount - 1)
-        AddAndDeleteParticleSystems_batchNode:removeChild(AddAndDeleteParticleSystems_batchNode:getChildren()[(rand)], true)
+        -- the table of children is 1-based
+        local rand = math.random(1, #children)
+        AddAndDeleteParticleSystems_batchNode:removeChild(children[rand], true)
 
 		--add new
         local particleSystem = cc.ParticleSystemQuad:create("Particles/Spiral.plist")
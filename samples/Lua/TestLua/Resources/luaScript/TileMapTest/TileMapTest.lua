@@ -158,20 +158,10 @@ local function TMXOrthoTest()
     local  s = map:getContentSize()
     cclog("ContentSize: %f, %f", s.width,s.height)
 
-    local  pChildrenArray = map:getChildren()
-    local  child = nil
-    local  pObject = nil
-    local i = 0
-    local len = table.getn(pChildrenArray)
-    for i = 0, len-1, 1 do
-        pObject = pChildrenArray[i + 1]
-        child = tolua.cast(pObject, "SpriteBatchNode")
-
-        if child == nil then
-            break
-        end
-
-        child:getTexture():setAntiAliasTexParameters()
+    local  children = map:getChildren()
+    for i = 1, #children do
+        -- each child comes with its own class, a TMXLayer here
+        children[i]:getTexture():setAntiAliasTexParameters()
     end
 
     local x = 0
@@ -412,7 +402,7 @@ local function TMXReadWriteTest()
         local layer = tolua.cast(map:getChildByTag(0), "TMXLayer")
 
         --------cclog("++++atlas quantity: %d", layer:textureAtlas():getTotalQuads())
-        --------cclog("++++children: %d", layer:getChildren():count() )
+        --------cclog("++++children: %d", #layer:getChildren() )
 
 
         local s = layer:getLayerSize()
@@ -473,7 +463,7 @@ local function TMXReadWriteTest()
 
     ret:registerScriptHandler(onNodeEvent)
     --------cclog("++++atlas quantity: %d", layer:textureAtlas():getTotalQuads())
-    --------cclog("++++children: %d", layer:getChildren():count() )
+    --------cclog("++++children: %d", #layer:getChildren() )
 
     m_gid2 = 0
     return ret
@@ -80,6 +80,29 @@ inline js_proxy_t *js_get_or_create_proxy(JSContext *cx, T *native_obj) {
     return NULL;
 }
 
+/**
+ * Returns a JS array with the proxies of the objects of a Vector, the same
+ * way ccarray_to_jsval() does for an Array.
+ */
+template<class T>
+jsval ccvector_to_jsval(JSContext *cx, const cocos2d::Vector<T*>& v) {
+    JSObject *jsretArr = JS_NewArrayObject(cx, 0, NULL);
+    
+    int i = 0;
+    for (const auto& obj : v) {
+        js_proxy_t *proxy = js_get_or_create_proxy<T>(cx, obj);
+        if (!proxy) {
+            continue;
+        }
+        jsval arrElement = OBJECT_TO_JSVAL(proxy->obj);
+        if (!JS_SetElement(cx, jsretArr, i, &arrElement)) {
+            break;
+        }
+        ++i;
+    }
+    return OBJECT_TO_JSVAL(jsretArr);
+}
+
 jsval anonEvaluate(JSContext *cx, JSObject *thisObj, const char* string);
 void register_cocos2dx_js_extensions(JSContext* cx, JSObject* obj);
 
@@ -70,5 +70,86 @@ JSBool JSB_localStorageSetItem(JSContext *cx, uint32_t argc, jsval *vp) {
 	return JS_TRUE;
 }
 
+// Arguments: object, the items by key
+// Ret value: void
+JSBool JSB_localStorageSetItems(JSContext *cx, uint32_t argc, jsval *vp) {
+	JSB_PRECONDITION2( argc == 1, cx, JS_FALSE, "Invalid number of arguments" );
+	jsval *argvp = JS_ARGV(cx,vp);
+	JSObject *jsobj;
+	JSBool ok = argvp->isObject() && JS_ValueToObject( cx, *argvp, &jsobj );
+	JSB_PRECONDITION2(ok, cx, JS_FALSE, "Error processing arguments");
+
+	std::map<std::string, std::string> items;
+	JSObject *it = JS_NewPropertyIterator(cx, jsobj);
+	while( true ) {
+		jsid idp;
+		jsval key;
+		ok = JS_NextProperty(cx, it, &idp) && JS_IdToValue(cx, idp, &key);
+		JSB_PRECONDITION2(ok, cx, JS_FALSE, "Error processing arguments");
+
+		if( key == JSVAL_VOID )
+			break; // end of iteration
+
+		jsval value;
+		const char* arg0; const char* arg1;
+		ok &= JS_GetPropertyById(cx, jsobj, idp, &value);
+		ok &= jsval_to_charptr( cx, key, &arg0 );
+		ok &= jsval_to_charptr( cx, value, &arg1 );
+		JSB_PRECONDITION2(ok, cx, JS_FALSE, "Error processing arguments");
+
+		items[arg0] = arg1;
+	}
+
+	localStorageSetItems(items);
+	JS_SET_RVAL(cx, vp, JSVAL_VOID);
+	return JS_TRUE;
+}
+
+// Arguments: array of char*
+// Ret value: object, the items found by key
+JSBool JSB_localStorageGetItems(JSContext *cx, uint32_t argc, jsval *vp) {
+	JSB_PRECONDITION2( argc == 1, cx, JS_FALSE, "Invalid number of arguments" );
+	jsval *argvp = JS_ARGV(cx,vp);
+	JSObject *jsobj;
+	JSBool ok = argvp->isObject() && JS_ValueToObject( cx, *argvp, &jsobj );
+	JSB_PRECONDITION2(ok && JS_IsArrayObject( cx, jsobj ), cx, JS_FALSE, "Error processing arguments");
+
+	uint32_t len = 0;
+	JS_GetArrayLength(cx, jsobj, &len);
+	std::vector<std::string> keys;
+	keys.reserve(len);
+	for( uint32_t i=0; i < len; i++ ) {
+		jsval value;
+		const char* arg0;
+		ok &= JS_GetElement(cx, jsobj, i, &value);
+		ok &= jsval_to_charptr( cx, value, &arg0 );
+		JSB_PRECONDITION2(ok, cx, JS_FALSE, "Error processing arguments");
+
+		keys.push_back(arg0);
+	}
+
+	std::map<std::string, std::string> items = localStorageGetItems(keys);
+
+	JSObject *ret = JS_NewObject(cx, NULL, NULL, NULL);
+	JSB_PRECONDITION2(ret, cx, JS_FALSE, "Error creating the result");
+	for( const auto& item : items ) {
+		ok &= JS_DefineProperty(cx, ret, item.first.c_str(), charptr_to_jsval( cx, item.second.c_str() ), NULL, NULL, JSPROP_ENUMERATE);
+	}
+	JSB_PRECONDITION2(ok, cx, JS_FALSE, "Error creating the result");
+
+	JS_SET_RVAL(cx, vp, OBJECT_TO_JSVAL(ret) );
+	return JS_TRUE;
+}
+
+// Arguments: none
+// Ret value: void
+JSBool JSB_localStorageFlush(JSContext *cx, uint32_t argc, jsval *vp) {
+	JSB_PRECONDITION2( argc == 0, cx, JS_FALSE, "Invalid number of arguments" );
+
+	localStorageFlush();
+	JS_SET_RVAL(cx, vp, JSVAL_VOID);
+	return JS_TRUE;
+}
+
 
 //#endif // JSB_INCLUDE_SYSTEM
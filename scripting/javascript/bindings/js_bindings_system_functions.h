@@ -14,6 +14,9 @@ extern "C" {
 JSBool JSB_localStorageGetItem(JSContext *cx, uint32_t argc, jsval *vp);
 JSBool JSB_localStorageRemoveItem(JSContext *cx, uint32_t argc, jsval *vp);
 JSBool JSB_localStorageSetItem(JSContext *cx, uint32_t argc, jsval *vp);
+JSBool JSB_localStorageSetItems(JSContext *cx, uint32_t argc, jsval *vp);
+JSBool JSB_localStorageGetItems(JSContext *cx, uint32_t argc, jsval *vp);
+JSBool JSB_localStorageFlush(JSContext *cx, uint32_t argc, jsval *vp);
 
 #ifdef __cplusplus
 }
@@ -6,6 +6,7 @@ extern "C" {
 #include "tolua++.h"
 }
 
+#include "tolua_fix.h"
 #include "cocos2d.h"
 
 using namespace cocos2d;
@@ -55,4 +56,31 @@ extern void affinetransform_to_luaval(lua_State* L,const AffineTransform& inValu
 extern void fontdefinition_to_luaval(lua_State* L,const FontDefinition& inValue);
 extern void array_to_luaval(lua_State* L,Array* inValue);
 extern void dictionary_to_luaval(lua_State* L, Dictionary* dict);
+
+/** Pushes a table of the objects of a Vector, each one with its own class, like array_to_luaval() does */
+template <class T>
+void ccvector_to_luaval(lua_State* L, const Vector<T*>& inValue)
+{
+    lua_newtable(L);
+
+    if (nullptr == L)
+        return;
+
+    int indexTable = 1;
+    for (const auto& obj : inValue)
+    {
+        if (nullptr == obj)
+            continue;
+
+        uint32_t typeId = typeid(*obj).hash_code();
+        auto iter = g_luaType.find(typeId);
+        if (g_luaType.end() != iter)
+        {
+            lua_pushnumber(L, (lua_Number)indexTable);
+            toluafix_pushusertype_ccobject(L, obj->_ID, &obj->_luaID, (void*)obj, iter->second.c_str());
+            lua_rawset(L, -3);
+            ++indexTable;
+        }
+    }
+}
 #endif //__COCOS2DX_SCRIPTING_LUA_COCOS2DXSUPPORT_LUABAISCCONVERSIONS_H__
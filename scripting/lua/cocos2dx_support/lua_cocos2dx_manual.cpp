@@ -1224,6 +1224,46 @@ tolua_lerror:
 #endif
 }
 
+static int tolua_cocos2d_Node_getChildren(lua_State* tolua_S)
+{
+    if (NULL == tolua_S)
+        return 0;
+    
+    int argc = 0;
+    Node* self = nullptr;
+    
+#if COCOS2D_DEBUG >= 1
+	tolua_Error tolua_err;
+	if (!tolua_isusertype(tolua_S,1,"Node",0,&tolua_err)) goto tolua_lerror;
+#endif
+    
+    self = static_cast<cocos2d::Node*>(tolua_tousertype(tolua_S,1,0));
+#if COCOS2D_DEBUG >= 1
+	if (nullptr == self) {
+		tolua_error(tolua_S,"invalid 'self' in function 'tolua_cocos2d_Node_getChildren'\n", NULL);
+		return 0;
+	}
+#endif
+    
+    argc = lua_gettop(tolua_S) - 1;
+    
+    if (0 == argc)
+    {
+        // a table of the children, as it was when they were kept in an Array
+        ccvector_to_luaval(tolua_S, self->getChildren());
+        return 1;
+    }
+    
+    CCLOG("'getChildren' function in Node has wrong number of arguments: %d, was expecting %d\n", argc, 0);
+    return 0;
+    
+#if COCOS2D_DEBUG >= 1
+tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'getChildren'.",&tolua_err);
+    return 0;
+#endif
+}
+
 static int tolua_cocos2d_Spawn_create(lua_State* tolua_S)
 {
     if (NULL == tolua_S)
@@ -2412,6 +2452,9 @@ static void extendNode(lua_State* tolua_S)
         lua_pushstring(tolua_S,"getPosition");
         lua_pushcfunction(tolua_S,tolua_cocos2d_Node_getPosition);
         lua_rawset(tolua_S, -3);
+        lua_pushstring(tolua_S,"getChildren");
+        lua_pushcfunction(tolua_S,tolua_cocos2d_Node_getChildren);
+        lua_rawset(tolua_S, -3);
     }
 }
 
@@ -0,0 +1,121 @@
+#!/usr/bin/python
+# pack_resources.py
+# Builds a resource pack read by cocos2d::ResourcePack (platform/CCResourcePack.h)
+# Copyright (c) 2013 cocos2d-x.org
+#
+# Usage:
+#   pack_resources.py [-c] [-x EXT ...] -o OUTPUT.pack DIRECTORY
+#
+# The files under DIRECTORY are stored with their path relative to it, so the pack
+# has to be mounted at the directory that plays the role of DIRECTORY at runtime:
+#   FileUtils::getInstance()->addResourcePack("res.pack");            // resource root
+#   FileUtils::getInstance()->addResourcePack("hd.pack", "hd");       // Resources/hd/
+#
+# With -c the files are zlib compressed when it makes them smaller, except the ones
+# whose extension is given with -x (by default the formats already compressed, which
+# are better read in place without any copy).
+
+import os
+import struct
+import sys
+import zlib
+from optparse import OptionParser
+
+MAGIC = b'CCPK'
+VERSION = 1
+HEADER_FORMAT = '<4s7I'
+ENTRY_FORMAT = '<QQIHHII'
+ENTRY_COMPRESSED = 1
+
+DEFAULT_STORED_EXTENSIONS = ['.png', '.jpg', '.jpeg', '.webp', '.ccz', '.gz', '.mp3', '.ogg', '.zip']
+
+def fnv1a64(data):
+    h = 14695981039346656037
+    for c in bytearray(data):
+        h ^= c
+        h = (h * 1099511628211) & 0xffffffffffffffff
+    return h
+
+def align(offset, alignment):
+    return (offset + alignment - 1) // alignment * alignment
+
+def collect_files(root):
+    files = []
+    for dirpath, dirnames, filenames in os.walk(root):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            path = os.path.join(dirpath, filename)
+            name = os.path.relpath(path, root).replace(os.sep, '/')
+            files.append((name, path))
+    return files
+
+def build_pack(root, output, compress, stored_extensions):
+    entries = []
+    for name, path in collect_files(root):
+        with open(path, 'rb') as f:
+            data = f.read()
+        flags = 0
+        stored = data
+        if compress and os.path.splitext(name)[1].lower() not in stored_extensions:
+            deflated = zlib.compress(data, 9)
+            if len(deflated) < len(data):
+                stored = deflated
+                flags = ENTRY_COMPRESSED
+        encoded = name.encode('utf-8')
+        if len(encoded) > 0xffff:
+            raise ValueError('file name too long: %s' % name)
+        entries.append({'name': encoded, 'hash': fnv1a64(encoded), 'flags': flags,
+                        'size': len(data), 'stored': stored})
+
+    entries.sort(key=lambda e: (e['hash'], e['name']))
+
+    header_size = struct.calcsize(HEADER_FORMAT)
+    entry_size = struct.calcsize(ENTRY_FORMAT)
+    index_offset = align(header_size, 8)
+    names_offset = index_offset + entry_size * len(entries)
+    names = b''.join(e['name'] for e in entries)
+
+    # the data of every file starts on its own 16 bytes boundary
+    offset = align(names_offset + len(names), 16)
+    name_offset = 0
+    for e in entries:
+        e['name_offset'] = name_offset
+        name_offset += len(e['name'])
+        e['data_offset'] = offset
+        offset = align(offset + len(e['stored']), 16)
+
+    with open(output, 'wb') as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(entries), index_offset,
+                            names_offset, len(names), 0, 0))
+        f.write(b'\0' * (index_offset - header_size))
+        for e in entries:
+            f.write(struct.pack(ENTRY_FORMAT, e['hash'], e['data_offset'], e['name_offset'],
+                                len(e['name']), e['flags'], e['size'], len(e['stored'])))
+        f.write(names)
+        for e in entries:
+            f.write(b'\0' * (e['data_offset'] - f.tell()))
+            f.write(e['stored'])
+
+    return entries
+
+def main():
+    parser = OptionParser(usage='usage: %prog [options] -o OUTPUT DIRECTORY')
+    parser.add_option('-o', '--output', dest='output', help='the pack to write')
+    parser.add_option('-c', '--compress', dest='compress', action='store_true', default=False,
+                      help='compress the files with zlib')
+    parser.add_option('-x', '--store', dest='stored', action='append', default=None,
+                      help='extension of files never compressed, e.g. -x .png (repeatable)')
+    (options, args) = parser.parse_args()
+
+    if len(args) != 1 or not options.output:
+        parser.print_help()
+        return 1
+
+    stored = DEFAULT_STORED_EXTENSIONS if options.stored is None else [e.lower() for e in options.stored]
+    entries = build_pack(args[0], options.output, options.compress, stored)
+    compressed = len([e for e in entries if e['flags'] & ENTRY_COMPRESSED])
+    print('%s: %d files, %d compressed' % (options.output, len(entries), compressed))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
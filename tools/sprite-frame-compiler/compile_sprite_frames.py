@@ -0,0 +1,153 @@
+#!/usr/bin/python
+# compile_sprite_frames.py
+# Compiles sprite frames plist files into the binary atlases read by
+# cocos2d::SpriteFrameAtlas (sprite_nodes/CCSpriteFrameAtlas.h)
+# Copyright (c) 2013 cocos2d-x.org
+#
+# Usage:
+#   compile_sprite_frames.py [-o OUTPUT.ccsf] PLIST ...
+#
+# Without -o, every PLIST is compiled next to itself, with the .ccsf extension.
+# The atlas is then loaded like the plist:
+#   SpriteFrameCache::getInstance()->addSpriteFramesWithFile("grossini.ccsf");
+#
+# All the plist formats read by SpriteFrameCache are supported (Zwoptex 0 to 3):
+# the frames are stored with the values SpriteFrameCache would have computed.
+
+import os
+import plistlib
+import re
+import struct
+import sys
+from optparse import OptionParser
+
+MAGIC = b'CCSF'
+VERSION = 1
+HEADER_FORMAT = '<4s9I'
+FRAME_FORMAT = '<IHH8f'
+ALIAS_FORMAT = '<IHHI'
+FRAME_ROTATED = 1
+
+try:
+    string_types = basestring   # Python 2: the plist strings may be unicode
+except NameError:
+    string_types = str
+
+NUMBER = re.compile(r'[-+]?(?:[0-9]+\.?[0-9]*|\.[0-9]+)(?:[eE][-+]?[0-9]+)?')
+
+def to_float(value):
+    if isinstance(value, (int, float)):
+        return float(value)
+    match = NUMBER.match(value.strip()) if isinstance(value, string_types) else None
+    return float(match.group(0)) if match else 0.0
+
+def to_int(value):
+    return int(to_float(value))
+
+def to_bool(value):
+    if isinstance(value, string_types):
+        return value not in ('', '0', 'false')
+    return bool(value)
+
+def numbers(value, count):
+    # the "{x,y}" and "{{x,y},{w,h}}" strings of the plists
+    found = [float(n) for n in NUMBER.findall(value or '')]
+    return found if len(found) == count else [0.0] * count
+
+def read_frames(frames, frame_format):
+    result = []
+    # sorted, so that the atlas doesn't depend on the order of the dictionary
+    for name, frame in sorted(frames.items()):
+        aliases = []
+        if frame_format == 0:
+            rect = [to_float(frame.get(k, 0)) for k in ('x', 'y', 'width', 'height')]
+            rotated = False
+            offset = [to_float(frame.get('offsetX', 0)), to_float(frame.get('offsetY', 0))]
+            original = [float(abs(to_int(frame.get('originalWidth', 0)))),
+                        float(abs(to_int(frame.get('originalHeight', 0))))]
+            if not original[0] or not original[1]:
+                sys.stderr.write('warning: originalWidth/Height not found for %s\n' % name)
+        elif frame_format in (1, 2):
+            rect = numbers(frame.get('frame'), 4)
+            rotated = frame_format == 2 and to_bool(frame.get('rotated', False))
+            offset = numbers(frame.get('offset'), 2)
+            original = numbers(frame.get('sourceSize'), 2)
+        else:
+            size = numbers(frame.get('spriteSize'), 2)
+            texture_rect = numbers(frame.get('textureRect'), 4)
+            rect = texture_rect[:2] + size
+            rotated = to_bool(frame.get('textureRotated', False))
+            offset = numbers(frame.get('spriteOffset'), 2)
+            original = numbers(frame.get('spriteSourceSize'), 2)
+            aliases = list(frame.get('aliases', []))
+        result.append({'name': name, 'rect': rect, 'rotated': rotated, 'offset': offset,
+                       'original': original, 'aliases': aliases})
+    return result
+
+def read_plist(plist):
+    with open(plist, 'rb') as f:
+        # plistlib.load() appeared in Python 3.4, readPlist() is gone since 3.9
+        if hasattr(plistlib, 'load'):
+            return plistlib.load(f)
+        return plistlib.readPlist(f)
+
+def compile_plist(plist, output):
+    root = read_plist(plist)
+    metadata = root.get('metadata', {})
+    frame_format = to_int(metadata.get('format', 0))
+    if frame_format < 0 or frame_format > 3:
+        raise ValueError('%s: unsupported format %d' % (plist, frame_format))
+    frames = read_frames(root.get('frames', {}), frame_format)
+
+    strings = bytearray()
+    def add_string(text):
+        encoded = text.encode('utf-8')
+        if len(encoded) > 0xffff:
+            raise ValueError('%s: name too long: %s' % (plist, text))
+        offset = len(strings)
+        strings.extend(encoded)
+        return offset, len(encoded)
+
+    texture_name = add_string(metadata.get('textureFileName', '') or '')
+    records = []
+    aliases = []
+    for index, frame in enumerate(frames):
+        name_offset, name_length = add_string(frame['name'])
+        flags = FRAME_ROTATED if frame['rotated'] else 0
+        records.append(struct.pack(FRAME_FORMAT, name_offset, name_length, flags,
+                                   *(frame['rect'] + frame['offset'] + frame['original'])))
+        for alias in frame['aliases']:
+            alias_offset, alias_length = add_string(alias)
+            aliases.append(struct.pack(ALIAS_FORMAT, alias_offset, alias_length, 0, index))
+
+    frames_offset = struct.calcsize(HEADER_FORMAT)
+    aliases_offset = frames_offset + struct.calcsize(FRAME_FORMAT) * len(records)
+    strings_offset = aliases_offset + struct.calcsize(ALIAS_FORMAT) * len(aliases)
+
+    with open(output, 'wb') as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(records), len(aliases),
+                            frames_offset, aliases_offset, strings_offset, len(strings),
+                            texture_name[0], texture_name[1]))
+        f.write(b''.join(records))
+        f.write(b''.join(aliases))
+        f.write(strings)
+
+    return len(records), len(aliases)
+
+def main():
+    parser = OptionParser(usage='usage: %prog [-o OUTPUT.ccsf] PLIST ...')
+    parser.add_option('-o', '--output', dest='output', help='the atlas to write, with a single plist')
+    (options, args) = parser.parse_args()
+
+    if not args or (options.output and len(args) != 1):
+        parser.print_help()
+        return 1
+
+    for plist in args:
+        output = options.output or os.path.splitext(plist)[0] + '.ccsf'
+        frames, aliases = compile_plist(plist, output)
+        print('%s: %d frames, %d aliases' % (output, frames, aliases))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())